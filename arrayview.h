@@ -0,0 +1,86 @@
+#pragma once
+#include "ue4math.h"
+#include "vector.h"
+#include "quat.h"
+#include "transform.h"
+#include <cstddef>
+
+/*-----------------------------------------------------------------------------
+	Non-owning strided views over raw memory, for reading engine arrays in
+	place. Element i starts Stride bytes after element i - 1; the fields are
+	doubles at the given byte offsets within an element, with no alignment
+	requirement. Elements are read with memcpy, and the batch kernels that
+	take a view gather straight from it.
+-----------------------------------------------------------------------------*/
+
+/** Num vectors (three consecutive doubles) starting Offset bytes into each element. */
+struct FVectorArrayView
+{
+	const std::byte* Data;		/* X of element 0 */
+	size_t Num;
+	size_t Stride;
+
+	FVectorArrayView() : Data(nullptr), Num(0), Stride(sizeof(FVector)) {}
+	FVectorArrayView(const std::byte* Data, size_t Num, size_t Stride = sizeof(FVector), size_t Offset = 0) : Data(Data + Offset), Num(Num), Stride(Stride) {}
+	FVectorArrayView(const FVector* Vectors, size_t Num) : Data((const std::byte*)Vectors), Num(Num), Stride(sizeof(FVector)) {}
+
+	FVector operator[](size_t Index) const
+	{
+		FVector V;
+		memcpy(&V, Data + Index * Stride, sizeof(FVector));
+		return V;
+	}
+
+	/** The elements are packed FVectors, as in an FVector array. */
+	bool IsPacked() const { return Stride == sizeof(FVector); }
+};
+
+/**
+ * Num transforms laid out like FTransform, or any record holding a quaternion, a translation and
+ * a scale as doubles at the given offsets. The defaults describe FTransform itself: rotation at
+ * 0, translation at 32 followed by the 8 byte pad, scale at 64, 96 bytes per element.
+ */
+struct FTransformArrayView
+{
+	static constexpr size_t DefaultRotationOffset = 0;
+	static constexpr size_t DefaultTranslationOffset = sizeof(FQuat);
+	static constexpr size_t DefaultScale3DOffset = sizeof(FQuat) + sizeof(FVector) + sizeof(double);
+
+	const std::byte* Data;
+	size_t Num;
+	size_t Stride;
+	size_t RotationOffset;
+	size_t TranslationOffset;
+	size_t Scale3DOffset;
+
+	FTransformArrayView()
+		: Data(nullptr), Num(0), Stride(sizeof(FTransform)), RotationOffset(DefaultRotationOffset), TranslationOffset(DefaultTranslationOffset), Scale3DOffset(DefaultScale3DOffset) {}
+
+	FTransformArrayView(const std::byte* Data, size_t Num, size_t Stride = sizeof(FTransform), size_t RotationOffset = DefaultRotationOffset,
+		size_t TranslationOffset = DefaultTranslationOffset, size_t Scale3DOffset = DefaultScale3DOffset)
+		: Data(Data), Num(Num), Stride(Stride), RotationOffset(RotationOffset), TranslationOffset(TranslationOffset), Scale3DOffset(Scale3DOffset) {}
+
+	FTransformArrayView(const FTransform* Transforms, size_t Num)
+		: Data((const std::byte*)Transforms), Num(Num), Stride(sizeof(FTransform)), RotationOffset(DefaultRotationOffset), TranslationOffset(DefaultTranslationOffset), Scale3DOffset(DefaultScale3DOffset) {}
+
+	FQuat GetRotation(size_t Index) const
+	{
+		FQuat Q;
+		memcpy(&Q, Data + Index * Stride + RotationOffset, sizeof(FQuat));
+		return Q;
+	}
+
+	FVector GetTranslation(size_t Index) const { return GetTranslations()[Index]; }
+	FVector GetScale3D(size_t Index) const { return GetScales3D()[Index]; }
+
+	FTransform operator[](size_t Index) const { return FTransform(GetRotation(Index), GetTranslation(Index), GetScale3D(Index)); }
+
+	FVectorArrayView GetTranslations() const { return FVectorArrayView(Data, Num, Stride, TranslationOffset); }
+	FVectorArrayView GetScales3D() const { return FVectorArrayView(Data, Num, Stride, Scale3DOffset); }
+
+	/** The elements have FTransform's layout, so each translation is followed by 8 bytes of pad inside its element. */
+	bool HasTransformLayout() const
+	{
+		return Stride == sizeof(FTransform) && RotationOffset == DefaultRotationOffset && TranslationOffset == DefaultTranslationOffset && Scale3DOffset == DefaultScale3DOffset;
+	}
+};
@@ -0,0 +1,860 @@
+#include "batch.h"
+#include "cpu.h"
+#include "parallel.h"
+#include "quat.h"
+#include "transformlanes.h"
+
+static void BatchGetBoneWithRotationScalar(const FTransform& ComponentToWorld, FVectorArrayView Translations, size_t Begin, size_t Count, FVectorSoA Out)
+{
+	const FTransform& C = ComponentToWorld;
+	for (size_t i = Begin; i < Count; ++i)
+	{
+		// GetBoneWithRotation, which only reads the bone's translation
+		Out.Set(i, C.Rotation * (C.Scale3D * Translations[i]) + C.Translation);
+	}
+}
+
+#if UE_MATH_X86
+/**
+ * bPaddedRows: the translations are followed by 8 readable bytes, as in FTransform, so each
+ * one loads as a 32 byte row; otherwise they are gathered.
+ */
+template<bool bPaddedRows>
+UE_TARGET_AVX2 UE_NO_FP_CONTRACT static void BatchGetBoneWithRotationAVX2(const FTransform& ComponentToWorld, FVectorArrayView Translations, size_t Count, FVectorSoA Out)
+{
+	const FTransform& C = ComponentToWorld;
+	const __m256d SX = _mm256_set1_pd(C.Scale3D.X);
+	const __m256d SY = _mm256_set1_pd(C.Scale3D.Y);
+	const __m256d SZ = _mm256_set1_pd(C.Scale3D.Z);
+	const __m256d QX = _mm256_set1_pd(C.Rotation.X);
+	const __m256d QY = _mm256_set1_pd(C.Rotation.Y);
+	const __m256d QZ = _mm256_set1_pd(C.Rotation.Z);
+	const __m256d QW = _mm256_set1_pd(C.Rotation.W);
+	const __m256d TX = _mm256_set1_pd(C.Translation.X);
+	const __m256d TY = _mm256_set1_pd(C.Translation.Y);
+	const __m256d TZ = _mm256_set1_pd(C.Translation.Z);
+	const __m256d Two = _mm256_set1_pd(2.0);
+
+	// Byte offsets of four consecutive elements
+	const long long Stride = (long long)Translations.Stride;
+	const __m256i Index = _mm256_set_epi64x(3 * Stride, 2 * Stride, Stride, 0);
+
+	size_t i = 0;
+	for (; i + 4 <= Count; i += 4)
+	{
+		const std::byte* Base = Translations.Data + i * Translations.Stride;
+		__m256d BX, BY, BZ;
+		if (bPaddedRows)
+		{
+			// Each bone yields one 32 byte row (X, Y, Z, pad); transpose four rows into X/Y/Z lanes
+			const __m256d R0 = _mm256_loadu_pd((const double*)(Base + 0 * Stride));
+			const __m256d R1 = _mm256_loadu_pd((const double*)(Base + 1 * Stride));
+			const __m256d R2 = _mm256_loadu_pd((const double*)(Base + 2 * Stride));
+			const __m256d R3 = _mm256_loadu_pd((const double*)(Base + 3 * Stride));
+			const __m256d XZ01 = _mm256_unpacklo_pd(R0, R1);
+			const __m256d YP01 = _mm256_unpackhi_pd(R0, R1);
+			const __m256d XZ23 = _mm256_unpacklo_pd(R2, R3);
+			const __m256d YP23 = _mm256_unpackhi_pd(R2, R3);
+			BX = _mm256_permute2f128_pd(XZ01, XZ23, 0x20);
+			BY = _mm256_permute2f128_pd(YP01, YP23, 0x20);
+			BZ = _mm256_permute2f128_pd(XZ01, XZ23, 0x31);
+		}
+		else
+		{
+			BX = _mm256_i64gather_pd((const double*)(Base + 0), Index, 1);
+			BY = _mm256_i64gather_pd((const double*)(Base + 8), Index, 1);
+			BZ = _mm256_i64gather_pd((const double*)(Base + 16), Index, 1);
+		}
+
+		// V = Scale3D * Bone.Translation
+		const __m256d VX = _mm256_mul_pd(SX, BX);
+		const __m256d VY = _mm256_mul_pd(SY, BY);
+		const __m256d VZ = _mm256_mul_pd(SZ, BZ);
+
+		// T = (Q ^ V) * 2
+		const __m256d T0 = _mm256_mul_pd(_mm256_sub_pd(_mm256_mul_pd(QY, VZ), _mm256_mul_pd(QZ, VY)), Two);
+		const __m256d T1 = _mm256_mul_pd(_mm256_sub_pd(_mm256_mul_pd(QZ, VX), _mm256_mul_pd(QX, VZ)), Two);
+		const __m256d T2 = _mm256_mul_pd(_mm256_sub_pd(_mm256_mul_pd(QX, VY), _mm256_mul_pd(QY, VX)), Two);
+
+		// V + (T * W) + (Q ^ T) + Translation
+		__m256d RX = _mm256_add_pd(VX, _mm256_mul_pd(T0, QW));
+		__m256d RY = _mm256_add_pd(VY, _mm256_mul_pd(T1, QW));
+		__m256d RZ = _mm256_add_pd(VZ, _mm256_mul_pd(T2, QW));
+		RX = _mm256_add_pd(RX, _mm256_sub_pd(_mm256_mul_pd(QY, T2), _mm256_mul_pd(QZ, T1)));
+		RY = _mm256_add_pd(RY, _mm256_sub_pd(_mm256_mul_pd(QZ, T0), _mm256_mul_pd(QX, T2)));
+		RZ = _mm256_add_pd(RZ, _mm256_sub_pd(_mm256_mul_pd(QX, T1), _mm256_mul_pd(QY, T0)));
+
+		_mm256_storeu_pd(Out.X + i, _mm256_add_pd(RX, TX));
+		_mm256_storeu_pd(Out.Y + i, _mm256_add_pd(RY, TY));
+		_mm256_storeu_pd(Out.Z + i, _mm256_add_pd(RZ, TZ));
+	}
+
+	_mm256_zeroupper();
+	BatchGetBoneWithRotationScalar(ComponentToWorld, Translations, i, Count, Out);
+}
+
+UE_TARGET_AVX512 UE_NO_FP_CONTRACT static void BatchGetBoneWithRotationAVX512(const FTransform& ComponentToWorld, FVectorArrayView Translations, size_t Count, FVectorSoA Out)
+{
+	const FTransform& C = ComponentToWorld;
+	const __m512d SX = _mm512_set1_pd(C.Scale3D.X);
+	const __m512d SY = _mm512_set1_pd(C.Scale3D.Y);
+	const __m512d SZ = _mm512_set1_pd(C.Scale3D.Z);
+	const __m512d QX = _mm512_set1_pd(C.Rotation.X);
+	const __m512d QY = _mm512_set1_pd(C.Rotation.Y);
+	const __m512d QZ = _mm512_set1_pd(C.Rotation.Z);
+	const __m512d QW = _mm512_set1_pd(C.Rotation.W);
+	const __m512d TX = _mm512_set1_pd(C.Translation.X);
+	const __m512d TY = _mm512_set1_pd(C.Translation.Y);
+	const __m512d TZ = _mm512_set1_pd(C.Translation.Z);
+	const __m512d Two = _mm512_set1_pd(2.0);
+
+	// Byte offsets of eight consecutive elements
+	const long long Stride = (long long)Translations.Stride;
+	const __m512i Index = _mm512_set_epi64(7 * Stride, 6 * Stride, 5 * Stride, 4 * Stride, 3 * Stride, 2 * Stride, Stride, 0);
+
+	size_t i = 0;
+	for (; i + 8 <= Count; i += 8)
+	{
+		const std::byte* Base = Translations.Data + i * Translations.Stride;
+		const __m512d BX = _mm512_i64gather_pd(Index, Base + 0, 1);
+		const __m512d BY = _mm512_i64gather_pd(Index, Base + 8, 1);
+		const __m512d BZ = _mm512_i64gather_pd(Index, Base + 16, 1);
+
+		const __m512d VX = _mm512_mul_pd(SX, BX);
+		const __m512d VY = _mm512_mul_pd(SY, BY);
+		const __m512d VZ = _mm512_mul_pd(SZ, BZ);
+
+		const __m512d T0 = _mm512_mul_pd(_mm512_sub_pd(_mm512_mul_pd(QY, VZ), _mm512_mul_pd(QZ, VY)), Two);
+		const __m512d T1 = _mm512_mul_pd(_mm512_sub_pd(_mm512_mul_pd(QZ, VX), _mm512_mul_pd(QX, VZ)), Two);
+		const __m512d T2 = _mm512_mul_pd(_mm512_sub_pd(_mm512_mul_pd(QX, VY), _mm512_mul_pd(QY, VX)), Two);
+
+		__m512d RX = _mm512_add_pd(VX, _mm512_mul_pd(T0, QW));
+		__m512d RY = _mm512_add_pd(VY, _mm512_mul_pd(T1, QW));
+		__m512d RZ = _mm512_add_pd(VZ, _mm512_mul_pd(T2, QW));
+		RX = _mm512_add_pd(RX, _mm512_sub_pd(_mm512_mul_pd(QY, T2), _mm512_mul_pd(QZ, T1)));
+		RY = _mm512_add_pd(RY, _mm512_sub_pd(_mm512_mul_pd(QZ, T0), _mm512_mul_pd(QX, T2)));
+		RZ = _mm512_add_pd(RZ, _mm512_sub_pd(_mm512_mul_pd(QX, T1), _mm512_mul_pd(QY, T0)));
+
+		_mm512_storeu_pd(Out.X + i, _mm512_add_pd(RX, TX));
+		_mm512_storeu_pd(Out.Y + i, _mm512_add_pd(RY, TY));
+		_mm512_storeu_pd(Out.Z + i, _mm512_add_pd(RZ, TZ));
+	}
+
+	_mm256_zeroupper();
+	BatchGetBoneWithRotationScalar(ComponentToWorld, Translations, i, Count, Out);
+}
+#endif
+
+#if UE_MATH_X86
+UE_TARGET_AVX2 static size_t NarrowAVX2(const double* In, float* Out, size_t Count)
+{
+	size_t i = 0;
+	for (; i + 8 <= Count; i += 8)
+	{
+		_mm_storeu_ps(Out + i, _mm256_cvtpd_ps(_mm256_loadu_pd(In + i)));
+		_mm_storeu_ps(Out + i + 4, _mm256_cvtpd_ps(_mm256_loadu_pd(In + i + 4)));
+	}
+	return i;
+}
+
+UE_TARGET_AVX2 static size_t WidenAVX2(const float* In, double* Out, size_t Count)
+{
+	size_t i = 0;
+	for (; i + 8 <= Count; i += 8)
+	{
+		_mm256_storeu_pd(Out + i, _mm256_cvtps_pd(_mm_loadu_ps(In + i)));
+		_mm256_storeu_pd(Out + i + 4, _mm256_cvtps_pd(_mm_loadu_ps(In + i + 4)));
+	}
+	return i;
+}
+
+UE_TARGET_AVX512 static size_t NarrowAVX512(const double* In, float* Out, size_t Count)
+{
+	size_t i = 0;
+	for (; i + 16 <= Count; i += 16)
+	{
+		_mm256_storeu_ps(Out + i, _mm512_cvtpd_ps(_mm512_loadu_pd(In + i)));
+		_mm256_storeu_ps(Out + i + 8, _mm512_cvtpd_ps(_mm512_loadu_pd(In + i + 8)));
+	}
+	return i;
+}
+
+UE_TARGET_AVX512 static size_t WidenAVX512(const float* In, double* Out, size_t Count)
+{
+	size_t i = 0;
+	for (; i + 16 <= Count; i += 16)
+	{
+		_mm512_storeu_pd(Out + i, _mm512_cvtps_pd(_mm256_loadu_ps(In + i)));
+		_mm512_storeu_pd(Out + i + 8, _mm512_cvtps_pd(_mm256_loadu_ps(In + i + 8)));
+	}
+	return i;
+}
+#endif
+
+void BatchConvert(const double* In, float* Out, size_t Count)
+{
+	size_t i = 0;
+	switch (GetSimdLevel())
+	{
+#if UE_MATH_X86
+	case ESimdLevel::AVX512:
+		i = NarrowAVX512(In, Out, Count);
+		break;
+	case ESimdLevel::AVX2:
+		i = NarrowAVX2(In, Out, Count);
+		break;
+#endif
+	default:
+		break;
+	}
+
+	for (; i < Count; ++i)
+	{
+		Out[i] = (float)In[i];
+	}
+}
+
+void BatchConvert(const float* In, double* Out, size_t Count)
+{
+	size_t i = 0;
+	switch (GetSimdLevel())
+	{
+#if UE_MATH_X86
+	case ESimdLevel::AVX512:
+		i = WidenAVX512(In, Out, Count);
+		break;
+	case ESimdLevel::AVX2:
+		i = WidenAVX2(In, Out, Count);
+		break;
+#endif
+	default:
+		break;
+	}
+
+	for (; i < Count; ++i)
+	{
+		Out[i] = (double)In[i];
+	}
+}
+
+/*-----------------------------------------------------------------------------
+	Reciprocal square roots. The Fast kernels take the single precision rsqrt
+	estimate of each lane, the same instruction InvSqrtEstimate uses, and
+	repeat InvSqrtFast's two Newton-Raphson steps operation for operation;
+	without FMA contraction both precisions match the scalar code bit for bit.
+-----------------------------------------------------------------------------*/
+
+#if UE_MATH_X86
+template<bool bFast>
+UE_TARGET_AVX2 UE_NO_FP_CONTRACT static inline __m256d InvSqrtAVX2(__m256d F)
+{
+	if (!bFast)
+		return _mm256_div_pd(_mm256_set1_pd(1.0), _mm256_sqrt_pd(F));
+
+	const __m256d Half = _mm256_mul_pd(_mm256_set1_pd(0.5), F);
+	const __m256d ThreeHalves = _mm256_set1_pd(1.5);
+	__m256d Y = _mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(F)));
+	Y = _mm256_mul_pd(Y, _mm256_sub_pd(ThreeHalves, _mm256_mul_pd(_mm256_mul_pd(Half, Y), Y)));
+	Y = _mm256_mul_pd(Y, _mm256_sub_pd(ThreeHalves, _mm256_mul_pd(_mm256_mul_pd(Half, Y), Y)));
+	return Y;
+}
+
+template<bool bFast>
+UE_TARGET_AVX512 UE_NO_FP_CONTRACT static inline __m512d InvSqrtAVX512(__m512d F)
+{
+	if (!bFast)
+		return _mm512_div_pd(_mm512_set1_pd(1.0), _mm512_sqrt_pd(F));
+
+	// Not _mm512_rsqrt14_pd: it is more accurate than rsqrtps, so the results would differ from the other paths
+	const __m512d Half = _mm512_mul_pd(_mm512_set1_pd(0.5), F);
+	const __m512d ThreeHalves = _mm512_set1_pd(1.5);
+	__m512d Y = _mm512_cvtps_pd(_mm256_rsqrt_ps(_mm512_cvtpd_ps(F)));
+	Y = _mm512_mul_pd(Y, _mm512_sub_pd(ThreeHalves, _mm512_mul_pd(_mm512_mul_pd(Half, Y), Y)));
+	Y = _mm512_mul_pd(Y, _mm512_sub_pd(ThreeHalves, _mm512_mul_pd(_mm512_mul_pd(Half, Y), Y)));
+	return Y;
+}
+
+template<bool bFast>
+UE_TARGET_AVX2 UE_NO_FP_CONTRACT static size_t InvSqrtKernelAVX2(const double* In, double* Out, size_t Count)
+{
+	size_t i = 0;
+	for (; i + 4 <= Count; i += 4)
+	{
+		_mm256_storeu_pd(Out + i, InvSqrtAVX2<bFast>(_mm256_loadu_pd(In + i)));
+	}
+	return i;
+}
+
+template<bool bFast>
+UE_TARGET_AVX512 UE_NO_FP_CONTRACT static size_t InvSqrtKernelAVX512(const double* In, double* Out, size_t Count)
+{
+	size_t i = 0;
+	for (; i + 8 <= Count; i += 8)
+	{
+		_mm512_storeu_pd(Out + i, InvSqrtAVX512<bFast>(_mm512_loadu_pd(In + i)));
+	}
+	return i;
+}
+
+template<bool bFast>
+UE_TARGET_AVX2 UE_NO_FP_CONTRACT static size_t NormalizeVectorsAVX2(FVectorSoA In, FVectorSoA Out, size_t Count)
+{
+	size_t i = 0;
+	for (; i + 4 <= Count; i += 4)
+	{
+		const __m256d X = _mm256_loadu_pd(In.X + i);
+		const __m256d Y = _mm256_loadu_pd(In.Y + i);
+		const __m256d Z = _mm256_loadu_pd(In.Z + i);
+		const __m256d Scale = InvSqrtAVX2<bFast>(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(X, X), _mm256_mul_pd(Y, Y)), _mm256_mul_pd(Z, Z)));
+		_mm256_storeu_pd(Out.X + i, _mm256_mul_pd(X, Scale));
+		_mm256_storeu_pd(Out.Y + i, _mm256_mul_pd(Y, Scale));
+		_mm256_storeu_pd(Out.Z + i, _mm256_mul_pd(Z, Scale));
+	}
+	return i;
+}
+
+template<bool bFast>
+UE_TARGET_AVX512 UE_NO_FP_CONTRACT static size_t NormalizeVectorsAVX512(FVectorSoA In, FVectorSoA Out, size_t Count)
+{
+	size_t i = 0;
+	for (; i + 8 <= Count; i += 8)
+	{
+		const __m512d X = _mm512_loadu_pd(In.X + i);
+		const __m512d Y = _mm512_loadu_pd(In.Y + i);
+		const __m512d Z = _mm512_loadu_pd(In.Z + i);
+		const __m512d Scale = InvSqrtAVX512<bFast>(_mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(X, X), _mm512_mul_pd(Y, Y)), _mm512_mul_pd(Z, Z)));
+		_mm512_storeu_pd(Out.X + i, _mm512_mul_pd(X, Scale));
+		_mm512_storeu_pd(Out.Y + i, _mm512_mul_pd(Y, Scale));
+		_mm512_storeu_pd(Out.Z + i, _mm512_mul_pd(Z, Scale));
+	}
+	return i;
+}
+
+/**
+ * Four quaternions per step, one per register. The squares are transposed so each square sum
+ * adds X, Y, Z and W in FQuat::Normalize's order; the scales are then broadcast back per row.
+ * Also used at the AVX-512 level, where eight quaternions per step would need a wider transpose
+ * for no gain over the divider or estimate throughput.
+ */
+template<bool bFast>
+UE_TARGET_AVX2 UE_NO_FP_CONTRACT static size_t NormalizeQuatsAVX2(const FQuat* In, FQuat* Out, size_t Count, double Tolerance)
+{
+	const __m256d Identity = _mm256_set_pd(1.0, 0.0, 0.0, 0.0);
+	const __m256d TolerancePD = _mm256_set1_pd(Tolerance);
+
+	size_t i = 0;
+	for (; i + 4 <= Count; i += 4)
+	{
+		const __m256d R0 = _mm256_loadu_pd(&In[i].X);
+		const __m256d R1 = _mm256_loadu_pd(&In[i + 1].X);
+		const __m256d R2 = _mm256_loadu_pd(&In[i + 2].X);
+		const __m256d R3 = _mm256_loadu_pd(&In[i + 3].X);
+		const __m256d S0 = _mm256_mul_pd(R0, R0);
+		const __m256d S1 = _mm256_mul_pd(R1, R1);
+		const __m256d S2 = _mm256_mul_pd(R2, R2);
+		const __m256d S3 = _mm256_mul_pd(R3, R3);
+		const __m256d XZ01 = _mm256_unpacklo_pd(S0, S1);
+		const __m256d YW01 = _mm256_unpackhi_pd(S0, S1);
+		const __m256d XZ23 = _mm256_unpacklo_pd(S2, S3);
+		const __m256d YW23 = _mm256_unpackhi_pd(S2, S3);
+		const __m256d XX = _mm256_permute2f128_pd(XZ01, XZ23, 0x20);
+		const __m256d YY = _mm256_permute2f128_pd(YW01, YW23, 0x20);
+		const __m256d ZZ = _mm256_permute2f128_pd(XZ01, XZ23, 0x31);
+		const __m256d WW = _mm256_permute2f128_pd(YW01, YW23, 0x31);
+		const __m256d SquareSum = _mm256_add_pd(_mm256_add_pd(_mm256_add_pd(XX, YY), ZZ), WW);
+
+		const __m256d Scale = InvSqrtAVX2<bFast>(SquareSum);
+		const __m256d bValid = _mm256_cmp_pd(SquareSum, TolerancePD, _CMP_GE_OQ);
+		const __m256d Rows[4] = { R0, R1, R2, R3 };
+		const __m256d Scales[4] = { _mm256_permute4x64_pd(Scale, 0x00), _mm256_permute4x64_pd(Scale, 0x55), _mm256_permute4x64_pd(Scale, 0xAA), _mm256_permute4x64_pd(Scale, 0xFF) };
+		const __m256d Valid[4] = { _mm256_permute4x64_pd(bValid, 0x00), _mm256_permute4x64_pd(bValid, 0x55), _mm256_permute4x64_pd(bValid, 0xAA), _mm256_permute4x64_pd(bValid, 0xFF) };
+		for (int Row = 0; Row < 4; ++Row)
+		{
+			_mm256_storeu_pd(&Out[i + Row].X, _mm256_blendv_pd(Identity, _mm256_mul_pd(Rows[Row], Scales[Row]), Valid[Row]));
+		}
+	}
+	return i;
+}
+#endif
+
+void BatchInvSqrt(const double* In, double* Out, size_t Count, EMathPrecision Precision)
+{
+	const bool bFast = Precision == EMathPrecision::Fast;
+	size_t i = 0;
+	switch (GetSimdLevel())
+	{
+#if UE_MATH_X86
+	case ESimdLevel::AVX512:
+		i = bFast ? InvSqrtKernelAVX512<true>(In, Out, Count) : InvSqrtKernelAVX512<false>(In, Out, Count);
+		break;
+	case ESimdLevel::AVX2:
+		i = bFast ? InvSqrtKernelAVX2<true>(In, Out, Count) : InvSqrtKernelAVX2<false>(In, Out, Count);
+		break;
+#endif
+	default:
+		break;
+	}
+
+	for (; i < Count; ++i)
+	{
+		Out[i] = bFast ? InvSqrtFast(In[i]) : InvSqrt(In[i]);
+	}
+}
+
+void BatchNormalizeVectors(FVectorSoA In, FVectorSoA Out, size_t Count, EMathPrecision Precision)
+{
+	const bool bFast = Precision == EMathPrecision::Fast;
+	size_t i = 0;
+	switch (GetSimdLevel())
+	{
+#if UE_MATH_X86
+	case ESimdLevel::AVX512:
+		i = bFast ? NormalizeVectorsAVX512<true>(In, Out, Count) : NormalizeVectorsAVX512<false>(In, Out, Count);
+		break;
+	case ESimdLevel::AVX2:
+		i = bFast ? NormalizeVectorsAVX2<true>(In, Out, Count) : NormalizeVectorsAVX2<false>(In, Out, Count);
+		break;
+#endif
+	default:
+		break;
+	}
+
+	for (; i < Count; ++i)
+	{
+		const FVector V = In.Get(i);
+		Out.Set(i, bFast ? V.GetNormalizedVector<EMathPrecision::Fast>() : V.GetNormalizedVector());
+	}
+}
+
+void BatchNormalizeQuats(const FQuat* In, FQuat* Out, size_t Count, EMathPrecision Precision, double Tolerance)
+{
+	const bool bFast = Precision == EMathPrecision::Fast;
+	size_t i = 0;
+	switch (GetSimdLevel())
+	{
+#if UE_MATH_X86
+	case ESimdLevel::AVX512:
+	case ESimdLevel::AVX2:
+		i = bFast ? NormalizeQuatsAVX2<true>(In, Out, Count, Tolerance) : NormalizeQuatsAVX2<false>(In, Out, Count, Tolerance);
+		break;
+#endif
+	default:
+		break;
+	}
+
+	for (; i < Count; ++i)
+	{
+		Out[i] = bFast ? In[i].GetNormalized<EMathPrecision::Fast>(Tolerance) : In[i].GetNormalized(Tolerance);
+	}
+}
+
+static void BatchGetBoneWithRotationDispatch(const FTransform& ComponentToWorld, FVectorArrayView Translations, bool bTransformLayout, size_t Count, FVectorSoA Out)
+{
+	switch (GetSimdLevel())
+	{
+#if UE_MATH_X86
+	case ESimdLevel::AVX512:
+		BatchGetBoneWithRotationAVX512(ComponentToWorld, Translations, Count, Out);
+		return;
+	case ESimdLevel::AVX2:
+		if (bTransformLayout)
+			BatchGetBoneWithRotationAVX2<true>(ComponentToWorld, Translations, Count, Out);
+		else
+			BatchGetBoneWithRotationAVX2<false>(ComponentToWorld, Translations, Count, Out);
+		return;
+#endif
+	default:
+		BatchGetBoneWithRotationScalar(ComponentToWorld, Translations, 0, Count, Out);
+		return;
+	}
+}
+
+void BatchGetBoneWithRotation(const FTransform& ComponentToWorld, const FTransform* Bones, size_t Count, FVectorSoA Out, FTaskScheduler* Scheduler)
+{
+	BatchGetBoneWithRotation(ComponentToWorld, FTransformArrayView(Bones, Count), Out, Scheduler);
+}
+
+void BatchGetBoneWithRotation(const FTransform& ComponentToWorld, const FTransformArrayView& Bones, FVectorSoA Out, FTaskScheduler* Scheduler)
+{
+	const FVectorArrayView Translations = Bones.GetTranslations();
+	const bool bTransformLayout = Bones.HasTransformLayout();
+	const size_t ChunkSize = GetParallelChunkSize(Bones.Stride + 3 * sizeof(double));
+
+	ParallelFor(Scheduler, Bones.Num, ChunkSize, [&](size_t Begin, size_t End)
+	{
+		const FVectorArrayView Chunk(Translations.Data + Begin * Translations.Stride, End - Begin, Translations.Stride);
+		BatchGetBoneWithRotationDispatch(ComponentToWorld, Chunk, bTransformLayout, End - Begin, FVectorSoA(Out.X + Begin, Out.Y + Begin, Out.Z + Begin));
+	});
+}
+
+/*-----------------------------------------------------------------------------
+	Relative transforms against a shared base. The vector kernels evaluate
+	GetRelativeTransform's quaternion path with the base's half of every
+	product in VectorQuaternionMultiply computed up front; the sums are the
+	same, so are the results.
+-----------------------------------------------------------------------------*/
+
+/** What GetRelativeTransform derives from Other, once per batch. */
+struct FRelativeTransformBase
+{
+	FQuat InverseRotation;
+	FVector Translation;
+	FVector Scale3D;
+	FVector SafeRecipScale3D;
+	FMatrix InverseMatrix;			/* ToInverseMatrixWithScale(), for the negative scale path */
+	bool bNegativeScale;
+	bool bNormalized;
+
+	explicit FRelativeTransformBase(const FTransform& Base)
+		: InverseRotation(Base.Rotation.Inverse())
+		, Translation(Base.Translation)
+		, Scale3D(Base.Scale3D)
+		, SafeRecipScale3D(FTransform::GetSafeScaleReciprocal(Base.Scale3D, SMALL_NUMBER))
+		, InverseMatrix(Base.ToInverseMatrixWithScale())
+		, bNegativeScale(Base.Scale3D.X < 0.0 || Base.Scale3D.Y < 0.0 || Base.Scale3D.Z < 0.0)
+		, bNormalized(Base.Rotation.IsNormalized())
+	{
+	}
+};
+
+/** T.GetRelativeTransform(Base), step for step. */
+static FTransform GetRelativeTransformScalar(const FTransform& T, const FRelativeTransformBase& Base)
+{
+	FTransform Result;
+	if (FTransform::AnyHasNegativeScale(T.Scale3D, Base.Scale3D))
+	{
+		FTransform::ConstructTransformFromMatrixWithDesiredScale(T.ToMatrixWithScale(), Base.InverseMatrix, T.Scale3D * Base.SafeRecipScale3D, Result);
+		return Result;
+	}
+	if (!Base.bNormalized)
+	{
+		return FTransform();
+	}
+	Result.Scale3D = T.Scale3D * Base.SafeRecipScale3D;
+	Result.Rotation = Base.InverseRotation * T.Rotation;
+	Result.Translation = (Base.InverseRotation * (T.Translation - Base.Translation)) * Base.SafeRecipScale3D;
+	return Result;
+}
+
+#if UE_MATH_X86
+/**
+ * Writes the fields of the lanes not in Skip, leaving the pads as they are; the skipped ones
+ * get the scalar result. In[Lane] is still unwritten when its lane is computed, so Out may alias In.
+ */
+UE_TARGET_AVX2 static inline void StoreRelativeLanes(const FTransform* In, const FRelativeTransformBase& Base, FTransform* Out, const FTransformLanesAVX2& L, unsigned Skip)
+{
+	__m256d Rotation[4], Translation[4], Scale[4];
+	TransposeTransformLanesAVX2(L, Rotation, Translation, Scale);
+	for (int Lane = 0; Lane < 4; ++Lane)
+	{
+		if (Skip & (1u << Lane))
+			Out[Lane] = GetRelativeTransformScalar(In[Lane], Base);
+		else
+			StoreTransformRowsAVX2(Out[Lane], Rotation[Lane], Translation[Lane], Scale[Lane]);
+	}
+}
+
+UE_TARGET_AVX2 UE_NO_FP_CONTRACT static size_t GetRelativeTransformsAVX2(const FTransform* In, const FRelativeTransformBase& Base, FTransform* Out, size_t Count)
+{
+	// The base's operands of VectorQuaternionMultiply(Inverse, Rotation)
+	const FQuat& A = Base.InverseRotation;
+	const __m256d AZmY = _mm256_set1_pd(A.Z - A.Y);
+	const __m256d AWpX = _mm256_set1_pd(A.W + A.X);
+	const __m256d AWmX = _mm256_set1_pd(A.W - A.X);
+	const __m256d AYpZ = _mm256_set1_pd(A.Y + A.Z);
+	const __m256d AZmX = _mm256_set1_pd(A.Z - A.X);
+	const __m256d AZpX = _mm256_set1_pd(A.Z + A.X);
+	const __m256d AWpY = _mm256_set1_pd(A.W + A.Y);
+	const __m256d AWmY = _mm256_set1_pd(A.W - A.Y);
+	const __m256d QX = _mm256_set1_pd(A.X);
+	const __m256d QY = _mm256_set1_pd(A.Y);
+	const __m256d QZ = _mm256_set1_pd(A.Z);
+	const __m256d QW = _mm256_set1_pd(A.W);
+	const __m256d BX = _mm256_set1_pd(Base.Translation.X);
+	const __m256d BY = _mm256_set1_pd(Base.Translation.Y);
+	const __m256d BZ = _mm256_set1_pd(Base.Translation.Z);
+	const __m256d RX = _mm256_set1_pd(Base.SafeRecipScale3D.X);
+	const __m256d RY = _mm256_set1_pd(Base.SafeRecipScale3D.Y);
+	const __m256d RZ = _mm256_set1_pd(Base.SafeRecipScale3D.Z);
+	const __m256d Half = _mm256_set1_pd(0.5);
+	const __m256d Two = _mm256_set1_pd(2.0);
+	const __m256d Zero = _mm256_setzero_pd();
+
+	size_t i = 0;
+	for (; i + 4 <= Count; i += 4)
+	{
+		FTransformLanesAVX2 L;
+		LoadTransformLanesAVX2(In + i, L);
+
+		// Lanes with a negative scale take the matrix path
+		const __m256d Negative = _mm256_or_pd(_mm256_or_pd(_mm256_cmp_pd(L.SX, Zero, _CMP_LT_OQ), _mm256_cmp_pd(L.SY, Zero, _CMP_LT_OQ)), _mm256_cmp_pd(L.SZ, Zero, _CMP_LT_OQ));
+
+		// Rotation = Inverse * Rotation
+		const __m256d T0 = _mm256_mul_pd(AZmY, _mm256_sub_pd(L.QY, L.QZ));
+		const __m256d T1 = _mm256_mul_pd(AWpX, _mm256_add_pd(L.QW, L.QX));
+		const __m256d T2 = _mm256_mul_pd(AWmX, _mm256_add_pd(L.QY, L.QZ));
+		const __m256d T3 = _mm256_mul_pd(AYpZ, _mm256_sub_pd(L.QW, L.QX));
+		const __m256d T4 = _mm256_mul_pd(AZmX, _mm256_sub_pd(L.QX, L.QY));
+		const __m256d T5 = _mm256_mul_pd(AZpX, _mm256_add_pd(L.QX, L.QY));
+		const __m256d T6 = _mm256_mul_pd(AWpY, _mm256_sub_pd(L.QW, L.QZ));
+		const __m256d T7 = _mm256_mul_pd(AWmY, _mm256_add_pd(L.QW, L.QZ));
+		const __m256d T8 = _mm256_add_pd(_mm256_add_pd(T5, T6), T7);
+		const __m256d T9 = _mm256_mul_pd(Half, _mm256_add_pd(T4, T8));
+		L.QX = _mm256_sub_pd(_mm256_add_pd(T1, T9), T8);
+		L.QY = _mm256_sub_pd(_mm256_add_pd(T2, T9), T7);
+		L.QZ = _mm256_sub_pd(_mm256_add_pd(T3, T9), T6);
+		L.QW = _mm256_sub_pd(_mm256_add_pd(T0, T9), T5);
+
+		// Translation = Inverse.RotateVector(Translation - Base.Translation) * SafeRecipScale3D
+		const __m256d VX = _mm256_sub_pd(L.TX, BX);
+		const __m256d VY = _mm256_sub_pd(L.TY, BY);
+		const __m256d VZ = _mm256_sub_pd(L.TZ, BZ);
+		const __m256d U0 = _mm256_mul_pd(_mm256_sub_pd(_mm256_mul_pd(QY, VZ), _mm256_mul_pd(QZ, VY)), Two);
+		const __m256d U1 = _mm256_mul_pd(_mm256_sub_pd(_mm256_mul_pd(QZ, VX), _mm256_mul_pd(QX, VZ)), Two);
+		const __m256d U2 = _mm256_mul_pd(_mm256_sub_pd(_mm256_mul_pd(QX, VY), _mm256_mul_pd(QY, VX)), Two);
+		__m256d PX = _mm256_add_pd(VX, _mm256_mul_pd(U0, QW));
+		__m256d PY = _mm256_add_pd(VY, _mm256_mul_pd(U1, QW));
+		__m256d PZ = _mm256_add_pd(VZ, _mm256_mul_pd(U2, QW));
+		PX = _mm256_add_pd(PX, _mm256_sub_pd(_mm256_mul_pd(QY, U2), _mm256_mul_pd(QZ, U1)));
+		PY = _mm256_add_pd(PY, _mm256_sub_pd(_mm256_mul_pd(QZ, U0), _mm256_mul_pd(QX, U2)));
+		PZ = _mm256_add_pd(PZ, _mm256_sub_pd(_mm256_mul_pd(QX, U1), _mm256_mul_pd(QY, U0)));
+		L.TX = _mm256_mul_pd(PX, RX);
+		L.TY = _mm256_mul_pd(PY, RY);
+		L.TZ = _mm256_mul_pd(PZ, RZ);
+
+		L.SX = _mm256_mul_pd(L.SX, RX);
+		L.SY = _mm256_mul_pd(L.SY, RY);
+		L.SZ = _mm256_mul_pd(L.SZ, RZ);
+
+		StoreRelativeLanes(In + i, Base, Out + i, L, (unsigned)_mm256_movemask_pd(Negative));
+	}
+	return i;
+}
+#endif
+
+static void BatchGetRelativeTransformsDispatch(const FTransform* In, const FRelativeTransformBase& Base, FTransform* Out, size_t Count)
+{
+	size_t i = 0;
+	// A base with a negative scale sends every element down the matrix path, an unnormalized rotation every other one to the identity
+	if (!Base.bNegativeScale && Base.bNormalized)
+	{
+		switch (GetSimdLevel())
+		{
+#if UE_MATH_X86
+		// The loads and stores are shuffles of 32 byte rows either way; eight lanes per step measured no faster
+		case ESimdLevel::AVX512:
+		case ESimdLevel::AVX2:
+			i = GetRelativeTransformsAVX2(In, Base, Out, Count);
+			break;
+#endif
+		default:
+			break;
+		}
+	}
+
+	for (; i < Count; ++i)
+	{
+		Out[i] = GetRelativeTransformScalar(In[i], Base);
+	}
+}
+
+void BatchGetRelativeTransforms(const FTransform* In, const FTransform& Base, FTransform* Out, size_t Count, FTaskScheduler* Scheduler)
+{
+	const FRelativeTransformBase RelativeBase(Base);
+	ParallelFor(Scheduler, Count, GetParallelChunkSize(2 * sizeof(FTransform)), [&](size_t Begin, size_t End)
+	{
+		BatchGetRelativeTransformsDispatch(In + Begin, RelativeBase, Out + Begin, End - Begin);
+	});
+}
+
+// Elements per pass of the rotation conversions; one pass keeps its trig inputs and outputs on the stack
+static const size_t ConversionBlockSize = 128;
+
+/** fmod(Degrees, 360), exact like fmod itself. */
+static inline double FmodDegrees360(double Degrees)
+{
+	// NaN, Inf and angles past 2^51 cannot take the integer cast below; fmod gives NaN or the exact remainder
+	if (!(fabs(Degrees) < 2251799813685248.0))
+	{
+		return fmod(Degrees, 360.0);
+	}
+
+	// The whole turns are an integer multiple of 360 and subtract exactly
+	const double Turns = (double)(int64_t)(Degrees * (1.0 / 360.0));
+	double Result = Degrees - Turns * 360.0;
+
+	// A quotient that rounded up to a whole number leaves Result one turn past zero
+	if (Degrees >= 0.0 ? Result < 0.0 : Result > 0.0)
+	{
+		Result += Degrees >= 0.0 ? 360.0 : -360.0;
+	}
+	return Result;
+}
+
+void BatchRotatorsToQuats(const FRotator* In, FQuat* Out, size_t Count, ETrigAccuracy Accuracy)
+{
+	double HalfAngles[3 * ConversionBlockSize];
+	double Sin[3 * ConversionBlockSize];
+	double Cos[3 * ConversionBlockSize];
+
+	for (size_t Begin = 0; Begin < Count; Begin += ConversionBlockSize)
+	{
+		const size_t N = std::min(ConversionBlockSize, Count - Begin);
+		const FRotator* R = In + Begin;
+		for (size_t i = 0; i < N; ++i)
+		{
+			HalfAngles[i] = FmodDegrees360(R[i].Pitch) * 0.5;
+			HalfAngles[N + i] = FmodDegrees360(R[i].Yaw) * 0.5;
+			HalfAngles[2 * N + i] = FmodDegrees360(R[i].Roll) * 0.5;
+		}
+
+		BatchSinCosDegrees(HalfAngles, Sin, Cos, 3 * N, Accuracy);
+
+		FQuat* Q = Out + Begin;
+		for (size_t i = 0; i < N; ++i)
+		{
+			const double SP = Sin[i], SY = Sin[N + i], SR = Sin[2 * N + i];
+			const double CP = Cos[i], CY = Cos[N + i], CR = Cos[2 * N + i];
+			Q[i].X = CR * SP * SY - SR * CP * CY;
+			Q[i].Y = -CR * SP * CY - SR * CP * SY;
+			Q[i].Z = CR * CP * SY - SR * SP * CY;
+			Q[i].W = CR * CP * CY + SR * SP * SY;
+		}
+	}
+}
+
+void BatchQuatsToRotators(const FQuat* In, FRotator* Out, size_t Count, ETrigAccuracy Accuracy)
+{
+	const double SingularityThreshold = 0.4999995;
+	const double RadToDeg = 180.0 / PI;
+
+	// Three atan2 per quaternion: yaw, roll (or the gimbal lock angle) and pitch, the asin
+	// of the singularity test written as an atan2
+	double Y[3 * ConversionBlockSize];
+	double X[3 * ConversionBlockSize];
+	double Angles[3 * ConversionBlockSize];
+
+	for (size_t Begin = 0; Begin < Count; Begin += ConversionBlockSize)
+	{
+		const size_t N = std::min(ConversionBlockSize, Count - Begin);
+		const FQuat* Q = In + Begin;
+		for (size_t i = 0; i < N; ++i)
+		{
+			const FQuat& q = Q[i];
+			const double SingularityTest = q.Z * q.X - q.W * q.Y;
+			const bool bSingular = fabs(SingularityTest) > SingularityThreshold;
+			Y[i] = 2.0 * (q.W * q.Z + q.X * q.Y);
+			X[i] = 1.0 - 2.0 * (q.Y * q.Y + q.Z * q.Z);
+			Y[N + i] = bSingular ? q.X : -2.0 * (q.W * q.X + q.Y * q.Z);
+			X[N + i] = bSingular ? q.W : 1.0 - 2.0 * (q.X * q.X + q.Y * q.Y);
+			Y[2 * N + i] = 2.0 * SingularityTest;
+			X[2 * N + i] = sqrt(std::max(0.0, (1.0 - 2.0 * SingularityTest) * (1.0 + 2.0 * SingularityTest)));
+		}
+
+		BatchAtan2(Y, X, Angles, 3 * N, Accuracy);
+
+		FRotator* R = Out + Begin;
+		for (size_t i = 0; i < N; ++i)
+		{
+			const FQuat& q = Q[i];
+			const double SingularityTest = q.Z * q.X - q.W * q.Y;
+			const double Yaw = Angles[i] * RadToDeg;
+			R[i].Yaw = Yaw;
+			if (SingularityTest < -SingularityThreshold)
+			{
+				R[i].Pitch = -90.0;
+				R[i].Roll = FRotator::NormalizeAxis(-Yaw - (2.0 * Angles[N + i] * RadToDeg));
+			}
+			else if (SingularityTest > SingularityThreshold)
+			{
+				R[i].Pitch = 90.0;
+				R[i].Roll = FRotator::NormalizeAxis(Yaw - (2.0 * Angles[N + i] * RadToDeg));
+			}
+			else
+			{
+				R[i].Pitch = Angles[2 * N + i] * RadToDeg;
+				R[i].Roll = Angles[N + i] * RadToDeg;
+			}
+		}
+	}
+}
+
+void BatchRotatorsToMatrices(const FRotator* In, FMatrix* Out, size_t Count, ETrigAccuracy Accuracy)
+{
+	double Angles[3 * ConversionBlockSize];
+	double Sin[3 * ConversionBlockSize];
+	double Cos[3 * ConversionBlockSize];
+
+	for (size_t Begin = 0; Begin < Count; Begin += ConversionBlockSize)
+	{
+		const size_t N = std::min(ConversionBlockSize, Count - Begin);
+		const FRotator* R = In + Begin;
+		for (size_t i = 0; i < N; ++i)
+		{
+			Angles[i] = R[i].Pitch;
+			Angles[N + i] = R[i].Yaw;
+			Angles[2 * N + i] = R[i].Roll;
+		}
+
+		BatchSinCosDegrees(Angles, Sin, Cos, 3 * N, Accuracy);
+
+		FMatrix* M = Out + Begin;
+		for (size_t i = 0; i < N; ++i)
+		{
+			const double SP = Sin[i], SY = Sin[N + i], SR = Sin[2 * N + i];
+			const double CP = Cos[i], CY = Cos[N + i], CR = Cos[2 * N + i];
+			FMatrix& Result = M[i];
+			Result.M[0][0] = CP * CY;
+			Result.M[0][1] = CP * SY;
+			Result.M[0][2] = SP;
+			Result.M[0][3] = 0.0;
+
+			Result.M[1][0] = SR * SP * CY - CR * SY;
+			Result.M[1][1] = SR * SP * SY + CR * CY;
+			Result.M[1][2] = -SR * CP;
+			Result.M[1][3] = 0.0;
+
+			Result.M[2][0] = -(CR * SP * CY + SR * SY);
+			Result.M[2][1] = CY * SR - CR * SP * SY;
+			Result.M[2][2] = CR * CP;
+			Result.M[2][3] = 0.0;
+
+			Result.M[3][0] = 0.0;
+			Result.M[3][1] = 0.0;
+			Result.M[3][2] = 0.0;
+			Result.M[3][3] = 1.0;
+		}
+	}
+}
+
+void BatchVectorsToDirectionRotators(const FVector* In, FRotator* Out, size_t Count, ETrigAccuracy Accuracy)
+{
+	const double RadToDeg = 180.0 / PI;
+
+	double Y[2 * ConversionBlockSize];
+	double X[2 * ConversionBlockSize];
+	double Angles[2 * ConversionBlockSize];
+
+	for (size_t Begin = 0; Begin < Count; Begin += ConversionBlockSize)
+	{
+		const size_t N = std::min(ConversionBlockSize, Count - Begin);
+		const FVector* V = In + Begin;
+		for (size_t i = 0; i < N; ++i)
+		{
+			Y[i] = V[i].Z;
+			X[i] = sqrt(V[i].X * V[i].X + V[i].Y * V[i].Y);
+			Y[N + i] = V[i].Y;
+			X[N + i] = V[i].X;
+		}
+
+		BatchAtan2(Y, X, Angles, 2 * N, Accuracy);
+
+		FRotator* R = Out + Begin;
+		for (size_t i = 0; i < N; ++i)
+		{
+			R[i].Pitch = Angles[i] * RadToDeg;
+			R[i].Yaw = Angles[N + i] * RadToDeg;
+			R[i].Roll = 0.0;
+		}
+	}
+}
@@ -0,0 +1,143 @@
+#pragma once
+#include "ue4math.h"
+#include "mathfwd.h"
+#include "vector.h"
+#include "quat.h"
+#include "rotator.h"
+#include "matrix.h"
+#include "transform.h"
+#include "trig.h"
+#include "arrayview.h"
+
+/**
+ * Structure-of-arrays view over Count vectors, one array per component.
+ * Not owning; the batch APIs write X[i], Y[i], Z[i] for each element i.
+ */
+struct FVectorSoA
+{
+	double* X;
+	double* Y;
+	double* Z;
+
+	FVectorSoA() : X(nullptr), Y(nullptr), Z(nullptr) {}
+	FVectorSoA(double* X, double* Y, double* Z) : X(X), Y(Y), Z(Z) {}
+
+	FVector Get(size_t Index) const { return FVector(X[Index], Y[Index], Z[Index]); }
+	void Set(size_t Index, const FVector& V) { X[Index] = V.X; Y[Index] = V.Y; Z[Index] = V.Z; }
+};
+
+/** Structure-of-arrays view over Count quaternions, as FVectorSoA. */
+struct FQuatSoA
+{
+	double* X;
+	double* Y;
+	double* Z;
+	double* W;
+
+	FQuatSoA() : X(nullptr), Y(nullptr), Z(nullptr), W(nullptr) {}
+	FQuatSoA(double* X, double* Y, double* Z, double* W) : X(X), Y(Y), Z(Z), W(W) {}
+
+	FQuat Get(size_t Index) const { return FQuat(X[Index], Y[Index], Z[Index], W[Index]); }
+	void Set(size_t Index, const FQuat& Q) { X[Index] = Q.X; Y[Index] = Q.Y; Z[Index] = Q.Z; W[Index] = Q.W; }
+};
+
+/** Structure-of-arrays view over Count transforms: ten arrays, as FVectorSoA. */
+struct FTransformSoA
+{
+	FQuatSoA Rotation;
+	FVectorSoA Translation;
+	FVectorSoA Scale3D;
+
+	FTransformSoA() {}
+	FTransformSoA(FQuatSoA Rotation, FVectorSoA Translation, FVectorSoA Scale3D) : Rotation(Rotation), Translation(Translation), Scale3D(Scale3D) {}
+
+	FTransform Get(size_t Index) const { return FTransform(Rotation.Get(Index), Translation.Get(Index), Scale3D.Get(Index)); }
+	void Set(size_t Index, const FTransform& T) { Rotation.Set(Index, T.Rotation); Translation.Set(Index, T.Translation); Scale3D.Set(Index, T.Scale3D); }
+};
+
+/**
+ * Batch form of ComponentToWorld.GetBoneWithRotation(Bones[i]) for every i in [0, Count).
+ *
+ * Dispatches on GetSimdLevel() to an AVX-512 (8 bones per step), AVX2 (4 bones per step)
+ * or scalar kernel. The vector kernels evaluate the same operations in the same order as
+ * FQuat::RotateVector without fused multiply-adds, so as long as the scalar code is not built
+ * with FMA contraction they agree with it bit for bit.
+ *
+ * With a Scheduler, batches of more than a few cache-sized chunks are split over its threads;
+ * the results are the same.
+ */
+void BatchGetBoneWithRotation(const FTransform& ComponentToWorld, const FTransform* Bones, size_t Count, FVectorSoA Out, FTaskScheduler* Scheduler = nullptr);
+
+/**
+ * BatchGetBoneWithRotation over bones read in place, e.g. a raw engine bone array, with no
+ * staging copy. Only the translations are read; the kernels gather them at the view's stride
+ * (the AVX2 one loads rows instead when the view has FTransform's layout). Same results as above.
+ */
+void BatchGetBoneWithRotation(const FTransform& ComponentToWorld, const FTransformArrayView& Bones, FVectorSoA Out, FTaskScheduler* Scheduler = nullptr);
+
+/**
+ * Out[i] = In[i].GetRelativeTransform(Base) for every i in [0, Count), e.g. a frame's transforms
+ * relative to the camera or root. Base's inverse rotation, reciprocal scale and inverse matrix
+ * are derived once for the batch instead of per element.
+ *
+ * The vector kernel (AVX2, 4 per step, also used at the AVX-512 level) takes the quaternion
+ * path of GetRelativeTransform; lanes with a negative scale take its matrix path one by one, so a
+ * mirrored element does not slow down the rest of its step. Bit for bit like the scalar code,
+ * with the same caveat as BatchGetBoneWithRotation. Out may alias In; pads are left as they are.
+ */
+void BatchGetRelativeTransforms(const FTransform* In, const FTransform& Base, FTransform* Out, size_t Count, FTaskScheduler* Scheduler = nullptr);
+
+/** Narrows Count doubles to float, rounding to nearest. Vectorized per GetSimdLevel(). */
+void BatchConvert(const double* In, float* Out, size_t Count);
+
+/** Widens Count floats to double (exact). Vectorized per GetSimdLevel(). */
+void BatchConvert(const float* In, double* Out, size_t Count);
+
+/**
+ * Converts an array of math types between precisions, e.g. FTransform -> FTransform3f or
+ * FVector3f -> FVector. Each of the types is a flat run of reals in either precision
+ * (TTransform's pad is sizeof(T) wide), so the array converts as one stream of scalars;
+ * TTransform's pad is carried along as whatever bits it holds.
+ */
+template<template<typename> class TType, typename From, typename To>
+void BatchConvert(const TType<From>* In, TType<To>* Out, size_t Count)
+{
+	constexpr size_t RealsPerElement = sizeof(TType<From>) / sizeof(From);
+	static_assert(RealsPerElement * sizeof(From) == sizeof(TType<From>) && RealsPerElement * sizeof(To) == sizeof(TType<To>), "BatchConvert needs a layout of reals only");
+	BatchConvert((const From*)In, (To*)Out, Count * RealsPerElement);
+}
+
+/**
+ * Out[i] = InvSqrt(In[i]), or InvSqrtFast(In[i]) with EMathPrecision::Fast (same domain and
+ * error). Both match the scalar functions bit for bit, given the same CPU: the Fast path
+ * starts from the same rsqrt estimate at every SIMD level. Out may alias In.
+ */
+void BatchInvSqrt(const double* In, double* Out, size_t Count, EMathPrecision Precision = EMathPrecision::Precise);
+
+/** Out[i] = In[i].GetNormalizedVector<Precision>(), bit for bit like BatchInvSqrt. Out may alias In. */
+void BatchNormalizeVectors(FVectorSoA In, FVectorSoA Out, size_t Count, EMathPrecision Precision = EMathPrecision::Precise);
+
+/** Out[i] = In[i].GetNormalized<Precision>(Tolerance), bit for bit like BatchInvSqrt. Out may alias In. */
+void BatchNormalizeQuats(const FQuat* In, FQuat* Out, size_t Count, EMathPrecision Precision = EMathPrecision::Precise, double Tolerance = SMALL_NUMBER);
+
+/*-----------------------------------------------------------------------------
+	Rotation conversions. Each runs its trigonometry through the batch kernels
+	in trig.h a block of elements at a time instead of calling libm per value,
+	so results differ from the single element functions by the ULP bounds
+	documented there (or by up to 1e-8 with ETrigAccuracy::Fast).
+-----------------------------------------------------------------------------*/
+
+/**
+ * Out[i] = In[i].GetQuaternion(). The fmod(Angle, 360) that GetQuaternion applies per axis is
+ * reproduced exactly, so the quaternions come out with the same sign.
+ */
+void BatchRotatorsToQuats(const FRotator* In, FQuat* Out, size_t Count, ETrigAccuracy Accuracy = ETrigAccuracy::Precise);
+
+/** Out[i] = FRotator(In[i]), including the gimbal lock handling near +-90 degrees pitch. */
+void BatchQuatsToRotators(const FQuat* In, FRotator* Out, size_t Count, ETrigAccuracy Accuracy = ETrigAccuracy::Precise);
+
+/** Out[i] = In[i].GetMatrix(), i.e. with a zero origin. */
+void BatchRotatorsToMatrices(const FRotator* In, FMatrix* Out, size_t Count, ETrigAccuracy Accuracy = ETrigAccuracy::Precise);
+
+/** Out[i] = In[i].GetDirectionRotator(). */
+void BatchVectorsToDirectionRotators(const FVector* In, FRotator* Out, size_t Count, ETrigAccuracy Accuracy = ETrigAccuracy::Precise);
@@ -0,0 +1,1264 @@
+#include "ue4math.h"
+#include "cpu.h"
+#include "vector.h"
+#include "quat.h"
+#include "rotator.h"
+#include "matrix.h"
+#include "transform.h"
+#include "batch.h"
+#include "trig.h"
+#include "camera.h"
+#include "skeleton.h"
+#include "interpolation.h"
+#include "bounds.h"
+#include "frustum.h"
+#include "bvh.h"
+#include "ray.h"
+#include "parallel.h"
+#include "stats.h"
+#include "packedtransform.h"
+#include "history.h"
+#include "dualquat.h"
+#include "skinning.h"
+#include "cachedtransform.h"
+#include "vectorexpr.h"
+#include "rebased.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*-----------------------------------------------------------------------------
+	Self-contained benchmark harness.
+
+	Every operation is measured in one or both of two modes:
+	  latency     a dependent chain, each result feeding the next call, so
+	              the time per op is the critical path of one call;
+	  throughput  independent calls over arrays of 1, 64, 4096 and 1M
+	              elements, so the time per element includes the memory
+	              traffic of the working set at that size. Cases that
+	              measure how a query scales with the data set size run
+	              at their own sizes instead (AddScaling), and the
+	              parallel cases run the batch APIs over 1, 2, 4 ... threads
+	              at sizes around the sequential cutoff and above.
+	Each case runs for at least --min-time seconds per sample; the reported
+	figure is the median of the samples. --json writes every result in a
+	stable schema for comparing library versions.
+-----------------------------------------------------------------------------*/
+
+#ifndef UE_MATH_VERSION_STRING
+#define UE_MATH_VERSION_STRING "unknown"
+#endif
+
+/** Keeps the compiler from discarding stores to the memory behind Pointer. */
+static inline void Escape(const void* Pointer)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "g"(Pointer) : "memory");
+#else
+	static const void* volatile Sink;
+	Sink = Pointer;
+#endif
+}
+
+struct FBenchRandom
+{
+	uint64_t State = 0x2545F4914F6CDD1Dull;
+
+	double Range(double Min, double Max)
+	{
+		State ^= State >> 12;
+		State ^= State << 25;
+		State ^= State >> 27;
+		return Min + (Max - Min) * (double)((State * 0x2545F4914F6CDD1Dull) >> 11) * (1.0 / 9007199254740992.0);
+	}
+
+	FVector Vector(double Extent) { return FVector(Range(-Extent, Extent), Range(-Extent, Extent), Range(-Extent, Extent)); }
+	FRotator Rotator() { return FRotator(Range(-89, 89), Range(-180, 180), Range(-180, 180)); }
+	FQuat Quat() { return Rotator().GetQuaternion(); }
+	FTransform Transform() { return FTransform(Quat(), Vector(1000), FVector(Range(0.5, 2), Range(0.5, 2), Range(0.5, 2))); }
+	FMatrix Matrix() { return Transform().ToMatrixWithScale(); }
+};
+
+enum class EBenchMode : uint8_t
+{
+	Latency,
+	Throughput,
+};
+
+/** A prepared case: Run() performs OpsPerRun operations. */
+struct FBenchRunner
+{
+	std::function<void()> Run;
+	size_t OpsPerRun;
+};
+
+struct FBenchmark
+{
+	std::string Name;
+	EBenchMode Mode;
+	std::function<FBenchRunner(size_t)> Prepare;	/* Argument is the element count (throughput) */
+	std::vector<size_t> Sizes;						/* Replaces the default sizes when not empty */
+};
+
+struct FBenchResult
+{
+	std::string Name;
+	EBenchMode Mode;
+	size_t Size;
+	uint64_t Iterations;
+	double NsPerOp;
+	double NsPerOpMin;
+};
+
+static std::vector<FBenchmark>& GetBenchmarks()
+{
+	static std::vector<FBenchmark> Benchmarks;
+	return Benchmarks;
+}
+
+/*----------------------------------------------------------------------------
+	Case builders.
+----------------------------------------------------------------------------*/
+
+/** Dependent chain of Op starting from Initial; one call per op. */
+template<typename StateType, typename OpType>
+static void AddLatency(const char* Name, StateType Initial, OpType Op)
+{
+	GetBenchmarks().push_back({ Name, EBenchMode::Latency, [=](size_t)
+	{
+		constexpr size_t ChainLength = 256;
+		auto State = std::make_shared<StateType>(Initial);
+		return FBenchRunner{ [=]()
+		{
+			StateType Value = *State;
+			for (size_t i = 0; i < ChainLength; ++i)
+				Value = Op(Value);
+			*State = Value;
+			Escape(State.get());
+		}, ChainLength };
+	} });
+}
+
+/** Out[i] = Op(In[i]) over Count independent elements made by Generate. */
+template<typename InType, typename OutType, typename GenerateType, typename OpType>
+static void AddThroughput(const char* Name, GenerateType Generate, OpType Op)
+{
+	GetBenchmarks().push_back({ Name, EBenchMode::Throughput, [=](size_t Count)
+	{
+		FBenchRandom Random;
+		auto In = std::make_shared<std::vector<InType>>(Count);
+		auto Out = std::make_shared<std::vector<OutType>>(Count);
+		for (InType& Element : *In)
+			Element = Generate(Random);
+		return FBenchRunner{ [=]()
+		{
+			const InType* InData = In->data();
+			OutType* OutData = Out->data();
+			for (size_t i = 0; i < Count; ++i)
+				OutData[i] = Op(InData[i]);
+			Escape(OutData);
+		}, Count };
+	} });
+}
+
+/** A batch API call over Count elements: Batch(In, Out, Count). */
+template<typename InType, typename OutType, typename GenerateType, typename BatchType>
+static void AddBatch(const char* Name, GenerateType Generate, BatchType Batch)
+{
+	GetBenchmarks().push_back({ Name, EBenchMode::Throughput, [=](size_t Count)
+	{
+		FBenchRandom Random;
+		auto In = std::make_shared<std::vector<InType>>(Count);
+		auto Out = std::make_shared<std::vector<OutType>>(Count);
+		for (InType& Element : *In)
+			Element = Generate(Random);
+		return FBenchRunner{ [=]()
+		{
+			Batch(In->data(), Out->data(), Count);
+			Escape(Out->data());
+		}, Count };
+	} });
+}
+
+/** Free-form throughput case; Prepare builds the data and returns the runner. */
+static void AddCustom(const char* Name, std::function<FBenchRunner(size_t)> Prepare)
+{
+	GetBenchmarks().push_back({ Name, EBenchMode::Throughput, std::move(Prepare) });
+}
+
+/** Custom case run at 100 to 100K elements, for queries whose cost per op grows with the data set. */
+static void AddScaling(const char* Name, std::function<FBenchRunner(size_t)> Prepare)
+{
+	GetBenchmarks().push_back({ Name, EBenchMode::Throughput, std::move(Prepare), { 100, 1000, 10000, 100000 } });
+}
+
+/**
+ * One case per thread count, powers of two up to the hardware's, named Name/Threads<N>; Prepare
+ * gets the scheduler to pass (a one thread scheduler runs everything on the caller, the baseline).
+ */
+static void AddParallelScaling(const char* Name, std::function<FBenchRunner(size_t, FTaskScheduler*)> Prepare)
+{
+	const int MaxThreads = std::max(1, (int)std::thread::hardware_concurrency());
+	for (int NumThreads = 1; ; NumThreads = std::min(NumThreads * 2, MaxThreads))
+	{
+		auto Scheduler = std::make_shared<FTaskScheduler>(NumThreads);
+		const std::string CaseName = std::string(Name) + "/Threads" + std::to_string(NumThreads);
+		GetBenchmarks().push_back({ CaseName, EBenchMode::Throughput, [=](size_t Count) { return Prepare(Count, Scheduler.get()); }, { 4096, 65536, (size_t)1 << 20 } });
+		if (NumThreads == MaxThreads)
+			break;
+	}
+}
+
+/*----------------------------------------------------------------------------
+	Vector chains, eager and through vectorexpr.h, with and without FP contraction.
+	Every variant targets AVX2 + FMA so that contraction is the only difference.
+----------------------------------------------------------------------------*/
+
+#if defined(__GNUC__) && !defined(__clang__)
+#define UE_BENCH_FP_CONTRACT	__attribute__((optimize("fp-contract=fast")))
+#else
+#define UE_BENCH_FP_CONTRACT
+#endif
+
+/** FQuat::RotateVector's chain plus a translation, as in FTransform::Multiply. */
+template<bool bLazy>
+static inline FVector RotateAndTranslate(const FQuat& Q, const FVector& Translation, const FVector& V)
+{
+	const FVector QV(Q.X, Q.Y, Q.Z);
+	if (bLazy)
+	{
+		const FVector T = (LazyVector(QV) ^ V) * 2.0;
+		return LazyVector(V) + LazyVector(T) * Q.W + (LazyVector(QV) ^ T) + Translation;
+	}
+	const FVector T = (QV ^ V) * 2.0;
+	return V + (T * Q.W) + (QV ^ T) + Translation;
+}
+
+template<bool bLazy>
+UE_TARGET_AVX2_FMA UE_NO_FP_CONTRACT static void RotateAndTranslateNoContract(const FQuat& Q, const FVector& Translation, const FVector* In, FVector* Out, size_t Count)
+{
+	for (size_t i = 0; i < Count; ++i)
+		Out[i] = RotateAndTranslate<bLazy>(Q, Translation, In[i]);
+}
+
+template<bool bLazy>
+UE_TARGET_AVX2_FMA UE_BENCH_FP_CONTRACT static void RotateAndTranslateContract(const FQuat& Q, const FVector& Translation, const FVector* In, FVector* Out, size_t Count)
+{
+	for (size_t i = 0; i < Count; ++i)
+		Out[i] = RotateAndTranslate<bLazy>(Q, Translation, In[i]);
+}
+
+/*----------------------------------------------------------------------------
+	The cases.
+----------------------------------------------------------------------------*/
+
+static void RegisterBenchmarks()
+{
+	const auto MakeVector = [](FBenchRandom& R) { return R.Vector(100); };
+	const auto MakeQuat = [](FBenchRandom& R) { return R.Quat(); };
+	const auto MakeRotator = [](FBenchRandom& R) { return R.Rotator(); };
+	const auto MakeMatrix = [](FBenchRandom& R) { return R.Matrix(); };
+	const auto MakeTransform = [](FBenchRandom& R) { return R.Transform(); };
+
+	FBenchRandom Random;
+	const FVector SharedVector = Random.Vector(1).GetNormalizedVector();
+	const FQuat SharedQuat = Random.Quat();
+	const FMatrix SharedMatrix = Random.Matrix();
+	const FTransform SharedTransform = Random.Transform();
+
+	// FVector
+	AddLatency("FVector/DotProduct", FVector(0.5, 0.25, 0.125), [=](const FVector& V) { return FVector(V.DotProduct(SharedVector), V.Y, V.Z); });
+	AddLatency("FVector/CrossProduct", FVector(0.5, 0.25, 0.125), [=](const FVector& V) { return V ^ SharedVector; });
+	AddLatency("FVector/GetNormalizedVector", FVector(0.5, 0.25, 0.125), [](const FVector& V) { return V.GetNormalizedVector(); });
+	AddLatency("FVector/GetNormalizedVector/Fast", FVector(0.5, 0.25, 0.125), [](const FVector& V) { return V.GetNormalizedVector<EMathPrecision::Fast>(); });
+	AddThroughput<FVector, double>("FVector/DotProduct", MakeVector, [=](const FVector& V) { return V | SharedVector; });
+	AddThroughput<FVector, FVector>("FVector/CrossProduct", MakeVector, [=](const FVector& V) { return V ^ SharedVector; });
+	AddThroughput<FVector, FVector>("FVector/GetNormalizedVector", MakeVector, [](const FVector& V) { return V.GetNormalizedVector(); });
+	AddThroughput<FVector, FVector>("FVector/GetNormalizedVector/Fast", MakeVector, [](const FVector& V) { return V.GetNormalizedVector<EMathPrecision::Fast>(); });
+	AddThroughput<FVector, double>("FVector/Length", MakeVector, [](const FVector& V) { return V.Length(); });
+	AddThroughput<FVector, FRotator>("FVector/GetDirectionRotator", MakeVector, [](const FVector& V) { return V.GetDirectionRotator(); });
+	AddBatch<FVector, FRotator>("FVector/BatchVectorsToDirectionRotators", MakeVector, [](const FVector* In, FRotator* Out, size_t Count) { BatchVectorsToDirectionRotators(In, Out, Count); });
+	for (EMathPrecision Precision : { EMathPrecision::Precise, EMathPrecision::Fast })
+	{
+		AddCustom(Precision == EMathPrecision::Fast ? "FVector/BatchNormalizeVectors/Fast" : "FVector/BatchNormalizeVectors", [=](size_t Count)
+		{
+			FBenchRandom R;
+			auto In = std::make_shared<std::vector<double>>(Count * 3);
+			auto Out = std::make_shared<std::vector<double>>(Count * 3);
+			for (double& Value : *In)
+				Value = R.Range(-100, 100);
+			return FBenchRunner{ [=]()
+			{
+				double* I = In->data();
+				double* O = Out->data();
+				BatchNormalizeVectors(FVectorSoA(I, I + Count, I + 2 * Count), FVectorSoA(O, O + Count, O + 2 * Count), Count, Precision);
+				Escape(O);
+			}, Count };
+		});
+	}
+
+	// The same vector chain eager and as an expression, with FP contraction off and on
+	if (GetSupportedSimdLevel() >= ESimdLevel::AVX2)
+	{
+		AddBatch<FVector, FVector>("FVector/RotateAndTranslate/Eager", MakeVector, [=](const FVector* In, FVector* Out, size_t Count) { RotateAndTranslateNoContract<false>(SharedQuat, SharedVector, In, Out, Count); });
+		AddBatch<FVector, FVector>("FVector/RotateAndTranslate/Lazy", MakeVector, [=](const FVector* In, FVector* Out, size_t Count) { RotateAndTranslateNoContract<true>(SharedQuat, SharedVector, In, Out, Count); });
+		AddBatch<FVector, FVector>("FVector/RotateAndTranslate/Eager/FpContract", MakeVector, [=](const FVector* In, FVector* Out, size_t Count) { RotateAndTranslateContract<false>(SharedQuat, SharedVector, In, Out, Count); });
+		AddBatch<FVector, FVector>("FVector/RotateAndTranslate/Lazy/FpContract", MakeVector, [=](const FVector* In, FVector* Out, size_t Count) { RotateAndTranslateContract<true>(SharedQuat, SharedVector, In, Out, Count); });
+	}
+
+	// FQuat
+	AddLatency("FQuat/Multiply", SharedQuat, [=](const FQuat& Q) { return Q * SharedQuat; });
+	AddLatency("FQuat/RotateVector", SharedVector, [=](const FVector& V) { return SharedQuat.RotateVector(V); });
+	AddLatency("FQuat/Normalize", FQuat(0.1, 0.2, 0.3, 0.9), [](FQuat Q) { Q.Normalize(); Q.W += 1e-3; return Q; });
+	AddLatency("FQuat/Normalize/Fast", FQuat(0.1, 0.2, 0.3, 0.9), [](FQuat Q) { Q.Normalize<EMathPrecision::Fast>(); Q.W += 1e-3; return Q; });
+	AddThroughput<FQuat, FQuat>("FQuat/Multiply", MakeQuat, [=](const FQuat& Q) { return Q * SharedQuat; });
+	AddThroughput<FVector, FVector>("FQuat/RotateVector", MakeVector, [=](const FVector& V) { return SharedQuat.RotateVector(V); });
+	AddThroughput<FVector, FVector>("FQuat/RotateVectorInverse", MakeVector, [=](const FVector& V) { return SharedQuat.RotateVectorInverse(V); });
+	AddThroughput<FQuat, FQuat>("FQuat/Normalize", MakeQuat, [](FQuat Q) { Q.Normalize(); return Q; });
+	AddThroughput<FQuat, FQuat>("FQuat/Normalize/Fast", MakeQuat, [](FQuat Q) { Q.Normalize<EMathPrecision::Fast>(); return Q; });
+	AddBatch<FQuat, FQuat>("FQuat/BatchNormalizeQuats", MakeQuat, [](const FQuat* In, FQuat* Out, size_t Count) { BatchNormalizeQuats(In, Out, Count); });
+	AddBatch<FQuat, FQuat>("FQuat/BatchNormalizeQuats/Fast", MakeQuat, [](const FQuat* In, FQuat* Out, size_t Count) { BatchNormalizeQuats(In, Out, Count, EMathPrecision::Fast); });
+	AddThroughput<FMatrix, FQuat>("FQuat/FromMatrix", MakeMatrix, [](const FMatrix& M) { return FQuat(M); });
+	AddThroughput<FQuat, FRotator>("FQuat/ToRotator", MakeQuat, [](const FQuat& Q) { return FRotator(Q); });
+	AddBatch<FQuat, FRotator>("FQuat/BatchQuatsToRotators", MakeQuat, [](const FQuat* In, FRotator* Out, size_t Count) { BatchQuatsToRotators(In, Out, Count); });
+
+	// FRotator
+	AddLatency("FRotator/GetQuaternion", FRotator(10, 20, 30), [](const FRotator& R) { const FQuat Q = R.GetQuaternion(); return FRotator(R.Pitch, R.Yaw + Q.W, R.Roll); });
+	AddThroughput<FRotator, FQuat>("FRotator/GetQuaternion", MakeRotator, [](const FRotator& R) { return R.GetQuaternion(); });
+	AddThroughput<FRotator, FMatrix>("FRotator/GetMatrix", MakeRotator, [](const FRotator& R) { return R.GetMatrix(); });
+	AddThroughput<FRotator, FVector>("FRotator/GetUnitVector", MakeRotator, [](const FRotator& R) { return R.GetUnitVector(); });
+	AddThroughput<FRotator, FRotator>("FRotator/Clamp", [](FBenchRandom& R) { return FRotator(R.Range(-300, 300), R.Range(-300, 300), R.Range(-300, 300)); }, [](FRotator R) { R.Clamp(); return R; });
+	AddBatch<FRotator, FQuat>("FRotator/BatchRotatorsToQuats", MakeRotator, [](const FRotator* In, FQuat* Out, size_t Count) { BatchRotatorsToQuats(In, Out, Count); });
+	AddBatch<FRotator, FQuat>("FRotator/BatchRotatorsToQuats/Fast", MakeRotator, [](const FRotator* In, FQuat* Out, size_t Count) { BatchRotatorsToQuats(In, Out, Count, ETrigAccuracy::Fast); });
+	AddBatch<FRotator, FMatrix>("FRotator/BatchRotatorsToMatrices", MakeRotator, [](const FRotator* In, FMatrix* Out, size_t Count) { BatchRotatorsToMatrices(In, Out, Count); });
+
+	// FMatrix
+	AddLatency("FMatrix/Multiply", SharedMatrix, [=](const FMatrix& M) { return M * SharedMatrix; });
+	AddLatency("FMatrix/Inverse", SharedMatrix, [](const FMatrix& M) { return M.Inverse(); });
+	AddThroughput<FMatrix, FMatrix>("FMatrix/Multiply", MakeMatrix, [=](const FMatrix& M) { return M * SharedMatrix; });
+	AddBatch<FMatrix, FMatrix>("FMatrix/MultiplyBatch", MakeMatrix, [=](const FMatrix* In, FMatrix* Out, size_t Count) { FMatrix::MultiplyBatch(Out, In, SharedMatrix, Count); });
+	AddThroughput<FMatrix, double>("FMatrix/Determinant", MakeMatrix, [](const FMatrix& M) { return M.Determinant(); });
+	AddThroughput<FMatrix, FMatrix>("FMatrix/Inverse", MakeMatrix, [](const FMatrix& M) { return M.Inverse(); });
+	AddThroughput<FMatrix, FMatrix>("FMatrix/InverseAffine", MakeMatrix, [](const FMatrix& M) { return M.InverseAffine(); });
+	AddThroughput<FMatrix, FMatrix>("FMatrix/InverseAuto", MakeMatrix, [](const FMatrix& M) { return M.InverseAuto(); });
+	AddThroughput<FMatrix, FRotator>("FMatrix/GetRotator", MakeMatrix, [](const FMatrix& M) { return M.GetRotator(); });
+	AddThroughput<FMatrix, FMatrix>("FMatrix/RemoveScaling", MakeMatrix, [](FMatrix M) { M.RemoveScaling(); return M; });
+
+	// FTransform
+	AddLatency("FTransform/Multiply", SharedTransform, [=](const FTransform& T) { FTransform Out; FTransform::Multiply(&Out, &T, &SharedTransform); return Out; });
+	AddLatency("FTransform/GetBoneWithRotation", SharedTransform, [=](FTransform T) { T.Translation = SharedTransform.GetBoneWithRotation(T); return T; });
+	AddThroughput<FTransform, FTransform>("FTransform/Multiply", MakeTransform, [=](const FTransform& T) { FTransform Out; FTransform::Multiply(&Out, &T, &SharedTransform); return Out; });
+	AddThroughput<FTransform, FTransform>("FTransform/GetRelativeTransform", MakeTransform, [=](const FTransform& T) { return T.GetRelativeTransform(SharedTransform); });
+	AddThroughput<FTransform, FTransform>("FTransform/Inverse", MakeTransform, [](FTransform T) { return T.Inverse(); });
+	AddThroughput<FTransform, FMatrix>("FTransform/ToMatrixWithScale", MakeTransform, [](const FTransform& T) { return T.ToMatrixWithScale(); });
+	// Cached matrices and inverses against building them per query; the first pass fills the caches
+	const auto MakeNegativeTransform = [](FBenchRandom& R) { FTransform T = R.Transform(); T.Scale3D.X = -T.Scale3D.X; return T; };
+	const FCachedTransform SharedCachedTransform(MakeNegativeTransform(Random));
+	AddThroughput<FCachedTransform, FMatrix>("FCachedTransform/GetMatrixWithScale", [](FBenchRandom& R) { return FCachedTransform(R.Transform()); }, [](const FCachedTransform& T) { return T.GetMatrixWithScale(); });
+	AddThroughput<FTransform, FMatrix>("FTransform/ToInverseMatrixWithScale", MakeTransform, [](const FTransform& T) { return T.ToInverseMatrixWithScale(); });
+	AddThroughput<FCachedTransform, FMatrix>("FCachedTransform/GetInverseMatrixWithScale", [](FBenchRandom& R) { return FCachedTransform(R.Transform()); }, [](const FCachedTransform& T) { return T.GetInverseMatrixWithScale(); });
+	AddThroughput<FTransform, FTransform>("FTransform/GetRelativeTransform/NegativeScale", MakeNegativeTransform, [=](const FTransform& T) { return T.GetRelativeTransform(SharedCachedTransform.GetTransform()); });
+	AddThroughput<FCachedTransform, FTransform>("FCachedTransform/GetRelativeTransform/NegativeScale", [=](FBenchRandom& R) { return FCachedTransform(MakeNegativeTransform(R)); }, [=](const FCachedTransform& T) { return T.GetRelativeTransform(SharedCachedTransform); });
+	// Against one shared base; Mixed mirrors one transform in eight, which the batch sends down the matrix path per lane
+	const auto MakeMixedTransform = [](FBenchRandom& R) { FTransform T = R.Transform(); if (R.Range(0, 8) < 1) T.Scale3D.X = -T.Scale3D.X; return T; };
+	AddThroughput<FTransform, FTransform>("FTransform/GetRelativeTransform/Mixed", MakeMixedTransform, [=](const FTransform& T) { return T.GetRelativeTransform(SharedTransform); });
+	AddBatch<FTransform, FTransform>("FTransform/BatchGetRelativeTransforms", MakeTransform, [=](const FTransform* In, FTransform* Out, size_t Count) { BatchGetRelativeTransforms(In, SharedTransform, Out, Count); });
+	AddBatch<FTransform, FTransform>("FTransform/BatchGetRelativeTransforms/Mixed", MakeMixedTransform, [=](const FTransform* In, FTransform* Out, size_t Count) { BatchGetRelativeTransforms(In, SharedTransform, Out, Count); });
+	AddThroughput<FTransform, FVector>("FTransform/GetBoneWithRotation", MakeTransform, [=](const FTransform& T) { return SharedTransform.GetBoneWithRotation(T); });
+	AddCustom("FTransform/BatchGetBoneWithRotation", [=](size_t Count)
+	{
+		FBenchRandom R;
+		auto Bones = std::make_shared<std::vector<FTransform>>(Count);
+		auto Out = std::make_shared<std::vector<double>>(Count * 3);
+		for (FTransform& Bone : *Bones)
+			Bone = R.Transform();
+		return FBenchRunner{ [=]()
+		{
+			double* Data = Out->data();
+			BatchGetBoneWithRotation(SharedTransform, Bones->data(), Count, FVectorSoA(Data, Data + Count, Data + 2 * Count));
+			Escape(Data);
+		}, Count };
+	});
+	// Bones inside larger raw records (an FTransform and 16 bytes of other data), read through a
+	// view against copying each one into an FTransform array first
+	const auto MakeBoneRecords = [](size_t Count)
+	{
+		FBenchRandom R;
+		auto Records = std::make_shared<std::vector<std::byte>>(Count * (sizeof(FTransform) + 16));
+		for (size_t i = 0; i < Count; ++i)
+		{
+			const FTransform Bone = R.Transform();
+			memcpy(Records->data() + i * (sizeof(FTransform) + 16), &Bone, sizeof(FTransform));
+		}
+		return Records;
+	};
+	AddCustom("FTransform/BatchGetBoneWithRotation/View", [=](size_t Count)
+	{
+		auto Records = MakeBoneRecords(Count);
+		auto Out = std::make_shared<std::vector<double>>(Count * 3);
+		return FBenchRunner{ [=]()
+		{
+			double* Data = Out->data();
+			BatchGetBoneWithRotation(SharedTransform, FTransformArrayView(Records->data(), Count, sizeof(FTransform) + 16), FVectorSoA(Data, Data + Count, Data + 2 * Count));
+			Escape(Data);
+		}, Count };
+	});
+	AddCustom("FTransform/BatchGetBoneWithRotation/StagingCopy", [=](size_t Count)
+	{
+		auto Records = MakeBoneRecords(Count);
+		auto Bones = std::make_shared<std::vector<FTransform>>(Count);
+		auto Out = std::make_shared<std::vector<double>>(Count * 3);
+		return FBenchRunner{ [=]()
+		{
+			for (size_t i = 0; i < Count; ++i)
+				memcpy((void*)&(*Bones)[i], Records->data() + i * (sizeof(FTransform) + 16), sizeof(FTransform));
+			double* Data = Out->data();
+			BatchGetBoneWithRotation(SharedTransform, Bones->data(), Count, FVectorSoA(Data, Data + Count, Data + 2 * Count));
+			Escape(Data);
+		}, Count };
+	});
+	AddBatch<FTransform, FTransform3f>("FTransform/BatchConvert", MakeTransform, [](const FTransform* In, FTransform3f* Out, size_t Count) { BatchConvert(In, Out, Count); });
+
+	// Packed transforms, uniform scale as in most history
+	const FTranslationQuantizer SharedQuantizer(FVector(-1000, -1000, -1000), FVector(1000, 1000, 1000));
+	const auto MakeUniformTransform = [](FBenchRandom& R) { const double Scale = R.Range(0.5, 2); return FTransform(R.Quat(), R.Vector(1000), FVector(Scale, Scale, Scale)); };
+	AddBatch<FTransform, FPackedTransform>("FTransform/BatchPackTransforms", MakeUniformTransform, [=](const FTransform* In, FPackedTransform* Out, size_t Count) { BatchPackTransforms(In, Out, Count, SharedQuantizer); });
+	for (bool bSoA : { false, true })
+	{
+		AddCustom(bSoA ? "FTransform/BatchUnpackTransforms/SoA" : "FTransform/BatchUnpackTransforms", [=](size_t Count)
+		{
+			FBenchRandom R;
+			std::vector<FTransform> Transforms(Count);
+			for (FTransform& T : Transforms)
+				T = MakeUniformTransform(R);
+			auto Packed = std::make_shared<std::vector<FPackedTransform>>(Count);
+			BatchPackTransforms(Transforms.data(), Packed->data(), Count, SharedQuantizer);
+			auto Out = std::make_shared<std::vector<FTransform>>(Count);
+			auto Columns = std::make_shared<std::vector<double>>(Count * 10);
+			return FBenchRunner{ [=]()
+			{
+				double* C = Columns->data();
+				if (bSoA)
+					BatchUnpackTransforms(Packed->data(), FTransformSoA(FQuatSoA(C, C + Count, C + 2 * Count, C + 3 * Count), FVectorSoA(C + 4 * Count, C + 5 * Count, C + 6 * Count), FVectorSoA(C + 7 * Count, C + 8 * Count, C + 9 * Count)), Count, SharedQuantizer);
+				else
+					BatchUnpackTransforms(Packed->data(), Out->data(), Count, SharedQuantizer);
+				Escape(bSoA ? (const void*)C : (const void*)Out->data());
+			}, Count };
+		});
+	}
+
+	// Interpolation, scalar and over arrays of quaternion pairs with one shared Alpha
+	AddThroughput<FQuat, FQuat>("FQuat/Slerp", MakeQuat, [=](const FQuat& Q) { return FQuat::Slerp(Q, SharedQuat, 0.3); });
+	AddThroughput<FQuat, FQuat>("FQuat/FastSlerp", MakeQuat, [=](const FQuat& Q) { return FQuat::FastSlerp(Q, SharedQuat, 0.3); });
+	AddThroughput<FQuat, FQuat>("FQuat/NLerp", MakeQuat, [=](const FQuat& Q) { return FQuat::NLerp(Q, SharedQuat, 0.3); });
+	const auto AddQuatPairs = [](const char* Name, std::function<void(const FQuat*, const FQuat*, FQuat*, size_t)> Interpolate)
+	{
+		AddCustom(Name, [=](size_t Count)
+		{
+			FBenchRandom R;
+			auto Data = std::make_shared<std::vector<FQuat>>(Count * 3);
+			for (size_t i = 0; i < Count * 2; ++i)
+				(*Data)[i] = R.Quat();
+			return FBenchRunner{ [=]()
+			{
+				FQuat* D = Data->data();
+				Interpolate(D, D + Count, D + 2 * Count, Count);
+				Escape(D);
+			}, Count };
+		});
+	};
+	AddQuatPairs("FQuat/BatchSlerp", [](const FQuat* A, const FQuat* B, FQuat* Out, size_t Count) { BatchSlerp(A, B, 0.3, Out, Count); });
+	AddQuatPairs("FQuat/BatchSlerp/Fast", [](const FQuat* A, const FQuat* B, FQuat* Out, size_t Count) { BatchSlerp(A, B, 0.3, Out, Count, ETrigAccuracy::Fast); });
+	AddQuatPairs("FQuat/BatchFastSlerp", [](const FQuat* A, const FQuat* B, FQuat* Out, size_t Count) { BatchFastSlerp(A, B, 0.3, Out, Count); });
+	AddQuatPairs("FQuat/BatchNLerp", [](const FQuat* A, const FQuat* B, FQuat* Out, size_t Count) { BatchNLerp(A, B, 0.3, Out, Count); });
+	AddQuatPairs("FQuat/BatchSquad", [](const FQuat* A, const FQuat* B, FQuat* Out, size_t Count) { BatchSquad(A, B, B, A, 0.3, Out, Count); });
+	AddThroughput<FTransform, FTransform>("FTransform/Blend", MakeTransform, [=](const FTransform& T) { FTransform Out; Out.Blend(T, SharedTransform, 0.3); return Out; });
+	AddBatch<FTransform, FTransform>("FTransform/BatchBlendTransforms", MakeTransform, [](const FTransform* In, FTransform* Out, size_t Count) { BatchBlendTransforms(In, Out, 0.3, Out, Count); });
+
+	// Histories of 32 samples at irregular intervals, every entity sampled at one time between samples
+	for (bool bBatch : { false, true })
+	{
+		AddCustom(bBatch ? "FTransformHistory/BatchSampleHistories" : "FTransformHistory/Sample", [=](size_t Count)
+		{
+			FBenchRandom R;
+			auto Histories = std::make_shared<std::vector<FTransformHistory>>(Count);
+			for (FTransformHistory& History : *Histories)
+			{
+				History.Init(32);
+				double Time = R.Range(0.0, 0.05);
+				for (int Sample = 0; Sample < 32; ++Sample, Time += R.Range(0.01, 0.05))
+					History.AddSample(Time, R.Transform());
+			}
+			auto Out = std::make_shared<std::vector<FTransform>>(Count);
+			return FBenchRunner{ [=]()
+			{
+				if (bBatch)
+				{
+					BatchSampleHistories(Histories->data(), Count, 0.7, Out->data());
+				}
+				else
+				{
+					for (size_t i = 0; i < Count; ++i)
+						(*Histories)[i].Sample(0.7, (*Out)[i]);
+				}
+				Escape(Out->data());
+			}, Count };
+		});
+	}
+
+	// Dual quaternions, against FTransform::Multiply above and BatchGetBoneWithRotation
+	const FDualQuat SharedDualQuat(SharedQuat, Random.Vector(1000));
+	const auto MakeDualQuat = [](FBenchRandom& R) { return FDualQuat(R.Quat(), R.Vector(1000)); };
+	AddLatency("FDualQuat/Multiply", SharedDualQuat, [=](const FDualQuat& D) { return D * SharedDualQuat; });
+	AddThroughput<FDualQuat, FDualQuat>("FDualQuat/Multiply", MakeDualQuat, [=](const FDualQuat& D) { return D * SharedDualQuat; });
+	AddThroughput<FDualQuat, FDualQuat>("FDualQuat/Blend", MakeDualQuat, [=](const FDualQuat& D) { return FDualQuat::Blend(D, SharedDualQuat, 0.3); });
+	AddThroughput<FVector, FVector>("FDualQuat/TransformPosition", MakeVector, [=](const FVector& V) { return SharedDualQuat.TransformPosition(V); });
+	AddCustom("FDualQuat/BatchTransformPositions", [=](size_t Count)
+	{
+		FBenchRandom R;
+		auto In = std::make_shared<std::vector<double>>(Count * 3);
+		auto Out = std::make_shared<std::vector<double>>(Count * 3);
+		for (double& Value : *In)
+			Value = R.Range(-100, 100);
+		return FBenchRunner{ [=]()
+		{
+			double* I = In->data();
+			double* O = Out->data();
+			BatchTransformPositions(SharedDualQuat, FVectorSoA(I, I + Count, I + 2 * Count), FVectorSoA(O, O + Count, O + 2 * Count), Count);
+			Escape(O);
+		}, Count };
+	});
+
+	// Trigonometry, camera and skeleton
+	AddCustom("Trig/BatchSinCos", [](size_t Count)
+	{
+		FBenchRandom R;
+		auto Data = std::make_shared<std::vector<double>>(Count * 3);
+		for (size_t i = 0; i < Count; ++i)
+			(*Data)[i] = R.Range(-10, 10);
+		return FBenchRunner{ [=]()
+		{
+			double* D = Data->data();
+			BatchSinCos(D, D + Count, D + 2 * Count, Count);
+			Escape(D);
+		}, Count };
+	});
+	AddCustom("Trig/BatchAtan2", [](size_t Count)
+	{
+		FBenchRandom R;
+		auto Data = std::make_shared<std::vector<double>>(Count * 3);
+		for (size_t i = 0; i < Count * 2; ++i)
+			(*Data)[i] = R.Range(-10, 10);
+		return FBenchRunner{ [=]()
+		{
+			double* D = Data->data();
+			BatchAtan2(D, D + Count, D + 2 * Count, Count);
+			Escape(D);
+		}, Count };
+	});
+	AddCustom("FCamera/WorldToScreen", [](size_t Count)
+	{
+		FBenchRandom R;
+		auto Camera = std::make_shared<FCamera>(FVector(0, 0, 0), FRotator(0, 0, 0), 90.0, 1920.0, 1080.0);
+		auto Points = std::make_shared<std::vector<FVector>>(Count);
+		auto Screen = std::make_shared<std::vector<FVector2D>>(Count);
+		auto Mask = std::make_shared<std::vector<uint64_t>>((Count + 63) / 64);
+		for (FVector& Point : *Points)
+			Point = R.Vector(1000);
+		return FBenchRunner{ [=]()
+		{
+			Camera->WorldToScreen(Points->data(), Screen->data(), Mask->data(), Count);
+			Escape(Screen->data());
+		}, Count };
+	});
+	AddCustom("FFrustum/CullBoxes", [](size_t Count)
+	{
+		FBenchRandom R;
+		auto Frustum = std::make_shared<FFrustum>(FCamera(FVector(0, 0, 0), FRotator(0, 0, 0), 90.0, 1920.0, 1080.0).GetFrustum());
+		auto Boxes = std::make_shared<std::vector<FBox>>(Count);
+		auto Mask = std::make_shared<std::vector<uint64_t>>((Count + 63) / 64);
+		for (FBox& Box : *Boxes)
+		{
+			const FVector Center = R.Vector(1000);
+			Box = FBox(Center - FVector(20, 20, 20), Center + FVector(20, 20, 20));
+		}
+		return FBenchRunner{ [=]()
+		{
+			Frustum->CullBoxes(Boxes->data(), Mask->data(), Count);
+			Escape(Mask->data());
+		}, Count };
+	});
+	AddCustom("FFrustum/CullSpheres", [](size_t Count)
+	{
+		FBenchRandom R;
+		auto Frustum = std::make_shared<FFrustum>(FCamera(FVector(0, 0, 0), FRotator(0, 0, 0), 90.0, 1920.0, 1080.0).GetFrustum());
+		auto Spheres = std::make_shared<std::vector<FSphere>>(Count);
+		auto Mask = std::make_shared<std::vector<uint64_t>>((Count + 63) / 64);
+		for (FSphere& Sphere : *Spheres)
+			Sphere = FSphere(R.Vector(1000), 20.0);
+		return FBenchRunner{ [=]()
+		{
+			Frustum->CullSpheres(Spheres->data(), Mask->data(), Count);
+			Escape(Mask->data());
+		}, Count };
+	});
+	// The same scenes as FCamera/WorldToScreen and FFrustum/CullSpheres, far from the world origin, as float offsets
+	const FVector FarOrigin(6.0e8, -7.5e8, 1.0e5);
+	const auto RebasedView = [=](std::vector<float>& Offsets, size_t Count) { return FRebasedVectorSoA(FarOrigin, FVector3fSoA(Offsets.data(), Offsets.data() + Count, Offsets.data() + 2 * Count)); };
+	AddCustom("FRebasedVectorSoA/BatchWorldToScreen", [=](size_t Count)
+	{
+		FBenchRandom R;
+		auto Camera = std::make_shared<FCamera>(FarOrigin, FRotator(0, 0, 0), 90.0, 1920.0, 1080.0);
+		auto Offsets = std::make_shared<std::vector<float>>(Count * 3);
+		auto Screen = std::make_shared<std::vector<FVector2f>>(Count);
+		auto Mask = std::make_shared<std::vector<uint64_t>>((Count + 63) / 64);
+		FRebasedVectorSoA Points = RebasedView(*Offsets, Count);
+		for (size_t i = 0; i < Count; ++i)
+			Points.Set(i, FarOrigin + R.Vector(1000));
+		return FBenchRunner{ [=]()
+		{
+			BatchWorldToScreen(*Camera, RebasedView(*Offsets, Count), Screen->data(), Mask->data(), Count);
+			Escape(Screen->data());
+		}, Count };
+	});
+	AddCustom("FRebasedVectorSoA/BatchCullSpheres", [=](size_t Count)
+	{
+		FBenchRandom R;
+		auto Frustum = std::make_shared<FFrustum>(FCamera(FarOrigin, FRotator(0, 0, 0), 90.0, 1920.0, 1080.0).GetFrustum());
+		auto Offsets = std::make_shared<std::vector<float>>(Count * 3);
+		auto Radii = std::make_shared<std::vector<float>>(Count, 20.0f);
+		auto Mask = std::make_shared<std::vector<uint64_t>>((Count + 63) / 64);
+		FRebasedVectorSoA Centers = RebasedView(*Offsets, Count);
+		for (size_t i = 0; i < Count; ++i)
+			Centers.Set(i, FarOrigin + R.Vector(1000));
+		return FBenchRunner{ [=]()
+		{
+			BatchCullSpheres(*Frustum, RebasedView(*Offsets, Count), Radii->data(), Mask->data(), Count);
+			Escape(Mask->data());
+		}, Count };
+	});
+	AddCustom("FRebasedVectorSoA/BatchDistanceSquared", [=](size_t Count)
+	{
+		FBenchRandom R;
+		auto Offsets = std::make_shared<std::vector<float>>(Count * 3);
+		auto Out = std::make_shared<std::vector<float>>(Count);
+		FRebasedVectorSoA Points = RebasedView(*Offsets, Count);
+		for (size_t i = 0; i < Count; ++i)
+			Points.Set(i, FarOrigin + R.Vector(1000));
+		return FBenchRunner{ [=]()
+		{
+			BatchDistanceSquared(RebasedView(*Offsets, Count), FarOrigin + FVector(10, 20, 30), Out->data(), Count);
+			Escape(Out->data());
+		}, Count };
+	});
+	for (bool bResolve : { false, true })
+	{
+		AddCustom(bResolve ? "FRebasedVectorSoA/BatchResolve" : "FRebasedVectorSoA/BatchRebase", [=](size_t Count)
+		{
+			FBenchRandom R;
+			auto World = std::make_shared<std::vector<FVector>>(Count);
+			auto Offsets = std::make_shared<std::vector<float>>(Count * 3);
+			FRebasedVectorSoA Points = RebasedView(*Offsets, Count);
+			for (FVector& Point : *World)
+				Point = FarOrigin + R.Vector(1000);
+			BatchRebase(World->data(), Points, Count);
+			return FBenchRunner{ [=]()
+			{
+				if (bResolve)
+					BatchResolve(RebasedView(*Offsets, Count), World->data(), Count);
+				else
+					BatchRebase(World->data(), RebasedView(*Offsets, Count), Count);
+				Escape(bResolve ? (void*)World->data() : (void*)Offsets->data());
+			}, Count };
+		});
+	}
+	AddCustom("FBox/FromBones", [](size_t Count)
+	{
+		FBenchRandom R;
+		auto Bones = std::make_shared<std::vector<FTransform>>(Count);
+		auto Box = std::make_shared<FBox>();
+		for (FTransform& Bone : *Bones)
+			Bone = R.Transform();
+		return FBenchRunner{ [=]()
+		{
+			*Box = FBox(Bones->data(), Count);
+			Escape(Box.get());
+		}, Count };
+	});
+	// Spatial queries over Count entities in a 10K cube, 256 queries per run
+	const auto MakeEntities = [](size_t Count)
+	{
+		FBenchRandom R;
+		auto Points = std::make_shared<std::vector<FVector>>(Count);
+		for (FVector& Point : *Points)
+			Point = R.Vector(5000);
+		return Points;
+	};
+	const auto MakeQueries = []()
+	{
+		FBenchRandom R;
+		R.State ^= 0x9E3779B97F4A7C15ull;
+		auto Queries = std::make_shared<std::vector<FVector>>(256);
+		for (FVector& Query : *Queries)
+			Query = R.Vector(5000);
+		return Queries;
+	};
+	AddScaling("Spatial/BruteForceNearest", [=](size_t Count)
+	{
+		auto Points = MakeEntities(Count);
+		auto Queries = MakeQueries();
+		auto Result = std::make_shared<size_t>();
+		return FBenchRunner{ [=]()
+		{
+			for (const FVector& Query : *Queries)
+			{
+				size_t Best = 0;
+				double BestDistance = INFINITY;
+				for (size_t i = 0; i < Count; ++i)
+				{
+					const double Distance = Query.Distance((*Points)[i]);
+					if (Distance < BestDistance)
+					{
+						BestDistance = Distance;
+						Best = i;
+					}
+				}
+				*Result += Best;
+			}
+			Escape(Result.get());
+		}, Queries->size() };
+	});
+	const auto AddTreeQuery = [=](const char* Name, std::function<size_t(const FBVH&, const FVector&)> Query)
+	{
+		AddScaling(Name, [=](size_t Count)
+		{
+			auto Points = MakeEntities(Count);
+			auto Queries = MakeQueries();
+			auto Tree = std::make_shared<FBVH>();
+			auto Result = std::make_shared<size_t>();
+			Tree->Build(Points->data(), Count);
+			return FBenchRunner{ [=]()
+			{
+				for (const FVector& Point : *Queries)
+					*Result += Query(*Tree, Point);
+				Escape(Result.get());
+			}, Queries->size() };
+		});
+	};
+	AddTreeQuery("Spatial/FBVH/FindNearest", [](const FBVH& Tree, const FVector& Point) { return (size_t)Tree.FindNearest(Point); });
+	AddTreeQuery("Spatial/FBVH/FindNearest/K8", [](const FBVH& Tree, const FVector& Point)
+	{
+		int32_t Indices[8];
+		double Distances[8];
+		return Tree.FindNearest(Point, 8, Indices, Distances);
+	});
+	AddTreeQuery("Spatial/FBVH/FindInRadius/500", [](const FBVH& Tree, const FVector& Point)
+	{
+		thread_local std::vector<int32_t> Found;
+		Found.clear();
+		Tree.FindInRadius(Point, 500.0, Found);
+		return Found.size();
+	});
+	AddTreeQuery("Spatial/FBVH/Raycast", [](const FBVH& Tree, const FVector& Point)
+	{
+		int32_t Index = -1;
+		double Distance;
+		Tree.Raycast(FVector(0, 0, 0), Point.GetNormalizedVector(), 10000.0, Index, Distance);
+		return (size_t)Index;
+	});
+	AddScaling("Spatial/FBVH/Build", [=](size_t Count)
+	{
+		auto Points = MakeEntities(Count);
+		auto Tree = std::make_shared<FBVH>();
+		return FBenchRunner{ [=]()
+		{
+			Tree->Build(Points->data(), Count);
+			Escape(Tree.get());
+		}, Count };
+	});
+	AddScaling("Spatial/FBVH/Refit", [=](size_t Count)
+	{
+		auto Points = MakeEntities(Count);
+		auto Tree = std::make_shared<FBVH>();
+		Tree->Build(Points->data(), Count);
+		return FBenchRunner{ [=]()
+		{
+			Tree->Refit(Points->data());
+			Escape(Tree.get());
+		}, Count };
+	});
+
+	// One ray against Count shapes scattered in front of it, a quarter of them on its path
+	const auto MakeShapes = [](size_t Count)
+	{
+		FBenchRandom R;
+		auto Arrays = std::make_shared<std::vector<std::vector<double>>>(7, std::vector<double>(Count));
+		for (size_t i = 0; i < Count; ++i)
+		{
+			const FVector Start = i % 4 == 0 ? FVector(R.Range(100, 10000), R.Range(-50, 50), R.Range(-50, 50)) : R.Vector(10000);
+			const FVector End = Start + R.Vector(40);
+			for (int Axis = 0; Axis < 3; ++Axis)
+			{
+				(*Arrays)[Axis][i] = std::min((&Start.X)[Axis], (&End.X)[Axis]);
+				(*Arrays)[3 + Axis][i] = std::max((&Start.X)[Axis], (&End.X)[Axis]);
+			}
+			(*Arrays)[6][i] = R.Range(5, 30);
+		}
+		return Arrays;
+	};
+	const auto AddRaycast = [=](const char* Name, std::function<int32_t(const FRay&, std::vector<std::vector<double>>&, size_t)> Cast)
+	{
+		AddCustom(Name, [=](size_t Count)
+		{
+			auto Arrays = MakeShapes(Count);
+			auto Result = std::make_shared<int32_t>();
+			return FBenchRunner{ [=]()
+			{
+				*Result += Cast(FRay(FVector(0, 0, 0), FVector(1, 0, 0)), *Arrays, Count);
+				Escape(Result.get());
+			}, Count };
+		});
+	};
+	const auto Vectors = [](std::vector<std::vector<double>>& Arrays, int First)
+	{
+		return FVectorSoA(Arrays[First].data(), Arrays[First + 1].data(), Arrays[First + 2].data());
+	};
+	AddRaycast("FRay/RaycastSpheres", [=](const FRay& Ray, std::vector<std::vector<double>>& Arrays, size_t Count)
+	{
+		int32_t Index = -1;
+		double Distance;
+		RaycastSpheres(Ray, FSphereSoA(Vectors(Arrays, 0), Arrays[6].data()), Count, Index, Distance);
+		return Index;
+	});
+	AddRaycast("FRay/RaycastBoxes", [=](const FRay& Ray, std::vector<std::vector<double>>& Arrays, size_t Count)
+	{
+		int32_t Index = -1;
+		double Distance;
+		RaycastBoxes(Ray, FBoxSoA(Vectors(Arrays, 0), Vectors(Arrays, 3)), Count, Index, Distance);
+		return Index;
+	});
+	AddRaycast("FRay/RaycastCapsules", [=](const FRay& Ray, std::vector<std::vector<double>>& Arrays, size_t Count)
+	{
+		int32_t Index = -1;
+		double Distance;
+		RaycastCapsules(Ray, FCapsuleSoA(Vectors(Arrays, 0), Vectors(Arrays, 3), Arrays[6].data()), Count, Index, Distance);
+		return Index;
+	});
+	AddRaycast("FRay/IntersectCapsule/Loop", [=](const FRay& Ray, std::vector<std::vector<double>>& Arrays, size_t Count)
+	{
+		// The one shape at a time loop the batch replaces
+		int32_t Index = -1;
+		double Best = INFINITY, Distance;
+		for (size_t i = 0; i < Count; ++i)
+		{
+			if (Ray.IntersectCapsule(Vectors(Arrays, 0).Get(i), Vectors(Arrays, 3).Get(i), Arrays[6][i], Distance) && Distance < Best)
+			{
+				Best = Distance;
+				Index = (int32_t)i;
+			}
+		}
+		return Index;
+	});
+	AddParallelScaling("Parallel/BatchGetBoneWithRotation", [=](size_t Count, FTaskScheduler* Scheduler)
+	{
+		FBenchRandom R;
+		auto Bones = std::make_shared<std::vector<FTransform>>(Count);
+		auto Out = std::make_shared<std::vector<double>>(Count * 3);
+		for (FTransform& Bone : *Bones)
+			Bone = R.Transform();
+		return FBenchRunner{ [=]()
+		{
+			double* Data = Out->data();
+			BatchGetBoneWithRotation(SharedTransform, Bones->data(), Count, FVectorSoA(Data, Data + Count, Data + 2 * Count), Scheduler);
+			Escape(Data);
+		}, Count };
+	});
+	AddParallelScaling("Parallel/FCamera/WorldToScreen", [](size_t Count, FTaskScheduler* Scheduler)
+	{
+		FBenchRandom R;
+		auto Camera = std::make_shared<FCamera>(FVector(0, 0, 0), FRotator(0, 0, 0), 90.0, 1920.0, 1080.0);
+		auto Points = std::make_shared<std::vector<FVector>>(Count);
+		auto Screen = std::make_shared<std::vector<FVector2D>>(Count);
+		auto Mask = std::make_shared<std::vector<uint64_t>>((Count + 63) / 64);
+		for (FVector& Point : *Points)
+			Point = R.Vector(1000);
+		return FBenchRunner{ [=]()
+		{
+			Camera->WorldToScreen(Points->data(), Screen->data(), Mask->data(), Count, Scheduler);
+			Escape(Screen->data());
+		}, Count };
+	});
+	AddParallelScaling("Parallel/FFrustum/CullBoxes", [](size_t Count, FTaskScheduler* Scheduler)
+	{
+		FBenchRandom R;
+		auto Frustum = std::make_shared<FFrustum>(FCamera(FVector(0, 0, 0), FRotator(0, 0, 0), 90.0, 1920.0, 1080.0).GetFrustum());
+		auto Boxes = std::make_shared<std::vector<FBox>>(Count);
+		auto Mask = std::make_shared<std::vector<uint64_t>>((Count + 63) / 64);
+		for (FBox& Box : *Boxes)
+		{
+			const FVector Center = R.Vector(1000);
+			Box = FBox(Center - FVector(20, 20, 20), Center + FVector(20, 20, 20));
+		}
+		return FBenchRunner{ [=]()
+		{
+			Frustum->CullBoxes(Boxes->data(), Mask->data(), Count, Scheduler);
+			Escape(Mask->data());
+		}, Count };
+	});
+	// Skinning a mesh against a 128 bone palette, Mops/s being millions of vertices per second
+	for (bool bDualQuat : { false, true })
+	{
+		AddParallelScaling(bDualQuat ? "Skinning/BatchSkinPositions/DualQuat" : "Skinning/BatchSkinPositions/Matrix", [=](size_t Count, FTaskScheduler* Scheduler)
+		{
+			FBenchRandom R;
+			const size_t NumBones = 128;
+			auto Matrices = std::make_shared<std::vector<FMatrix>>(NumBones);
+			auto DualQuats = std::make_shared<std::vector<FDualQuat>>(NumBones);
+			for (size_t i = 0; i < NumBones; ++i)
+			{
+				const FTransform Bone = R.Transform();
+				(*Matrices)[i] = Bone.ToMatrixWithScale();
+				(*DualQuats)[i] = FDualQuat(Bone);
+			}
+			auto Weights = std::make_shared<std::vector<FSkinWeightInfo>>(Count);
+			for (FSkinWeightInfo& Info : *Weights)
+			{
+				for (int Influence = 0; Influence < MaxSkinInfluences; ++Influence)
+					Info.InfluenceBones[Influence] = (uint16_t)R.Range(0, NumBones - 1);
+				Info.InfluenceWeights[0] = 0.4f;
+				Info.InfluenceWeights[1] = 0.3f;
+				Info.InfluenceWeights[2] = 0.2f;
+				Info.InfluenceWeights[3] = 0.1f;
+			}
+			auto In = std::make_shared<std::vector<double>>(Count * 3);
+			auto Out = std::make_shared<std::vector<double>>(Count * 3);
+			for (double& Value : *In)
+				Value = R.Range(-100, 100);
+			return FBenchRunner{ [=]()
+			{
+				double* I = In->data();
+				double* O = Out->data();
+				const FVectorSoA InSoA(I, I + Count, I + 2 * Count), OutSoA(O, O + Count, O + 2 * Count);
+				if (bDualQuat)
+					BatchSkinPositions(DualQuats->data(), Weights->data(), InSoA, OutSoA, Count, Scheduler);
+				else
+					BatchSkinPositions(Matrices->data(), Weights->data(), InSoA, OutSoA, Count, Scheduler);
+				Escape(O);
+			}, Count };
+		});
+	}
+	AddCustom("FSkeletonPose/EvaluateAll", [](size_t Count)
+	{
+		FBenchRandom R;
+		std::vector<int32_t> Parents(Count);
+		for (size_t i = 0; i < Count; ++i)
+			Parents[i] = i == 0 ? -1 : (int32_t)(R.Range(0, (double)i));
+		auto Pose = std::make_shared<FSkeletonPose>();
+		Pose->Init(Parents.data(), Count);
+		for (size_t i = 0; i < Count; ++i)
+		{
+			FTransform Local = R.Transform();
+			Local.Scale3D = FVector(1, 1, 1);
+			Pose->SetLocalTransform(i, Local);
+		}
+		return FBenchRunner{ [=]()
+		{
+			Pose->MarkAllDirty();
+			Pose->Evaluate();
+			Escape(Pose->GetComponentTransforms());
+		}, Count };
+	});
+	// Count bones split into 128 bone skeletons, the way a crowd is evaluated. Each run sets the
+	// local transform of a fresh random DirtyPercent of every skeleton's bones, which also dirties
+	// their subtrees, then evaluates every skeleton; FullRecompute marks every bone instead. The
+	// bone picks are drawn up front, cycling through eight sets, so the runs time the pose only.
+	for (int DirtyPercent : { -1, 0, 2, 10, 100 })
+	{
+		const std::string CaseName = DirtyPercent < 0 ? std::string("FSkeletonPose/Skeletons/FullRecompute") : "FSkeletonPose/Skeletons/Dirty" + std::to_string(DirtyPercent) + "%";
+		AddCustom(CaseName.c_str(), [=](size_t Count)
+		{
+			const size_t BonesPerSkeleton = std::min<size_t>(Count, 128);
+			const size_t NumSkeletons = Count / BonesPerSkeleton;
+			const size_t NumDirty = DirtyPercent < 0 ? 0 : (BonesPerSkeleton * DirtyPercent + 50) / 100;
+			const size_t NumPickSets = 8;
+
+			FBenchRandom R;
+			std::vector<int32_t> Parents(BonesPerSkeleton);
+			for (size_t i = 0; i < BonesPerSkeleton; ++i)
+				Parents[i] = i == 0 ? -1 : (int32_t)(R.Range(0, (double)i));
+			auto Locals = std::make_shared<std::vector<FTransform>>(Count);
+			auto Poses = std::make_shared<std::vector<FSkeletonPose>>(NumSkeletons);
+			for (size_t Skeleton = 0; Skeleton < NumSkeletons; ++Skeleton)
+			{
+				FSkeletonPose& Pose = (*Poses)[Skeleton];
+				Pose.Init(Parents.data(), BonesPerSkeleton);
+				for (size_t i = 0; i < BonesPerSkeleton; ++i)
+				{
+					FTransform& Local = (*Locals)[Skeleton * BonesPerSkeleton + i];
+					Local = R.Transform();
+					Local.Scale3D = FVector(1, 1, 1);
+					Pose.SetLocalTransform(i, Local);
+				}
+				Pose.Evaluate();
+			}
+
+			// NumDirty distinct bones per skeleton and pick set, the head of a partial shuffle
+			auto Picks = std::make_shared<std::vector<int32_t>>(NumPickSets * NumSkeletons * NumDirty);
+			std::vector<int32_t> Order(BonesPerSkeleton);
+			for (size_t i = 0; i < BonesPerSkeleton; ++i)
+				Order[i] = (int32_t)i;
+			int32_t* Pick = Picks->data();
+			for (size_t n = 0; n < NumPickSets * NumSkeletons; ++n)
+			{
+				for (size_t i = 0; i < NumDirty; ++i)
+				{
+					std::swap(Order[i], Order[i + (size_t)R.Range(0, (double)(BonesPerSkeleton - i))]);
+					*Pick++ = Order[i];
+				}
+			}
+
+			auto PickSet = std::make_shared<size_t>(0);
+			return FBenchRunner{ [=]()
+			{
+				const int32_t* SetPicks = Picks->data() + *PickSet * NumSkeletons * NumDirty;
+				*PickSet = (*PickSet + 1) % NumPickSets;
+				for (size_t Skeleton = 0; Skeleton < NumSkeletons; ++Skeleton)
+				{
+					FSkeletonPose& Pose = (*Poses)[Skeleton];
+					if (DirtyPercent < 0)
+						Pose.MarkAllDirty();
+					const FTransform* SkeletonLocals = Locals->data() + Skeleton * BonesPerSkeleton;
+					for (size_t i = 0; i < NumDirty; ++i, ++SetPicks)
+						Pose.SetLocalTransform(*SetPicks, SkeletonLocals[*SetPicks]);
+					Pose.Evaluate();
+					Escape(Pose.GetComponentTransforms());
+				}
+			}, NumSkeletons * BonesPerSkeleton };
+		});
+	}
+}
+
+/*----------------------------------------------------------------------------
+	Measurement and reporting.
+----------------------------------------------------------------------------*/
+
+struct FBenchOptions
+{
+	const char* JsonPath = nullptr;
+	const char* Filter = nullptr;
+	size_t MaxSize = (size_t)1 << 20;
+	double MinTime = 0.1;
+	int Samples = 5;
+	bool bStats = false;
+};
+
+static double NowSeconds()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static FBenchResult Measure(const FBenchmark& Benchmark, size_t Size, const FBenchOptions& Options)
+{
+	FBenchRunner Runner = Benchmark.Prepare(Size);
+
+	// Warm up caches and branch predictors, then size the batch of runs to the minimum time
+	Runner.Run();
+	uint64_t Runs = 1;
+	for (;;)
+	{
+		const double Start = NowSeconds();
+		for (uint64_t i = 0; i < Runs; ++i)
+			Runner.Run();
+		const double Elapsed = NowSeconds() - Start;
+		if (Elapsed >= Options.MinTime * 0.5 || Runs >= ((uint64_t)1 << 40))
+		{
+			Runs = (uint64_t)std::max(1.0, (double)Runs * Options.MinTime / std::max(Elapsed, 1e-9));
+			break;
+		}
+		Runs *= Elapsed > 0 ? std::max<uint64_t>(2, std::min<uint64_t>(16, (uint64_t)(Options.MinTime / Elapsed))) : 16;
+	}
+
+	std::vector<double> Samples;
+	for (int Sample = 0; Sample < Options.Samples; ++Sample)
+	{
+		const double Start = NowSeconds();
+		for (uint64_t i = 0; i < Runs; ++i)
+			Runner.Run();
+		Samples.push_back((NowSeconds() - Start) * 1e9 / ((double)Runs * (double)Runner.OpsPerRun));
+	}
+	std::sort(Samples.begin(), Samples.end());
+
+	FBenchResult Result;
+	Result.Name = Benchmark.Name;
+	Result.Mode = Benchmark.Mode;
+	Result.Size = Size;
+	Result.Iterations = Runs * Runner.OpsPerRun;
+	Result.NsPerOp = Samples[Samples.size() / 2];
+	Result.NsPerOpMin = Samples.front();
+	return Result;
+}
+
+static const char* GetModeName(EBenchMode Mode)
+{
+	return Mode == EBenchMode::Latency ? "latency" : "throughput";
+}
+
+static const char* GetCompilerString()
+{
+#if defined(__clang__)
+	return "clang " __clang_version__;
+#elif defined(__GNUC__)
+	return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+#define UE_BENCH_STRINGIFY_INNER(X) #X
+#define UE_BENCH_STRINGIFY(X) UE_BENCH_STRINGIFY_INNER(X)
+	return "msvc " UE_BENCH_STRINGIFY(_MSC_FULL_VER);
+#else
+	return "unknown";
+#endif
+}
+
+static bool WriteJson(const char* Path, const std::vector<FBenchResult>& Results, const FBenchOptions& Options)
+{
+	FILE* File = fopen(Path, "w");
+	if (!File)
+		return false;
+
+	char Date[64];
+	const time_t Now = time(nullptr);
+	strftime(Date, sizeof(Date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&Now));
+
+	fprintf(File, "{\n  \"context\": {\n");
+	fprintf(File, "    \"library\": \"ue5math\",\n");
+	fprintf(File, "    \"version\": \"%s\",\n", UE_MATH_VERSION_STRING);
+	fprintf(File, "    \"date\": \"%s\",\n", Date);
+	fprintf(File, "    \"compiler\": \"%s\",\n", GetCompilerString());
+	fprintf(File, "    \"header_only\": %s,\n", UE_MATH_HEADER_ONLY ? "true" : "false");
+	fprintf(File, "    \"simd_level\": \"%s\",\n", GetSimdLevelName(GetSimdLevel()));
+	fprintf(File, "    \"supported_simd_level\": \"%s\",\n", GetSimdLevelName(GetSupportedSimdLevel()));
+	fprintf(File, "    \"min_time_seconds\": %g,\n", Options.MinTime);
+	fprintf(File, "    \"samples\": %d\n", Options.Samples);
+	fprintf(File, "  },\n  \"benchmarks\": [\n");
+	for (size_t i = 0; i < Results.size(); ++i)
+	{
+		const FBenchResult& Result = Results[i];
+		fprintf(File, "    {\"name\": \"%s\", \"mode\": \"%s\", \"size\": %zu, \"iterations\": %llu, \"ns_per_op\": %.4f, \"ns_per_op_min\": %.4f, \"ops_per_second\": %.6g}%s\n",
+			Result.Name.c_str(), GetModeName(Result.Mode), Result.Size, (unsigned long long)Result.Iterations,
+			Result.NsPerOp, Result.NsPerOpMin, 1e9 / Result.NsPerOp, i + 1 < Results.size() ? "," : "");
+	}
+	fprintf(File, "  ]\n}\n");
+	return fclose(File) == 0;
+}
+
+static void PrintUsage()
+{
+	printf(
+		"Usage: ue5math_bench [options]\n"
+		"  --json <file>       write the results as JSON\n"
+		"  --filter <text>     only run cases whose name contains text\n"
+		"  --max-size <n>      skip throughput sizes above n (default 1048576)\n"
+		"  --min-time <sec>    minimum time per sample (default 0.1)\n"
+		"  --samples <n>       samples per case, the median is reported (default 5)\n"
+		"  --simd <level>      scalar, avx2 or avx512 (clamped to the CPU)\n"
+		"  --quick             --min-time 0.002 --samples 1, for smoke testing\n"
+		"  --stats             print the UE_MATH_STATS report after the run\n");
+}
+
+int main(int argc, char** argv)
+{
+	FBenchOptions Options;
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* Argument = argv[i];
+		const char* Value = i + 1 < argc ? argv[i + 1] : nullptr;
+		if (!strcmp(Argument, "--quick"))
+		{
+			Options.MinTime = 0.002;
+			Options.Samples = 1;
+			continue;
+		}
+		if (!strcmp(Argument, "--stats"))
+		{
+			Options.bStats = true;
+			continue;
+		}
+		if (!strcmp(Argument, "--help") || !Value)
+		{
+			PrintUsage();
+			return strcmp(Argument, "--help") ? 1 : 0;
+		}
+		++i;
+		if (!strcmp(Argument, "--json"))
+			Options.JsonPath = Value;
+		else if (!strcmp(Argument, "--filter"))
+			Options.Filter = Value;
+		else if (!strcmp(Argument, "--max-size"))
+			Options.MaxSize = (size_t)strtoull(Value, nullptr, 10);
+		else if (!strcmp(Argument, "--min-time"))
+			Options.MinTime = atof(Value);
+		else if (!strcmp(Argument, "--samples"))
+			Options.Samples = std::max(1, atoi(Value));
+		else if (!strcmp(Argument, "--simd"))
+		{
+			if (!strcmp(Value, "scalar"))
+				SetSimdLevel(ESimdLevel::Scalar);
+			else if (!strcmp(Value, "avx2"))
+				SetSimdLevel(ESimdLevel::AVX2);
+			else if (!strcmp(Value, "avx512"))
+				SetSimdLevel(ESimdLevel::AVX512);
+			else
+			{
+				PrintUsage();
+				return 1;
+			}
+		}
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	RegisterBenchmarks();
+
+	static const std::vector<size_t> DefaultSizes = { 1, 64, 4096, (size_t)1 << 20 };
+	std::vector<FBenchResult> Results;
+
+	printf("ue5math %s, %s, SIMD level %s\n", UE_MATH_VERSION_STRING, GetCompilerString(), GetSimdLevelName(GetSimdLevel()));
+	printf("%-44s %-10s %8s %12s %12s\n", "name", "mode", "size", "ns/op", "Mops/s");
+	for (const FBenchmark& Benchmark : GetBenchmarks())
+	{
+		if (Options.Filter && !strstr(Benchmark.Name.c_str(), Options.Filter))
+			continue;
+
+		for (size_t Size : Benchmark.Sizes.empty() ? DefaultSizes : Benchmark.Sizes)
+		{
+			if (Benchmark.Mode == EBenchMode::Latency && Size != 1)
+				continue;
+			if (Size > Options.MaxSize)
+				continue;
+
+			const FBenchResult Result = Measure(Benchmark, Size, Options);
+			printf("%-44s %-10s %8zu %12.3f %12.2f\n", Result.Name.c_str(), GetModeName(Result.Mode), Result.Size, Result.NsPerOp, 1e3 / Result.NsPerOp);
+			fflush(stdout);
+			Results.push_back(Result);
+		}
+	}
+
+	if (Options.bStats)
+		DumpMathStats(stdout);
+
+	if (Options.JsonPath && !WriteJson(Options.JsonPath, Results, Options))
+	{
+		fprintf(stderr, "Failed to write %s\n", Options.JsonPath);
+		return 1;
+	}
+	return Results.empty() ? 1 : 0;
+}
@@ -0,0 +1,10 @@
+#include "bounds.h"
+
+#if !UE_MATH_HEADER_ONLY
+#include "bounds.inl"
+
+template struct TBox<float>;
+template struct TBox<double>;
+template struct TSphere<float>;
+template struct TSphere<double>;
+#endif
@@ -0,0 +1,130 @@
+#pragma once
+#include "ue4math.h"
+#include "mathfwd.h"
+#include "vector.h"
+#include "transform.h"
+
+/** Axis aligned box. An empty box (IsValid == 0) takes the first point added as both corners. */
+template<typename T>
+struct TBox
+{
+public:
+	using FReal = T;
+
+	TVector<T>                                          Min;
+	TVector<T>                                          Max;
+	uint8_t                                             IsValid;
+
+	constexpr TBox() : Min(), Max(), IsValid(0) {}
+	constexpr TBox(const TVector<T>& Min, const TVector<T>& Max) : Min(Min), Max(Max), IsValid(1) {}
+
+	/** Bounds of Count points. */
+	TBox(const TVector<T>* Points, size_t Count);
+
+	/** Bounds of the bone translations, e.g. FSkeletonPose::GetComponentTransforms(), in one pass. */
+	TBox(const TTransform<T>* Bones, size_t Count);
+
+	template<typename U, typename = typename std::enable_if<!std::is_same<T, U>::value>::type>
+	constexpr explicit TBox(const TBox<U>& Other) : Min(Other.Min), Max(Other.Max), IsValid(Other.IsValid) {}
+
+	TBox& operator+=(const TVector<T>& Point)
+	{
+		if (IsValid)
+		{
+			Min = Min.Min(Point);
+			Max = Max.Max(Point);
+		}
+		else
+		{
+			Min = Max = Point;
+			IsValid = 1;
+		}
+		return *this;
+	}
+
+	TBox& operator+=(const TBox& Other)
+	{
+		if (IsValid && Other.IsValid)
+		{
+			Min = Min.Min(Other.Min);
+			Max = Max.Max(Other.Max);
+		}
+		else if (Other.IsValid)
+		{
+			*this = Other;
+		}
+		return *this;
+	}
+
+	TBox operator+(const TVector<T>& Point) const { return TBox(*this) += Point; }
+	TBox operator+(const TBox& Other) const { return TBox(*this) += Other; }
+
+	constexpr TVector<T> GetCenter() const { return (Min + Max) * T(0.5); }
+	constexpr TVector<T> GetExtent() const { return (Max - Min) * T(0.5); }
+	constexpr TVector<T> GetSize() const { return Max - Min; }
+
+	/** The box grown by W on every side. */
+	constexpr TBox ExpandBy(T W) const { return TBox(Min - TVector<T>(W, W, W), Max + TVector<T>(W, W, W)); }
+
+	/** Point inside the box, boundary excluded. */
+	constexpr bool IsInside(const TVector<T>& Point) const
+	{
+		return Point.X > Min.X && Point.X < Max.X && Point.Y > Min.Y && Point.Y < Max.Y && Point.Z > Min.Z && Point.Z < Max.Z;
+	}
+
+	/** Overlap test; boxes that only touch count as intersecting. */
+	constexpr bool Intersect(const TBox& Other) const
+	{
+		return Min.X <= Other.Max.X && Other.Min.X <= Max.X && Min.Y <= Other.Max.Y && Other.Min.Y <= Max.Y && Min.Z <= Other.Max.Z && Other.Min.Z <= Max.Z;
+	}
+
+	/** Box around this one after a transform by M (Arvo's method, exact for affine matrices). */
+	TBox TransformBy(const TMatrix<T>& M) const;
+};
+
+static_assert(sizeof(FBox) == 56, "FBox");
+
+/** Sphere: Center and radius W. */
+template<typename T>
+struct TSphere
+{
+public:
+	using FReal = T;
+
+	TVector<T>                                          Center;
+	T                                                   W;
+
+	constexpr TSphere() : Center(), W(0) {}
+	constexpr TSphere(const TVector<T>& Center, T W) : Center(Center), W(W) {}
+
+	/** Sphere through the corners of Box, as for FBoxSphereBounds. */
+	explicit TSphere(const TBox<T>& Box) : Center(Box.GetCenter()), W(Box.GetExtent().Length()) {}
+
+	template<typename U, typename = typename std::enable_if<!std::is_same<T, U>::value>::type>
+	constexpr explicit TSphere(const TSphere<U>& Other) : Center(Other.Center), W((T)Other.W) {}
+
+	/** Point inside the sphere, grown by Tolerance. */
+	constexpr bool IsInside(const TVector<T>& Point, T Tolerance = T(KINDA_SMALL_NUMBER)) const
+	{
+		const TVector<T> Delta = Point - Center;
+		return (Delta | Delta) <= (W + Tolerance) * (W + Tolerance);
+	}
+
+	/** Overlap test, grown by Tolerance. */
+	constexpr bool Intersects(const TSphere& Other, T Tolerance = T(KINDA_SMALL_NUMBER)) const
+	{
+		const TVector<T> Delta = Other.Center - Center;
+		return (Delta | Delta) <= (W + Other.W + Tolerance) * (W + Other.W + Tolerance);
+	}
+};
+
+static_assert(sizeof(FSphere) == 32, "FSphere");
+
+#if UE_MATH_HEADER_ONLY
+#include "bounds.inl"
+#else
+extern template struct TBox<float>;
+extern template struct TBox<double>;
+extern template struct TSphere<float>;
+extern template struct TSphere<double>;
+#endif
@@ -0,0 +1,59 @@
+#pragma once
+#include "bounds.h"
+#include "matrix.h"
+
+template<typename T>
+UE_MATH_INLINE TBox<T>::TBox(const TVector<T>* Points, size_t Count) : Min(), Max(), IsValid(0)
+{
+	for (size_t i = 0; i < Count; ++i)
+	{
+		*this += Points[i];
+	}
+}
+
+template<typename T>
+UE_MATH_INLINE TBox<T>::TBox(const TTransform<T>* Bones, size_t Count) : Min(), Max(), IsValid(0)
+{
+	if (Count == 0)
+	{
+		return;
+	}
+
+	// Seeded with the first bone so the loop is a plain min/max the compiler can vectorize
+	TVector<T> BoxMin = Bones[0].Translation, BoxMax = Bones[0].Translation;
+	for (size_t i = 1; i < Count; ++i)
+	{
+		BoxMin = BoxMin.Min(Bones[i].Translation);
+		BoxMax = BoxMax.Max(Bones[i].Translation);
+	}
+	*this = TBox(BoxMin, BoxMax);
+}
+
+template<typename T>
+UE_MATH_INLINE TBox<T> TBox<T>::TransformBy(const TMatrix<T>& M) const
+{
+	if (!IsValid)
+	{
+		return TBox();
+	}
+
+	// Each output axis is the translation plus, per input axis, the smaller and larger of the two
+	// corner coordinates times the matrix entry
+	TVector<T> NewMin(M.M[3][0], M.M[3][1], M.M[3][2]);
+	TVector<T> NewMax = NewMin;
+	const T* BoxMin = &Min.X;
+	const T* BoxMax = &Max.X;
+	T* OutMin = &NewMin.X;
+	T* OutMax = &NewMax.X;
+	for (int Row = 0; Row < 3; ++Row)
+	{
+		for (int Column = 0; Column < 3; ++Column)
+		{
+			const T A = M.M[Row][Column] * BoxMin[Row];
+			const T B = M.M[Row][Column] * BoxMax[Row];
+			OutMin[Column] += A < B ? A : B;
+			OutMax[Column] += A < B ? B : A;
+		}
+	}
+	return TBox(NewMin, NewMax);
+}
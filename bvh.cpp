@@ -0,0 +1,385 @@
+#include "bvh.h"
+#include <algorithm>
+
+// Deeper than any tree of fewer than 2^31 items gets: every split halves the item range
+static const int32_t MaxTraversalDepth = 64;
+
+static inline double DistanceSquared(const FVector& Point, const FVector& Min, const FVector& Max)
+{
+	const double DX = std::max(std::max(Min.X - Point.X, 0.0), Point.X - Max.X);
+	const double DY = std::max(std::max(Min.Y - Point.Y, 0.0), Point.Y - Max.Y);
+	const double DZ = std::max(std::max(Min.Z - Point.Z, 0.0), Point.Z - Max.Z);
+	return DX * DX + DY * DY + DZ * DZ;
+}
+
+/** Slab test of the ray against a box, clipped to [0, MaxT]. A NaN from a ray lying in a slab plane leaves the interval alone. */
+static inline bool IntersectSlabs(const FVector& Origin, const FVector& InvDirection, const FVector& Min, const FVector& Max, double MaxT, double& OutT)
+{
+	double T0 = 0.0, T1 = MaxT;
+	const double* O = &Origin.X;
+	const double* Inv = &InvDirection.X;
+	const double* BoxMin = &Min.X;
+	const double* BoxMax = &Max.X;
+	for (int Axis = 0; Axis < 3; ++Axis)
+	{
+		double Near = (BoxMin[Axis] - O[Axis]) * Inv[Axis];
+		double Far = (BoxMax[Axis] - O[Axis]) * Inv[Axis];
+		if (Near > Far)
+		{
+			std::swap(Near, Far);
+		}
+		T0 = Near > T0 ? Near : T0;
+		T1 = Far < T1 ? Far : T1;
+	}
+	OutT = T0;
+	return T0 <= T1;
+}
+
+/*-----------------------------------------------------------------------------
+	Build and refit.
+-----------------------------------------------------------------------------*/
+
+void FBVH::Build(const FBox* Bounds, size_t Count)
+{
+	BuildItems.resize(Count);
+	for (size_t i = 0; i < Count; ++i)
+	{
+		BuildItems[i] = { Bounds[i].GetCenter(), (int32_t)i };
+	}
+	BuildTopology();
+	Refit(Bounds);
+}
+
+void FBVH::Build(const FVector* Points, size_t Count)
+{
+	BuildItems.resize(Count);
+	for (size_t i = 0; i < Count; ++i)
+	{
+		BuildItems[i] = { Points[i], (int32_t)i };
+	}
+	BuildTopology();
+	Refit(Points);
+}
+
+void FBVH::BuildTopology()
+{
+	Nodes.clear();
+	if (!BuildItems.empty())
+	{
+		BuildNode(0, (int32_t)BuildItems.size());
+	}
+
+	Items.resize(BuildItems.size());
+	for (size_t i = 0; i < BuildItems.size(); ++i)
+	{
+		Items[i] = BuildItems[i].Index;
+	}
+}
+
+int32_t FBVH::BuildNode(int32_t Begin, int32_t End)
+{
+	const int32_t NodeIndex = (int32_t)Nodes.size();
+	Nodes.push_back(FNode());
+
+	if (End - Begin <= MaxLeafSize)
+	{
+		Nodes[NodeIndex].Offset = Begin;
+		Nodes[NodeIndex].Count = End - Begin;
+		return NodeIndex;
+	}
+
+	FVector Min = BuildItems[Begin].Center, Max = Min;
+	for (int32_t i = Begin + 1; i < End; ++i)
+	{
+		Min = Min.Min(BuildItems[i].Center);
+		Max = Max.Max(BuildItems[i].Center);
+	}
+	const FVector Size = Max - Min;
+	const int Axis = Size.X >= Size.Y && Size.X >= Size.Z ? 0 : (Size.Y >= Size.Z ? 1 : 2);
+
+	const int32_t Mid = Begin + (End - Begin) / 2;
+	std::nth_element(BuildItems.begin() + Begin, BuildItems.begin() + Mid, BuildItems.begin() + End, [Axis](const FBuildItem& A, const FBuildItem& B)
+	{
+		return (&A.Center.X)[Axis] < (&B.Center.X)[Axis];
+	});
+
+	BuildNode(Begin, Mid);
+	const int32_t Right = BuildNode(Mid, End);
+	Nodes[NodeIndex].Offset = Right;
+	Nodes[NodeIndex].Count = 0;
+	return NodeIndex;
+}
+
+void FBVH::Refit(const FBox* Bounds)
+{
+	ItemMin.resize(Items.size());
+	ItemMax.resize(Items.size());
+	for (size_t i = 0; i < Items.size(); ++i)
+	{
+		ItemMin[i] = Bounds[Items[i]].Min;
+		ItemMax[i] = Bounds[Items[i]].Max;
+	}
+	RefitNodes();
+}
+
+void FBVH::Refit(const FVector* Points)
+{
+	ItemMin.resize(Items.size());
+	ItemMax.resize(Items.size());
+	for (size_t i = 0; i < Items.size(); ++i)
+	{
+		ItemMin[i] = ItemMax[i] = Points[Items[i]];
+	}
+	RefitNodes();
+}
+
+void FBVH::RefitNodes()
+{
+	// Children come after their parent in the node array, so one backwards sweep is bottom up
+	for (size_t i = Nodes.size(); i-- > 0;)
+	{
+		FNode& Node = Nodes[i];
+		if (Node.Count > 0)
+		{
+			Node.Min = ItemMin[Node.Offset];
+			Node.Max = ItemMax[Node.Offset];
+			for (int32_t Item = Node.Offset + 1; Item < Node.Offset + Node.Count; ++Item)
+			{
+				Node.Min = Node.Min.Min(ItemMin[Item]);
+				Node.Max = Node.Max.Max(ItemMax[Item]);
+			}
+		}
+		else
+		{
+			const FNode& Left = Nodes[i + 1];
+			const FNode& Right = Nodes[Node.Offset];
+			Node.Min = Left.Min.Min(Right.Min);
+			Node.Max = Left.Max.Max(Right.Max);
+		}
+	}
+}
+
+FBox FBVH::GetBounds() const
+{
+	return Nodes.empty() ? FBox() : FBox(Nodes[0].Min, Nodes[0].Max);
+}
+
+/*-----------------------------------------------------------------------------
+	Queries. Each walks the tree with a fixed stack, nearer child first, and
+	skips nodes that cannot beat the current result.
+-----------------------------------------------------------------------------*/
+
+/** Restores the max-heap order of Keys (with Values alongside) below Index. */
+static void SiftDown(double* Keys, int32_t* Values, size_t Size, size_t Index)
+{
+	for (;;)
+	{
+		size_t Largest = Index;
+		const size_t Left = 2 * Index + 1, Right = Left + 1;
+		if (Left < Size && Keys[Left] > Keys[Largest])
+			Largest = Left;
+		if (Right < Size && Keys[Right] > Keys[Largest])
+			Largest = Right;
+		if (Largest == Index)
+			return;
+		std::swap(Keys[Index], Keys[Largest]);
+		std::swap(Values[Index], Values[Largest]);
+		Index = Largest;
+	}
+}
+
+static void SiftUp(double* Keys, int32_t* Values, size_t Index)
+{
+	while (Index > 0)
+	{
+		const size_t Parent = (Index - 1) / 2;
+		if (!(Keys[Index] > Keys[Parent]))
+			return;
+		std::swap(Keys[Index], Keys[Parent]);
+		std::swap(Values[Index], Values[Parent]);
+		Index = Parent;
+	}
+}
+
+size_t FBVH::FindNearest(const FVector& Point, size_t K, int32_t* OutIndices, double* OutDistancesSquared) const
+{
+	K = std::min(K, Items.size());
+	if (K == 0)
+	{
+		return 0;
+	}
+
+	// The results so far are a max-heap in the output arrays, the worst one on top
+	size_t NumFound = 0;
+	const auto WorstDistanceSquared = [&]() { return NumFound < K ? INFINITY : OutDistancesSquared[0]; };
+
+	struct FEntry { int32_t Node; double DistanceSquared; };
+	FEntry Stack[MaxTraversalDepth];
+	int32_t StackSize = 0;
+	Stack[StackSize++] = { 0, DistanceSquared(Point, Nodes[0].Min, Nodes[0].Max) };
+
+	while (StackSize > 0)
+	{
+		const FEntry Entry = Stack[--StackSize];
+		if (!(Entry.DistanceSquared < WorstDistanceSquared()))
+		{
+			continue;
+		}
+
+		const FNode& Node = Nodes[Entry.Node];
+		if (Node.Count > 0)
+		{
+			for (int32_t Item = Node.Offset; Item < Node.Offset + Node.Count; ++Item)
+			{
+				const double Distance = DistanceSquared(Point, ItemMin[Item], ItemMax[Item]);
+				if (!(Distance < WorstDistanceSquared()))
+				{
+					continue;
+				}
+				if (NumFound < K)
+				{
+					OutDistancesSquared[NumFound] = Distance;
+					OutIndices[NumFound] = Items[Item];
+					SiftUp(OutDistancesSquared, OutIndices, NumFound++);
+				}
+				else
+				{
+					OutDistancesSquared[0] = Distance;
+					OutIndices[0] = Items[Item];
+					SiftDown(OutDistancesSquared, OutIndices, K, 0);
+				}
+			}
+		}
+		else
+		{
+			const FEntry Left = { Entry.Node + 1, DistanceSquared(Point, Nodes[Entry.Node + 1].Min, Nodes[Entry.Node + 1].Max) };
+			const FEntry Right = { Node.Offset, DistanceSquared(Point, Nodes[Node.Offset].Min, Nodes[Node.Offset].Max) };
+			const bool bLeftFirst = Left.DistanceSquared <= Right.DistanceSquared;
+			Stack[StackSize++] = bLeftFirst ? Right : Left;
+			Stack[StackSize++] = bLeftFirst ? Left : Right;
+		}
+	}
+
+	// Heap sort in place: popping the maximum to the back leaves them nearest first
+	for (size_t Size = NumFound; Size > 1; --Size)
+	{
+		std::swap(OutDistancesSquared[0], OutDistancesSquared[Size - 1]);
+		std::swap(OutIndices[0], OutIndices[Size - 1]);
+		SiftDown(OutDistancesSquared, OutIndices, Size - 1, 0);
+	}
+	return NumFound;
+}
+
+int32_t FBVH::FindNearest(const FVector& Point) const
+{
+	int32_t Index = -1;
+	double DistanceSquared;
+	FindNearest(Point, 1, &Index, &DistanceSquared);
+	return Index;
+}
+
+void FBVH::FindInRadius(const FVector& Center, double Radius, std::vector<int32_t>& OutIndices) const
+{
+	if (Nodes.empty())
+	{
+		return;
+	}
+
+	const double RadiusSquared = Radius * Radius;
+	int32_t Stack[MaxTraversalDepth];
+	int32_t StackSize = 0;
+	Stack[StackSize++] = 0;
+
+	while (StackSize > 0)
+	{
+		const FNode& Node = Nodes[Stack[--StackSize]];
+		if (!(DistanceSquared(Center, Node.Min, Node.Max) <= RadiusSquared))
+		{
+			continue;
+		}
+
+		if (Node.Count > 0)
+		{
+			for (int32_t Item = Node.Offset; Item < Node.Offset + Node.Count; ++Item)
+			{
+				if (DistanceSquared(Center, ItemMin[Item], ItemMax[Item]) <= RadiusSquared)
+				{
+					OutIndices.push_back(Items[Item]);
+				}
+			}
+		}
+		else
+		{
+			Stack[StackSize++] = Node.Offset;
+			Stack[StackSize++] = (int32_t)(&Node - Nodes.data()) + 1;
+		}
+	}
+}
+
+bool FBVH::Raycast(const FVector& Origin, const FVector& Direction, double MaxDistance, int32_t& OutIndex, double& OutDistance) const
+{
+	double T;
+	const FVector InvDirection(1.0 / Direction.X, 1.0 / Direction.Y, 1.0 / Direction.Z);
+	if (Nodes.empty() || !IntersectSlabs(Origin, InvDirection, Nodes[0].Min, Nodes[0].Max, MaxDistance, T))
+	{
+		return false;
+	}
+
+	int32_t BestIndex = -1;
+	double BestT = MaxDistance;
+
+	struct FEntry { int32_t Node; double T; };
+	FEntry Stack[MaxTraversalDepth];
+	int32_t StackSize = 0;
+	Stack[StackSize++] = { 0, T };
+
+	while (StackSize > 0)
+	{
+		const FEntry Entry = Stack[--StackSize];
+		if (Entry.T > BestT)
+		{
+			continue;
+		}
+
+		const FNode& Node = Nodes[Entry.Node];
+		if (Node.Count > 0)
+		{
+			for (int32_t Item = Node.Offset; Item < Node.Offset + Node.Count; ++Item)
+			{
+				if (IntersectSlabs(Origin, InvDirection, ItemMin[Item], ItemMax[Item], BestT, T) && (BestIndex < 0 || T < BestT))
+				{
+					BestIndex = Items[Item];
+					BestT = T;
+				}
+			}
+		}
+		else
+		{
+			double LeftT, RightT;
+			const bool bLeft = IntersectSlabs(Origin, InvDirection, Nodes[Entry.Node + 1].Min, Nodes[Entry.Node + 1].Max, BestT, LeftT);
+			const bool bRight = IntersectSlabs(Origin, InvDirection, Nodes[Node.Offset].Min, Nodes[Node.Offset].Max, BestT, RightT);
+			if (bLeft && bRight)
+			{
+				const bool bLeftFirst = LeftT <= RightT;
+				Stack[StackSize++] = bLeftFirst ? FEntry{ Node.Offset, RightT } : FEntry{ Entry.Node + 1, LeftT };
+				Stack[StackSize++] = bLeftFirst ? FEntry{ Entry.Node + 1, LeftT } : FEntry{ Node.Offset, RightT };
+			}
+			else if (bLeft)
+			{
+				Stack[StackSize++] = { Entry.Node + 1, LeftT };
+			}
+			else if (bRight)
+			{
+				Stack[StackSize++] = { Node.Offset, RightT };
+			}
+		}
+	}
+
+	if (BestIndex < 0)
+	{
+		return false;
+	}
+	OutIndex = BestIndex;
+	OutDistance = BestT;
+	return true;
+}
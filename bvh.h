@@ -0,0 +1,83 @@
+#pragma once
+#include "ue4math.h"
+#include "vector.h"
+#include "bounds.h"
+#include <vector>
+
+/**
+ * Bounding volume hierarchy over points or boxes, for nearest, radius and ray queries.
+ *
+ * Build() splits at the median along the longest axis of the centers, so the tree is balanced
+ * whatever the distribution and takes O(N log N) with no allocation after the first build of a
+ * given size. Refit() keeps the topology and only recomputes the bounds bottom up, O(N): use it
+ * every frame while the entities move moderately, and rebuild when queries slow down.
+ *
+ * Distances are from the query point to an item's box, 0 inside it; for points that is the
+ * plain distance. Item indices are positions in the array passed to Build().
+ */
+struct FBVH
+{
+public:
+	/** Items per leaf at most. */
+	static constexpr int32_t MaxLeafSize = 4;
+
+	void Build(const FBox* Bounds, size_t Count);
+	void Build(const FVector* Points, size_t Count);
+
+	/** New bounds for the items of the last Build(), in the same order and count. */
+	void Refit(const FBox* Bounds);
+	void Refit(const FVector* Points);
+
+	size_t Num() const { return Items.size(); }
+
+	/** Bounds of everything; invalid when empty. */
+	FBox GetBounds() const;
+
+	/**
+	 * The K items closest to Point, nearest first, with their squared distances.
+	 *
+	 * @return number of items written, min(K, Num())
+	 */
+	size_t FindNearest(const FVector& Point, size_t K, int32_t* OutIndices, double* OutDistancesSquared) const;
+
+	/** The closest item, or -1 when empty. */
+	int32_t FindNearest(const FVector& Point) const;
+
+	/** Appends the items within Radius of Center to OutIndices, in no particular order. */
+	void FindInRadius(const FVector& Center, double Radius, std::vector<int32_t>& OutIndices) const;
+
+	/**
+	 * First item box hit by the ray Origin + t * Direction, 0 <= t <= MaxDistance; t is a distance
+	 * when Direction is normalized. A ray starting inside a box hits it at t = 0.
+	 *
+	 * @return false if nothing is hit (the out values are left alone)
+	 */
+	bool Raycast(const FVector& Origin, const FVector& Direction, double MaxDistance, int32_t& OutIndex, double& OutDistance) const;
+
+private:
+	/** Leaf (Count > 0): items Offset .. Offset + Count - 1 of the leaf order. Inner node: children at this + 1 and Offset. */
+	struct FNode
+	{
+		FVector Min;
+		FVector Max;
+		int32_t Offset;
+		int32_t Count;
+	};
+
+	/** Item center and index, sorted into leaf order by the build. */
+	struct FBuildItem
+	{
+		FVector Center;
+		int32_t Index;
+	};
+
+	void BuildTopology();
+	int32_t BuildNode(int32_t Begin, int32_t End);
+	void RefitNodes();
+
+	std::vector<FNode> Nodes;
+	std::vector<int32_t> Items;			/* Item index per leaf order slot */
+	std::vector<FVector> ItemMin;		/* Item bounds in leaf order, so leaves read them contiguously */
+	std::vector<FVector> ItemMax;
+	std::vector<FBuildItem> BuildItems;
+};
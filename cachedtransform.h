@@ -0,0 +1,109 @@
+#pragma once
+#include "ue4math.h"
+#include "mathfwd.h"
+#include "vector.h"
+#include "quat.h"
+#include "matrix.h"
+#include "transform.h"
+
+/**
+ * An FTransform with its matrix, inverse matrix and inverse transform computed on first use and
+ * kept until it changes, for long-lived transforms queried many times (component-to-world,
+ * socket and attachment transforms).
+ *
+ * Every mutation bumps the version; each derived value remembers the version it was computed
+ * at and is recomputed when that is stale. The values are the same as those of the plain
+ * functions, bit for bit. Filling the cache from a const getter writes to the object, so the
+ * first queries after a change must not race each other; Update() fills everything up front.
+ */
+template<typename T>
+struct TCachedTransform
+{
+public:
+	TCachedTransform() : Version(1), MatrixVersion(0), InverseMatrixVersion(0), InverseVersion(0) {}
+	explicit TCachedTransform(const TTransform<T>& Transform) : Transform(Transform), Version(1), MatrixVersion(0), InverseMatrixVersion(0), InverseVersion(0) {}
+
+	const TTransform<T>& GetTransform() const { return Transform; }
+	const TQuat<T>& GetRotation() const { return Transform.Rotation; }
+	const TVector<T>& GetTranslation() const { return Transform.Translation; }
+	const TVector<T>& GetScale3D() const { return Transform.Scale3D; }
+
+	/** Bumped by every mutation, starting at 1; other caches can key on it. */
+	uint64_t GetVersion() const { return Version; }
+
+	void SetTransform(const TTransform<T>& InTransform) { Transform = InTransform; ++Version; }
+	void SetRotation(const TQuat<T>& Rotation) { Transform.Rotation = Rotation; ++Version; }
+	void SetTranslation(const TVector<T>& Translation) { Transform.Translation = Translation; ++Version; }
+	void SetScale3D(const TVector<T>& Scale3D) { Transform.Scale3D = Scale3D; ++Version; }
+
+	/** GetTransform().ToMatrixWithScale(). */
+	const TMatrix<T>& GetMatrixWithScale() const
+	{
+		if (MatrixVersion != Version)
+		{
+			Matrix = Transform.ToMatrixWithScale();
+			MatrixVersion = Version;
+		}
+		return Matrix;
+	}
+
+	/** GetTransform().ToInverseMatrixWithScale(). */
+	const TMatrix<T>& GetInverseMatrixWithScale() const
+	{
+		if (InverseMatrixVersion != Version)
+		{
+			InverseMatrix = Transform.ToInverseMatrixWithScale();
+			InverseMatrixVersion = Version;
+		}
+		return InverseMatrix;
+	}
+
+	/**
+	 * The transform undoing this one, FTransform().GetRelativeTransform(GetTransform()): reciprocal
+	 * scale, through the matrices when the scale is negative. Identity for an unnormalized rotation.
+	 */
+	const TTransform<T>& GetInverse() const
+	{
+		if (InverseVersion != Version)
+		{
+			Inverse = TTransform<T>().GetRelativeTransform(Transform);
+			InverseVersion = Version;
+		}
+		return Inverse;
+	}
+
+	/**
+	 * GetTransform().GetRelativeTransform(Other.GetTransform()), bit for bit. With a negative scale
+	 * the matrix path takes both matrices from the caches instead of building and inverting them.
+	 */
+	TTransform<T> GetRelativeTransform(const TCachedTransform& Other) const
+	{
+		if (!TTransform<T>::AnyHasNegativeScale(Transform.Scale3D, Other.Transform.Scale3D))
+		{
+			return Transform.GetRelativeTransform(Other.Transform);
+		}
+		const TVector<T> DesiredScale3D = Transform.Scale3D * TTransform<T>::GetSafeScaleReciprocal(Other.Transform.Scale3D, T(SMALL_NUMBER));
+		TTransform<T> Result;
+		TTransform<T>::ConstructTransformFromMatrixWithDesiredScale(GetMatrixWithScale(), Other.GetInverseMatrixWithScale(), DesiredScale3D, Result);
+		return Result;
+	}
+
+	/** Computes every cached value now. */
+	void Update() const
+	{
+		GetMatrixWithScale();
+		GetInverseMatrixWithScale();
+		GetInverse();
+	}
+
+private:
+	TTransform<T> Transform;
+	uint64_t Version;
+
+	mutable uint64_t MatrixVersion;			/* Version Matrix was computed at, 0 if never */
+	mutable uint64_t InverseMatrixVersion;
+	mutable uint64_t InverseVersion;
+	mutable TMatrix<T> Matrix;
+	mutable TMatrix<T> InverseMatrix;
+	mutable TTransform<T> Inverse;
+};
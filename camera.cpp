@@ -0,0 +1,224 @@
+#include "camera.h"
+#include "cpu.h"
+#include "parallel.h"
+
+#if UE_MATH_X86
+#include <immintrin.h>
+#endif
+
+FCamera::FCamera() : FOV(90.0), ViewportWidth(1920.0), ViewportHeight(1080.0), NearPlane(1.0)
+{
+	Update();
+}
+
+FCamera::FCamera(const FVector& Location, const FRotator& Rotation, double FOV, double ViewportWidth, double ViewportHeight)
+	: Location(Location), Rotation(Rotation), FOV(FOV), ViewportWidth(ViewportWidth), ViewportHeight(ViewportHeight), NearPlane(1.0)
+{
+	Update();
+}
+
+void FCamera::Update()
+{
+	const FMatrix RotationMatrix = Rotation.GetMatrix();
+	const FVector AxisX = RotationMatrix.GetScaledAxisX();	// forward
+	const FVector AxisY = RotationMatrix.GetScaledAxisY();	// right
+	const FVector AxisZ = RotationMatrix.GetScaledAxisZ();	// up
+
+	const double CenterX = ViewportWidth / 2.0;
+	const double CenterY = ViewportHeight / 2.0;
+	const double Focal = CenterX / tan(ConvertToRadians(FOV) / 2.0);
+
+	// Screen X = CenterX + Focal * (D | Right) / (D | Forward), Screen Y = CenterY - Focal * (D | Up) / (D | Forward)
+	// with D = P - Location; multiplying through by (D | Forward) makes both linear in P.
+	const FVector ColumnX = AxisY * Focal + AxisX * CenterX;
+	const FVector ColumnY = AxisX * CenterY - AxisZ * Focal;
+	const FVector ColumnW = AxisX;
+
+	FMatrix& M = ViewProjection;
+	M.M[0][0] = ColumnX.X; M.M[1][0] = ColumnX.Y; M.M[2][0] = ColumnX.Z; M.M[3][0] = -(Location | ColumnX);
+	M.M[0][1] = ColumnY.X; M.M[1][1] = ColumnY.Y; M.M[2][1] = ColumnY.Z; M.M[3][1] = -(Location | ColumnY);
+	M.M[0][2] = ColumnW.X; M.M[1][2] = ColumnW.Y; M.M[2][2] = ColumnW.Z; M.M[3][2] = -(Location | ColumnW);
+	M.M[0][3] = ColumnW.X; M.M[1][3] = ColumnW.Y; M.M[2][3] = ColumnW.Z; M.M[3][3] = -(Location | ColumnW);
+}
+
+bool FCamera::WorldToScreen(const FVector& World, FVector2D& OutScreen) const
+{
+	const FMatrix& M = ViewProjection;
+	const double SX = World.X * M.M[0][0] + World.Y * M.M[1][0] + World.Z * M.M[2][0] + M.M[3][0];
+	const double SY = World.X * M.M[0][1] + World.Y * M.M[1][1] + World.Z * M.M[2][1] + M.M[3][1];
+	const double W = World.X * M.M[0][3] + World.Y * M.M[1][3] + World.Z * M.M[2][3] + M.M[3][3];
+	const double Depth = std::max(W, NearPlane);
+	OutScreen = FVector2D(SX / Depth, SY / Depth);
+	return W >= NearPlane;
+}
+
+static size_t WorldToScreenScalar(const FCamera& Camera, FVectorArrayView World, FVector2D* OutScreen, uint64_t* OutVisibleMask, size_t Begin, size_t Count)
+{
+	size_t NumVisible = 0;
+	for (size_t i = Begin; i < Count; ++i)
+	{
+		const bool bVisible = Camera.WorldToScreen(World[i], OutScreen[i]);
+		OutVisibleMask[i >> 6] |= (uint64_t)bVisible << (i & 63);
+		NumVisible += bVisible;
+	}
+	return NumVisible;
+}
+
+#if UE_MATH_X86
+/** bPacked: World is a plain FVector array and loads as whole registers; otherwise the points are gathered at its stride. */
+template<bool bPacked>
+UE_TARGET_AVX2_FMA static size_t WorldToScreenAVX2(const FCamera& Camera, FVectorArrayView World, FVector2D* OutScreen, uint64_t* OutVisibleMask, size_t Count)
+{
+	const FMatrix& M = Camera.GetViewProjectionMatrix();
+	const __m256d M00 = _mm256_set1_pd(M.M[0][0]), M10 = _mm256_set1_pd(M.M[1][0]), M20 = _mm256_set1_pd(M.M[2][0]), M30 = _mm256_set1_pd(M.M[3][0]);
+	const __m256d M01 = _mm256_set1_pd(M.M[0][1]), M11 = _mm256_set1_pd(M.M[1][1]), M21 = _mm256_set1_pd(M.M[2][1]), M31 = _mm256_set1_pd(M.M[3][1]);
+	const __m256d M03 = _mm256_set1_pd(M.M[0][3]), M13 = _mm256_set1_pd(M.M[1][3]), M23 = _mm256_set1_pd(M.M[2][3]), M33 = _mm256_set1_pd(M.M[3][3]);
+	const __m256d Near = _mm256_set1_pd(Camera.NearPlane);
+	const long long Stride = (long long)World.Stride;
+	const __m256i Index = _mm256_set_epi64x(3 * Stride, 2 * Stride, Stride, 0);
+
+	size_t NumVisible = 0;
+	size_t i = 0;
+	for (; i + 4 <= Count; i += 4)
+	{
+		const std::byte* Src = World.Data + i * World.Stride;
+		__m256d PX, PY, PZ;
+		if (bPacked)
+		{
+			// Four packed FVectors are three registers: x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3
+			const __m256d R0 = _mm256_loadu_pd((const double*)Src + 0);
+			const __m256d R1 = _mm256_loadu_pd((const double*)Src + 4);
+			const __m256d R2 = _mm256_loadu_pd((const double*)Src + 8);
+			PX = _mm256_permute4x64_pd(_mm256_blend_pd(_mm256_blend_pd(R0, R1, 0x4), R2, 0x2), _MM_SHUFFLE(1, 2, 3, 0));
+			PY = _mm256_permute4x64_pd(_mm256_blend_pd(_mm256_blend_pd(R0, R1, 0x9), R2, 0x4), _MM_SHUFFLE(2, 3, 0, 1));
+			PZ = _mm256_permute4x64_pd(_mm256_blend_pd(_mm256_blend_pd(R0, R1, 0x2), R2, 0x9), _MM_SHUFFLE(3, 0, 1, 2));
+		}
+		else
+		{
+			PX = _mm256_i64gather_pd((const double*)(Src + 0), Index, 1);
+			PY = _mm256_i64gather_pd((const double*)(Src + 8), Index, 1);
+			PZ = _mm256_i64gather_pd((const double*)(Src + 16), Index, 1);
+		}
+
+		const __m256d SX = _mm256_fmadd_pd(PX, M00, _mm256_fmadd_pd(PY, M10, _mm256_fmadd_pd(PZ, M20, M30)));
+		const __m256d SY = _mm256_fmadd_pd(PX, M01, _mm256_fmadd_pd(PY, M11, _mm256_fmadd_pd(PZ, M21, M31)));
+		const __m256d W = _mm256_fmadd_pd(PX, M03, _mm256_fmadd_pd(PY, M13, _mm256_fmadd_pd(PZ, M23, M33)));
+
+		const __m256d Visible = _mm256_cmp_pd(W, Near, _CMP_GE_OQ);
+		const __m256d Depth = _mm256_max_pd(W, Near);
+		const __m256d X = _mm256_div_pd(SX, Depth);
+		const __m256d Y = _mm256_div_pd(SY, Depth);
+
+		// Interleave back to FVector2D pairs
+		const __m256d XY02 = _mm256_unpacklo_pd(X, Y);
+		const __m256d XY13 = _mm256_unpackhi_pd(X, Y);
+		double* Dst = &OutScreen[i].X;
+		_mm256_storeu_pd(Dst + 0, _mm256_permute2f128_pd(XY02, XY13, 0x20));
+		_mm256_storeu_pd(Dst + 4, _mm256_permute2f128_pd(XY02, XY13, 0x31));
+
+		const uint64_t Bits = (uint64_t)_mm256_movemask_pd(Visible);
+		OutVisibleMask[i >> 6] |= Bits << (i & 63);
+		NumVisible += CountBits64(Bits);
+	}
+
+	_mm256_zeroupper();
+	return NumVisible + WorldToScreenScalar(Camera, World, OutScreen, OutVisibleMask, i, Count);
+}
+
+template<bool bPacked>
+UE_TARGET_AVX512 static size_t WorldToScreenAVX512(const FCamera& Camera, FVectorArrayView World, FVector2D* OutScreen, uint64_t* OutVisibleMask, size_t Count)
+{
+	const FMatrix& M = Camera.GetViewProjectionMatrix();
+	const __m512d M00 = _mm512_set1_pd(M.M[0][0]), M10 = _mm512_set1_pd(M.M[1][0]), M20 = _mm512_set1_pd(M.M[2][0]), M30 = _mm512_set1_pd(M.M[3][0]);
+	const __m512d M01 = _mm512_set1_pd(M.M[0][1]), M11 = _mm512_set1_pd(M.M[1][1]), M21 = _mm512_set1_pd(M.M[2][1]), M31 = _mm512_set1_pd(M.M[3][1]);
+	const __m512d M03 = _mm512_set1_pd(M.M[0][3]), M13 = _mm512_set1_pd(M.M[1][3]), M23 = _mm512_set1_pd(M.M[2][3]), M33 = _mm512_set1_pd(M.M[3][3]);
+	const __m512d Near = _mm512_set1_pd(Camera.NearPlane);
+	// Eight packed FVectors are three registers; pick X/Y/Z from the first two, then finish from the third
+	const __m512i GatherX01 = _mm512_set_epi64(0, 0, 15, 12, 9, 6, 3, 0);
+	const __m512i GatherY01 = _mm512_set_epi64(0, 0, 0, 13, 10, 7, 4, 1);
+	const __m512i GatherZ01 = _mm512_set_epi64(0, 0, 0, 14, 11, 8, 5, 2);
+	const __m512i GatherX2 = _mm512_set_epi64(13, 10, 5, 4, 3, 2, 1, 0);
+	const __m512i GatherY2 = _mm512_set_epi64(14, 11, 8, 4, 3, 2, 1, 0);
+	const __m512i GatherZ2 = _mm512_set_epi64(15, 12, 9, 4, 3, 2, 1, 0);
+	const __m512i InterleaveLo = _mm512_set_epi64(11, 3, 10, 2, 9, 1, 8, 0);
+	const __m512i InterleaveHi = _mm512_set_epi64(15, 7, 14, 6, 13, 5, 12, 4);
+	const long long Stride = (long long)World.Stride;
+	const __m512i Index = _mm512_set_epi64(7 * Stride, 6 * Stride, 5 * Stride, 4 * Stride, 3 * Stride, 2 * Stride, Stride, 0);
+
+	size_t NumVisible = 0;
+	size_t i = 0;
+	for (; i + 8 <= Count; i += 8)
+	{
+		const std::byte* Src = World.Data + i * World.Stride;
+		__m512d PX, PY, PZ;
+		if (bPacked)
+		{
+			const __m512d R0 = _mm512_loadu_pd((const double*)Src + 0);
+			const __m512d R1 = _mm512_loadu_pd((const double*)Src + 8);
+			const __m512d R2 = _mm512_loadu_pd((const double*)Src + 16);
+			PX = _mm512_permutex2var_pd(_mm512_permutex2var_pd(R0, GatherX01, R1), GatherX2, R2);
+			PY = _mm512_permutex2var_pd(_mm512_permutex2var_pd(R0, GatherY01, R1), GatherY2, R2);
+			PZ = _mm512_permutex2var_pd(_mm512_permutex2var_pd(R0, GatherZ01, R1), GatherZ2, R2);
+		}
+		else
+		{
+			PX = _mm512_i64gather_pd(Index, Src + 0, 1);
+			PY = _mm512_i64gather_pd(Index, Src + 8, 1);
+			PZ = _mm512_i64gather_pd(Index, Src + 16, 1);
+		}
+
+		const __m512d SX = _mm512_fmadd_pd(PX, M00, _mm512_fmadd_pd(PY, M10, _mm512_fmadd_pd(PZ, M20, M30)));
+		const __m512d SY = _mm512_fmadd_pd(PX, M01, _mm512_fmadd_pd(PY, M11, _mm512_fmadd_pd(PZ, M21, M31)));
+		const __m512d W = _mm512_fmadd_pd(PX, M03, _mm512_fmadd_pd(PY, M13, _mm512_fmadd_pd(PZ, M23, M33)));
+
+		const __mmask8 Visible = _mm512_cmp_pd_mask(W, Near, _CMP_GE_OQ);
+		const __m512d Depth = _mm512_max_pd(W, Near);
+		const __m512d X = _mm512_div_pd(SX, Depth);
+		const __m512d Y = _mm512_div_pd(SY, Depth);
+
+		double* Dst = &OutScreen[i].X;
+		_mm512_storeu_pd(Dst + 0, _mm512_permutex2var_pd(X, InterleaveLo, Y));
+		_mm512_storeu_pd(Dst + 8, _mm512_permutex2var_pd(X, InterleaveHi, Y));
+
+		OutVisibleMask[i >> 6] |= (uint64_t)Visible << (i & 63);
+		NumVisible += CountBits64(Visible);
+	}
+
+	_mm256_zeroupper();
+	return NumVisible + WorldToScreenScalar(Camera, World, OutScreen, OutVisibleMask, i, Count);
+}
+#endif
+
+static size_t WorldToScreenDispatch(const FCamera& Camera, FVectorArrayView World, FVector2D* OutScreen, uint64_t* OutVisibleMask)
+{
+	const size_t Count = World.Num;
+	memset(OutVisibleMask, 0, ((Count + 63) / 64) * sizeof(uint64_t));
+
+	switch (GetSimdLevel())
+	{
+#if UE_MATH_X86
+	case ESimdLevel::AVX512:
+		return World.IsPacked() ? WorldToScreenAVX512<true>(Camera, World, OutScreen, OutVisibleMask, Count) : WorldToScreenAVX512<false>(Camera, World, OutScreen, OutVisibleMask, Count);
+	case ESimdLevel::AVX2:
+		return World.IsPacked() ? WorldToScreenAVX2<true>(Camera, World, OutScreen, OutVisibleMask, Count) : WorldToScreenAVX2<false>(Camera, World, OutScreen, OutVisibleMask, Count);
+#endif
+	default:
+		return WorldToScreenScalar(Camera, World, OutScreen, OutVisibleMask, 0, Count);
+	}
+}
+
+size_t FCamera::WorldToScreen(const FVector* World, FVector2D* OutScreen, uint64_t* OutVisibleMask, size_t Count, FTaskScheduler* Scheduler) const
+{
+	return WorldToScreen(FVectorArrayView(World, Count), OutScreen, OutVisibleMask, Scheduler);
+}
+
+size_t FCamera::WorldToScreen(const FVectorArrayView& World, FVector2D* OutScreen, uint64_t* OutVisibleMask, FTaskScheduler* Scheduler) const
+{
+	std::atomic<size_t> NumVisible(0);
+	ParallelFor(Scheduler, World.Num, GetParallelChunkSize(sizeof(FVector) + sizeof(FVector2D)), [&](size_t Begin, size_t End)
+	{
+		const FVectorArrayView Chunk(World.Data + Begin * World.Stride, End - Begin, World.Stride);
+		NumVisible.fetch_add(WorldToScreenDispatch(*this, Chunk, OutScreen + Begin, OutVisibleMask + Begin / 64), std::memory_order_relaxed);
+	});
+	return NumVisible.load(std::memory_order_relaxed);
+}
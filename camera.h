@@ -0,0 +1,57 @@
+#pragma once
+#include "ue4math.h"
+#include "vector.h"
+#include "rotator.h"
+#include "matrix.h"
+#include "frustum.h"
+#include "arrayview.h"
+
+/**
+ * Camera (location, rotation, horizontal FOV, viewport) with a cached view-projection matrix.
+ *
+ * The matrix maps a world point p, as a row vector (p, 1), straight to homogeneous viewport
+ * pixels: column 0 / column 3 is the screen X, column 1 / column 3 the screen Y, and column 3
+ * (also copied to column 2) is the distance along the view direction. All trigonometry
+ * happens in Update(); projecting a point is one matrix row sweep and a divide.
+ */
+struct FCamera
+{
+public:
+	FVector Location;
+	FRotator Rotation;
+	double FOV;				/* Horizontal field of view in degrees */
+	double ViewportWidth;
+	double ViewportHeight;
+	double NearPlane;		/* Points closer than this along the view direction are not visible */
+
+	FCamera();
+	FCamera(const FVector& Location, const FRotator& Rotation, double FOV, double ViewportWidth, double ViewportHeight);
+
+	/** Rebuilds the cached matrix; call after changing any of the fields above. */
+	void Update();
+
+	const FMatrix& GetViewProjectionMatrix() const { return ViewProjection; }
+
+	/** The visible volume, for culling bounds before projecting what they contain. Open at the back unless FarPlane > NearPlane. */
+	FFrustum GetFrustum(double FarPlane = 0.0) const { return FFrustum(ViewProjection, ViewportWidth, ViewportHeight, NearPlane, FarPlane); }
+
+	/** Projects one point. @return false if it is behind the near plane (OutScreen is still written) */
+	bool WorldToScreen(const FVector& World, FVector2D& OutScreen) const;
+
+	/**
+	 * Projects Count points. Bit i of OutVisibleMask (an array of (Count + 63) / 64 words) is set
+	 * when point i is in front of the near plane; points behind it still get a finite OutScreen
+	 * value, computed against the near plane distance, so no lane needs a branch.
+	 * Uses AVX-512 or AVX2 per GetSimdLevel(), and with a Scheduler splits batches of more than a
+	 * few cache-sized chunks over its threads.
+	 *
+	 * @return number of visible points
+	 */
+	size_t WorldToScreen(const FVector* World, FVector2D* OutScreen, uint64_t* OutVisibleMask, size_t Count, FTaskScheduler* Scheduler = nullptr) const;
+
+	/** WorldToScreen over World.Num points read in place at the view's stride, e.g. the translations of a bone array. */
+	size_t WorldToScreen(const FVectorArrayView& World, FVector2D* OutScreen, uint64_t* OutVisibleMask, FTaskScheduler* Scheduler = nullptr) const;
+
+private:
+	FMatrix ViewProjection;
+};
@@ -0,0 +1,103 @@
+#include "cpu.h"
+
+#if UE_MATH_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#if UE_MATH_X86
+static void CpuId(uint32_t Leaf, uint32_t SubLeaf, uint32_t Regs[4])
+{
+#if defined(_MSC_VER)
+	int Info[4];
+	__cpuidex(Info, (int)Leaf, (int)SubLeaf);
+	for (int i = 0; i < 4; ++i)
+		Regs[i] = (uint32_t)Info[i];
+#else
+	__cpuid_count(Leaf, SubLeaf, Regs[0], Regs[1], Regs[2], Regs[3]);
+#endif
+}
+
+static uint64_t ReadXCR0()
+{
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#else
+	uint32_t Lo, Hi;
+	__asm__ volatile("xgetbv" : "=a"(Lo), "=d"(Hi) : "c"(0));
+	return ((uint64_t)Hi << 32) | Lo;
+#endif
+}
+#endif
+
+static ESimdLevel DetectSimdLevel()
+{
+#if UE_MATH_X86
+	uint32_t Regs[4];
+	CpuId(0, 0, Regs);
+	const uint32_t MaxLeaf = Regs[0];
+	if (MaxLeaf < 7)
+		return ESimdLevel::Scalar;
+
+	CpuId(1, 0, Regs);
+	const bool bOSXSave = (Regs[2] & (1u << 27)) != 0;
+	const bool bAVX = (Regs[2] & (1u << 28)) != 0;
+	const bool bFMA = (Regs[2] & (1u << 12)) != 0;
+	if (!bOSXSave || !bAVX)
+		return ESimdLevel::Scalar;
+
+	// The OS has to save YMM (and for AVX-512 also opmask/ZMM) state on context switch
+	const uint64_t XCR0 = ReadXCR0();
+	const bool bYmmState = (XCR0 & 0x6) == 0x6;
+	const bool bZmmState = (XCR0 & 0xE6) == 0xE6;
+
+	CpuId(7, 0, Regs);
+	const bool bAVX2 = (Regs[1] & (1u << 5)) != 0;
+	const bool bAVX512F = (Regs[1] & (1u << 16)) != 0;
+	const bool bAVX512DQ = (Regs[1] & (1u << 17)) != 0;
+	const bool bAVX512VL = (Regs[1] & (1u << 31)) != 0;
+
+	if (!bYmmState || !bAVX2 || !bFMA)
+		return ESimdLevel::Scalar;
+	if (bZmmState && bAVX512F && bAVX512DQ && bAVX512VL)
+		return ESimdLevel::AVX512;
+	return ESimdLevel::AVX2;
+#else
+	return ESimdLevel::Scalar;
+#endif
+}
+
+ESimdLevel GetSupportedSimdLevel()
+{
+	static const ESimdLevel Supported = DetectSimdLevel();
+	return Supported;
+}
+
+static ESimdLevel& ActiveSimdLevel()
+{
+	static ESimdLevel Active = GetSupportedSimdLevel();
+	return Active;
+}
+
+ESimdLevel GetSimdLevel()
+{
+	return ActiveSimdLevel();
+}
+
+void SetSimdLevel(ESimdLevel Level)
+{
+	ActiveSimdLevel() = std::min(Level, GetSupportedSimdLevel());
+}
+
+const char* GetSimdLevelName(ESimdLevel Level)
+{
+	switch (Level)
+	{
+	case ESimdLevel::AVX512: return "AVX512";
+	case ESimdLevel::AVX2: return "AVX2";
+	default: return "Scalar";
+	}
+}
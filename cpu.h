@@ -0,0 +1,61 @@
+#pragma once
+#include "ue4math.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define UE_MATH_X86 1
+#else
+#define UE_MATH_X86 0
+#endif
+
+/*-----------------------------------------------------------------------------
+	Per-function ISA targeting. GCC/Clang need the attribute to emit AVX code
+	from a translation unit built for the baseline ISA; MSVC accepts the
+	intrinsics anywhere.
+
+	GCC does not always emit vzeroupper when such a function calls or jumps
+	into baseline code (a scalar tail), and the SSE code that follows then
+	runs with dirty upper register state, several times slower on the CPUs
+	we measured. Kernels call _mm256_zeroupper() before handing over.
+-----------------------------------------------------------------------------*/
+#if UE_MATH_X86 && (defined(__GNUC__) || defined(__clang__))
+#define UE_TARGET_AVX2		__attribute__((target("avx2")))
+#define UE_TARGET_AVX2_FMA	__attribute__((target("avx2,fma")))
+#define UE_TARGET_AVX512	__attribute__((target("avx512f,avx512dq,avx512vl")))
+#else
+#define UE_TARGET_AVX2
+#define UE_TARGET_AVX2_FMA
+#define UE_TARGET_AVX512
+#endif
+
+/**
+ * Keeps the compiler from fusing separate multiply and add intrinsics into FMAs, for kernels
+ * that promise the same rounding as the scalar code. Clang contracts only within a single
+ * expression and MSVC leaves intrinsics alone, so only GCC needs telling.
+ */
+#if defined(__GNUC__) && !defined(__clang__)
+#define UE_NO_FP_CONTRACT	__attribute__((optimize("fp-contract=off")))
+#else
+#define UE_NO_FP_CONTRACT
+#endif
+
+/** Instruction set tiers the batch kernels are built for, in increasing order. */
+enum class ESimdLevel : uint8_t
+{
+	Scalar,
+	AVX2,		/* AVX2 + FMA */
+	AVX512,		/* AVX-512 F/DQ/VL */
+};
+
+/** Highest tier supported by both the CPU and the OS. Detected once, on first call. */
+ESimdLevel GetSupportedSimdLevel();
+
+/** Tier the batch kernels dispatch to. Defaults to GetSupportedSimdLevel(). */
+ESimdLevel GetSimdLevel();
+
+/**
+ * Restrict dispatch to at most Level (clamped to what the CPU supports).
+ * Meant for validation and A/B benchmarking; not thread-safe against running kernels.
+ */
+void SetSimdLevel(ESimdLevel Level);
+
+const char* GetSimdLevelName(ESimdLevel Level);
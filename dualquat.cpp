@@ -0,0 +1,107 @@
+#include "dualquat.h"
+#include "cpu.h"
+
+#if UE_MATH_X86
+#include <immintrin.h>
+#endif
+
+#if UE_MATH_X86
+UE_TARGET_AVX2 UE_NO_FP_CONTRACT static size_t TransformPositionsAVX2(const FQuat& Q, const FVector& Translation, FVectorSoA In, FVectorSoA Out, size_t Count)
+{
+	const __m256d QX = _mm256_set1_pd(Q.X);
+	const __m256d QY = _mm256_set1_pd(Q.Y);
+	const __m256d QZ = _mm256_set1_pd(Q.Z);
+	const __m256d QW = _mm256_set1_pd(Q.W);
+	const __m256d TX = _mm256_set1_pd(Translation.X);
+	const __m256d TY = _mm256_set1_pd(Translation.Y);
+	const __m256d TZ = _mm256_set1_pd(Translation.Z);
+	const __m256d Two = _mm256_set1_pd(2.0);
+
+	size_t i = 0;
+	for (; i + 4 <= Count; i += 4)
+	{
+		const __m256d VX = _mm256_loadu_pd(In.X + i);
+		const __m256d VY = _mm256_loadu_pd(In.Y + i);
+		const __m256d VZ = _mm256_loadu_pd(In.Z + i);
+
+		// T = (Q ^ V) * 2
+		const __m256d T0 = _mm256_mul_pd(_mm256_sub_pd(_mm256_mul_pd(QY, VZ), _mm256_mul_pd(QZ, VY)), Two);
+		const __m256d T1 = _mm256_mul_pd(_mm256_sub_pd(_mm256_mul_pd(QZ, VX), _mm256_mul_pd(QX, VZ)), Two);
+		const __m256d T2 = _mm256_mul_pd(_mm256_sub_pd(_mm256_mul_pd(QX, VY), _mm256_mul_pd(QY, VX)), Two);
+
+		// V + (T * W) + (Q ^ T) + Translation
+		__m256d RX = _mm256_add_pd(VX, _mm256_mul_pd(T0, QW));
+		__m256d RY = _mm256_add_pd(VY, _mm256_mul_pd(T1, QW));
+		__m256d RZ = _mm256_add_pd(VZ, _mm256_mul_pd(T2, QW));
+		RX = _mm256_add_pd(RX, _mm256_sub_pd(_mm256_mul_pd(QY, T2), _mm256_mul_pd(QZ, T1)));
+		RY = _mm256_add_pd(RY, _mm256_sub_pd(_mm256_mul_pd(QZ, T0), _mm256_mul_pd(QX, T2)));
+		RZ = _mm256_add_pd(RZ, _mm256_sub_pd(_mm256_mul_pd(QX, T1), _mm256_mul_pd(QY, T0)));
+
+		_mm256_storeu_pd(Out.X + i, _mm256_add_pd(RX, TX));
+		_mm256_storeu_pd(Out.Y + i, _mm256_add_pd(RY, TY));
+		_mm256_storeu_pd(Out.Z + i, _mm256_add_pd(RZ, TZ));
+	}
+	return i;
+}
+
+UE_TARGET_AVX512 UE_NO_FP_CONTRACT static size_t TransformPositionsAVX512(const FQuat& Q, const FVector& Translation, FVectorSoA In, FVectorSoA Out, size_t Count)
+{
+	const __m512d QX = _mm512_set1_pd(Q.X);
+	const __m512d QY = _mm512_set1_pd(Q.Y);
+	const __m512d QZ = _mm512_set1_pd(Q.Z);
+	const __m512d QW = _mm512_set1_pd(Q.W);
+	const __m512d TX = _mm512_set1_pd(Translation.X);
+	const __m512d TY = _mm512_set1_pd(Translation.Y);
+	const __m512d TZ = _mm512_set1_pd(Translation.Z);
+	const __m512d Two = _mm512_set1_pd(2.0);
+
+	size_t i = 0;
+	for (; i + 8 <= Count; i += 8)
+	{
+		const __m512d VX = _mm512_loadu_pd(In.X + i);
+		const __m512d VY = _mm512_loadu_pd(In.Y + i);
+		const __m512d VZ = _mm512_loadu_pd(In.Z + i);
+
+		const __m512d T0 = _mm512_mul_pd(_mm512_sub_pd(_mm512_mul_pd(QY, VZ), _mm512_mul_pd(QZ, VY)), Two);
+		const __m512d T1 = _mm512_mul_pd(_mm512_sub_pd(_mm512_mul_pd(QZ, VX), _mm512_mul_pd(QX, VZ)), Two);
+		const __m512d T2 = _mm512_mul_pd(_mm512_sub_pd(_mm512_mul_pd(QX, VY), _mm512_mul_pd(QY, VX)), Two);
+
+		__m512d RX = _mm512_add_pd(VX, _mm512_mul_pd(T0, QW));
+		__m512d RY = _mm512_add_pd(VY, _mm512_mul_pd(T1, QW));
+		__m512d RZ = _mm512_add_pd(VZ, _mm512_mul_pd(T2, QW));
+		RX = _mm512_add_pd(RX, _mm512_sub_pd(_mm512_mul_pd(QY, T2), _mm512_mul_pd(QZ, T1)));
+		RY = _mm512_add_pd(RY, _mm512_sub_pd(_mm512_mul_pd(QZ, T0), _mm512_mul_pd(QX, T2)));
+		RZ = _mm512_add_pd(RZ, _mm512_sub_pd(_mm512_mul_pd(QX, T1), _mm512_mul_pd(QY, T0)));
+
+		_mm512_storeu_pd(Out.X + i, _mm512_add_pd(RX, TX));
+		_mm512_storeu_pd(Out.Y + i, _mm512_add_pd(RY, TY));
+		_mm512_storeu_pd(Out.Z + i, _mm512_add_pd(RZ, TZ));
+	}
+	return i;
+}
+#endif
+
+void BatchTransformPositions(const FDualQuat& DualQuat, FVectorSoA In, FVectorSoA Out, size_t Count)
+{
+	const FVector Translation = DualQuat.GetTranslation();
+
+	size_t i = 0;
+	switch (GetSimdLevel())
+	{
+#if UE_MATH_X86
+	case ESimdLevel::AVX512:
+		i = TransformPositionsAVX512(DualQuat.Real, Translation, In, Out, Count);
+		break;
+	case ESimdLevel::AVX2:
+		i = TransformPositionsAVX2(DualQuat.Real, Translation, In, Out, Count);
+		break;
+#endif
+	default:
+		break;
+	}
+
+	for (; i < Count; ++i)
+	{
+		Out.Set(i, DualQuat.Real.RotateVector(In.Get(i)) + Translation);
+	}
+}
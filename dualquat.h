@@ -0,0 +1,122 @@
+#pragma once
+#include "ue4math.h"
+#include "mathfwd.h"
+#include "vector.h"
+#include "quat.h"
+#include "transform.h"
+#include "batch.h"
+
+/**
+ * Unit dual quaternion Real + e * Dual: a rotation and translation without scale, in 8 reals
+ * against FMatrix's 16 and FTransform's 12. Real is the rotation; Dual is half the translation
+ * (as a quaternion with W = 0) times Real, so each part composes with one quaternion product.
+ *
+ * Blending dual quaternions linearly and normalizing (DLB, Kavan et al. 2008) interpolates the
+ * rotation and translation together and keeps rigid transforms rigid, without the shrinking
+ * that blending matrices gives at twisted joints.
+ */
+template<typename T>
+struct alignas(16) TDualQuat
+{
+public:
+	using FReal = T;
+
+	TQuat<T>                                            Real;
+	TQuat<T>                                            Dual;
+
+	/** The identity. */
+	constexpr TDualQuat() : Real(), Dual(0, 0, 0, 0) {}
+	constexpr TDualQuat(const TQuat<T>& Real, const TQuat<T>& Dual) : Real(Real), Dual(Dual) {}
+
+	/** Rotation then translation, as FTransform. Rotation should be normalized. */
+	TDualQuat(const TQuat<T>& Rotation, const TVector<T>& Translation)
+		: Real(Rotation), Dual(TQuat<T>(Translation.X, Translation.Y, Translation.Z, 0) * Rotation * T(0.5))
+	{
+	}
+
+	/** Rotation and translation of Transform; its Scale3D is dropped, so convert only unscaled transforms. */
+	explicit TDualQuat(const TTransform<T>& Transform) : TDualQuat(Transform.Rotation, Transform.Translation) {}
+
+	TQuat<T> GetRotation() const { return Real; }
+
+	/** 2 * Dual * conjugate(Real), expanded. */
+	TVector<T> GetTranslation() const
+	{
+		const TVector<T> RealV(Real.X, Real.Y, Real.Z);
+		const TVector<T> DualV(Dual.X, Dual.Y, Dual.Z);
+		return (DualV * Real.W - RealV * Dual.W + (RealV ^ DualV)) * T(2);
+	}
+
+	/** The FTransform with this rotation and translation and unit scale. */
+	TTransform<T> ToTransform() const { return TTransform<T>(Real, GetTranslation(), TVector<T>(1, 1, 1)); }
+
+	TVector<T> TransformPosition(const TVector<T>& Position) const { return Real.RotateVector(Position) + GetTranslation(); }
+	TVector<T> TransformVector(const TVector<T>& Vector) const { return Real.RotateVector(Vector); }
+
+	/** This then Other, the order of FTransform::Multiply: FDualQuat(A) * FDualQuat(B) is FDualQuat(A * B). */
+	TDualQuat operator*(const TDualQuat& Other) const
+	{
+		return TDualQuat(Other.Real * Real, (Other.Real * Dual) + (Other.Dual * Real));
+	}
+
+	/** The inverse of a unit dual quaternion: both parts conjugated. */
+	constexpr TDualQuat Inverse() const { return TDualQuat(Real.Inverse(), Dual.Inverse()); }
+
+	/** Scales both parts to a unit Real and removes the part of Dual along Real, so it is a rigid transform again. */
+	void Normalize()
+	{
+		const T SquareSum = Real.SizeSquared();
+		if (SquareSum < T(SMALL_NUMBER))
+		{
+			*this = TDualQuat();
+			return;
+		}
+		const T Scale = InvSqrt(SquareSum);
+		Real *= Scale;
+		Dual *= Scale;
+		Dual -= Real * (Real | Dual);
+	}
+
+	TDualQuat GetNormalized() const
+	{
+		TDualQuat Result(*this);
+		Result.Normalize();
+		return Result;
+	}
+
+	/**
+	 * Dual quaternion linear blend of Count weighted transforms, normalized. Each one is flipped to
+	 * the hemisphere of the first so that Q and -Q, the same transform, add up instead of cancelling.
+	 */
+	static TDualQuat Blend(const TDualQuat* DualQuats, const T* Weights, size_t Count)
+	{
+		TDualQuat Result(TQuat<T>(0, 0, 0, 0), TQuat<T>(0, 0, 0, 0));
+		for (size_t i = 0; i < Count; ++i)
+		{
+			const T Weight = Select(DualQuats[0].Real | DualQuats[i].Real, Weights[i], -Weights[i]);
+			Result.Real += DualQuats[i].Real * Weight;
+			Result.Dual += DualQuats[i].Dual * Weight;
+		}
+		Result.Normalize();
+		return Result;
+	}
+
+	/** Blend of A and B by Alpha, from A at 0 to B at 1. */
+	static TDualQuat Blend(const TDualQuat& A, const TDualQuat& B, T Alpha)
+	{
+		const TDualQuat Pair[2] = { A, B };
+		const T Weights[2] = { T(1) - Alpha, Alpha };
+		return Blend(Pair, Weights, 2);
+	}
+};
+
+static_assert(sizeof(FDualQuat) == 64, "FDualQuat");
+static_assert(sizeof(FDualQuat4f) == 32, "FDualQuat4f");
+
+/**
+ * Out[i] = DualQuat.TransformPosition(In[i]) for every i in [0, Count). The translation is
+ * extracted once; the AVX-512 and AVX2 kernels (8 and 4 points per step) rotate with the
+ * operations of FQuat::RotateVector in the same order, so they match the scalar function bit
+ * for bit as long as it is not built with FMA contraction. Out may alias In.
+ */
+void BatchTransformPositions(const FDualQuat& DualQuat, FVectorSoA In, FVectorSoA Out, size_t Count);
@@ -0,0 +1,270 @@
+#include "frustum.h"
+#include "cpu.h"
+#include "parallel.h"
+
+#if UE_MATH_X86
+#include <immintrin.h>
+#endif
+
+FFrustum::FFrustum(const FMatrix& ViewProjection, double ViewportWidth, double ViewportHeight, double NearPlane, double FarPlane)
+	: Offsets(), NumPlanes(0)
+{
+	// Column j of the matrix is the linear function p -> (p | ColumnJ) + M[3][j]; each bound on the
+	// projected point is one such function >= 0 (Gribb and Hartmann)
+	const FMatrix& M = ViewProjection;
+	const FVector ColumnX(M.M[0][0], M.M[1][0], M.M[2][0]);
+	const FVector ColumnY(M.M[0][1], M.M[1][1], M.M[2][1]);
+	const FVector ColumnZ(M.M[0][2], M.M[1][2], M.M[2][2]);
+	const FVector ColumnW(M.M[0][3], M.M[1][3], M.M[2][3]);
+
+	AddPlane(ColumnX, M.M[3][0]);
+	AddPlane(ColumnW * ViewportWidth - ColumnX, M.M[3][3] * ViewportWidth - M.M[3][0]);
+	AddPlane(ColumnY, M.M[3][1]);
+	AddPlane(ColumnW * ViewportHeight - ColumnY, M.M[3][3] * ViewportHeight - M.M[3][1]);
+	AddPlane(ColumnZ, M.M[3][2] - NearPlane);
+	if (FarPlane > NearPlane)
+	{
+		AddPlane(-ColumnZ, FarPlane - M.M[3][2]);
+	}
+}
+
+void FFrustum::AddPlane(const FVector& Normal, double Offset)
+{
+	const double Length = Normal.Length();
+	if (NumPlanes == MaxPlanes || Length == 0.0)
+	{
+		return;
+	}
+
+	Normals[NumPlanes] = Normal * (1.0 / Length);
+	Offsets[NumPlanes] = Offset / Length;
+	NumPlanes++;
+}
+
+bool FFrustum::IntersectsPoint(const FVector& Point) const
+{
+	return IntersectsSphere(FSphere(Point, 0.0));
+}
+
+bool FFrustum::IntersectsSphere(const FSphere& Sphere) const
+{
+	for (int i = 0; i < NumPlanes; ++i)
+	{
+		if (!((Normals[i] | Sphere.Center) + Offsets[i] + Sphere.W >= 0.0))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool FFrustum::IntersectsBox(const FBox& Box) const
+{
+	const FVector Center = Box.GetCenter();
+	const FVector Extent = Box.GetExtent();
+	for (int i = 0; i < NumPlanes; ++i)
+	{
+		// Distance of the corner furthest along the normal
+		const FVector& N = Normals[i];
+		const double Reach = fabs(N.X) * Extent.X + fabs(N.Y) * Extent.Y + fabs(N.Z) * Extent.Z;
+		if (!((N | Center) + Offsets[i] + Reach >= 0.0))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+static inline bool Intersects(const FFrustum& Frustum, const FBox& Box) { return Frustum.IntersectsBox(Box); }
+static inline bool Intersects(const FFrustum& Frustum, const FSphere& Sphere) { return Frustum.IntersectsSphere(Sphere); }
+
+template<typename ShapeType>
+static size_t CullScalar(const FFrustum& Frustum, const ShapeType* Shapes, uint64_t* OutVisibleMask, size_t Begin, size_t Count)
+{
+	size_t NumVisible = 0;
+	for (size_t i = Begin; i < Count; ++i)
+	{
+		const bool bVisible = Intersects(Frustum, Shapes[i]);
+		OutVisibleMask[i >> 6] |= (uint64_t)bVisible << (i & 63);
+		NumVisible += bVisible;
+	}
+	return NumVisible;
+}
+
+/*-----------------------------------------------------------------------------
+	Vector kernels. The shapes are gathered straight from the AoS arrays; a
+	box becomes its center and extent, a sphere its center and radius, and
+	each plane narrows the lane mask of shapes still inside.
+-----------------------------------------------------------------------------*/
+
+#if UE_MATH_X86
+template<bool bBoxes, typename ShapeType>
+UE_TARGET_AVX2_FMA static size_t CullAVX2(const FFrustum& Frustum, const ShapeType* Shapes, uint64_t* OutVisibleMask, size_t Count)
+{
+	constexpr long long Stride = sizeof(ShapeType) / sizeof(double);
+	const __m256i Index = _mm256_set_epi64x(3 * Stride, 2 * Stride, Stride, 0);
+	const __m256d Half = _mm256_set1_pd(0.5);
+	const __m256d Zero = _mm256_setzero_pd();
+	const __m256d AbsMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+
+	size_t NumVisible = 0;
+	size_t i = 0;
+	for (; i + 4 <= Count; i += 4)
+	{
+		// Boxes: Min.X Min.Y Min.Z Max.X Max.Y Max.Z; spheres: Center.X Center.Y Center.Z W
+		const double* Src = (const double*)&Shapes[i];
+		const __m256d A0 = _mm256_i64gather_pd(Src + 0, Index, 8);
+		const __m256d A1 = _mm256_i64gather_pd(Src + 1, Index, 8);
+		const __m256d A2 = _mm256_i64gather_pd(Src + 2, Index, 8);
+		const __m256d A3 = _mm256_i64gather_pd(Src + 3, Index, 8);
+
+		__m256d CX, CY, CZ, EX, EY, EZ;
+		if (bBoxes)
+		{
+			const __m256d A4 = _mm256_i64gather_pd(Src + 4, Index, 8);
+			const __m256d A5 = _mm256_i64gather_pd(Src + 5, Index, 8);
+			CX = _mm256_mul_pd(_mm256_add_pd(A0, A3), Half);
+			CY = _mm256_mul_pd(_mm256_add_pd(A1, A4), Half);
+			CZ = _mm256_mul_pd(_mm256_add_pd(A2, A5), Half);
+			EX = _mm256_mul_pd(_mm256_sub_pd(A3, A0), Half);
+			EY = _mm256_mul_pd(_mm256_sub_pd(A4, A1), Half);
+			EZ = _mm256_mul_pd(_mm256_sub_pd(A5, A2), Half);
+		}
+		else
+		{
+			// The radius is the reach along any normal
+			CX = A0; CY = A1; CZ = A2;
+			EX = EY = EZ = A3;
+		}
+
+		__m256d Inside = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+		for (int Plane = 0; Plane < Frustum.NumPlanes; ++Plane)
+		{
+			const FVector& N = Frustum.Normals[Plane];
+			const __m256d NX = _mm256_set1_pd(N.X), NY = _mm256_set1_pd(N.Y), NZ = _mm256_set1_pd(N.Z);
+			__m256d Distance = _mm256_fmadd_pd(NX, CX, _mm256_fmadd_pd(NY, CY, _mm256_fmadd_pd(NZ, CZ, _mm256_set1_pd(Frustum.Offsets[Plane]))));
+			if (bBoxes)
+			{
+				Distance = _mm256_fmadd_pd(_mm256_and_pd(NX, AbsMask), EX, Distance);
+				Distance = _mm256_fmadd_pd(_mm256_and_pd(NY, AbsMask), EY, Distance);
+				Distance = _mm256_fmadd_pd(_mm256_and_pd(NZ, AbsMask), EZ, Distance);
+			}
+			else
+			{
+				Distance = _mm256_add_pd(Distance, EX);
+			}
+			Inside = _mm256_and_pd(Inside, _mm256_cmp_pd(Distance, Zero, _CMP_GE_OQ));
+		}
+
+		const uint64_t Bits = (uint64_t)_mm256_movemask_pd(Inside);
+		OutVisibleMask[i >> 6] |= Bits << (i & 63);
+		NumVisible += CountBits64(Bits);
+	}
+
+	_mm256_zeroupper();
+	return NumVisible + CullScalar(Frustum, Shapes, OutVisibleMask, i, Count);
+}
+
+template<bool bBoxes, typename ShapeType>
+UE_TARGET_AVX512 static size_t CullAVX512(const FFrustum& Frustum, const ShapeType* Shapes, uint64_t* OutVisibleMask, size_t Count)
+{
+	constexpr long long Stride = sizeof(ShapeType) / sizeof(double);
+	const __m512i Index = _mm512_set_epi64(7 * Stride, 6 * Stride, 5 * Stride, 4 * Stride, 3 * Stride, 2 * Stride, Stride, 0);
+	const __m512d Half = _mm512_set1_pd(0.5);
+	const __m512d Zero = _mm512_setzero_pd();
+
+	size_t NumVisible = 0;
+	size_t i = 0;
+	for (; i + 8 <= Count; i += 8)
+	{
+		const double* Src = (const double*)&Shapes[i];
+		const __m512d A0 = _mm512_i64gather_pd(Index, Src + 0, 8);
+		const __m512d A1 = _mm512_i64gather_pd(Index, Src + 1, 8);
+		const __m512d A2 = _mm512_i64gather_pd(Index, Src + 2, 8);
+		const __m512d A3 = _mm512_i64gather_pd(Index, Src + 3, 8);
+
+		__m512d CX, CY, CZ, EX, EY, EZ;
+		if (bBoxes)
+		{
+			const __m512d A4 = _mm512_i64gather_pd(Index, Src + 4, 8);
+			const __m512d A5 = _mm512_i64gather_pd(Index, Src + 5, 8);
+			CX = _mm512_mul_pd(_mm512_add_pd(A0, A3), Half);
+			CY = _mm512_mul_pd(_mm512_add_pd(A1, A4), Half);
+			CZ = _mm512_mul_pd(_mm512_add_pd(A2, A5), Half);
+			EX = _mm512_mul_pd(_mm512_sub_pd(A3, A0), Half);
+			EY = _mm512_mul_pd(_mm512_sub_pd(A4, A1), Half);
+			EZ = _mm512_mul_pd(_mm512_sub_pd(A5, A2), Half);
+		}
+		else
+		{
+			// The radius is the reach along any normal
+			CX = A0; CY = A1; CZ = A2;
+			EX = EY = EZ = A3;
+		}
+
+		__mmask8 Inside = 0xFF;
+		for (int Plane = 0; Plane < Frustum.NumPlanes; ++Plane)
+		{
+			const FVector& N = Frustum.Normals[Plane];
+			const __m512d NX = _mm512_set1_pd(N.X), NY = _mm512_set1_pd(N.Y), NZ = _mm512_set1_pd(N.Z);
+			__m512d Distance = _mm512_fmadd_pd(NX, CX, _mm512_fmadd_pd(NY, CY, _mm512_fmadd_pd(NZ, CZ, _mm512_set1_pd(Frustum.Offsets[Plane]))));
+			if (bBoxes)
+			{
+				Distance = _mm512_fmadd_pd(_mm512_abs_pd(NX), EX, Distance);
+				Distance = _mm512_fmadd_pd(_mm512_abs_pd(NY), EY, Distance);
+				Distance = _mm512_fmadd_pd(_mm512_abs_pd(NZ), EZ, Distance);
+			}
+			else
+			{
+				Distance = _mm512_add_pd(Distance, EX);
+			}
+			Inside = _mm512_mask_cmp_pd_mask(Inside, Distance, Zero, _CMP_GE_OQ);
+		}
+
+		OutVisibleMask[i >> 6] |= (uint64_t)Inside << (i & 63);
+		NumVisible += CountBits64(Inside);
+	}
+
+	_mm256_zeroupper();
+	return NumVisible + CullScalar(Frustum, Shapes, OutVisibleMask, i, Count);
+}
+#endif
+
+template<bool bBoxes, typename ShapeType>
+static size_t CullDispatch(const FFrustum& Frustum, const ShapeType* Shapes, uint64_t* OutVisibleMask, size_t Count)
+{
+	memset(OutVisibleMask, 0, ((Count + 63) / 64) * sizeof(uint64_t));
+
+	switch (GetSimdLevel())
+	{
+#if UE_MATH_X86
+	case ESimdLevel::AVX512:
+		return CullAVX512<bBoxes>(Frustum, Shapes, OutVisibleMask, Count);
+	case ESimdLevel::AVX2:
+		return CullAVX2<bBoxes>(Frustum, Shapes, OutVisibleMask, Count);
+#endif
+	default:
+		return CullScalar(Frustum, Shapes, OutVisibleMask, 0, Count);
+	}
+}
+
+template<bool bBoxes, typename ShapeType>
+static size_t CullParallel(const FFrustum& Frustum, const ShapeType* Shapes, uint64_t* OutVisibleMask, size_t Count, FTaskScheduler* Scheduler)
+{
+	std::atomic<size_t> NumVisible(0);
+	ParallelFor(Scheduler, Count, GetParallelChunkSize(sizeof(ShapeType)), [&](size_t Begin, size_t End)
+	{
+		NumVisible.fetch_add(CullDispatch<bBoxes>(Frustum, Shapes + Begin, OutVisibleMask + Begin / 64, End - Begin), std::memory_order_relaxed);
+	});
+	return NumVisible.load(std::memory_order_relaxed);
+}
+
+size_t FFrustum::CullBoxes(const FBox* Boxes, uint64_t* OutVisibleMask, size_t Count, FTaskScheduler* Scheduler) const
+{
+	return CullParallel<true>(*this, Boxes, OutVisibleMask, Count, Scheduler);
+}
+
+size_t FFrustum::CullSpheres(const FSphere* Spheres, uint64_t* OutVisibleMask, size_t Count, FTaskScheduler* Scheduler) const
+{
+	return CullParallel<false>(*this, Spheres, OutVisibleMask, Count, Scheduler);
+}
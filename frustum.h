@@ -0,0 +1,54 @@
+#pragma once
+#include "ue4math.h"
+#include "vector.h"
+#include "matrix.h"
+#include "bounds.h"
+
+/**
+ * Convex volume of up to six planes for visibility culling.
+ *
+ * Normals point inwards and are unit length, so (Normals[i] | P) + Offsets[i] is the signed
+ * distance of P from plane i, positive inside. Boxes and spheres are kept when they reach the
+ * inside of every plane; a box is tested through its corner furthest along each normal, so a
+ * box near a frustum corner can be kept without touching it, never culled while it does.
+ */
+struct FFrustum
+{
+public:
+	static constexpr int MaxPlanes = 6;
+
+	FVector Normals[MaxPlanes];
+	double Offsets[MaxPlanes];
+	int NumPlanes;
+
+	FFrustum() : Offsets(), NumPlanes(0) {}
+
+	/**
+	 * Planes of a view-projection matrix in the FCamera convention: a world point p as the row
+	 * vector (p, 1) maps to homogeneous viewport pixels with column 3 as the divisor and column
+	 * 2 as the distance along the view direction. Visible points have 0 <= x <= ViewportWidth,
+	 * 0 <= y <= ViewportHeight and a distance of at least NearPlane; FarPlane > NearPlane adds a
+	 * far plane, otherwise the frustum is open at the back.
+	 */
+	FFrustum(const FMatrix& ViewProjection, double ViewportWidth, double ViewportHeight, double NearPlane, double FarPlane = 0.0);
+
+	/** Adds a plane from a normal pointing inwards, of any length. Ignored when full or Normal is zero. */
+	void AddPlane(const FVector& Normal, double Offset);
+
+	bool IntersectsPoint(const FVector& Point) const;
+	bool IntersectsSphere(const FSphere& Sphere) const;
+	bool IntersectsBox(const FBox& Box) const;
+
+	/**
+	 * Culls Count boxes. Bit i of OutVisibleMask (an array of (Count + 63) / 64 words) is set when
+	 * IntersectsBox(Boxes[i]); IsValid is not looked at. Tests four (AVX2) or eight (AVX-512)
+	 * boxes per step per GetSimdLevel(). With a Scheduler, batches of more than a few
+	 * cache-sized chunks are split over its threads.
+	 *
+	 * @return number of visible boxes
+	 */
+	size_t CullBoxes(const FBox* Boxes, uint64_t* OutVisibleMask, size_t Count, FTaskScheduler* Scheduler = nullptr) const;
+
+	/** CullBoxes for spheres. */
+	size_t CullSpheres(const FSphere* Spheres, uint64_t* OutVisibleMask, size_t Count, FTaskScheduler* Scheduler = nullptr) const;
+};
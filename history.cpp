@@ -0,0 +1,204 @@
+#include "history.h"
+#include "interpolation.h"
+
+static inline FVector BlendSamples(const FVector& A, const FVector& B, double Alpha)
+{
+	return A + (B - A) * Alpha;
+}
+
+static inline FVector BlendScales(const FVector& A, const FVector& B, double Alpha)
+{
+	// The scale holds at the newest sample rather than extrapolating
+	return A + (B - A) * std::min(Alpha, 1.0);
+}
+
+static inline FTransform BlendSamples(const FTransform& A, const FTransform& B, double Alpha)
+{
+	return FTransform(FQuat::Slerp(A.Rotation, B.Rotation, Alpha), BlendSamples(A.Translation, B.Translation, Alpha), BlendScales(A.Scale3D, B.Scale3D, Alpha));
+}
+
+template<typename TSample>
+void TSampleHistory<TSample>::Init(size_t Capacity)
+{
+	Times.assign(Capacity, 0.0);
+	Samples.assign(Capacity, TSample());
+	Reset();
+}
+
+template<typename TSample>
+bool TSampleHistory<TSample>::AddSample(double Time, const TSample& Sample)
+{
+	const size_t Capacity = Times.size();
+	if (Capacity == 0)
+		return false;
+
+	if (NumSamples > 0)
+	{
+		const size_t Newest = Slot(NumSamples - 1);
+		if (!(Time >= Times[Newest]))
+			return false;
+		if (Time == Times[Newest])
+		{
+			Samples[Newest] = Sample;
+			return true;
+		}
+	}
+
+	size_t Target;
+	if (NumSamples < Capacity)
+	{
+		Target = Slot(NumSamples++);
+	}
+	else
+	{
+		Target = Head;
+		Head = Slot(1);
+	}
+	Times[Target] = Time;
+	Samples[Target] = Sample;
+	return true;
+}
+
+template<typename TSample>
+EHistorySample TSampleHistory<TSample>::FindSamples(double Time, double MaxExtrapolation, size_t& OutIndex0, size_t& OutIndex1, double& OutAlpha) const
+{
+	OutAlpha = 0.0;
+	if (NumSamples == 0)
+	{
+		OutIndex0 = OutIndex1 = 0;
+		return EHistorySample::Empty;
+	}
+
+	const size_t Last = NumSamples - 1;
+	if (!(Time > GetTime(0)))
+	{
+		OutIndex0 = OutIndex1 = 0;
+		return Time == GetTime(0) ? EHistorySample::Interpolated : EHistorySample::Clamped;
+	}
+
+	const double Newest = GetTime(Last);
+	if (Time >= Newest)
+	{
+		OutIndex0 = OutIndex1 = Last;
+		if (Time == Newest)
+			return EHistorySample::Interpolated;
+
+		double Elapsed = Time - Newest;
+		const bool bClamped = !(Elapsed <= MaxExtrapolation);
+		Elapsed = bClamped ? MaxExtrapolation : Elapsed;
+		if (Last == 0 || !(Elapsed > 0.0))
+			return EHistorySample::Clamped;
+
+		OutIndex0 = Last - 1;
+		OutAlpha = 1.0 + Elapsed / (Newest - GetTime(Last - 1));
+		return bClamped ? EHistorySample::Clamped : EHistorySample::Extrapolated;
+	}
+
+	// GetTime(Low) < Time < GetTime(High)
+	size_t Low = 0, High = Last;
+	while (High - Low > 1)
+	{
+		const size_t Mid = (Low + High) / 2;
+		if (GetTime(Mid) <= Time)
+			Low = Mid;
+		else
+			High = Mid;
+	}
+
+	const double Time0 = GetTime(Low);
+	if (Time == Time0)
+	{
+		OutIndex0 = OutIndex1 = Low;
+		return EHistorySample::Interpolated;
+	}
+	OutIndex0 = Low;
+	OutIndex1 = High;
+	OutAlpha = (Time - Time0) / (GetTime(High) - Time0);
+	return EHistorySample::Interpolated;
+}
+
+template<typename TSample>
+EHistorySample TSampleHistory<TSample>::Sample(double Time, TSample& OutSample, double MaxExtrapolation) const
+{
+	size_t Index0, Index1;
+	double Alpha;
+	const EHistorySample Result = FindSamples(Time, MaxExtrapolation, Index0, Index1, Alpha);
+	if (Result != EHistorySample::Empty)
+	{
+		OutSample = Index0 == Index1 ? GetSample(Index0) : BlendSamples(GetSample(Index0), GetSample(Index1), Alpha);
+	}
+	return Result;
+}
+
+template struct TSampleHistory<FVector>;
+template struct TSampleHistory<FTransform>;
+
+/*-----------------------------------------------------------------------------
+	Batch queries.
+-----------------------------------------------------------------------------*/
+
+// Entities per pass; one pass keeps its rotation pairs on the stack
+static const size_t HistoryBlockSize = 128;
+
+/** Stack space for one block of quaternions, left uninitialized. */
+union FHistoryQuatBlock
+{
+	FQuat Quats[HistoryBlockSize];
+	FHistoryQuatBlock() {}
+};
+
+void BatchSampleHistories(const FTransformHistory* Histories, size_t Count, double Time, FTransform* Out, EHistorySample* OutResults, double MaxExtrapolation, ETrigAccuracy Accuracy)
+{
+	FHistoryQuatBlock From, To;
+	double Alphas[HistoryBlockSize];
+	size_t Targets[HistoryBlockSize];
+
+	for (size_t Begin = 0; Begin < Count; Begin += HistoryBlockSize)
+	{
+		const size_t End = std::min(Begin + HistoryBlockSize, Count);
+
+		// Find every entity's pair and blend everything but the rotations
+		size_t NumBlends = 0;
+		for (size_t i = Begin; i < End; ++i)
+		{
+			const FTransformHistory& History = Histories[i];
+			size_t Index0, Index1;
+			double Alpha;
+			const EHistorySample Result = History.FindSamples(Time, MaxExtrapolation, Index0, Index1, Alpha);
+			if (OutResults)
+				OutResults[i] = Result;
+			if (Result == EHistorySample::Empty)
+				continue;
+			if (Index0 == Index1)
+			{
+				Out[i] = History.GetSample(Index0);
+				continue;
+			}
+
+			const FTransform& A = History.GetSample(Index0);
+			const FTransform& B = History.GetSample(Index1);
+			Out[i].Translation = BlendSamples(A.Translation, B.Translation, Alpha);
+			Out[i].Scale3D = BlendScales(A.Scale3D, B.Scale3D, Alpha);
+			From.Quats[NumBlends] = A.Rotation;
+			To.Quats[NumBlends] = B.Rotation;
+			Alphas[NumBlends] = Alpha;
+			Targets[NumBlends++] = i;
+		}
+
+		BatchSlerp(From.Quats, To.Quats, Alphas, From.Quats, NumBlends, Accuracy);
+		for (size_t Blend = 0; Blend < NumBlends; ++Blend)
+		{
+			Out[Targets[Blend]].Rotation = From.Quats[Blend];
+		}
+	}
+}
+
+void BatchSampleHistories(const FVectorHistory* Histories, size_t Count, double Time, FVector* Out, EHistorySample* OutResults, double MaxExtrapolation)
+{
+	for (size_t i = 0; i < Count; ++i)
+	{
+		const EHistorySample Result = Histories[i].Sample(Time, Out[i], MaxExtrapolation);
+		if (OutResults)
+			OutResults[i] = Result;
+	}
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include "ue4math.h"
+#include "vector.h"
+#include "quat.h"
+#include "transform.h"
+#include "trig.h"
+#include <vector>
+
+/** What TSampleHistory::Sample returned. */
+enum class EHistorySample : uint8_t
+{
+	Empty,			/* No samples; the output is left alone */
+	Interpolated,	/* Within the sampled span: between two samples, or on one */
+	Extrapolated,	/* After the newest sample, at the velocity between the last two */
+	Clamped,		/* Before the oldest sample, or later than MaxExtrapolation past the newest: held at that end */
+};
+
+/** Extrapolation past the newest sample that Sample allows by default, in the units of the timestamps (seconds). */
+static constexpr double DefaultMaxExtrapolation = 0.25;
+
+/**
+ * Timestamped samples of one entity's FVector or FTransform, the newest Capacity kept in a ring.
+ * The storage is allocated by Init; adding samples and querying never allocate.
+ *
+ * Samples are added in time order, possibly at irregular intervals. Sample(Time) interpolates
+ * between the samples around Time: translation and scale linearly, rotation with FQuat::Slerp.
+ * After the newest sample it extrapolates from the last two, continuing the translation
+ * velocity and the rotation along the same arc (the scale holds). One sample holds its value.
+ */
+template<typename TSample>
+struct TSampleHistory
+{
+public:
+	TSampleHistory() : Head(0), NumSamples(0) {}
+	explicit TSampleHistory(size_t Capacity) : Head(0), NumSamples(0) { Init(Capacity); }
+
+	/** Allocates room for Capacity samples and empties the history. */
+	void Init(size_t Capacity);
+
+	/** Empties the history, keeping the storage. */
+	void Reset() { Head = 0; NumSamples = 0; }
+
+	size_t GetCapacity() const { return Times.size(); }
+	size_t Num() const { return NumSamples; }
+
+	/** Index 0 is the oldest sample kept, Num() - 1 the newest. */
+	double GetTime(size_t Index) const { return Times[Slot(Index)]; }
+	const TSample& GetSample(size_t Index) const { return Samples[Slot(Index)]; }
+
+	/**
+	 * Appends a sample, dropping the oldest when full. A sample at the newest sample's time
+	 * replaces it.
+	 * @return false, leaving the history alone, if Time is before the newest sample or the capacity is 0
+	 */
+	bool AddSample(double Time, const TSample& Sample);
+
+	/** The value at Time; see EHistorySample. */
+	EHistorySample Sample(double Time, TSample& OutSample, double MaxExtrapolation = DefaultMaxExtrapolation) const;
+
+	/**
+	 * The samples to blend for Time: OutSample = Blend(GetSample(OutIndex0), GetSample(OutIndex1), OutAlpha),
+	 * with OutIndex0 == OutIndex1 and OutAlpha 0 when one sample is returned as it is.
+	 */
+	EHistorySample FindSamples(double Time, double MaxExtrapolation, size_t& OutIndex0, size_t& OutIndex1, double& OutAlpha) const;
+
+private:
+	size_t Slot(size_t Index) const { const size_t S = Head + Index; return S < Times.size() ? S : S - Times.size(); }
+
+	std::vector<double> Times;
+	std::vector<TSample> Samples;
+	size_t Head;		/* Slot of the oldest sample */
+	size_t NumSamples;
+};
+
+using FVectorHistory = TSampleHistory<FVector>;
+using FTransformHistory = TSampleHistory<FTransform>;
+
+/**
+ * Histories[i].Sample(Time, Out[i], MaxExtrapolation) for every i in [0, Count), for many entities
+ * sampled at one time (e.g. the server's view of every actor at a client's timestamp). The
+ * rotations are blended in blocks through the per-element BatchSlerp, so they are within 1e-14 of
+ * Sample per component (1e-8 with ETrigAccuracy::Fast); translations and scales are bit identical.
+ * Out[i] is left alone for an empty history. OutResults, if not null, receives each result.
+ */
+void BatchSampleHistories(const FTransformHistory* Histories, size_t Count, double Time, FTransform* Out, EHistorySample* OutResults = nullptr,
+	double MaxExtrapolation = DefaultMaxExtrapolation, ETrigAccuracy Accuracy = ETrigAccuracy::Precise);
+
+/** Histories[i].Sample(Time, Out[i], MaxExtrapolation) for every i in [0, Count). Bit identical to Sample. */
+void BatchSampleHistories(const FVectorHistory* Histories, size_t Count, double Time, FVector* Out, EHistorySample* OutResults = nullptr,
+	double MaxExtrapolation = DefaultMaxExtrapolation);
@@ -0,0 +1,506 @@
+#include "interpolation.h"
+#include "cpu.h"
+
+#if UE_MATH_X86
+#include <immintrin.h>
+#endif
+
+// Elements per pass of the trig based functions; one pass keeps its angles on the stack
+static const size_t InterpolationBlockSize = 128;
+
+/** Stack space for one block of quaternions. Left uninitialized, where an FQuat array would write the identity into every slot. */
+union FQuatBlock
+{
+	FQuat Quats[InterpolationBlockSize];
+	FQuatBlock() {}
+};
+
+/*-----------------------------------------------------------------------------
+	FastSlerp weights. With Alpha shared by the batch, the i-th factor of
+	each series is a constant times (Cosom - 1); Weights0 is the series for
+	1 - Alpha, Weights1 the one for Alpha, the last term already weighted.
+-----------------------------------------------------------------------------*/
+
+struct FFastSlerpWeights
+{
+	double Weights0[FAST_SLERP_TERMS];
+	double Weights1[FAST_SLERP_TERMS];
+	double Alpha0;
+	double Alpha1;
+
+	explicit FFastSlerpWeights(double Alpha) : Alpha0(1.0 - Alpha), Alpha1(Alpha)
+	{
+		for (int i = 1; i <= FAST_SLERP_TERMS; ++i)
+		{
+			const double Weight = (i == FAST_SLERP_TERMS ? FAST_SLERP_LAST_TERM_WEIGHT : 1.0) * FastSlerpReciprocals[i - 1];
+			Weights0[i - 1] = (Alpha0 * Alpha0 - (double)(i * i)) * Weight;
+			Weights1[i - 1] = (Alpha1 * Alpha1 - (double)(i * i)) * Weight;
+		}
+	}
+};
+
+static inline FQuat FastSlerpScalar(const FQuat& A, const FQuat& B, const FFastSlerpWeights& W)
+{
+	const double RawCosom = A | B;
+	const double CosomMinusOne = fabs(RawCosom) - 1.0;
+
+	double Series0 = 1.0, Series1 = 1.0;
+	for (int i = FAST_SLERP_TERMS - 1; i >= 0; --i)
+	{
+		Series0 = 1.0 + W.Weights0[i] * CosomMinusOne * Series0;
+		Series1 = 1.0 + W.Weights1[i] * CosomMinusOne * Series1;
+	}
+
+	const double Scale0 = W.Alpha0 * Series0;
+	const double Scale1 = Select(RawCosom, W.Alpha1 * Series1, -W.Alpha1 * Series1);
+	return ((A * Scale0) + (B * Scale1)).GetNormalized();
+}
+
+/*-----------------------------------------------------------------------------
+	Vector kernels. Quaternions are loaded four (AVX2) or eight (AVX-512) at
+	a time and transposed into X/Y/Z/W registers. With one Alpha for the
+	whole batch the lane order does not matter, as long as the store undoes
+	the same shuffle. Each returns how many elements it handled.
+-----------------------------------------------------------------------------*/
+
+#if UE_MATH_X86
+UE_TARGET_AVX2_FMA static inline void LoadQuatsAVX2(const FQuat* Q, __m256d& X, __m256d& Y, __m256d& Z, __m256d& W)
+{
+	const __m256d R0 = _mm256_loadu_pd(&Q[0].X);
+	const __m256d R1 = _mm256_loadu_pd(&Q[1].X);
+	const __m256d R2 = _mm256_loadu_pd(&Q[2].X);
+	const __m256d R3 = _mm256_loadu_pd(&Q[3].X);
+	const __m256d XZ01 = _mm256_unpacklo_pd(R0, R1);
+	const __m256d YW01 = _mm256_unpackhi_pd(R0, R1);
+	const __m256d XZ23 = _mm256_unpacklo_pd(R2, R3);
+	const __m256d YW23 = _mm256_unpackhi_pd(R2, R3);
+	X = _mm256_permute2f128_pd(XZ01, XZ23, 0x20);
+	Y = _mm256_permute2f128_pd(YW01, YW23, 0x20);
+	Z = _mm256_permute2f128_pd(XZ01, XZ23, 0x31);
+	W = _mm256_permute2f128_pd(YW01, YW23, 0x31);
+}
+
+UE_TARGET_AVX2_FMA static inline void StoreQuatsAVX2(FQuat* Q, __m256d X, __m256d Y, __m256d Z, __m256d W)
+{
+	const __m256d XZ01 = _mm256_permute2f128_pd(X, Z, 0x20);
+	const __m256d XZ23 = _mm256_permute2f128_pd(X, Z, 0x31);
+	const __m256d YW01 = _mm256_permute2f128_pd(Y, W, 0x20);
+	const __m256d YW23 = _mm256_permute2f128_pd(Y, W, 0x31);
+	_mm256_storeu_pd(&Q[0].X, _mm256_unpacklo_pd(XZ01, YW01));
+	_mm256_storeu_pd(&Q[1].X, _mm256_unpackhi_pd(XZ01, YW01));
+	_mm256_storeu_pd(&Q[2].X, _mm256_unpacklo_pd(XZ23, YW23));
+	_mm256_storeu_pd(&Q[3].X, _mm256_unpackhi_pd(XZ23, YW23));
+}
+
+/** Q / |Q|, or the identity where |Q|^2 < SMALL_NUMBER, as FQuat::Normalize does. */
+UE_TARGET_AVX2_FMA static inline void NormalizeQuatsAVX2(__m256d& X, __m256d& Y, __m256d& Z, __m256d& W)
+{
+	const __m256d SquareSum = _mm256_fmadd_pd(X, X, _mm256_fmadd_pd(Y, Y, _mm256_fmadd_pd(Z, Z, _mm256_mul_pd(W, W))));
+	const __m256d bValid = _mm256_cmp_pd(SquareSum, _mm256_set1_pd(SMALL_NUMBER), _CMP_GE_OQ);
+	const __m256d Scale = _mm256_and_pd(_mm256_div_pd(_mm256_set1_pd(1.0), _mm256_sqrt_pd(SquareSum)), bValid);
+	X = _mm256_mul_pd(X, Scale);
+	Y = _mm256_mul_pd(Y, Scale);
+	Z = _mm256_mul_pd(Z, Scale);
+	W = _mm256_blendv_pd(_mm256_set1_pd(1.0), _mm256_mul_pd(W, Scale), bValid);
+}
+
+UE_TARGET_AVX2_FMA static size_t NLerpAVX2(const FQuat* A, const FQuat* B, double Alpha, FQuat* Out, size_t Count)
+{
+	// Nothing for the vector loop: return before touching the wide registers at all
+	if (Count < 4)
+	{
+		return 0;
+	}
+
+	const __m256d Alpha1 = _mm256_set1_pd(Alpha);
+	const __m256d Alpha0 = _mm256_set1_pd(1.0 - Alpha);
+	const __m256d NegAlpha0 = _mm256_set1_pd(-(1.0 - Alpha));
+	const __m256d Zero = _mm256_setzero_pd();
+
+	size_t i = 0;
+	for (; i + 4 <= Count; i += 4)
+	{
+		__m256d AX, AY, AZ, AW, BX, BY, BZ, BW;
+		LoadQuatsAVX2(A + i, AX, AY, AZ, AW);
+		LoadQuatsAVX2(B + i, BX, BY, BZ, BW);
+
+		const __m256d Dot = _mm256_fmadd_pd(AX, BX, _mm256_fmadd_pd(AY, BY, _mm256_fmadd_pd(AZ, BZ, _mm256_mul_pd(AW, BW))));
+		const __m256d Scale0 = _mm256_blendv_pd(NegAlpha0, Alpha0, _mm256_cmp_pd(Dot, Zero, _CMP_GE_OQ));
+
+		__m256d X = _mm256_fmadd_pd(AX, Scale0, _mm256_mul_pd(BX, Alpha1));
+		__m256d Y = _mm256_fmadd_pd(AY, Scale0, _mm256_mul_pd(BY, Alpha1));
+		__m256d Z = _mm256_fmadd_pd(AZ, Scale0, _mm256_mul_pd(BZ, Alpha1));
+		__m256d W = _mm256_fmadd_pd(AW, Scale0, _mm256_mul_pd(BW, Alpha1));
+		NormalizeQuatsAVX2(X, Y, Z, W);
+		StoreQuatsAVX2(Out + i, X, Y, Z, W);
+	}
+	return i;
+}
+
+UE_TARGET_AVX2_FMA static size_t FastSlerpAVX2(const FQuat* A, const FQuat* B, const FFastSlerpWeights& Weights, FQuat* Out, size_t Count)
+{
+	if (Count < 4)
+	{
+		return 0;
+	}
+
+	const __m256d One = _mm256_set1_pd(1.0);
+	const __m256d Alpha0 = _mm256_set1_pd(Weights.Alpha0);
+	const __m256d Alpha1 = _mm256_set1_pd(Weights.Alpha1);
+	const __m256d SignMask = _mm256_set1_pd(-0.0);
+
+	size_t i = 0;
+	for (; i + 4 <= Count; i += 4)
+	{
+		__m256d AX, AY, AZ, AW, BX, BY, BZ, BW;
+		LoadQuatsAVX2(A + i, AX, AY, AZ, AW);
+		LoadQuatsAVX2(B + i, BX, BY, BZ, BW);
+
+		const __m256d RawCosom = _mm256_fmadd_pd(AX, BX, _mm256_fmadd_pd(AY, BY, _mm256_fmadd_pd(AZ, BZ, _mm256_mul_pd(AW, BW))));
+		const __m256d CosomMinusOne = _mm256_sub_pd(_mm256_andnot_pd(SignMask, RawCosom), One);
+
+		__m256d Series0 = One, Series1 = One;
+		for (int Term = FAST_SLERP_TERMS - 1; Term >= 0; --Term)
+		{
+			Series0 = _mm256_fmadd_pd(_mm256_mul_pd(_mm256_set1_pd(Weights.Weights0[Term]), CosomMinusOne), Series0, One);
+			Series1 = _mm256_fmadd_pd(_mm256_mul_pd(_mm256_set1_pd(Weights.Weights1[Term]), CosomMinusOne), Series1, One);
+		}
+
+		// Scale1 takes the sign of RawCosom (negative zero counts as positive, like Select)
+		const __m256d Scale0 = _mm256_mul_pd(Alpha0, Series0);
+		const __m256d Scale1 = _mm256_mul_pd(Alpha1, Series1);
+		const __m256d Sign = _mm256_andnot_pd(_mm256_cmp_pd(RawCosom, _mm256_setzero_pd(), _CMP_GE_OQ), SignMask);
+		const __m256d SignedScale1 = _mm256_xor_pd(Scale1, Sign);
+
+		__m256d X = _mm256_fmadd_pd(AX, Scale0, _mm256_mul_pd(BX, SignedScale1));
+		__m256d Y = _mm256_fmadd_pd(AY, Scale0, _mm256_mul_pd(BY, SignedScale1));
+		__m256d Z = _mm256_fmadd_pd(AZ, Scale0, _mm256_mul_pd(BZ, SignedScale1));
+		__m256d W = _mm256_fmadd_pd(AW, Scale0, _mm256_mul_pd(BW, SignedScale1));
+		NormalizeQuatsAVX2(X, Y, Z, W);
+		StoreQuatsAVX2(Out + i, X, Y, Z, W);
+	}
+	return i;
+}
+
+UE_TARGET_AVX512 static inline void LoadQuatsAVX512(const FQuat* Q, __m512d& X, __m512d& Y, __m512d& Z, __m512d& W)
+{
+	// Two quaternions per register; the unpacks gather X/Z and Y/W pairs, the permutes the rest
+	const __m512d R0 = _mm512_loadu_pd(&Q[0].X);
+	const __m512d R1 = _mm512_loadu_pd(&Q[2].X);
+	const __m512d R2 = _mm512_loadu_pd(&Q[4].X);
+	const __m512d R3 = _mm512_loadu_pd(&Q[6].X);
+	const __m512d XZ0 = _mm512_unpacklo_pd(R0, R1);
+	const __m512d YW0 = _mm512_unpackhi_pd(R0, R1);
+	const __m512d XZ1 = _mm512_unpacklo_pd(R2, R3);
+	const __m512d YW1 = _mm512_unpackhi_pd(R2, R3);
+	const __m512i Even = _mm512_set_epi64(13, 12, 9, 8, 5, 4, 1, 0);
+	const __m512i Odd = _mm512_set_epi64(15, 14, 11, 10, 7, 6, 3, 2);
+	X = _mm512_permutex2var_pd(XZ0, Even, XZ1);
+	Z = _mm512_permutex2var_pd(XZ0, Odd, XZ1);
+	Y = _mm512_permutex2var_pd(YW0, Even, YW1);
+	W = _mm512_permutex2var_pd(YW0, Odd, YW1);
+}
+
+UE_TARGET_AVX512 static inline void StoreQuatsAVX512(FQuat* Q, __m512d X, __m512d Y, __m512d Z, __m512d W)
+{
+	const __m512i Low = _mm512_set_epi64(11, 10, 3, 2, 9, 8, 1, 0);
+	const __m512i High = _mm512_set_epi64(15, 14, 7, 6, 13, 12, 5, 4);
+	const __m512d XZ0 = _mm512_permutex2var_pd(X, Low, Z);
+	const __m512d XZ1 = _mm512_permutex2var_pd(X, High, Z);
+	const __m512d YW0 = _mm512_permutex2var_pd(Y, Low, W);
+	const __m512d YW1 = _mm512_permutex2var_pd(Y, High, W);
+	_mm512_storeu_pd(&Q[0].X, _mm512_unpacklo_pd(XZ0, YW0));
+	_mm512_storeu_pd(&Q[2].X, _mm512_unpackhi_pd(XZ0, YW0));
+	_mm512_storeu_pd(&Q[4].X, _mm512_unpacklo_pd(XZ1, YW1));
+	_mm512_storeu_pd(&Q[6].X, _mm512_unpackhi_pd(XZ1, YW1));
+}
+
+UE_TARGET_AVX512 static inline void NormalizeQuatsAVX512(__m512d& X, __m512d& Y, __m512d& Z, __m512d& W)
+{
+	const __m512d SquareSum = _mm512_fmadd_pd(X, X, _mm512_fmadd_pd(Y, Y, _mm512_fmadd_pd(Z, Z, _mm512_mul_pd(W, W))));
+	const __mmask8 bValid = _mm512_cmp_pd_mask(SquareSum, _mm512_set1_pd(SMALL_NUMBER), _CMP_GE_OQ);
+	const __m512d Scale = _mm512_maskz_div_pd(bValid, _mm512_set1_pd(1.0), _mm512_sqrt_pd(SquareSum));
+	X = _mm512_mul_pd(X, Scale);
+	Y = _mm512_mul_pd(Y, Scale);
+	Z = _mm512_mul_pd(Z, Scale);
+	W = _mm512_mask_mul_pd(_mm512_set1_pd(1.0), bValid, W, Scale);
+}
+
+UE_TARGET_AVX512 static size_t NLerpAVX512(const FQuat* A, const FQuat* B, double Alpha, FQuat* Out, size_t Count)
+{
+	if (Count < 8)
+	{
+		return 0;
+	}
+
+	const __m512d Alpha1 = _mm512_set1_pd(Alpha);
+	const __m512d Alpha0 = _mm512_set1_pd(1.0 - Alpha);
+	const __m512d NegAlpha0 = _mm512_set1_pd(-(1.0 - Alpha));
+
+	size_t i = 0;
+	for (; i + 8 <= Count; i += 8)
+	{
+		__m512d AX, AY, AZ, AW, BX, BY, BZ, BW;
+		LoadQuatsAVX512(A + i, AX, AY, AZ, AW);
+		LoadQuatsAVX512(B + i, BX, BY, BZ, BW);
+
+		const __m512d Dot = _mm512_fmadd_pd(AX, BX, _mm512_fmadd_pd(AY, BY, _mm512_fmadd_pd(AZ, BZ, _mm512_mul_pd(AW, BW))));
+		const __m512d Scale0 = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(Dot, _mm512_setzero_pd(), _CMP_GE_OQ), NegAlpha0, Alpha0);
+
+		__m512d X = _mm512_fmadd_pd(AX, Scale0, _mm512_mul_pd(BX, Alpha1));
+		__m512d Y = _mm512_fmadd_pd(AY, Scale0, _mm512_mul_pd(BY, Alpha1));
+		__m512d Z = _mm512_fmadd_pd(AZ, Scale0, _mm512_mul_pd(BZ, Alpha1));
+		__m512d W = _mm512_fmadd_pd(AW, Scale0, _mm512_mul_pd(BW, Alpha1));
+		NormalizeQuatsAVX512(X, Y, Z, W);
+		StoreQuatsAVX512(Out + i, X, Y, Z, W);
+	}
+	return i;
+}
+
+UE_TARGET_AVX512 static size_t FastSlerpAVX512(const FQuat* A, const FQuat* B, const FFastSlerpWeights& Weights, FQuat* Out, size_t Count)
+{
+	if (Count < 8)
+	{
+		return 0;
+	}
+
+	const __m512d One = _mm512_set1_pd(1.0);
+	const __m512d Alpha0 = _mm512_set1_pd(Weights.Alpha0);
+	const __m512d Alpha1 = _mm512_set1_pd(Weights.Alpha1);
+
+	size_t i = 0;
+	for (; i + 8 <= Count; i += 8)
+	{
+		__m512d AX, AY, AZ, AW, BX, BY, BZ, BW;
+		LoadQuatsAVX512(A + i, AX, AY, AZ, AW);
+		LoadQuatsAVX512(B + i, BX, BY, BZ, BW);
+
+		const __m512d RawCosom = _mm512_fmadd_pd(AX, BX, _mm512_fmadd_pd(AY, BY, _mm512_fmadd_pd(AZ, BZ, _mm512_mul_pd(AW, BW))));
+		const __m512d CosomMinusOne = _mm512_sub_pd(_mm512_abs_pd(RawCosom), One);
+
+		__m512d Series0 = One, Series1 = One;
+		for (int Term = FAST_SLERP_TERMS - 1; Term >= 0; --Term)
+		{
+			Series0 = _mm512_fmadd_pd(_mm512_mul_pd(_mm512_set1_pd(Weights.Weights0[Term]), CosomMinusOne), Series0, One);
+			Series1 = _mm512_fmadd_pd(_mm512_mul_pd(_mm512_set1_pd(Weights.Weights1[Term]), CosomMinusOne), Series1, One);
+		}
+
+		const __m512d Scale0 = _mm512_mul_pd(Alpha0, Series0);
+		const __m512d Scale1 = _mm512_mul_pd(Alpha1, Series1);
+		const __mmask8 bNegative = _mm512_cmp_pd_mask(RawCosom, _mm512_setzero_pd(), _CMP_NGE_UQ);
+		const __m512d SignedScale1 = _mm512_mask_sub_pd(Scale1, bNegative, _mm512_setzero_pd(), Scale1);
+
+		__m512d X = _mm512_fmadd_pd(AX, Scale0, _mm512_mul_pd(BX, SignedScale1));
+		__m512d Y = _mm512_fmadd_pd(AY, Scale0, _mm512_mul_pd(BY, SignedScale1));
+		__m512d Z = _mm512_fmadd_pd(AZ, Scale0, _mm512_mul_pd(BZ, SignedScale1));
+		__m512d W = _mm512_fmadd_pd(AW, Scale0, _mm512_mul_pd(BW, SignedScale1));
+		NormalizeQuatsAVX512(X, Y, Z, W);
+		StoreQuatsAVX512(Out + i, X, Y, Z, W);
+	}
+	return i;
+}
+#endif
+
+/*-----------------------------------------------------------------------------
+	Trig based slerp. For a block of elements: the angle from the cosine
+	with BatchAtan2, then sin and cos of Alpha times it with BatchSinCos, and
+	sin((1 - Alpha) * Angle) from the difference formula, so one sincos per
+	element covers both weights.
+-----------------------------------------------------------------------------*/
+
+/**
+ * Slerp_NotNormalized (bShortestPath) or SlerpFullPath_NotNormalized of N <= InterpolationBlockSize
+ * elements, normalized on request. Element i uses Alphas[i * AlphaStride], so a stride of 0 shares
+ * one Alpha. Out may alias A or B.
+ */
+static void SlerpBlock(const FQuat* A, const FQuat* B, const double* Alphas, size_t AlphaStride, FQuat* Out, size_t N, bool bShortestPath, bool bNormalize, ETrigAccuracy Accuracy)
+{
+	double Cosines[InterpolationBlockSize];
+	double Sines[InterpolationBlockSize];
+	double Angles[InterpolationBlockSize];
+	double SinAlphaAngles[InterpolationBlockSize];
+	double CosAlphaAngles[InterpolationBlockSize];
+
+	for (size_t i = 0; i < N; ++i)
+	{
+		const double RawCosom = A[i] | B[i];
+		const double Cosom = bShortestPath ? fabs(RawCosom) : std::clamp(RawCosom, -1.0, 1.0);
+		Cosines[i] = Cosom;
+		Sines[i] = sqrt((1.0 - Cosom) * (1.0 + Cosom));
+	}
+
+	BatchAtan2(Sines, Cosines, Angles, N, Accuracy);
+	for (size_t i = 0; i < N; ++i)
+	{
+		SinAlphaAngles[i] = Alphas[i * AlphaStride] * Angles[i];
+	}
+	BatchSinCos(SinAlphaAngles, SinAlphaAngles, CosAlphaAngles, N, Accuracy);
+
+	for (size_t i = 0; i < N; ++i)
+	{
+		const double Alpha = Alphas[i * AlphaStride];
+		const double Cosom = Cosines[i];
+		double Scale0, Scale1;
+		if (bShortestPath ? Cosom >= 0.9999 : Angles[i] < KINDA_SMALL_NUMBER)
+		{
+			// Too close for the angle to be accurate: a linear blend, or the first key for the full path
+			Scale0 = bShortestPath ? 1.0 - Alpha : 1.0;
+			Scale1 = bShortestPath ? Alpha : 0.0;
+		}
+		else if (Sines[i] < KINDA_SMALL_NUMBER)
+		{
+			// Antipodal on the full path: sin(Angle) is no divisor there, so blend linearly as Slerp_NotNormalized does
+			Scale0 = 1.0 - Alpha;
+			Scale1 = Alpha;
+		}
+		else
+		{
+			// sin((1 - Alpha) * Angle) = sin(Angle) * cos(Alpha * Angle) - cos(Angle) * sin(Alpha * Angle)
+			Scale1 = SinAlphaAngles[i] / Sines[i];
+			Scale0 = CosAlphaAngles[i] - Cosom * Scale1;
+		}
+
+		if (bShortestPath)
+		{
+			Scale1 = Select(A[i] | B[i], Scale1, -Scale1);
+		}
+
+		const FQuat Result = (A[i] * Scale0) + (B[i] * Scale1);
+		Out[i] = bNormalize ? Result.GetNormalized() : Result;
+	}
+}
+
+/*-----------------------------------------------------------------------------
+	Public entry points.
+-----------------------------------------------------------------------------*/
+
+void BatchSlerp(const FQuat* A, const FQuat* B, double Alpha, FQuat* Out, size_t Count, ETrigAccuracy Accuracy)
+{
+	for (size_t Begin = 0; Begin < Count; Begin += InterpolationBlockSize)
+	{
+		const size_t N = std::min(InterpolationBlockSize, Count - Begin);
+		SlerpBlock(A + Begin, B + Begin, &Alpha, 0, Out + Begin, N, true, true, Accuracy);
+	}
+}
+
+void BatchSlerp(const FQuat* A, const FQuat* B, const double* Alpha, FQuat* Out, size_t Count, ETrigAccuracy Accuracy)
+{
+	for (size_t Begin = 0; Begin < Count; Begin += InterpolationBlockSize)
+	{
+		const size_t N = std::min(InterpolationBlockSize, Count - Begin);
+		SlerpBlock(A + Begin, B + Begin, Alpha + Begin, 1, Out + Begin, N, true, true, Accuracy);
+	}
+}
+
+void BatchFastSlerp(const FQuat* A, const FQuat* B, double Alpha, FQuat* Out, size_t Count)
+{
+	const FFastSlerpWeights Weights(Alpha);
+
+	size_t i = 0;
+	switch (GetSimdLevel())
+	{
+#if UE_MATH_X86
+	case ESimdLevel::AVX512:
+		i = FastSlerpAVX512(A, B, Weights, Out, Count);
+		break;
+	case ESimdLevel::AVX2:
+		i = FastSlerpAVX2(A, B, Weights, Out, Count);
+		break;
+#endif
+	default:
+		break;
+	}
+
+	for (; i < Count; ++i)
+	{
+		Out[i] = FastSlerpScalar(A[i], B[i], Weights);
+	}
+}
+
+void BatchNLerp(const FQuat* A, const FQuat* B, double Alpha, FQuat* Out, size_t Count)
+{
+	size_t i = 0;
+	switch (GetSimdLevel())
+	{
+#if UE_MATH_X86
+	case ESimdLevel::AVX512:
+		i = NLerpAVX512(A, B, Alpha, Out, Count);
+		break;
+	case ESimdLevel::AVX2:
+		i = NLerpAVX2(A, B, Alpha, Out, Count);
+		break;
+#endif
+	default:
+		break;
+	}
+
+	for (; i < Count; ++i)
+	{
+		Out[i] = FQuat::NLerp(A[i], B[i], Alpha);
+	}
+}
+
+void BatchSquad(const FQuat* P, const FQuat* TangentP, const FQuat* Q, const FQuat* TangentQ, double Alpha, FQuat* Out, size_t Count, ETrigAccuracy Accuracy)
+{
+	FQuatBlock Q1, Q2;
+	const double SquadAlpha = 2.0 * Alpha * (1.0 - Alpha);
+
+	for (size_t Begin = 0; Begin < Count; Begin += InterpolationBlockSize)
+	{
+		const size_t N = std::min(InterpolationBlockSize, Count - Begin);
+		SlerpBlock(P + Begin, Q + Begin, &Alpha, 0, Q1.Quats, N, true, false, Accuracy);
+		SlerpBlock(TangentP + Begin, TangentQ + Begin, &Alpha, 0, Q2.Quats, N, false, false, Accuracy);
+		SlerpBlock(Q1.Quats, Q2.Quats, &SquadAlpha, 0, Out + Begin, N, false, true, Accuracy);
+	}
+}
+
+void BatchBlendTransforms(const FTransform* A, const FTransform* B, double Alpha, FTransform* Out, size_t Count, EQuatInterpolation RotationInterpolation)
+{
+	// The end points copy whole transforms, like FTransform::Blend
+	if (Alpha <= ZERO_ANIMWEIGHT_THRESH || Alpha >= 1.0 - ZERO_ANIMWEIGHT_THRESH)
+	{
+		const FTransform* Source = Alpha <= ZERO_ANIMWEIGHT_THRESH ? A : B;
+		if (Source != Out)
+		{
+			memmove((void*)Out, (const void*)Source, Count * sizeof(FTransform));
+		}
+		return;
+	}
+
+	FQuatBlock BlockA, BlockB;
+	FQuat* RotationsA = BlockA.Quats;
+	FQuat* RotationsB = BlockB.Quats;
+
+	for (size_t Begin = 0; Begin < Count; Begin += InterpolationBlockSize)
+	{
+		const size_t N = std::min(InterpolationBlockSize, Count - Begin);
+		for (size_t i = 0; i < N; ++i)
+		{
+			RotationsA[i] = A[Begin + i].Rotation;
+			RotationsB[i] = B[Begin + i].Rotation;
+		}
+
+		switch (RotationInterpolation)
+		{
+		case EQuatInterpolation::Slerp:
+			BatchSlerp(RotationsA, RotationsB, Alpha, RotationsA, N);
+			break;
+		case EQuatInterpolation::FastSlerp:
+			BatchFastSlerp(RotationsA, RotationsB, Alpha, RotationsA, N);
+			break;
+		default:
+			BatchNLerp(RotationsA, RotationsB, Alpha, RotationsA, N);
+			break;
+		}
+
+		for (size_t i = 0; i < N; ++i)
+		{
+			const FTransform& From = A[Begin + i];
+			const FTransform& To = B[Begin + i];
+			FTransform& Result = Out[Begin + i];
+			Result.Translation = Lerp(From.Translation, To.Translation, Alpha);
+			Result.Scale3D = Lerp(From.Scale3D, To.Scale3D, Alpha);
+			Result.Rotation = RotationsA[i];
+		}
+	}
+}
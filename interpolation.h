@@ -0,0 +1,57 @@
+#pragma once
+#include "ue4math.h"
+#include "mathfwd.h"
+#include "quat.h"
+#include "transform.h"
+#include "trig.h"
+
+/*-----------------------------------------------------------------------------
+	Batch quaternion and transform interpolation.
+
+	Each function blends A[i] towards B[i] by one Alpha shared by the whole
+	batch, the common case of sampling every bone or camera between two
+	snapshots. Inputs should be normalized quaternions. Out may alias any
+	input array.
+-----------------------------------------------------------------------------*/
+
+/** How BatchBlendTransforms interpolates the rotations, from cheapest to most exact. */
+enum class EQuatInterpolation : uint8_t
+{
+	NLerp,		/* FQuat::NLerp, what FTransform::Blend uses */
+	FastSlerp,	/* FQuat::FastSlerp */
+	Slerp,		/* FQuat::Slerp */
+};
+
+/**
+ * Out[i] = FQuat::Slerp(A[i], B[i], Alpha). The angles go through BatchAtan2 and BatchSinCos a
+ * block at a time; with ETrigAccuracy::Precise every component is within 1e-15 of FQuat::Slerp,
+ * with ETrigAccuracy::Fast within 1e-8.
+ */
+void BatchSlerp(const FQuat* A, const FQuat* B, double Alpha, FQuat* Out, size_t Count, ETrigAccuracy Accuracy = ETrigAccuracy::Precise);
+
+/**
+ * BatchSlerp with one Alpha per element, e.g. sampling many keyframe pairs at one time. An Alpha
+ * outside [0, 1] continues along the same arc, as Slerp does. Same error bounds.
+ */
+void BatchSlerp(const FQuat* A, const FQuat* B, const double* Alpha, FQuat* Out, size_t Count, ETrigAccuracy Accuracy = ETrigAccuracy::Precise);
+
+/**
+ * Out[i] = FQuat::FastSlerp(A[i], B[i], Alpha), within 5e-8 of Slerp per component. The series
+ * weights depend only on Alpha, so they are computed once per call. Vectorized per GetSimdLevel().
+ */
+void BatchFastSlerp(const FQuat* A, const FQuat* B, double Alpha, FQuat* Out, size_t Count);
+
+/** Out[i] = FQuat::NLerp(A[i], B[i], Alpha), to within a few ULP. Vectorized per GetSimdLevel(). */
+void BatchNLerp(const FQuat* A, const FQuat* B, double Alpha, FQuat* Out, size_t Count);
+
+/**
+ * Out[i] = FQuat::Squad(P[i], TangentP[i], Q[i], TangentQ[i], Alpha), within 1e-14 of it with ETrigAccuracy::Precise.
+ * Where a full path slerp meets (nearly) antipodal keys it blends them linearly instead of dividing by sin(pi).
+ */
+void BatchSquad(const FQuat* P, const FQuat* TangentP, const FQuat* Q, const FQuat* TangentQ, double Alpha, FQuat* Out, size_t Count, ETrigAccuracy Accuracy = ETrigAccuracy::Precise);
+
+/**
+ * Out[i].Blend(A[i], B[i], Alpha) with the rotations interpolated by RotationInterpolation, so the
+ * NLerp default matches FTransform::Blend. The translation and scale are bit identical to it.
+ */
+void BatchBlendTransforms(const FTransform* A, const FTransform* B, double Alpha, FTransform* Out, size_t Count, EQuatInterpolation RotationInterpolation = EQuatInterpolation::NLerp);
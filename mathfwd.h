@@ -0,0 +1,61 @@
+#pragma once
+
+/*-----------------------------------------------------------------------------
+	Forward declarations of the math templates and their aliases.
+	The F names keep their historic double precision meaning; the 3f/4f/44f
+	aliases are the float32 storage variants.
+-----------------------------------------------------------------------------*/
+
+template<typename T> struct TVector;
+template<typename T> struct TVector2;
+template<typename T> struct TQuat;
+template<typename T> struct TRotator;
+template<typename T> struct TMatrix;
+template<typename T> struct TTransform;
+template<typename T> struct TBox;
+template<typename T> struct TSphere;
+template<typename T> struct TDualQuat;
+template<typename T> struct TCachedTransform;
+
+using FVector = TVector<double>;
+using FVector3d = TVector<double>;
+using FVector3f = TVector<float>;
+
+using FVector2D = TVector2<double>;
+using FVector2d = TVector2<double>;
+using FVector2f = TVector2<float>;
+
+using FQuat = TQuat<double>;
+using FQuat4d = TQuat<double>;
+using FQuat4f = TQuat<float>;
+
+using FRotator = TRotator<double>;
+using FRotator3d = TRotator<double>;
+using FRotator3f = TRotator<float>;
+
+using FMatrix = TMatrix<double>;
+using FMatrix44d = TMatrix<double>;
+using FMatrix44f = TMatrix<float>;
+
+using FTransform = TTransform<double>;
+using FTransform3d = TTransform<double>;
+using FTransform3f = TTransform<float>;
+
+using FBox = TBox<double>;
+using FBox3d = TBox<double>;
+using FBox3f = TBox<float>;
+
+using FSphere = TSphere<double>;
+using FSphere3d = TSphere<double>;
+using FSphere3f = TSphere<float>;
+
+using FDualQuat = TDualQuat<double>;
+using FDualQuat4d = TDualQuat<double>;
+using FDualQuat4f = TDualQuat<float>;
+
+using FCachedTransform = TCachedTransform<double>;
+using FCachedTransform3d = TCachedTransform<double>;
+using FCachedTransform3f = TCachedTransform<float>;
+
+/** Thread pool the batch APIs can split their work over (see parallel.h). */
+struct FTaskScheduler;
@@ -1,82 +1,147 @@
 
 #include "matrix.h"
-#include "vector.h"
-#include "rotator.h"
-#include "transform.h"
+#include "cpu.h"
+#if !UE_MATH_HEADER_ONLY
+#include "matrix.inl"
+#endif
 
-FVector FMatrix::GetScaledAxisX() const { return FVector(M[0][0], M[0][1], M[0][2]); }
-FVector FMatrix::GetScaledAxisY() const { return FVector(M[1][0], M[1][1], M[1][2]); }
-FVector FMatrix::GetScaledAxisZ() const { return FVector(M[2][0], M[2][1], M[2][2]); }
+#if UE_MATH_X86
+#include <immintrin.h>
+#endif
 
-FVector FMatrix::GetOrigin() const { return FVector(_41, _42, _43); }
+template<typename T>
+using real4x4 = T[4][4];
+typedef real4x4<double> double4x4;
 
-FRotator FMatrix::GetRotator() const {
-    const FVector XAxis = GetScaledAxisX();
-    const FVector YAxis = GetScaledAxisY();
-    const FVector ZAxis = GetScaledAxisZ();
+#if UE_MATH_X86
+// Each result row is a linear combination of the rows of B weighted by one row of A:
+// R[i] = A[i][0] * B[0] + A[i][1] * B[1] + A[i][2] * B[2] + A[i][3] * B[3]
+// B stays in registers for the whole call, which also makes writing over either input safe.
 
-    FRotator r = FRotator(
-        atan2(XAxis.Z, sqrt(XAxis.X * XAxis.X + XAxis.Y * XAxis.Y)) * 180.0 / PI,
-        atan2(XAxis.Y, XAxis.X) * 180.0 / PI,
-        0
-    );
-
-    const FVector SYAxis = GetScaledAxisY();
-
-    r.Roll = atan2(ZAxis | SYAxis, YAxis | SYAxis) * 180.0 / PI;
-
-    return r;
-}
-
-FMatrix& FMatrix::operator=(const FTransform& t) { return *this = FTransform(t).ToMatrixWithScale(); }
-FMatrix::FMatrix(const FTransform& t) { operator=(t); }
-
-void FMatrix::SetAxis0(const FVector& Axis)
+UE_TARGET_AVX2_FMA static inline __m256d MatrixRowAVX2(const double* ARow, __m256d B0, __m256d B1, __m256d B2, __m256d B3)
 {
-    M[0][0] = Axis.X;
-    M[0][1] = Axis.Y;
-    M[0][2] = Axis.Z;
+    __m256d R = _mm256_mul_pd(_mm256_broadcast_sd(ARow + 0), B0);
+    R = _mm256_fmadd_pd(_mm256_broadcast_sd(ARow + 1), B1, R);
+    R = _mm256_fmadd_pd(_mm256_broadcast_sd(ARow + 2), B2, R);
+    R = _mm256_fmadd_pd(_mm256_broadcast_sd(ARow + 3), B3, R);
+    return R;
 }
 
-void FMatrix::SetAxis1(const FVector& Axis)
+UE_TARGET_AVX2_FMA static void MatrixMultiplyManyAVX2(double4x4* Out, const double4x4* A, size_t AStride, const double4x4* B, size_t BStride, size_t Count)
 {
-    M[1][0] = Axis.X;
-    M[1][1] = Axis.Y;
-    M[1][2] = Axis.Z;
-}
-
-void FMatrix::SetAxis2(const FVector& Axis)
-{
-    M[2][0] = Axis.X;
-    M[2][1] = Axis.Y;
-    M[2][2] = Axis.Z;
+    for (size_t n = 0; n < Count; ++n)
+    {
+        const double4x4& MA = A[n * AStride];
+        const double4x4& MB = B[n * BStride];
+        const __m256d B0 = _mm256_loadu_pd(MB[0]);
+        const __m256d B1 = _mm256_loadu_pd(MB[1]);
+        const __m256d B2 = _mm256_loadu_pd(MB[2]);
+        const __m256d B3 = _mm256_loadu_pd(MB[3]);
+        const __m256d R0 = MatrixRowAVX2(MA[0], B0, B1, B2, B3);
+        const __m256d R1 = MatrixRowAVX2(MA[1], B0, B1, B2, B3);
+        const __m256d R2 = MatrixRowAVX2(MA[2], B0, B1, B2, B3);
+        const __m256d R3 = MatrixRowAVX2(MA[3], B0, B1, B2, B3);
+        double4x4& MOut = Out[n];
+        _mm256_storeu_pd(MOut[0], R0);
+        _mm256_storeu_pd(MOut[1], R1);
+        _mm256_storeu_pd(MOut[2], R2);
+        _mm256_storeu_pd(MOut[3], R3);
+    }
 }
 
-FMatrix FMatrix::Inverse() const
+// Two result rows per 512 bit register: lanes 0-3 hold row i, lanes 4-7 row i + 1.
+UE_TARGET_AVX512 static void MatrixMultiplyManyAVX512(double4x4* Out, const double4x4* A, size_t AStride, const double4x4* B, size_t BStride, size_t Count)
 {
-    FMatrix Result;
+    const __m512i Splat0 = _mm512_set_epi64(4, 4, 4, 4, 0, 0, 0, 0);
+    const __m512i Splat1 = _mm512_set_epi64(5, 5, 5, 5, 1, 1, 1, 1);
+    const __m512i Splat2 = _mm512_set_epi64(6, 6, 6, 6, 2, 2, 2, 2);
+    const __m512i Splat3 = _mm512_set_epi64(7, 7, 7, 7, 3, 3, 3, 3);
 
-    // Check for zero scale matrix to invert
-    if (GetScaledAxisX().IsNearlyZero(SMALL_NUMBER) &&
-        GetScaledAxisY().IsNearlyZero(SMALL_NUMBER) &&
-        GetScaledAxisZ().IsNearlyZero(SMALL_NUMBER))
+    for (size_t n = 0; n < Count; ++n)
     {
-        // just set to zero - avoids unsafe inverse of zero and duplicates what QNANs were resulting in before (scaling away all children)
-        Result = FMatrix();
+        const double4x4& MA = A[n * AStride];
+        const double4x4& MB = B[n * BStride];
+        const __m512d B0 = _mm512_broadcast_f64x4(_mm256_loadu_pd(MB[0]));
+        const __m512d B1 = _mm512_broadcast_f64x4(_mm256_loadu_pd(MB[1]));
+        const __m512d B2 = _mm512_broadcast_f64x4(_mm256_loadu_pd(MB[2]));
+        const __m512d B3 = _mm512_broadcast_f64x4(_mm256_loadu_pd(MB[3]));
+        const __m512d A01 = _mm512_loadu_pd(MA[0]);
+        const __m512d A23 = _mm512_loadu_pd(MA[2]);
+
+        __m512d R01 = _mm512_mul_pd(_mm512_permutexvar_pd(Splat0, A01), B0);
+        __m512d R23 = _mm512_mul_pd(_mm512_permutexvar_pd(Splat0, A23), B0);
+        R01 = _mm512_fmadd_pd(_mm512_permutexvar_pd(Splat1, A01), B1, R01);
+        R23 = _mm512_fmadd_pd(_mm512_permutexvar_pd(Splat1, A23), B1, R23);
+        R01 = _mm512_fmadd_pd(_mm512_permutexvar_pd(Splat2, A01), B2, R01);
+        R23 = _mm512_fmadd_pd(_mm512_permutexvar_pd(Splat2, A23), B2, R23);
+        R01 = _mm512_fmadd_pd(_mm512_permutexvar_pd(Splat3, A01), B3, R01);
+        R23 = _mm512_fmadd_pd(_mm512_permutexvar_pd(Splat3, A23), B3, R23);
+
+        double4x4& MOut = Out[n];
+        _mm512_storeu_pd(MOut[0], R01);
+        _mm512_storeu_pd(MOut[2], R23);
     }
-    else
+}
+#endif
+
+/**
+ * Out[n] = A[n * AStride] * B[n * BStride]; a stride of 0 reuses the same matrix for every n.
+ * Only double has vector kernels; float matrices go through the scalar loop.
+ */
+template<typename T>
+static void MatrixMultiplyMany(real4x4<T>* Out, const real4x4<T>* A, size_t AStride, const real4x4<T>* B, size_t BStride, size_t Count)
+{
+#if UE_MATH_X86
+    if constexpr (std::is_same<T, double>::value)
     {
-        const double	Det = Determinant();
-
-        if (Det == 0.0)
+        switch (GetSimdLevel())
         {
-            Result = FMatrix();
-        }
-        else
-        {
-            VectorMatrixInverse(&Result, this);
+        case ESimdLevel::AVX512:
+            MatrixMultiplyManyAVX512(Out, A, AStride, B, BStride, Count);
+            return;
+        case ESimdLevel::AVX2:
+            MatrixMultiplyManyAVX2(Out, A, AStride, B, BStride, Count);
+            return;
+        default:
+            break;
         }
     }
+#endif
+    for (size_t n = 0; n < Count; ++n)
+    {
+        VectorMatrixMultiplyScalar<T>(&Out[n], &A[n * AStride], &B[n * BStride]);
+    }
+}
+
+#if !UE_MATH_HEADER_ONLY
+template<typename T>
+void VectorMatrixMultiply(void* Result, const void* Matrix1, const void* Matrix2)
+{
+    MatrixMultiplyMany<T>((real4x4<T>*)Result, (const real4x4<T>*)Matrix1, 0, (const real4x4<T>*)Matrix2, 0, 1);
+}
+
+template void VectorMatrixMultiply<float>(void* Result, const void* Matrix1, const void* Matrix2);
+template void VectorMatrixMultiply<double>(void* Result, const void* Matrix1, const void* Matrix2);
+#endif
+
+template<typename T>
+void TMatrix<T>::MultiplyBatch(TMatrix* Out, const TMatrix* A, const TMatrix& B, size_t Count)
+{
+    MatrixMultiplyMany<T>((real4x4<T>*)Out, (const real4x4<T>*)A, 1, (const real4x4<T>*)&B, 0, Count);
+}
+
+template<typename T>
+void TMatrix<T>::MultiplyBatch(TMatrix* Out, const TMatrix* A, const TMatrix* B, size_t Count)
+{
+    MatrixMultiplyMany<T>((real4x4<T>*)Out, (const real4x4<T>*)A, 1, (const real4x4<T>*)B, 1, Count);
+}
 
-    return Result;
-}
\ No newline at end of file
+#if !UE_MATH_HEADER_ONLY
+template struct TMatrix<float>;
+template struct TMatrix<double>;
+#else
+template void TMatrix<float>::MultiplyBatch(TMatrix<float>* Out, const TMatrix<float>* A, const TMatrix<float>& B, size_t Count);
+template void TMatrix<float>::MultiplyBatch(TMatrix<float>* Out, const TMatrix<float>* A, const TMatrix<float>* B, size_t Count);
+template void TMatrix<double>::MultiplyBatch(TMatrix<double>* Out, const TMatrix<double>* A, const TMatrix<double>& B, size_t Count);
+template void TMatrix<double>::MultiplyBatch(TMatrix<double>* Out, const TMatrix<double>* A, const TMatrix<double>* B, size_t Count);
+#endif
@@ -1,25 +1,43 @@
 #pragma once
 #include "ue4math.h"
+#include "mathfwd.h"
+#include "vector.h"
 
-struct FVector;
-struct FRotator;
-struct FTransform;
+/**
+ * Multiplies two 4x4 matrices of T, Result = Matrix1 * Matrix2. Result may alias either input.
+ * For double this uses the widest kernel GetSimdLevel() allows (AVX2/FMA or AVX-512 rows, scalar otherwise);
+ * the FMA kernels round each row sum once per term, so they can differ from the scalar path in the last bit.
+ * With UE_MATH_HEADER_ONLY it is always the scalar path, defined in matrix.inl.
+ */
+template<typename T = double>
+UE_MATH_INLINE void VectorMatrixMultiply(void* Result, const void* Matrix1, const void* Matrix2);
 
-struct FMatrix {
+/** Structure of a matrix as far as inversion is concerned, from cheapest to most expensive to invert. */
+enum class EMatrixClass : uint8_t
+{
+    Rigid,      /* Orthonormal 3x3 rotation plus translation: inverse is a transpose */
+    Affine,     /* Last column is (0, 0, 0, 1): only the 3x3 part needs a real inverse */
+    General,
+};
+
+template<typename T>
+struct TMatrix {
 public:
+    using FReal = T;
+
     union
     {
         struct
         {
-            double _11, _12, _13, _14;
-            double _21, _22, _23, _24;
-            double _31, _32, _33, _34;
-            double _41, _42, _43, _44;
+            T _11, _12, _13, _14;
+            T _21, _22, _23, _24;
+            T _31, _32, _33, _34;
+            T _41, _42, _43, _44;
         };
-        double M[4][4];
+        T M[4][4];
     };
 
-    FMatrix() {
+    TMatrix() {
         //Identity matrix
         _11 = 1.0; _12 = 0.0; _13 = 0.0; _14 = 0.0;
         _21 = 0.0; _22 = 1.0; _23 = 0.0; _24 = 0.0;
@@ -27,55 +45,38 @@ public:
         _41 = 0.0; _42 = 0.0; _43 = 0.0; _44 = 1.0;
     }
 
-    FMatrix MatrixMultiply(const FMatrix& M2) const {
-        const FMatrix& M1 = *this;
-        FMatrix mResult;
-        double x = M1.M[0][0];
-        double y = M1.M[0][1];
-        double z = M1.M[0][2];
-        double w = M1.M[0][3];
-        mResult.M[0][0] = (M2.M[0][0] * x) + (M2.M[1][0] * y) + (M2.M[2][0] * z) + (M2.M[3][0] * w);
-        mResult.M[0][1] = (M2.M[0][1] * x) + (M2.M[1][1] * y) + (M2.M[2][1] * z) + (M2.M[3][1] * w);
-        mResult.M[0][2] = (M2.M[0][2] * x) + (M2.M[1][2] * y) + (M2.M[2][2] * z) + (M2.M[3][2] * w);
-        mResult.M[0][3] = (M2.M[0][3] * x) + (M2.M[1][3] * y) + (M2.M[2][3] * z) + (M2.M[3][3] * w);
-        x = M1.M[1][0];
-        y = M1.M[1][1];
-        z = M1.M[1][2];
-        w = M1.M[1][3];
-        mResult.M[1][0] = (M2.M[0][0] * x) + (M2.M[1][0] * y) + (M2.M[2][0] * z) + (M2.M[3][0] * w);
-        mResult.M[1][1] = (M2.M[0][1] * x) + (M2.M[1][1] * y) + (M2.M[2][1] * z) + (M2.M[3][1] * w);
-        mResult.M[1][2] = (M2.M[0][2] * x) + (M2.M[1][2] * y) + (M2.M[2][2] * z) + (M2.M[3][2] * w);
-        mResult.M[1][3] = (M2.M[0][3] * x) + (M2.M[1][3] * y) + (M2.M[2][3] * z) + (M2.M[3][3] * w);
-        x = M1.M[2][0];
-        y = M1.M[2][1];
-        z = M1.M[2][2];
-        w = M1.M[2][3];
-        mResult.M[2][0] = (M2.M[0][0] * x) + (M2.M[1][0] * y) + (M2.M[2][0] * z) + (M2.M[3][0] * w);
-        mResult.M[2][1] = (M2.M[0][1] * x) + (M2.M[1][1] * y) + (M2.M[2][1] * z) + (M2.M[3][1] * w);
-        mResult.M[2][2] = (M2.M[0][2] * x) + (M2.M[1][2] * y) + (M2.M[2][2] * z) + (M2.M[3][2] * w);
-        mResult.M[2][3] = (M2.M[0][3] * x) + (M2.M[1][3] * y) + (M2.M[2][3] * z) + (M2.M[3][3] * w);
-        x = M1.M[3][0];
-        y = M1.M[3][1];
-        z = M1.M[3][2];
-        w = M1.M[3][3];
-        mResult.M[3][0] = (M2.M[0][0] * x) + (M2.M[1][0] * y) + (M2.M[2][0] * z) + (M2.M[3][0] * w);
-        mResult.M[3][1] = (M2.M[0][1] * x) + (M2.M[1][1] * y) + (M2.M[2][1] * z) + (M2.M[3][1] * w);
-        mResult.M[3][2] = (M2.M[0][2] * x) + (M2.M[1][2] * y) + (M2.M[2][2] * z) + (M2.M[3][2] * w);
-        mResult.M[3][3] = (M2.M[0][3] * x) + (M2.M[1][3] * y) + (M2.M[2][3] * z) + (M2.M[3][3] * w);
+    /** Explicit precision conversion, e.g. FMatrix44f(SomeFMatrix). */
+    template<typename U, typename = typename std::enable_if<!std::is_same<T, U>::value>::type>
+    explicit TMatrix(const TMatrix<U>& Other) {
+        for (int i = 0; i < 4; ++i)
+            for (int j = 0; j < 4; ++j)
+                M[i][j] = (T)Other.M[i][j];
+    }
+
+    TMatrix MatrixMultiply(const TMatrix& M2) const {
+        TMatrix mResult;
+        VectorMatrixMultiply<T>(&mResult, this, &M2);
         return mResult;
     }
 
-    FMatrix operator * (const FMatrix& v) const { return MatrixMultiply(v); }
+    /** Out[i] = A[i] * B for i in [0, Count), e.g. many model matrices against one shared view matrix. Out may alias A. */
+    static void MultiplyBatch(TMatrix* Out, const TMatrix* A, const TMatrix& B, size_t Count);
 
-    void RemoveScaling(double Tolerance = SMALL_NUMBER)
+    /** Out[i] = A[i] * B[i] for i in [0, Count). Out may alias A or B. */
+    static void MultiplyBatch(TMatrix* Out, const TMatrix* A, const TMatrix* B, size_t Count);
+
+    TMatrix operator * (const TMatrix& v) const { return MatrixMultiply(v); }
+
+    template<EMathPrecision Precision = EMathPrecision::Precise>
+    void RemoveScaling(T Tolerance = T(SMALL_NUMBER))
     {
         // For each row, find magnitude, and if its non-zero re-scale so its unit length.
-        const double SquareSum0 = (M[0][0] * M[0][0]) + (M[0][1] * M[0][1]) + (M[0][2] * M[0][2]);
-        const double SquareSum1 = (M[1][0] * M[1][0]) + (M[1][1] * M[1][1]) + (M[1][2] * M[1][2]);
-        const double SquareSum2 = (M[2][0] * M[2][0]) + (M[2][1] * M[2][1]) + (M[2][2] * M[2][2]);
-        const double Scale0 = Select(SquareSum0 - Tolerance, InvSqrt(SquareSum0), 1.0);
-        const double Scale1 = Select(SquareSum1 - Tolerance, InvSqrt(SquareSum1), 1.0);
-        const double Scale2 = Select(SquareSum2 - Tolerance, InvSqrt(SquareSum2), 1.0);
+        const T SquareSum0 = (M[0][0] * M[0][0]) + (M[0][1] * M[0][1]) + (M[0][2] * M[0][2]);
+        const T SquareSum1 = (M[1][0] * M[1][0]) + (M[1][1] * M[1][1]) + (M[1][2] * M[1][2]);
+        const T SquareSum2 = (M[2][0] * M[2][0]) + (M[2][1] * M[2][1]) + (M[2][2] * M[2][2]);
+        const T Scale0 = Select(SquareSum0 - Tolerance, InvSqrt<Precision>(SquareSum0), T(1));
+        const T Scale1 = Select(SquareSum1 - Tolerance, InvSqrt<Precision>(SquareSum1), T(1));
+        const T Scale2 = Select(SquareSum2 - Tolerance, InvSqrt<Precision>(SquareSum2), T(1));
         M[0][0] *= Scale0;
         M[0][1] *= Scale0;
         M[0][2] *= Scale0;
@@ -87,7 +88,7 @@ public:
         M[2][2] *= Scale2;
     }
 
-    double Determinant() const
+    T Determinant() const
     {
         return	
             M[0][0] * (
@@ -112,19 +113,53 @@ public:
                 );
     }
 
-    FMatrix Inverse() const;
+    TMatrix Inverse() const;
+
+    /**
+     * Inverse of an affine matrix (last column exactly 0, 0, 0, 1): inverts the 3x3 part and
+     * fixes up the translation. Returns identity for a singular matrix, like Inverse().
+     */
+    TMatrix InverseAffine() const;
 
-    void SetAxis0(const FVector& Axis);
-    void SetAxis1(const FVector& Axis);
-    void SetAxis2(const FVector& Axis);
+    /**
+     * Inverse of a rotation plus translation: the transposed 3x3 part and the translation
+     * rotated back. Only valid when Classify() returns EMatrixClass::Rigid.
+     */
+    TMatrix InverseRigid() const;
 
-    FVector GetOrigin() const;
-    FVector GetScaledAxisX() const;
-    FVector GetScaledAxisY() const;
-    FVector GetScaledAxisZ() const;
-    FRotator GetRotator() const;
+    /**
+     * Default tolerance of Classify. SMALL_NUMBER is below float epsilon, so a float rotation
+     * matrix built from a normalized quaternion would almost never pass as Rigid with it.
+     */
+    static constexpr T ClassifyTolerance = std::is_same<T, float>::value ? T(KINDA_SMALL_NUMBER) : T(SMALL_NUMBER);
+
+    /** Rigid if the 3x3 rows are unit length and orthogonal within Tolerance, Affine if the last column is exactly (0, 0, 0, 1). */
+    EMatrixClass Classify(T Tolerance = ClassifyTolerance) const;
+
+    /** Inverse through the cheapest routine that is correct for Classify(Tolerance), falling back to Inverse(). */
+    TMatrix InverseAuto(T Tolerance = ClassifyTolerance) const;
+
+    void SetAxis0(const TVector<T>& Axis) { M[0][0] = Axis.X; M[0][1] = Axis.Y; M[0][2] = Axis.Z; }
+    void SetAxis1(const TVector<T>& Axis) { M[1][0] = Axis.X; M[1][1] = Axis.Y; M[1][2] = Axis.Z; }
+    void SetAxis2(const TVector<T>& Axis) { M[2][0] = Axis.X; M[2][1] = Axis.Y; M[2][2] = Axis.Z; }
+
+    TVector<T> GetOrigin() const { return TVector<T>(_41, _42, _43); }
+    TVector<T> GetScaledAxisX() const { return TVector<T>(M[0][0], M[0][1], M[0][2]); }
+    TVector<T> GetScaledAxisY() const { return TVector<T>(M[1][0], M[1][1], M[1][2]); }
+    TVector<T> GetScaledAxisZ() const { return TVector<T>(M[2][0], M[2][1], M[2][2]); }
+    TRotator<T> GetRotator() const;
 
     //Convert to FTransform
-    FMatrix& operator=(const FTransform& t);
-    FMatrix(const FTransform& t);
-};
\ No newline at end of file
+    TMatrix& operator=(const TTransform<T>& t);
+    TMatrix(const TTransform<T>& t);
+};
+
+static_assert(sizeof(FMatrix) == 128, "FMatrix");
+static_assert(sizeof(FMatrix44f) == 64, "FMatrix44f");
+
+#if UE_MATH_HEADER_ONLY
+#include "matrix.inl"
+#else
+extern template struct TMatrix<float>;
+extern template struct TMatrix<double>;
+#endif
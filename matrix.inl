@@ -0,0 +1,182 @@
+#pragma once
+#include "matrix.h"
+#include "vector.h"
+#include "rotator.h"
+#include "transform.h"
+#include "stats.h"
+#include <string.h>
+
+/** Result = Matrix1 * Matrix2 one row at a time; the portable path behind VectorMatrixMultiply. */
+template<typename T>
+inline void VectorMatrixMultiplyScalar(void* Result, const void* Matrix1, const void* Matrix2)
+{
+    const T (&A)[4][4] = *((const T(*)[4][4])Matrix1);
+    const T (&B)[4][4] = *((const T(*)[4][4])Matrix2);
+    T Temp[4][4];
+    for (int i = 0; i < 4; ++i)
+    {
+        const T x = A[i][0];
+        const T y = A[i][1];
+        const T z = A[i][2];
+        const T w = A[i][3];
+        Temp[i][0] = (B[0][0] * x) + (B[1][0] * y) + (B[2][0] * z) + (B[3][0] * w);
+        Temp[i][1] = (B[0][1] * x) + (B[1][1] * y) + (B[2][1] * z) + (B[3][1] * w);
+        Temp[i][2] = (B[0][2] * x) + (B[1][2] * y) + (B[2][2] * z) + (B[3][2] * w);
+        Temp[i][3] = (B[0][3] * x) + (B[1][3] * y) + (B[2][3] * z) + (B[3][3] * w);
+    }
+    memcpy(Result, &Temp, 16 * sizeof(T));
+}
+
+#if UE_MATH_HEADER_ONLY
+/**
+ * Header-only builds multiply single matrices with the scalar path, so FMatrix::operator* links
+ * without the library; the SIMD kernels stay behind TMatrix::MultiplyBatch.
+ */
+template<typename T>
+UE_MATH_INLINE void VectorMatrixMultiply(void* Result, const void* Matrix1, const void* Matrix2)
+{
+    VectorMatrixMultiplyScalar<T>(Result, Matrix1, Matrix2);
+}
+#endif
+
+template<typename T>
+UE_MATH_INLINE TRotator<T> TMatrix<T>::GetRotator() const {
+    const TVector<T> XAxis = GetScaledAxisX();
+    const TVector<T> YAxis = GetScaledAxisY();
+    const TVector<T> ZAxis = GetScaledAxisZ();
+
+    TRotator<T> r = TRotator<T>(
+        atan2(XAxis.Z, sqrt(XAxis.X * XAxis.X + XAxis.Y * XAxis.Y)) * 180.0 / PI,
+        atan2(XAxis.Y, XAxis.X) * 180.0 / PI,
+        0
+    );
+
+    // Y axis of the rotation with zero roll; the roll is the angle from it to the actual Y axis
+    const TVector<T> SYAxis = r.GetMatrix().GetScaledAxisY();
+
+    r.Roll = atan2(ZAxis | SYAxis, YAxis | SYAxis) * 180.0 / PI;
+
+    return r;
+}
+
+template<typename T>
+UE_MATH_INLINE TMatrix<T>& TMatrix<T>::operator=(const TTransform<T>& t) { return *this = t.ToMatrixWithScale(); }
+template<typename T>
+UE_MATH_INLINE TMatrix<T>::TMatrix(const TTransform<T>& t) { operator=(t); }
+
+template<typename T>
+UE_MATH_INLINE TMatrix<T> TMatrix<T>::Inverse() const
+{
+    UE_MATH_STAT_SCOPE(MatrixInverse);
+    TMatrix Result;
+
+    // Check for zero scale matrix to invert
+    if (GetScaledAxisX().IsNearlyZero(SMALL_NUMBER) &&
+        GetScaledAxisY().IsNearlyZero(SMALL_NUMBER) &&
+        GetScaledAxisZ().IsNearlyZero(SMALL_NUMBER))
+    {
+        // just set to zero - avoids unsafe inverse of zero and duplicates what QNANs were resulting in before (scaling away all children)
+        UE_MATH_STAT_SLOW_PATH(MatrixInverse);
+        Result = TMatrix();
+    }
+    else if (!VectorMatrixInverse<T>(&Result, this))
+    {
+        UE_MATH_STAT_SLOW_PATH(MatrixInverse);
+        Result = TMatrix();
+    }
+
+    return Result;
+}
+
+template<typename T>
+UE_MATH_INLINE TMatrix<T> TMatrix<T>::InverseAffine() const
+{
+    TMatrix Result;
+
+    if (GetScaledAxisX().IsNearlyZero(SMALL_NUMBER) &&
+        GetScaledAxisY().IsNearlyZero(SMALL_NUMBER) &&
+        GetScaledAxisZ().IsNearlyZero(SMALL_NUMBER))
+    {
+        return Result;
+    }
+
+    // Cofactors of the upper 3x3 block, already transposed into the adjugate
+    const T C00 = M[1][1] * M[2][2] - M[1][2] * M[2][1];
+    const T C01 = M[0][2] * M[2][1] - M[0][1] * M[2][2];
+    const T C02 = M[0][1] * M[1][2] - M[0][2] * M[1][1];
+    const T C10 = M[1][2] * M[2][0] - M[1][0] * M[2][2];
+    const T C11 = M[0][0] * M[2][2] - M[0][2] * M[2][0];
+    const T C12 = M[0][2] * M[1][0] - M[0][0] * M[1][2];
+    const T C20 = M[1][0] * M[2][1] - M[1][1] * M[2][0];
+    const T C21 = M[0][1] * M[2][0] - M[0][0] * M[2][1];
+    const T C22 = M[0][0] * M[1][1] - M[0][1] * M[1][0];
+
+    const T Det = M[0][0] * C00 + M[0][1] * C10 + M[0][2] * C20;
+    if (Det == T(0))
+    {
+        return Result;
+    }
+
+    const T RDet = T(1) / Det;
+    Result.M[0][0] = C00 * RDet; Result.M[0][1] = C01 * RDet; Result.M[0][2] = C02 * RDet;
+    Result.M[1][0] = C10 * RDet; Result.M[1][1] = C11 * RDet; Result.M[1][2] = C12 * RDet;
+    Result.M[2][0] = C20 * RDet; Result.M[2][1] = C21 * RDet; Result.M[2][2] = C22 * RDet;
+
+    // Row vector convention: p' = p * A + T, so p = p' * A^-1 - T * A^-1
+    const T TX = M[3][0], TY = M[3][1], TZ = M[3][2];
+    Result.M[3][0] = -(TX * Result.M[0][0] + TY * Result.M[1][0] + TZ * Result.M[2][0]);
+    Result.M[3][1] = -(TX * Result.M[0][1] + TY * Result.M[1][1] + TZ * Result.M[2][1]);
+    Result.M[3][2] = -(TX * Result.M[0][2] + TY * Result.M[1][2] + TZ * Result.M[2][2]);
+
+    return Result;
+}
+
+template<typename T>
+UE_MATH_INLINE TMatrix<T> TMatrix<T>::InverseRigid() const
+{
+    TMatrix Result;
+    Result.M[0][0] = M[0][0]; Result.M[0][1] = M[1][0]; Result.M[0][2] = M[2][0];
+    Result.M[1][0] = M[0][1]; Result.M[1][1] = M[1][1]; Result.M[1][2] = M[2][1];
+    Result.M[2][0] = M[0][2]; Result.M[2][1] = M[1][2]; Result.M[2][2] = M[2][2];
+
+    // -T * R^T: minus the translation projected onto each axis
+    const T TX = M[3][0], TY = M[3][1], TZ = M[3][2];
+    Result.M[3][0] = -(TX * M[0][0] + TY * M[0][1] + TZ * M[0][2]);
+    Result.M[3][1] = -(TX * M[1][0] + TY * M[1][1] + TZ * M[1][2]);
+    Result.M[3][2] = -(TX * M[2][0] + TY * M[2][1] + TZ * M[2][2]);
+
+    return Result;
+}
+
+template<typename T>
+UE_MATH_INLINE EMatrixClass TMatrix<T>::Classify(T Tolerance) const
+{
+    if (M[0][3] != 0.0 || M[1][3] != 0.0 || M[2][3] != 0.0 || M[3][3] != 1.0)
+    {
+        return EMatrixClass::General;
+    }
+
+    const TVector<T> X = GetScaledAxisX();
+    const TVector<T> Y = GetScaledAxisY();
+    const TVector<T> Z = GetScaledAxisZ();
+    const bool bOrthonormal =
+        fabs((X | X) - T(1)) <= Tolerance && fabs((Y | Y) - T(1)) <= Tolerance && fabs((Z | Z) - T(1)) <= Tolerance &&
+        fabs(X | Y) <= Tolerance && fabs(X | Z) <= Tolerance && fabs(Y | Z) <= Tolerance;
+
+    // A reflection is orthonormal too; the transpose still inverts it
+    return bOrthonormal ? EMatrixClass::Rigid : EMatrixClass::Affine;
+}
+
+template<typename T>
+UE_MATH_INLINE TMatrix<T> TMatrix<T>::InverseAuto(T Tolerance) const
+{
+    switch (Classify(Tolerance))
+    {
+    case EMatrixClass::Rigid:
+        return InverseRigid();
+    case EMatrixClass::Affine:
+        return InverseAffine();
+    default:
+        return Inverse();
+    }
+}
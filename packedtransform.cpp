@@ -0,0 +1,460 @@
+#include "packedtransform.h"
+#include "cpu.h"
+#include "transformlanes.h"
+#include <string.h>
+
+/** Rotation components lie in [-1/sqrt(2), 1/sqrt(2)] and map to codes 0..32766, with 0 at QuatCodeBias so it comes back exact. */
+static constexpr int32_t QuatCodeBias = 16383;
+static constexpr double QuatCodeScale = QuatCodeBias * UE_SQRT_2;
+static constexpr double QuatCodeStep = UE_INV_SQRT_2 / QuatCodeBias;
+
+static constexpr uint64_t QuatCodeMask = 0x7FFF;
+static constexpr uint64_t TranslationCodeMask = FTranslationQuantizer::MaxCode;
+
+FTranslationQuantizer::FTranslationQuantizer(const FVector& InMin, const FVector& InMax)
+	: Min(InMin), Step((InMax.X - InMin.X) / MaxCode, (InMax.Y - InMin.Y) / MaxCode, (InMax.Z - InMin.Z) / MaxCode)
+{
+	InvStep.X = Step.X > 0.0 ? 1.0 / Step.X : 0.0;
+	InvStep.Y = Step.Y > 0.0 ? 1.0 / Step.Y : 0.0;
+	InvStep.Z = Step.Z > 0.0 ? 1.0 / Step.Z : 0.0;
+}
+
+uint16_t FloatToHalf(float V)
+{
+	uint32_t Bits;
+	memcpy(&Bits, &V, sizeof(Bits));
+	const uint32_t Sign = (Bits >> 16) & 0x8000;
+	uint32_t Abs = Bits & 0x7FFFFFFF;
+	if (Abs < 0x38800000)	// Under 2^-14, the smallest normal half
+		return (uint16_t)Sign;
+	Abs = Abs < 0x477FE000 ? Abs : 0x477FE000;	// 65504, the largest half; also takes infinity and NaN
+	// Round to nearest even on the 13 dropped mantissa bits, then rebias the exponent from 127 to 15
+	return (uint16_t)((((Abs + 0xFFF + ((Abs >> 13) & 1)) >> 13) - (112 << 10)) | Sign);
+}
+
+float HalfToFloat(uint16_t V)
+{
+	const uint32_t Abs = V & 0x7FFF;
+	const uint32_t Bits = (Abs ? (Abs << 13) + (112 << 23) : 0) | ((uint32_t)(V & 0x8000) << 16);
+	float Result;
+	memcpy(&Result, &Bits, sizeof(Result));
+	return Result;
+}
+
+/*-----------------------------------------------------------------------------
+	Scalar packing. The vector kernels below repeat these operations in the
+	same order.
+-----------------------------------------------------------------------------*/
+
+static inline uint64_t PackTranslationCode(double T, double Min, double InvStep)
+{
+	double Code = floor((T - Min) * InvStep + 0.5);
+	Code = Code > 0.0 ? Code : 0.0;
+	Code = Code < (double)FTranslationQuantizer::MaxCode ? Code : (double)FTranslationQuantizer::MaxCode;
+	return (uint64_t)Code;
+}
+
+static inline uint64_t PackRotationCode(double V, double Sign)
+{
+	double Code = floor(V * Sign * QuatCodeScale + 0.5);
+	Code = Code > -(double)QuatCodeBias ? Code : -(double)QuatCodeBias;
+	Code = Code < (double)QuatCodeBias ? Code : (double)QuatCodeBias;
+	return (uint64_t)(Code + QuatCodeBias);
+}
+
+/** The 48-bit smallest-three word of Q, normalized and with the dropped component made positive. */
+static uint64_t PackRotation(const FQuat& Q)
+{
+	const double InvNorm = 1.0 / sqrt(((Q.X * Q.X + Q.Y * Q.Y) + Q.Z * Q.Z) + Q.W * Q.W);
+
+	// The largest magnitude is the one dropped; ties go to the first
+	uint64_t Index = 0;
+	double Largest = Q.X;
+	double LargestAbs = fabs(Q.X);
+	if (fabs(Q.Y) > LargestAbs) { Index = 1; Largest = Q.Y; LargestAbs = fabs(Q.Y); }
+	if (fabs(Q.Z) > LargestAbs) { Index = 2; Largest = Q.Z; LargestAbs = fabs(Q.Z); }
+	if (fabs(Q.W) > LargestAbs) { Index = 3; Largest = Q.W; LargestAbs = fabs(Q.W); }
+
+	// Q and -Q are the same rotation; flip so the dropped component is positive
+	const double Sign = copysign(InvNorm, Largest);
+	const double A = Index == 0 ? Q.Y : Q.X;
+	const double B = Index <= 1 ? Q.Z : Q.Y;
+	const double C = Index <= 2 ? Q.W : Q.Z;
+	return PackRotationCode(A, Sign) | (PackRotationCode(B, Sign) << 15) | (PackRotationCode(C, Sign) << 30) | (Index << 45);
+}
+
+static inline double UnpackRotationCode(uint64_t Word, int Shift)
+{
+	return (double)((int32_t)((Word >> Shift) & QuatCodeMask) - QuatCodeBias) * QuatCodeStep;
+}
+
+static FQuat UnpackRotation(uint64_t Word)
+{
+	const double A = UnpackRotationCode(Word, 0);
+	const double B = UnpackRotationCode(Word, 15);
+	const double C = UnpackRotationCode(Word, 30);
+	const double Remainder = 1.0 - ((A * A + B * B) + C * C);
+	const double Largest = sqrt(Remainder > 0.0 ? Remainder : 0.0);
+	switch ((Word >> 45) & 3)
+	{
+	case 0:		return FQuat(Largest, A, B, C);
+	case 1:		return FQuat(A, Largest, B, C);
+	case 2:		return FQuat(A, B, Largest, C);
+	default:	return FQuat(A, B, C, Largest);
+	}
+}
+
+/** Stores the scale halves in Out, appending them to OutScales when they differ. */
+static void PackScale(uint16_t X, uint16_t Y, uint16_t Z, FPackedTransform& Out, FPackedScale* OutScales, size_t& NumScales)
+{
+	if (X == Y && X == Z)
+	{
+		Out.Scale = X;
+	}
+	else if (OutScales && NumScales < MaxPackedScales)
+	{
+		Out.Translation |= FPackedTransform::NonUniformScaleBit;
+		Out.Scale = (uint16_t)NumScales;
+		OutScales[NumScales++] = { X, Y, Z };
+	}
+	else
+	{
+		// Without room, fall back to the largest magnitude; halves order by magnitude as integers
+		uint16_t Largest = X;
+		Largest = (Y & 0x7FFF) > (Largest & 0x7FFF) ? Y : Largest;
+		Largest = (Z & 0x7FFF) > (Largest & 0x7FFF) ? Z : Largest;
+		Out.Scale = Largest;
+	}
+}
+
+static FVector UnpackScale(const FPackedTransform& In, const FPackedScale* Scales)
+{
+	if (In.HasNonUniformScale())
+	{
+		const FPackedScale& Scale = Scales[In.Scale];
+		return FVector(HalfToFloat(Scale.X), HalfToFloat(Scale.Y), HalfToFloat(Scale.Z));
+	}
+	const double Scale = HalfToFloat(In.Scale);
+	return FVector(Scale, Scale, Scale);
+}
+
+static void PackTransform(const FTransform& In, FPackedTransform& Out, const FTranslationQuantizer& Quantizer, FPackedScale* OutScales, size_t& NumScales)
+{
+	const FVector& T = In.Translation;
+	Out.Translation = PackTranslationCode(T.X, Quantizer.Min.X, Quantizer.InvStep.X)
+		| (PackTranslationCode(T.Y, Quantizer.Min.Y, Quantizer.InvStep.Y) << 21)
+		| (PackTranslationCode(T.Z, Quantizer.Min.Z, Quantizer.InvStep.Z) << 42);
+	const uint64_t Rotation = PackRotation(In.Rotation);
+	memcpy(Out.Rotation, &Rotation, sizeof(Out.Rotation));
+	PackScale(FloatToHalf((float)In.Scale3D.X), FloatToHalf((float)In.Scale3D.Y), FloatToHalf((float)In.Scale3D.Z), Out, OutScales, NumScales);
+}
+
+FTransform UnpackTransform(const FPackedTransform& In, const FTranslationQuantizer& Quantizer, const FPackedScale* Scales)
+{
+	uint64_t Rotation = 0;
+	memcpy(&Rotation, In.Rotation, sizeof(In.Rotation));
+	const FVector Translation(
+		(double)(In.Translation & TranslationCodeMask) * Quantizer.Step.X + Quantizer.Min.X,
+		(double)((In.Translation >> 21) & TranslationCodeMask) * Quantizer.Step.Y + Quantizer.Min.Y,
+		(double)((In.Translation >> 42) & TranslationCodeMask) * Quantizer.Step.Z + Quantizer.Min.Z);
+	return FTransform(UnpackRotation(Rotation), Translation, UnpackScale(In, Scales));
+}
+
+/** Element access shared by the FTransform array and SoA forms. */
+static inline FTransform GetTransform(const FTransform* In, size_t Index) { return In[Index]; }
+static inline FTransform GetTransform(const FTransformSoA& In, size_t Index) { return In.Get(Index); }
+static inline void SetTransform(FTransform* Out, size_t Index, const FTransform& T) { Out[Index] = T; }
+static inline void SetTransform(FTransformSoA& Out, size_t Index, const FTransform& T) { Out.Set(Index, T); }
+static inline void SetScale(FTransform* Out, size_t Index, const FVector& Scale) { Out[Index].Scale3D = Scale; }
+static inline void SetScale(FTransformSoA& Out, size_t Index, const FVector& Scale) { Out.Scale3D.Set(Index, Scale); }
+
+#if UE_MATH_X86
+/*-----------------------------------------------------------------------------
+	AVX2 kernels, four transforms per step. Records move as two 64-bit words,
+	Translation and (Rotation | Scale << 48), so four of them are a lane
+	vector of each.
+-----------------------------------------------------------------------------*/
+
+UE_TARGET_AVX2 static inline void LoadLanes(const FTransform* In, size_t Index, FTransformLanesAVX2& L)
+{
+	LoadTransformLanesAVX2(In + Index, L);
+}
+
+UE_TARGET_AVX2 static inline void LoadLanes(const FTransformSoA& In, size_t Index, FTransformLanesAVX2& L)
+{
+	L.QX = _mm256_loadu_pd(In.Rotation.X + Index);
+	L.QY = _mm256_loadu_pd(In.Rotation.Y + Index);
+	L.QZ = _mm256_loadu_pd(In.Rotation.Z + Index);
+	L.QW = _mm256_loadu_pd(In.Rotation.W + Index);
+	L.TX = _mm256_loadu_pd(In.Translation.X + Index);
+	L.TY = _mm256_loadu_pd(In.Translation.Y + Index);
+	L.TZ = _mm256_loadu_pd(In.Translation.Z + Index);
+	L.SX = _mm256_loadu_pd(In.Scale3D.X + Index);
+	L.SY = _mm256_loadu_pd(In.Scale3D.Y + Index);
+	L.SZ = _mm256_loadu_pd(In.Scale3D.Z + Index);
+}
+
+UE_TARGET_AVX2 static inline void StoreLanes(FTransform* Out, size_t Index, const FTransformLanesAVX2& L)
+{
+	StoreTransformLanesAVX2(Out + Index, L);
+}
+
+UE_TARGET_AVX2 static inline void StoreLanes(FTransformSoA& Out, size_t Index, const FTransformLanesAVX2& L)
+{
+	_mm256_storeu_pd(Out.Rotation.X + Index, L.QX);
+	_mm256_storeu_pd(Out.Rotation.Y + Index, L.QY);
+	_mm256_storeu_pd(Out.Rotation.Z + Index, L.QZ);
+	_mm256_storeu_pd(Out.Rotation.W + Index, L.QW);
+	_mm256_storeu_pd(Out.Translation.X + Index, L.TX);
+	_mm256_storeu_pd(Out.Translation.Y + Index, L.TY);
+	_mm256_storeu_pd(Out.Translation.Z + Index, L.TZ);
+	_mm256_storeu_pd(Out.Scale3D.X + Index, L.SX);
+	_mm256_storeu_pd(Out.Scale3D.Y + Index, L.SY);
+	_mm256_storeu_pd(Out.Scale3D.Z + Index, L.SZ);
+}
+
+/** The low 32 bits of each 64-bit lane. */
+UE_TARGET_AVX2 static inline __m128i NarrowEpi64(__m256i V)
+{
+	return _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(V, _mm256_set_epi32(7, 5, 3, 1, 6, 4, 2, 0)));
+}
+
+/** Integral doubles in [0, 2^31) to 64-bit lanes. */
+UE_TARGET_AVX2 static inline __m256i CodesToEpi64(__m256d Code)
+{
+	return _mm256_cvtepi32_epi64(_mm256_cvttpd_epi32(Code));
+}
+
+UE_TARGET_AVX2 UE_NO_FP_CONTRACT static inline __m256i PackTranslationCodeAVX2(__m256d T, double Min, double InvStep)
+{
+	__m256d Code = _mm256_floor_pd(_mm256_add_pd(_mm256_mul_pd(_mm256_sub_pd(T, _mm256_set1_pd(Min)), _mm256_set1_pd(InvStep)), _mm256_set1_pd(0.5)));
+	Code = _mm256_max_pd(Code, _mm256_setzero_pd());
+	Code = _mm256_min_pd(Code, _mm256_set1_pd((double)FTranslationQuantizer::MaxCode));
+	return CodesToEpi64(Code);
+}
+
+UE_TARGET_AVX2 UE_NO_FP_CONTRACT static inline __m256i PackRotationCodeAVX2(__m256d V, __m256d Sign)
+{
+	const __m256d Bias = _mm256_set1_pd((double)QuatCodeBias);
+	__m256d Code = _mm256_floor_pd(_mm256_add_pd(_mm256_mul_pd(_mm256_mul_pd(V, Sign), _mm256_set1_pd(QuatCodeScale)), _mm256_set1_pd(0.5)));
+	Code = _mm256_max_pd(Code, _mm256_sub_pd(_mm256_setzero_pd(), Bias));
+	Code = _mm256_min_pd(Code, Bias);
+	return CodesToEpi64(_mm256_add_pd(Code, Bias));
+}
+
+/** FloatToHalf on four lanes. */
+UE_TARGET_AVX2 static inline __m128i FloatToHalfAVX2(__m256d V)
+{
+	const __m128i Bits = _mm_castps_si128(_mm256_cvtpd_ps(V));
+	const __m128i Sign = _mm_and_si128(_mm_srli_epi32(Bits, 16), _mm_set1_epi32(0x8000));
+	const __m128i Abs = _mm_min_epu32(_mm_and_si128(Bits, _mm_set1_epi32(0x7FFFFFFF)), _mm_set1_epi32(0x477FE000));
+	const __m128i Tiny = _mm_cmplt_epi32(_mm_and_si128(Bits, _mm_set1_epi32(0x7FFFFFFF)), _mm_set1_epi32(0x38800000));
+	const __m128i Rounded = _mm_add_epi32(_mm_add_epi32(Abs, _mm_set1_epi32(0xFFF)), _mm_and_si128(_mm_srli_epi32(Abs, 13), _mm_set1_epi32(1)));
+	const __m128i Half = _mm_sub_epi32(_mm_srli_epi32(Rounded, 13), _mm_set1_epi32(112 << 10));
+	return _mm_or_si128(_mm_andnot_si128(Tiny, Half), Sign);
+}
+
+/** HalfToFloat on four lanes of 32-bit halves, widened to double. */
+UE_TARGET_AVX2 static inline __m256d HalfToDoubleAVX2(__m128i V)
+{
+	const __m128i Abs = _mm_and_si128(V, _mm_set1_epi32(0x7FFF));
+	const __m128i Zero = _mm_cmpeq_epi32(Abs, _mm_setzero_si128());
+	const __m128i Bits = _mm_andnot_si128(Zero, _mm_add_epi32(_mm_slli_epi32(Abs, 13), _mm_set1_epi32(112 << 23)));
+	const __m128i Sign = _mm_slli_epi32(_mm_and_si128(V, _mm_set1_epi32(0x8000)), 16);
+	return _mm256_cvtps_pd(_mm_castsi128_ps(_mm_or_si128(Bits, Sign)));
+}
+
+template<typename TInput>
+UE_TARGET_AVX2 UE_NO_FP_CONTRACT static size_t PackTransformsAVX2(const TInput& In, FPackedTransform* Out, size_t Count, const FTranslationQuantizer& Quantizer, FPackedScale* OutScales, size_t& NumScales)
+{
+	const __m256d SignMask = _mm256_set1_pd(-0.0);
+	const __m256d One = _mm256_set1_pd(1.0);
+
+	size_t i = 0;
+	for (; i + 4 <= Count; i += 4)
+	{
+		FTransformLanesAVX2 L;
+		LoadLanes(In, i, L);
+
+		const __m256i Translation = _mm256_or_si256(_mm256_or_si256(
+			PackTranslationCodeAVX2(L.TX, Quantizer.Min.X, Quantizer.InvStep.X),
+			_mm256_slli_epi64(PackTranslationCodeAVX2(L.TY, Quantizer.Min.Y, Quantizer.InvStep.Y), 21)),
+			_mm256_slli_epi64(PackTranslationCodeAVX2(L.TZ, Quantizer.Min.Z, Quantizer.InvStep.Z), 42));
+
+		// Rotation, as PackRotation
+		const __m256d SquareSum = _mm256_add_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(L.QX, L.QX), _mm256_mul_pd(L.QY, L.QY)), _mm256_mul_pd(L.QZ, L.QZ)), _mm256_mul_pd(L.QW, L.QW));
+		const __m256d InvNorm = _mm256_div_pd(One, _mm256_sqrt_pd(SquareSum));
+
+		__m256d Index = _mm256_setzero_pd();
+		__m256d Largest = L.QX;
+		__m256d LargestAbs = _mm256_andnot_pd(SignMask, L.QX);
+		const __m256d Components[3] = { L.QY, L.QZ, L.QW };
+		for (int Component = 0; Component < 3; ++Component)
+		{
+			const __m256d Abs = _mm256_andnot_pd(SignMask, Components[Component]);
+			const __m256d bGreater = _mm256_cmp_pd(Abs, LargestAbs, _CMP_GT_OQ);
+			Index = _mm256_blendv_pd(Index, _mm256_set1_pd(Component + 1.0), bGreater);
+			Largest = _mm256_blendv_pd(Largest, Components[Component], bGreater);
+			LargestAbs = _mm256_blendv_pd(LargestAbs, Abs, bGreater);
+		}
+
+		const __m256d Sign = _mm256_or_pd(InvNorm, _mm256_and_pd(Largest, SignMask));
+		const __m256d A = _mm256_blendv_pd(L.QX, L.QY, _mm256_cmp_pd(Index, _mm256_setzero_pd(), _CMP_EQ_OQ));
+		const __m256d B = _mm256_blendv_pd(L.QY, L.QZ, _mm256_cmp_pd(Index, One, _CMP_LE_OQ));
+		const __m256d C = _mm256_blendv_pd(L.QZ, L.QW, _mm256_cmp_pd(Index, _mm256_set1_pd(2.0), _CMP_LE_OQ));
+		const __m256i Rotation = _mm256_or_si256(_mm256_or_si256(
+			PackRotationCodeAVX2(A, Sign),
+			_mm256_slli_epi64(PackRotationCodeAVX2(B, Sign), 15)), _mm256_or_si256(
+			_mm256_slli_epi64(PackRotationCodeAVX2(C, Sign), 30),
+			_mm256_slli_epi64(CodesToEpi64(Index), 45)));
+
+		// Scale: the X half goes in every record, then the non-uniform ones are fixed up as in PackScale
+		const __m128i HX = FloatToHalfAVX2(L.SX);
+		const __m128i HY = FloatToHalfAVX2(L.SY);
+		const __m128i HZ = FloatToHalfAVX2(L.SZ);
+		const __m256i High = _mm256_or_si256(Rotation, _mm256_slli_epi64(_mm256_cvtepu32_epi64(HX), 48));
+
+		const __m256i Lo = _mm256_unpacklo_epi64(Translation, High);
+		const __m256i Hi = _mm256_unpackhi_epi64(Translation, High);
+		_mm256_storeu_si256((__m256i*)(Out + i), _mm256_permute2x128_si256(Lo, Hi, 0x20));
+		_mm256_storeu_si256((__m256i*)(Out + i + 2), _mm256_permute2x128_si256(Lo, Hi, 0x31));
+
+		const __m128i bUniform = _mm_and_si128(_mm_cmpeq_epi32(HX, HY), _mm_cmpeq_epi32(HX, HZ));
+		if (_mm_movemask_ps(_mm_castsi128_ps(bUniform)) != 0xF)
+		{
+			alignas(16) uint32_t X[4], Y[4], Z[4];
+			_mm_store_si128((__m128i*)X, HX);
+			_mm_store_si128((__m128i*)Y, HY);
+			_mm_store_si128((__m128i*)Z, HZ);
+			for (int Lane = 0; Lane < 4; ++Lane)
+			{
+				PackScale((uint16_t)X[Lane], (uint16_t)Y[Lane], (uint16_t)Z[Lane], Out[i + Lane], OutScales, NumScales);
+			}
+		}
+	}
+	return i;
+}
+
+template<typename TOutput>
+UE_TARGET_AVX2 UE_NO_FP_CONTRACT static size_t UnpackTransformsAVX2(const FPackedTransform* In, TOutput& Out, size_t Count, const FTranslationQuantizer& Quantizer, const FPackedScale* Scales)
+{
+	const __m256i TranslationMask = _mm256_set1_epi64x((long long)TranslationCodeMask);
+	const __m256i RotationMask = _mm256_set1_epi64x((long long)QuatCodeMask);
+	const __m256i Bias = _mm256_set1_epi64x(QuatCodeBias);
+	const __m256d Step = _mm256_set1_pd(QuatCodeStep);
+	const __m256d One = _mm256_set1_pd(1.0);
+
+	size_t i = 0;
+	for (; i + 4 <= Count; i += 4)
+	{
+		const __m256i R01 = _mm256_loadu_si256((const __m256i*)(In + i));
+		const __m256i R23 = _mm256_loadu_si256((const __m256i*)(In + i + 2));
+		const __m256i Lo = _mm256_permute2x128_si256(R01, R23, 0x20);
+		const __m256i Hi = _mm256_permute2x128_si256(R01, R23, 0x31);
+		const __m256i Translation = _mm256_unpacklo_epi64(Lo, Hi);
+		const __m256i High = _mm256_unpackhi_epi64(Lo, Hi);
+
+		FTransformLanesAVX2 L;
+		L.TX = _mm256_add_pd(_mm256_mul_pd(_mm256_cvtepi32_pd(NarrowEpi64(_mm256_and_si256(Translation, TranslationMask))), _mm256_set1_pd(Quantizer.Step.X)), _mm256_set1_pd(Quantizer.Min.X));
+		L.TY = _mm256_add_pd(_mm256_mul_pd(_mm256_cvtepi32_pd(NarrowEpi64(_mm256_and_si256(_mm256_srli_epi64(Translation, 21), TranslationMask))), _mm256_set1_pd(Quantizer.Step.Y)), _mm256_set1_pd(Quantizer.Min.Y));
+		L.TZ = _mm256_add_pd(_mm256_mul_pd(_mm256_cvtepi32_pd(NarrowEpi64(_mm256_and_si256(_mm256_srli_epi64(Translation, 42), TranslationMask))), _mm256_set1_pd(Quantizer.Step.Z)), _mm256_set1_pd(Quantizer.Min.Z));
+
+		// Rotation, as UnpackRotation
+		const __m256d A = _mm256_mul_pd(_mm256_cvtepi32_pd(NarrowEpi64(_mm256_sub_epi64(_mm256_and_si256(High, RotationMask), Bias))), Step);
+		const __m256d B = _mm256_mul_pd(_mm256_cvtepi32_pd(NarrowEpi64(_mm256_sub_epi64(_mm256_and_si256(_mm256_srli_epi64(High, 15), RotationMask), Bias))), Step);
+		const __m256d C = _mm256_mul_pd(_mm256_cvtepi32_pd(NarrowEpi64(_mm256_sub_epi64(_mm256_and_si256(_mm256_srli_epi64(High, 30), RotationMask), Bias))), Step);
+		const __m256d Remainder = _mm256_sub_pd(One, _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(A, A), _mm256_mul_pd(B, B)), _mm256_mul_pd(C, C)));
+		const __m256d Largest = _mm256_sqrt_pd(_mm256_max_pd(Remainder, _mm256_setzero_pd()));
+
+		const __m256i Index = _mm256_and_si256(_mm256_srli_epi64(High, 45), _mm256_set1_epi64x(3));
+		const __m256d bIndex0 = _mm256_castsi256_pd(_mm256_cmpeq_epi64(Index, _mm256_setzero_si256()));
+		const __m256d bIndex1 = _mm256_castsi256_pd(_mm256_cmpeq_epi64(Index, _mm256_set1_epi64x(1)));
+		const __m256d bIndex2 = _mm256_castsi256_pd(_mm256_cmpeq_epi64(Index, _mm256_set1_epi64x(2)));
+		const __m256d bIndex3 = _mm256_castsi256_pd(_mm256_cmpeq_epi64(Index, _mm256_set1_epi64x(3)));
+		L.QX = _mm256_blendv_pd(A, Largest, bIndex0);
+		L.QY = _mm256_blendv_pd(_mm256_blendv_pd(B, A, bIndex0), Largest, bIndex1);
+		L.QZ = _mm256_blendv_pd(_mm256_blendv_pd(C, B, _mm256_or_pd(bIndex0, bIndex1)), Largest, bIndex2);
+		L.QW = _mm256_blendv_pd(C, Largest, bIndex3);
+
+		// Uniform scale for every lane, then the non-uniform ones are fixed up from Scales
+		L.SX = L.SY = L.SZ = HalfToDoubleAVX2(NarrowEpi64(_mm256_srli_epi64(High, 48)));
+		StoreLanes(Out, i, L);
+
+		if (const int NonUniform = _mm256_movemask_pd(_mm256_castsi256_pd(Translation)))
+		{
+			for (int Lane = 0; Lane < 4; ++Lane)
+			{
+				if (NonUniform & (1 << Lane))
+					SetScale(Out, i + Lane, UnpackScale(In[i + Lane], Scales));
+			}
+		}
+	}
+	return i;
+}
+#endif
+
+template<typename TInput>
+static size_t BatchPackTransformsDispatch(const TInput& In, FPackedTransform* Out, size_t Count, const FTranslationQuantizer& Quantizer, FPackedScale* OutScales)
+{
+	size_t NumScales = 0;
+	size_t i = 0;
+	switch (GetSimdLevel())
+	{
+#if UE_MATH_X86
+	case ESimdLevel::AVX512:
+	case ESimdLevel::AVX2:
+		i = PackTransformsAVX2(In, Out, Count, Quantizer, OutScales, NumScales);
+		break;
+#endif
+	default:
+		break;
+	}
+
+	for (; i < Count; ++i)
+	{
+		PackTransform(GetTransform(In, i), Out[i], Quantizer, OutScales, NumScales);
+	}
+	return NumScales;
+}
+
+template<typename TOutput>
+static void BatchUnpackTransformsDispatch(const FPackedTransform* In, TOutput& Out, size_t Count, const FTranslationQuantizer& Quantizer, const FPackedScale* Scales)
+{
+	size_t i = 0;
+	switch (GetSimdLevel())
+	{
+#if UE_MATH_X86
+	case ESimdLevel::AVX512:
+	case ESimdLevel::AVX2:
+		i = UnpackTransformsAVX2(In, Out, Count, Quantizer, Scales);
+		break;
+#endif
+	default:
+		break;
+	}
+
+	for (; i < Count; ++i)
+	{
+		SetTransform(Out, i, UnpackTransform(In[i], Quantizer, Scales));
+	}
+}
+
+size_t BatchPackTransforms(const FTransform* In, FPackedTransform* Out, size_t Count, const FTranslationQuantizer& Quantizer, FPackedScale* OutScales)
+{
+	return BatchPackTransformsDispatch(In, Out, Count, Quantizer, OutScales);
+}
+
+size_t BatchPackTransforms(const FTransformSoA& In, FPackedTransform* Out, size_t Count, const FTranslationQuantizer& Quantizer, FPackedScale* OutScales)
+{
+	return BatchPackTransformsDispatch(In, Out, Count, Quantizer, OutScales);
+}
+
+void BatchUnpackTransforms(const FPackedTransform* In, FTransform* Out, size_t Count, const FTranslationQuantizer& Quantizer, const FPackedScale* Scales)
+{
+	BatchUnpackTransformsDispatch(In, Out, Count, Quantizer, Scales);
+}
+
+void BatchUnpackTransforms(const FPackedTransform* In, FTransformSoA Out, size_t Count, const FTranslationQuantizer& Quantizer, const FPackedScale* Scales)
+{
+	BatchUnpackTransformsDispatch(In, Out, Count, Quantizer, Scales);
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include "ue4math.h"
+#include "vector.h"
+#include "quat.h"
+#include "transform.h"
+#include "bounds.h"
+#include "batch.h"
+
+/*-----------------------------------------------------------------------------
+	Packed transforms for bulk storage, e.g. seconds of history per actor:
+	16 bytes instead of FTransform's 96. Rotation is a 48-bit smallest-three
+	quaternion, translation is quantized to 21 bits per axis over a range
+	given by an FTranslationQuantizer, and a uniform scale is stored in the
+	record as a half. A non-uniform scale goes to a side array of
+	FPackedScale, which only those transforms use.
+
+	Round-trip error for normalized rotations and scales in range:
+	  rotation     under 1.5e-4 radians, 0.009 degrees (1.37e-4 over two
+	               million random rotations); the identity is exact
+	  translation  at most GetMaxError() per axis, Step / 2, inside the range;
+	               a translation outside it is clamped to the range
+	  scale        at most 2^-11 relative per axis (half precision), powers
+	               of two exact; magnitudes under 2^-14 come back as zero and
+	               over 65504 as 65504
+-----------------------------------------------------------------------------*/
+
+/** Maps translations within [Min, Max] to 21-bit integers per axis, and back. */
+struct FTranslationQuantizer
+{
+public:
+	static constexpr uint32_t MaxCode = (1u << 21) - 1;
+
+	FVector Min;
+	FVector Step;		/* (Max - Min) / MaxCode: the distance between neighbouring codes */
+	FVector InvStep;	/* 1 / Step, or 0 for an axis of zero extent */
+
+	FTranslationQuantizer(const FVector& Min, const FVector& Max);
+
+	/** The range of Box, e.g. FBox(Transforms, Count) over the transforms to pack. */
+	explicit FTranslationQuantizer(const FBox& Box) : FTranslationQuantizer(Box.Min, Box.Max) {}
+
+	/** Largest error per axis for a translation within the range. */
+	FVector GetMaxError() const { return Step * 0.5; }
+};
+
+/** A non-uniform scale, one half per axis. */
+struct FPackedScale
+{
+	uint16_t X;
+	uint16_t Y;
+	uint16_t Z;
+};
+
+static_assert(sizeof(FPackedScale) == 6, "FPackedScale");
+
+/** Maximum number of FPackedScale entries one batch can refer to. */
+static constexpr size_t MaxPackedScales = 65536;
+
+struct FPackedTransform
+{
+public:
+	/** Bit 63 of Translation: Scale is the index of an FPackedScale rather than a uniform scale. */
+	static constexpr uint64_t NonUniformScaleBit = 1ull << 63;
+
+	uint64_t Translation;	/* Codes for X, Y, Z in bits 0-20, 21-41 and 42-62 */
+	uint16_t Rotation[3];	/* As one 48-bit word: three 15-bit components from bit 0, index of the dropped one in bits 45-46 */
+	uint16_t Scale;			/* Uniform scale as a half, or an index into the batch's FPackedScale array */
+
+	bool HasNonUniformScale() const { return (Translation & NonUniformScaleBit) != 0; }
+};
+
+static_assert(sizeof(FPackedTransform) == 16, "FPackedTransform");
+
+/** Half precision (binary16) bits for V, rounded to nearest; see the scale bounds above. */
+uint16_t FloatToHalf(float V);
+
+/** Float value of half bits written by FloatToHalf. */
+float HalfToFloat(uint16_t V);
+
+/**
+ * Packs In[i] into Out[i] for every i in [0, Count). Rotations are normalized first.
+ *
+ * Non-uniform scales (those whose axes differ once rounded to half) are appended to OutScales,
+ * which needs room for one entry per such transform, and the return value is how many were
+ * written. With OutScales null, or once MaxPackedScales entries are written, a non-uniform
+ * scale is stored as uniform, taking the axis of largest magnitude.
+ *
+ * Dispatches on GetSimdLevel(): the AVX2 kernel, also used at the AVX-512 level, packs four
+ * transforms per step and writes the same bits as the scalar code.
+ */
+size_t BatchPackTransforms(const FTransform* In, FPackedTransform* Out, size_t Count, const FTranslationQuantizer& Quantizer, FPackedScale* OutScales = nullptr);
+size_t BatchPackTransforms(const FTransformSoA& In, FPackedTransform* Out, size_t Count, const FTranslationQuantizer& Quantizer, FPackedScale* OutScales = nullptr);
+
+/**
+ * Unpacks In[i] into Out[i] for every i in [0, Count). Scales is the array BatchPackTransforms
+ * filled for this batch (unused if no transform has a non-uniform scale). The vector kernels
+ * give the same values as UnpackTransform.
+ */
+void BatchUnpackTransforms(const FPackedTransform* In, FTransform* Out, size_t Count, const FTranslationQuantizer& Quantizer, const FPackedScale* Scales = nullptr);
+void BatchUnpackTransforms(const FPackedTransform* In, FTransformSoA Out, size_t Count, const FTranslationQuantizer& Quantizer, const FPackedScale* Scales = nullptr);
+
+/** Unpacks one transform, e.g. for a lookup into packed history. */
+FTransform UnpackTransform(const FPackedTransform& In, const FTranslationQuantizer& Quantizer, const FPackedScale* Scales = nullptr);
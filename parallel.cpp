@@ -0,0 +1,190 @@
+#include "parallel.h"
+#include "cpu.h"
+#include <chrono>
+
+#if UE_MATH_X86
+#include <immintrin.h>
+#endif
+
+// How long an idle worker keeps polling for the next job before it sleeps
+static const std::chrono::microseconds IdleSpinTime(50);
+
+// Set on worker threads, and on a caller while it runs chunks, so nested ParallelFor() calls run inline
+static thread_local bool bInsideParallelFor = false;
+
+static inline void SpinPause()
+{
+#if UE_MATH_X86
+	_mm_pause();
+#else
+	std::this_thread::yield();
+#endif
+}
+
+FTaskScheduler::FTaskScheduler(int InNumThreads)
+	: NumThreads(InNumThreads > 0 ? InNumThreads : std::max(1, (int)std::thread::hardware_concurrency())), ActiveJob(nullptr), Generation(0), bStop(false)
+{
+	Queues.reset(new FQueue[NumThreads]);
+	Workers.reserve(NumThreads - 1);
+	for (int ThreadIndex = 1; ThreadIndex < NumThreads; ++ThreadIndex)
+	{
+		Workers.emplace_back(&FTaskScheduler::WorkerMain, this, ThreadIndex);
+	}
+}
+
+FTaskScheduler::~FTaskScheduler()
+{
+	{
+		std::lock_guard<std::mutex> Lock(WakeMutex);
+		bStop = true;
+	}
+	WakeCondition.notify_all();
+	for (std::thread& Worker : Workers)
+	{
+		Worker.join();
+	}
+}
+
+void FTaskScheduler::ParallelFor(size_t Count, size_t ChunkSize, const std::function<void(size_t, size_t)>& Body)
+{
+	ChunkSize = std::max<size_t>(ChunkSize, 1);
+	const size_t NumChunks = (Count + ChunkSize - 1) / ChunkSize;
+	if (NumChunks <= 1 || NumThreads == 1 || bInsideParallelFor)
+	{
+		if (Count > 0)
+		{
+			Body(0, Count);
+		}
+		return;
+	}
+
+	std::lock_guard<std::mutex> JobLock(JobMutex);
+	FJob Job;
+	Job.Body = &Body;
+	Job.Count = Count;
+	Job.ChunkSize = ChunkSize;
+	Job.NumChunksLeft.store(NumChunks, std::memory_order_relaxed);
+
+	// An equal, contiguous share of the chunks per thread
+	for (int ThreadIndex = 0; ThreadIndex < NumThreads; ++ThreadIndex)
+	{
+		const size_t First = NumChunks * ThreadIndex / NumThreads;
+		const size_t End = NumChunks * (ThreadIndex + 1) / NumThreads;
+		if (First < End)
+		{
+			std::lock_guard<std::mutex> Lock(Queues[ThreadIndex].Mutex);
+			Queues[ThreadIndex].Tasks.push_back({ &Job, First, End });
+		}
+	}
+
+	ActiveJob.store(&Job, std::memory_order_release);
+	{
+		std::lock_guard<std::mutex> Lock(WakeMutex);
+		Generation.fetch_add(1, std::memory_order_release);
+	}
+	WakeCondition.notify_all();
+
+	bInsideParallelFor = true;
+	while (Job.NumChunksLeft.load(std::memory_order_acquire) > 0)
+	{
+		if (!RunOneChunk(0))
+		{
+			SpinPause();
+		}
+	}
+	bInsideParallelFor = false;
+
+	// Every chunk is done, so no task refers to Job any more
+	ActiveJob.store(nullptr, std::memory_order_release);
+}
+
+void FTaskScheduler::WorkerMain(int ThreadIndex)
+{
+	bInsideParallelFor = true;
+	uint64_t SeenGeneration = 0;
+	while (WaitForJob(SeenGeneration))
+	{
+		while (ActiveJob.load(std::memory_order_acquire) != nullptr)
+		{
+			if (!RunOneChunk(ThreadIndex))
+			{
+				SpinPause();
+			}
+		}
+	}
+}
+
+bool FTaskScheduler::WaitForJob(uint64_t& SeenGeneration)
+{
+	const auto SpinEnd = std::chrono::steady_clock::now() + IdleSpinTime;
+	for (int Spin = 0; Generation.load(std::memory_order_acquire) == SeenGeneration; ++Spin)
+	{
+		if ((Spin & 63) == 63 && std::chrono::steady_clock::now() > SpinEnd)
+		{
+			std::unique_lock<std::mutex> Lock(WakeMutex);
+			WakeCondition.wait(Lock, [&]() { return bStop || Generation.load(std::memory_order_relaxed) != SeenGeneration; });
+			break;
+		}
+		SpinPause();
+	}
+
+	std::lock_guard<std::mutex> Lock(WakeMutex);
+	SeenGeneration = Generation.load(std::memory_order_relaxed);
+	return !bStop;
+}
+
+bool FTaskScheduler::RunOneChunk(int ThreadIndex)
+{
+	FTask Task;
+	if (!PopOwn(ThreadIndex, Task) && !Steal(ThreadIndex, Task))
+	{
+		return false;
+	}
+
+	// Keep one chunk and leave the rest behind in halves, the larger ones nearer the front for thieves
+	while (Task.EndChunk - Task.FirstChunk > 1)
+	{
+		const size_t Mid = Task.FirstChunk + (Task.EndChunk - Task.FirstChunk) / 2;
+		{
+			std::lock_guard<std::mutex> Lock(Queues[ThreadIndex].Mutex);
+			Queues[ThreadIndex].Tasks.push_back({ Task.Job, Mid, Task.EndChunk });
+		}
+		Task.EndChunk = Mid;
+	}
+
+	FJob& Job = *Task.Job;
+	const size_t Begin = Task.FirstChunk * Job.ChunkSize;
+	const size_t End = std::min(Begin + Job.ChunkSize, Job.Count);
+	(*Job.Body)(Begin, End);
+	Job.NumChunksLeft.fetch_sub(1, std::memory_order_acq_rel);
+	return true;
+}
+
+bool FTaskScheduler::PopOwn(int ThreadIndex, FTask& OutTask)
+{
+	FQueue& Queue = Queues[ThreadIndex];
+	std::lock_guard<std::mutex> Lock(Queue.Mutex);
+	if (Queue.Tasks.empty())
+	{
+		return false;
+	}
+	OutTask = Queue.Tasks.back();
+	Queue.Tasks.pop_back();
+	return true;
+}
+
+bool FTaskScheduler::Steal(int ThreadIndex, FTask& OutTask)
+{
+	for (int Offset = 1; Offset < NumThreads; ++Offset)
+	{
+		FQueue& Queue = Queues[(ThreadIndex + Offset) % NumThreads];
+		std::lock_guard<std::mutex> Lock(Queue.Mutex);
+		if (!Queue.Tasks.empty())
+		{
+			OutTask = Queue.Tasks.front();
+			Queue.Tasks.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
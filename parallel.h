@@ -0,0 +1,116 @@
+#pragma once
+#include "ue4math.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Work-stealing thread pool for splitting batch math over cores.
+ *
+ * ParallelFor() cuts the range into chunks and seeds every thread's deque with an equal share.
+ * A thread works from the back of its own deque, halving a range of several chunks and leaving
+ * the upper half behind; a thread whose deque runs dry steals from the front of another's,
+ * where the largest ranges sit. The calling thread works too, so a scheduler of N threads
+ * starts N - 1 workers. Idle workers spin briefly before sleeping, since batch calls tend to
+ * come in bursts.
+ *
+ * One ParallelFor() runs at a time: calls from other threads wait for it, and calls from
+ * inside a body run sequentially on the thread making them.
+ */
+struct FTaskScheduler
+{
+public:
+	/** NumThreads counts the caller; 0 means std::thread::hardware_concurrency(). */
+	explicit FTaskScheduler(int NumThreads = 0);
+	~FTaskScheduler();
+
+	FTaskScheduler(const FTaskScheduler&) = delete;
+	FTaskScheduler& operator=(const FTaskScheduler&) = delete;
+
+	int GetNumThreads() const { return NumThreads; }
+
+	/**
+	 * Calls Body(Begin, End) for the consecutive chunks of at most ChunkSize elements covering
+	 * [0, Count), spread over all threads, and returns once every chunk is done.
+	 */
+	void ParallelFor(size_t Count, size_t ChunkSize, const std::function<void(size_t, size_t)>& Body);
+
+private:
+	struct FJob
+	{
+		const std::function<void(size_t, size_t)>* Body;
+		size_t Count;
+		size_t ChunkSize;
+		std::atomic<size_t> NumChunksLeft;
+	};
+
+	/** Chunks FirstChunk .. EndChunk - 1 of Job. */
+	struct FTask
+	{
+		FJob* Job;
+		size_t FirstChunk;
+		size_t EndChunk;
+	};
+
+	struct alignas(64) FQueue
+	{
+		std::mutex Mutex;
+		std::deque<FTask> Tasks;
+	};
+
+	void WorkerMain(int ThreadIndex);
+	bool WaitForJob(uint64_t& SeenGeneration);
+	bool RunOneChunk(int ThreadIndex);
+	bool PopOwn(int ThreadIndex, FTask& OutTask);
+	bool Steal(int ThreadIndex, FTask& OutTask);
+
+	int NumThreads;
+	std::unique_ptr<FQueue[]> Queues;		/* Index 0 belongs to the thread calling ParallelFor() */
+	std::vector<std::thread> Workers;
+
+	std::mutex JobMutex;
+	std::atomic<FJob*> ActiveJob;
+
+	std::mutex WakeMutex;
+	std::condition_variable WakeCondition;
+	std::atomic<uint64_t> Generation;
+	bool bStop;
+};
+
+/** Bytes of input and output per chunk the batch APIs aim for, so a chunk stays within a core's L2 cache. */
+static constexpr size_t ParallelChunkBytes = 128 * 1024;
+
+/** Batches of fewer chunks than this run on the calling thread: waking the workers would cost more than the work. */
+static constexpr size_t ParallelMinChunks = 4;
+
+/**
+ * Elements per chunk for a kernel moving BytesPerElement bytes per element, about
+ * ParallelChunkBytes, rounded up to a multiple of Granularity. With the default of 64 every
+ * chunk starts on a bitmask word, so kernels writing a visibility mask (FCamera::WorldToScreen,
+ * FFrustum::CullSpheres and the like) own whole words of it and can OR bits in without atomics.
+ */
+inline size_t GetParallelChunkSize(size_t BytesPerElement, size_t Granularity = 64)
+{
+	const size_t Elements = std::max<size_t>(ParallelChunkBytes / std::max<size_t>(BytesPerElement, 1), 1);
+	return (Elements + Granularity - 1) / Granularity * Granularity;
+}
+
+/**
+ * Scheduler->ParallelFor() for the batch APIs: runs Body(0, Count) on the calling thread instead
+ * when Scheduler is null or the batch is under ParallelMinChunks chunks.
+ */
+template<typename BodyType>
+inline void ParallelFor(FTaskScheduler* Scheduler, size_t Count, size_t ChunkSize, const BodyType& Body)
+{
+	if (!Scheduler || Scheduler->GetNumThreads() == 1 || Count < ChunkSize * ParallelMinChunks)
+	{
+		Body((size_t)0, Count);
+		return;
+	}
+	Scheduler->ParallelFor(Count, ChunkSize, Body);
+}
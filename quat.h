@@ -1,35 +1,58 @@
 #pragma once
 #include "ue4math.h"
+#include "mathfwd.h"
+#include "vector.h"
 
-struct FVector;
-struct FMatrix;
+/*-----------------------------------------------------------------------------
+	FastSlerp series (Eberly, "A Fast and Accurate Algorithm for Computing
+	SLERP"): sin(t * Angle) / sin(Angle) = t * (1 + C1 (1 + C2 (1 + ...)))
+	with Ci = (t^2 - i^2) / (i * (2i + 1)) * (cos(Angle) - 1). It is cut
+	after FAST_SLERP_TERMS terms, the last one weighted so it stands in for
+	the rest: over the shortest path (0 <= cos(Angle) <= 1) each weight is
+	then within 3.1e-8 of the exact one.
+-----------------------------------------------------------------------------*/
+#define FAST_SLERP_TERMS			16
+#define FAST_SLERP_LAST_TERM_WEIGHT	(1.9168710482187592)
 
+/** 1 / (i * (2i + 1)) for i = 1 .. FAST_SLERP_TERMS */
+constexpr double FastSlerpReciprocals[FAST_SLERP_TERMS] =
+{
+	1.0 / 3, 1.0 / 10, 1.0 / 21, 1.0 / 36, 1.0 / 55, 1.0 / 78, 1.0 / 105, 1.0 / 136,
+	1.0 / 171, 1.0 / 210, 1.0 / 253, 1.0 / 300, 1.0 / 351, 1.0 / 406, 1.0 / 465, 1.0 / 528,
+};
 
-struct alignas(16) FQuat {
+template<typename T>
+struct alignas(16) TQuat {
 public:
-	double                                              X;                                          
-	double                                              Y;                                                     
-	double                                              Z;                                                   
-	double                                              W;                                                  
+	using FReal = T;
+
+	T                                                   X;
+	T                                                   Y;
+	T                                                   Z;
+	T                                                   W;
+
+	constexpr TQuat(T X = 0, T Y = 0, T Z = 0, T W = 1) : X(X), Y(Y), Z(Z), W(W) {}
 
-	FQuat(double X = 0.0, double Y = 0.0, double Z = 0.0, double W = 1.0) : X(X), Y(Y), Z(Z), W(W) {}
+	/** Explicit precision conversion, e.g. FQuat4f(SomeFQuat). */
+	template<typename U, typename = typename std::enable_if<!std::is_same<T, U>::value>::type>
+	constexpr explicit TQuat(const TQuat<U>& Q) : X((T)Q.X), Y((T)Q.Y), Z((T)Q.Z), W((T)Q.W) {}
 
 	static void VectorQuaternionMultiply(void* Result, const void* Quat1, const void* Quat2) {
-		typedef double double4[4];
-		const double4& A = *((const double4*)Quat1);
-		const double4& B = *((const double4*)Quat2);
-		double4& R = *((double4*)Result);
-
-		const double T0 = (A[2] - A[1]) * (B[1] - B[2]);
-		const double T1 = (A[3] + A[0]) * (B[3] + B[0]);
-		const double T2 = (A[3] - A[0]) * (B[1] + B[2]);
-		const double T3 = (A[1] + A[2]) * (B[3] - B[0]);
-		const double T4 = (A[2] - A[0]) * (B[0] - B[1]);
-		const double T5 = (A[2] + A[0]) * (B[0] + B[1]);
-		const double T6 = (A[3] + A[1]) * (B[3] - B[2]);
-		const double T7 = (A[3] - A[1]) * (B[3] + B[2]);
-		const double T8 = T5 + T6 + T7;
-		const double T9 = 0.5f * (T4 + T8);
+		typedef T real4[4];
+		const real4& A = *((const real4*)Quat1);
+		const real4& B = *((const real4*)Quat2);
+		real4& R = *((real4*)Result);
+
+		const T T0 = (A[2] - A[1]) * (B[1] - B[2]);
+		const T T1 = (A[3] + A[0]) * (B[3] + B[0]);
+		const T T2 = (A[3] - A[0]) * (B[1] + B[2]);
+		const T T3 = (A[1] + A[2]) * (B[3] - B[0]);
+		const T T4 = (A[2] - A[0]) * (B[0] - B[1]);
+		const T T5 = (A[2] + A[0]) * (B[0] + B[1]);
+		const T T6 = (A[3] + A[1]) * (B[3] - B[2]);
+		const T T7 = (A[3] - A[1]) * (B[3] + B[2]);
+		const T T8 = T5 + T6 + T7;
+		const T T9 = T(0.5) * (T4 + T8);
 
 		R[0] = T1 + T9 - T8;
 		R[1] = T2 + T9 - T7;
@@ -37,19 +60,20 @@ public:
 		R[3] = T0 + T9 - T5;
 	}
 
-	FQuat operator*(const FQuat& Q) const {
-		FQuat Result;
+	TQuat operator*(const TQuat& Q) const {
+		TQuat Result;
 		VectorQuaternionMultiply(&Result, this, &Q);
 		return Result;
 	}
 
-	void Normalize(double Tolerance = SMALL_NUMBER)
+	template<EMathPrecision Precision = EMathPrecision::Precise>
+	void Normalize(T Tolerance = T(SMALL_NUMBER))
 	{
-		const double SquareSum = X * X + Y * Y + Z * Z + W * W;
+		const T SquareSum = X * X + Y * Y + Z * Z + W * W;
 
 		if (SquareSum >= Tolerance)
 		{
-			const double Scale = InvSqrt(SquareSum);
+			const T Scale = InvSqrt<Precision>(SquareSum);
 
 			X *= Scale;
 			Y *= Scale;
@@ -58,17 +82,108 @@ public:
 		}
 		else
 		{
-			*this = FQuat();
+			*this = TQuat();
 		}
 	}
 
-	double SizeSquared() const { return (X * X + Y * Y + Z * Z + W * W); }
-	bool IsNormalized() const { return (fabs(1.0 - SizeSquared()) < THRESH_QUAT_NORMALIZED); }
-	FQuat Inverse() const { return FQuat(-X, -Y, -Z, W); }
+	template<EMathPrecision Precision = EMathPrecision::Precise>
+	TQuat GetNormalized(T Tolerance = T(SMALL_NUMBER)) const
+	{
+		TQuat Result(*this);
+		Result.template Normalize<Precision>(Tolerance);
+		return Result;
+	}
+
+	constexpr T SizeSquared() const { return (X * X + Y * Y + Z * Z + W * W); }
+	bool IsNormalized() const { return (fabs(T(1) - SizeSquared()) < T(THRESH_QUAT_NORMALIZED)); }
+	constexpr TQuat Inverse() const { return TQuat(-X, -Y, -Z, W); }
+
+	/** Component-wise arithmetic, as used by the interpolation functions; not rotation composition. */
+	constexpr TQuat operator+(const TQuat& Q) const { return TQuat(X + Q.X, Y + Q.Y, Z + Q.Z, W + Q.W); }
+	constexpr TQuat operator-(const TQuat& Q) const { return TQuat(X - Q.X, Y - Q.Y, Z - Q.Z, W - Q.W); }
+	constexpr TQuat operator*(T Scale) const { return TQuat(X * Scale, Y * Scale, Z * Scale, W * Scale); }
+	constexpr TQuat& operator+=(const TQuat& Q) { X += Q.X; Y += Q.Y; Z += Q.Z; W += Q.W; return *this; }
+	constexpr TQuat& operator-=(const TQuat& Q) { X -= Q.X; Y -= Q.Y; Z -= Q.Z; W -= Q.W; return *this; }
+	constexpr TQuat& operator*=(T Scale) { X *= Scale; Y *= Scale; Z *= Scale; W *= Scale; return *this; }
 
-	FQuat(const FMatrix& M);
+	/** 4D dot product: the cosine of half the angle between two unit quaternions. */
+	constexpr T operator|(const TQuat& Q) const { return X * Q.X + Y * Q.Y + Z * Q.Z + W * Q.W; }
 
-	FVector RotateVector(const FVector& V) const;
-	FVector RotateVectorInverse(const FVector& V) const;
-	FVector operator*(const FVector& V) const;
+	/** Logarithm of a unit quaternion: (axis * half angle, 0). */
+	TQuat Log() const;
+
+	/** Exponential of a quaternion with W == 0, the inverse of Log(). */
+	TQuat Exp() const;
+
+	/*---- Interpolation. Alpha runs from 0 (Quat1) to 1 (Quat2); the inputs should be normalized. ----*/
+
+	/** Spherical interpolation along the shorter arc, unnormalized. Falls back to a linear blend below about 1.6 degrees apart. */
+	static TQuat Slerp_NotNormalized(const TQuat& Quat1, const TQuat& Quat2, T Alpha);
+	static TQuat Slerp(const TQuat& Quat1, const TQuat& Quat2, T Alpha) { return Slerp_NotNormalized(Quat1, Quat2, Alpha).GetNormalized(); }
+
+	/** Spherical interpolation without the shortest path flip, as Squad needs it. */
+	static TQuat SlerpFullPath_NotNormalized(const TQuat& Quat1, const TQuat& Quat2, T Alpha);
+	static TQuat SlerpFullPath(const TQuat& Quat1, const TQuat& Quat2, T Alpha) { return SlerpFullPath_NotNormalized(Quat1, Quat2, Alpha).GetNormalized(); }
+
+	/**
+	 * Slerp along the shorter arc without trigonometry: the slerp weights come from the series
+	 * above (2 * FAST_SLERP_TERMS multiply-adds). Normalized; every component is within 5e-8 of Slerp.
+	 */
+	static TQuat FastSlerp(const TQuat& Quat1, const TQuat& Quat2, T Alpha);
+
+	/** Linear blend along the shorter arc, unnormalized. The result has the sign of Quat2. */
+	static TQuat FastLerp(const TQuat& Quat1, const TQuat& Quat2, T Alpha)
+	{
+		const T Bias = Select(Quat1 | Quat2, T(1), T(-1));
+		return (Quat2 * Alpha) + (Quat1 * (Bias * (T(1) - Alpha)));
+	}
+
+	/** Normalized FastLerp. Cheapest, but its angular speed is uneven: up to 0.92 degrees off Slerp across a 90 degree arc. */
+	static TQuat NLerp(const TQuat& Quat1, const TQuat& Quat2, T Alpha) { return FastLerp(Quat1, Quat2, Alpha).GetNormalized(); }
+
+	/**
+	 * Spherical quadrangle interpolation from Quat1 to Quat2, a C1 continuous spline through keys
+	 * whose tangents come from CalcTangents.
+	 */
+	static TQuat Squad(const TQuat& Quat1, const TQuat& Tangent1, const TQuat& Quat2, const TQuat& Tangent2, T Alpha);
+
+	/** Squad tangent at P between its neighbouring keys. Tension 0 gives Shoemake's C1 tangent; 1 makes Squad a plain Slerp. */
+	static void CalcTangents(const TQuat& PrevP, const TQuat& P, const TQuat& NextP, T Tension, TQuat& OutTan);
+
+	TQuat(const TMatrix<T>& M);
+
+	constexpr TVector<T> RotateVector(const TVector<T>& V) const
+	{
+		// http://people.csail.mit.edu/bkph/articles/Quaternions.pdf
+		// V' = V + 2w(Q x V) + (2Q x (Q x V))
+		// refactor:
+		// V' = V + w(2(Q x V)) + (Q x (2(Q x V)))
+		// T = 2(Q x V);
+		// V' = V + w*(T) + (Q x T)
+
+		const TVector<T> Q(X, Y, Z);
+		const TVector<T> TT = (Q ^ V) * T(2);
+		const TVector<T> Result = V + (TT * W) + (Q ^ TT);
+		return Result;
+	}
+
+	constexpr TVector<T> RotateVectorInverse(const TVector<T>& V) const
+	{
+		const TVector<T> Q(X, Y, Z);
+		const TVector<T> TT = (Q ^ V) * T(2);
+		const TVector<T> Result = V - (TT * W) + (Q ^ TT);
+		return Result;
+	}
+
+	constexpr TVector<T> operator*(const TVector<T>& V) const { return RotateVector(V); }
 };
+
+static_assert(sizeof(FQuat) == 32, "FQuat");
+static_assert(sizeof(FQuat4f) == 16, "FQuat4f");
+
+#if UE_MATH_HEADER_ONLY
+#include "quat.inl"
+#else
+extern template struct TQuat<float>;
+extern template struct TQuat<double>;
+#endif
@@ -0,0 +1,203 @@
+#pragma once
+#include "quat.h"
+#include "vector.h"
+#include "matrix.h"
+
+template<typename T>
+UE_MATH_INLINE TQuat<T>::TQuat(const TMatrix<T>& M) {
+	// If Matrix is NULL, return Identity quaternion. If any of them is 0, you won't be able to construct rotation
+	// if you have two plane at least, we can reconstruct the frame using cross product, but that's a bit expensive op to do here
+	// for now, if you convert to matrix from 0 scale and convert back, you'll lose rotation. Don't do that. 
+	if (M.GetScaledAxisX().IsNearlyZero() || M.GetScaledAxisY().IsNearlyZero() || M.GetScaledAxisZ().IsNearlyZero())
+	{
+		*this = TQuat();
+		return;
+	}
+
+	//const MeReal *const t = (MeReal *) tm;
+	T s;
+
+	// Check diagonal (trace)
+	const T tr = M.M[0][0] + M.M[1][1] + M.M[2][2];
+
+	if (tr > 0)
+	{
+		T InvS = InvSqrt(tr + T(1));
+		this->W = T(0.5) * (T(1) / InvS);
+		s = T(0.5) * InvS;
+
+		this->X = (M.M[1][2] - M.M[2][1]) * s;
+		this->Y = (M.M[2][0] - M.M[0][2]) * s;
+		this->Z = (M.M[0][1] - M.M[1][0]) * s;
+	}
+	else
+	{
+		// diagonal is negative
+		int i = 0;
+
+		if (M.M[1][1] > M.M[0][0])
+			i = 1;
+
+		if (M.M[2][2] > M.M[i][i])
+			i = 2;
+
+		const int nxt[3] = { 1, 2, 0 };
+		const int j = nxt[i];
+		const int k = nxt[j];
+
+		s = M.M[i][i] - M.M[j][j] - M.M[k][k] + T(1);
+
+		T InvS = InvSqrt(s);
+
+		T qt[4];
+		qt[i] = T(0.5) * (T(1) / InvS);
+
+		s = T(0.5) * InvS;
+
+		qt[3] = (M.M[j][k] - M.M[k][j]) * s;
+		qt[j] = (M.M[i][j] + M.M[j][i]) * s;
+		qt[k] = (M.M[i][k] + M.M[k][i]) * s;
+
+		this->X = qt[0];
+		this->Y = qt[1];
+		this->Z = qt[2];
+		this->W = qt[3];
+	}
+}
+
+template<typename T>
+UE_MATH_INLINE TQuat<T> TQuat<T>::Log() const
+{
+	TQuat Result(X, Y, Z, T(0));
+
+	if (fabs(W) < T(1))
+	{
+		const T Angle = acos(W);
+		const T SinAngle = sin(Angle);
+
+		if (fabs(SinAngle) >= T(SMALL_NUMBER))
+		{
+			const T Scale = Angle / SinAngle;
+			Result.X = Scale * X;
+			Result.Y = Scale * Y;
+			Result.Z = Scale * Z;
+		}
+	}
+
+	return Result;
+}
+
+template<typename T>
+UE_MATH_INLINE TQuat<T> TQuat<T>::Exp() const
+{
+	const T Angle = sqrt(X * X + Y * Y + Z * Z);
+	const T SinAngle = sin(Angle);
+
+	TQuat Result(X, Y, Z, cos(Angle));
+	if (fabs(SinAngle) >= T(SMALL_NUMBER))
+	{
+		const T Scale = SinAngle / Angle;
+		Result.X = Scale * X;
+		Result.Y = Scale * Y;
+		Result.Z = Scale * Z;
+	}
+
+	return Result;
+}
+
+template<typename T>
+UE_MATH_INLINE TQuat<T> TQuat<T>::Slerp_NotNormalized(const TQuat& Quat1, const TQuat& Quat2, T Alpha)
+{
+	// Get cosine of angle between quats.
+	const T RawCosom = Quat1 | Quat2;
+	// Unaligned quats - compensate, results in taking shorter route.
+	const T Cosom = Select(RawCosom, RawCosom, -RawCosom);
+
+	T Scale0, Scale1;
+
+	if (Cosom < T(0.9999))
+	{
+		const T Omega = acos(Cosom);
+		const T InvSin = T(1) / sin(Omega);
+		Scale0 = sin((T(1) - Alpha) * Omega) * InvSin;
+		Scale1 = sin(Alpha * Omega) * InvSin;
+	}
+	else
+	{
+		// Use linear interpolation.
+		Scale0 = T(1) - Alpha;
+		Scale1 = Alpha;
+	}
+
+	// In keeping with our flipped Cosom:
+	Scale1 = Select(RawCosom, Scale1, -Scale1);
+
+	return (Quat1 * Scale0) + (Quat2 * Scale1);
+}
+
+template<typename T>
+UE_MATH_INLINE TQuat<T> TQuat<T>::SlerpFullPath_NotNormalized(const TQuat& Quat1, const TQuat& Quat2, T Alpha)
+{
+	const T CosAngle = std::clamp(Quat1 | Quat2, T(-1), T(1));
+	const T Angle = acos(CosAngle);
+
+	if (fabs(Angle) < T(KINDA_SMALL_NUMBER))
+	{
+		return Quat1;
+	}
+
+	const T InvSinAngle = T(1) / sin(Angle);
+	const T Scale0 = sin((T(1) - Alpha) * Angle) * InvSinAngle;
+	const T Scale1 = sin(Alpha * Angle) * InvSinAngle;
+
+	return (Quat1 * Scale0) + (Quat2 * Scale1);
+}
+
+template<typename T>
+UE_MATH_INLINE TQuat<T> TQuat<T>::FastSlerp(const TQuat& Quat1, const TQuat& Quat2, T Alpha)
+{
+	const T RawCosom = Quat1 | Quat2;
+	const T CosomMinusOne = Select(RawCosom, RawCosom, -RawCosom) - T(1);
+
+	// Both series at once, innermost (weighted) term first
+	const T Alpha0 = T(1) - Alpha;
+	const T Alpha0Squared = Alpha0 * Alpha0;
+	const T Alpha1Squared = Alpha * Alpha;
+	const int Last = FAST_SLERP_TERMS;
+	const T LastWeight = T(FAST_SLERP_LAST_TERM_WEIGHT * FastSlerpReciprocals[Last - 1]) * CosomMinusOne;
+	T Series0 = T(1) + (Alpha0Squared - T(Last * Last)) * LastWeight;
+	T Series1 = T(1) + (Alpha1Squared - T(Last * Last)) * LastWeight;
+	for (int i = Last - 1; i >= 1; --i)
+	{
+		const T Weight = T(FastSlerpReciprocals[i - 1]) * CosomMinusOne;
+		Series0 = T(1) + (Alpha0Squared - T(i * i)) * Weight * Series0;
+		Series1 = T(1) + (Alpha1Squared - T(i * i)) * Weight * Series1;
+	}
+
+	const T Scale0 = Alpha0 * Series0;
+	const T Scale1 = Select(RawCosom, Alpha * Series1, -Alpha * Series1);
+
+	return ((Quat1 * Scale0) + (Quat2 * Scale1)).GetNormalized();
+}
+
+template<typename T>
+UE_MATH_INLINE TQuat<T> TQuat<T>::Squad(const TQuat& Quat1, const TQuat& Tangent1, const TQuat& Quat2, const TQuat& Tangent2, T Alpha)
+{
+	// Always slerp along the short path from Quat1 to Quat2 to prevent axis flipping.
+	// This approach is taken by OGRE engine, amongst others.
+	const TQuat Q1 = Slerp_NotNormalized(Quat1, Quat2, Alpha);
+	const TQuat Q2 = SlerpFullPath_NotNormalized(Tangent1, Tangent2, Alpha);
+	return SlerpFullPath(Q1, Q2, T(2) * Alpha * (T(1) - Alpha));
+}
+
+template<typename T>
+UE_MATH_INLINE void TQuat<T>::CalcTangents(const TQuat& PrevP, const TQuat& P, const TQuat& NextP, T Tension, TQuat& OutTan)
+{
+	const TQuat InvP = P.Inverse();
+	const TQuat Part1 = (InvP * PrevP).Log();
+	const TQuat Part2 = (InvP * NextP).Log();
+
+	const TQuat PreExp = (Part1 + Part2) * (T(-0.25) * (T(1) - Tension));
+
+	OutTan = P * PreExp.Exp();
+}
@@ -0,0 +1,526 @@
+#include "ray.h"
+#include "cpu.h"
+
+#if UE_MATH_X86
+#include <immintrin.h>
+#endif
+
+/*-----------------------------------------------------------------------------
+	Per shape tests. Each returns the distance to the first hit, or INFINITY
+	on a miss; the vector kernels below evaluate the same formulas lane-wise.
+-----------------------------------------------------------------------------*/
+
+/** First hit on the sphere around Center, for a ray starting outside it. */
+static inline double EnterSphere(const FVector& Direction, const FVector& OriginToCenter, double RadiusSquared)
+{
+	const double B = Direction | OriginToCenter;
+	const double C = (OriginToCenter | OriginToCenter) - RadiusSquared;
+	const double H = B * B - C;
+	const double T = -B - sqrt(H > 0.0 ? H : 0.0);
+	return H >= 0.0 && T >= 0.0 ? T : INFINITY;
+}
+
+static inline double HitSphere(const FRay& Ray, const FVector& Center, double Radius)
+{
+	const FVector OC = Ray.Origin - Center;
+	const double RadiusSquared = Radius * Radius;
+	const double T = (OC | OC) <= RadiusSquared ? 0.0 : EnterSphere(Ray.Direction, OC, RadiusSquared);
+	return T <= Ray.MaxDistance ? T : INFINITY;
+}
+
+/**
+ * Slab test against a box whose corners are already ordered along the ray: Near holds the
+ * corner coordinate the ray enters each slab through. A NaN from a ray lying in a slab plane
+ * leaves the interval alone, as with _mm_max_pd/_mm_min_pd.
+ */
+static inline double HitSlabs(const FRay& Ray, const FVector& InvDirection, const FVector& Near, const FVector& Far)
+{
+	double T0 = 0.0, T1 = Ray.MaxDistance;
+	const double* O = &Ray.Origin.X;
+	const double* Inv = &InvDirection.X;
+	for (int Axis = 0; Axis < 3; ++Axis)
+	{
+		const double TNear = ((&Near.X)[Axis] - O[Axis]) * Inv[Axis];
+		const double TFar = ((&Far.X)[Axis] - O[Axis]) * Inv[Axis];
+		T0 = TNear > T0 ? TNear : T0;
+		T1 = TFar < T1 ? TFar : T1;
+	}
+	return T0 <= T1 ? T0 : INFINITY;
+}
+
+/**
+ * The capsule is the union of the cylinder around Start - End and the spheres at both ends, so
+ * from outside the first hit is the nearest of the hits on the cylinder's side (within the
+ * segment) and on the two spheres.
+ */
+static inline double HitCapsule(const FRay& Ray, const FVector& Start, const FVector& End, double Radius)
+{
+	const FVector& D = Ray.Direction;
+	const FVector BA = End - Start;
+	const FVector OA = Ray.Origin - Start;
+	const double BABA = BA | BA;
+	const double BARD = BA | D;
+	const double BAOA = BA | OA;
+	const double RDOA = D | OA;
+	const double OAOA = OA | OA;
+	const double RadiusSquared = Radius * Radius;
+
+	// Closest point of the segment; 0 / 0 for a sphere capsule picks Start
+	double S = BAOA / BABA;
+	S = S > 0.0 ? S : 0.0;
+	S = S < 1.0 ? S : 1.0;
+	const FVector P = OA - BA * S;
+	if ((P | P) <= RadiusSquared)
+	{
+		return 0.0;
+	}
+
+	const double A = BABA - BARD * BARD;
+	const double B = BABA * RDOA - BAOA * BARD;
+	const double C = BABA * OAOA - BAOA * BAOA - RadiusSquared * BABA;
+	const double H = B * B - A * C;
+	const double TSide = (-B - sqrt(H > 0.0 ? H : 0.0)) / A;
+	const double Y = BAOA + TSide * BARD;
+	double T = H >= 0.0 && A > 0.0 && TSide >= 0.0 && Y >= 0.0 && Y <= BABA ? TSide : INFINITY;
+
+	T = std::min(T, EnterSphere(D, OA, RadiusSquared));
+	T = std::min(T, EnterSphere(D, Ray.Origin - End, RadiusSquared));
+	return T <= Ray.MaxDistance ? T : INFINITY;
+}
+
+static inline FVector GetInvDirection(const FRay& Ray)
+{
+	return FVector(1.0 / Ray.Direction.X, 1.0 / Ray.Direction.Y, 1.0 / Ray.Direction.Z);
+}
+
+/** Swaps Min and Max (coordinates or arrays) on the axes the ray runs backwards along, so Min holds the near slab planes. */
+template<typename T>
+static inline void OrderSlabs(const FVector& Direction, T& MinX, T& MinY, T& MinZ, T& MaxX, T& MaxY, T& MaxZ)
+{
+	if (signbit(Direction.X))
+		std::swap(MinX, MaxX);
+	if (signbit(Direction.Y))
+		std::swap(MinY, MaxY);
+	if (signbit(Direction.Z))
+		std::swap(MinZ, MaxZ);
+}
+
+FRay::FRay(const FVector& Origin, const FVector& Direction, double MaxDistance)
+	: Origin(Origin), Direction(), MaxDistance(MaxDistance)
+{
+	const double Length = Direction.Length();
+	if (Length > 0.0)
+	{
+		this->Direction = Direction * (1.0 / Length);
+	}
+}
+
+FRay FRay::Segment(const FVector& Start, const FVector& End)
+{
+	return FRay(Start, End - Start, Start.Distance(End));
+}
+
+bool FRay::IntersectSphere(const FSphere& Sphere, double& OutDistance) const
+{
+	const double T = HitSphere(*this, Sphere.Center, Sphere.W);
+	if (T == INFINITY)
+	{
+		return false;
+	}
+	OutDistance = T;
+	return true;
+}
+
+bool FRay::IntersectBox(const FBox& Box, double& OutDistance) const
+{
+	FVector Near = Box.Min, Far = Box.Max;
+	OrderSlabs(Direction, Near.X, Near.Y, Near.Z, Far.X, Far.Y, Far.Z);
+
+	const double T = HitSlabs(*this, GetInvDirection(*this), Near, Far);
+	if (T == INFINITY)
+	{
+		return false;
+	}
+	OutDistance = T;
+	return true;
+}
+
+bool FRay::IntersectCapsule(const FVector& Start, const FVector& End, double Radius, double& OutDistance) const
+{
+	const double T = HitCapsule(*this, Start, End, Radius);
+	if (T == INFINITY)
+	{
+		return false;
+	}
+	OutDistance = T;
+	return true;
+}
+
+/*-----------------------------------------------------------------------------
+	Batched casts. Each kernel keeps the nearest hit per lane and merges the
+	lanes at the end; a lane only takes strictly nearer hits, so ties go to
+	the lower index as in the scalar loop.
+-----------------------------------------------------------------------------*/
+
+static inline double HitAt(const FRay& Ray, const FVector&, const FSphereSoA& Spheres, size_t i)
+{
+	return HitSphere(Ray, Spheres.Center.Get(i), Spheres.Radius[i]);
+}
+
+static inline double HitAt(const FRay& Ray, const FVector& InvDirection, const FBoxSoA& Slabs, size_t i)
+{
+	return HitSlabs(Ray, InvDirection, Slabs.Min.Get(i), Slabs.Max.Get(i));
+}
+
+static inline double HitAt(const FRay& Ray, const FVector&, const FCapsuleSoA& Capsules, size_t i)
+{
+	return HitCapsule(Ray, Capsules.Start.Get(i), Capsules.End.Get(i), Capsules.Radius[i]);
+}
+
+template<typename ShapeSoA>
+static void RaycastScalar(const FRay& Ray, const FVector& InvDirection, const ShapeSoA& Shapes, size_t Begin, size_t Count, int32_t& BestIndex, double& BestDistance)
+{
+	for (size_t i = Begin; i < Count; ++i)
+	{
+		const double T = HitAt(Ray, InvDirection, Shapes, i);
+		if (T < BestDistance)
+		{
+			BestDistance = T;
+			BestIndex = (int32_t)i;
+		}
+	}
+}
+
+/** Merges per lane results, the lower index winning ties. */
+static void MergeLanes(const double* Distances, const double* Indices, int NumLanes, int32_t& BestIndex, double& BestDistance)
+{
+	for (int Lane = 0; Lane < NumLanes; ++Lane)
+	{
+		if (Distances[Lane] < BestDistance || (Distances[Lane] == BestDistance && Distances[Lane] < INFINITY && (int32_t)Indices[Lane] < BestIndex))
+		{
+			BestDistance = Distances[Lane];
+			BestIndex = (int32_t)Indices[Lane];
+		}
+	}
+}
+
+#if UE_MATH_X86
+struct FRayAVX2
+{
+	__m256d OX, OY, OZ;
+	__m256d DX, DY, DZ;
+	__m256d IX, IY, IZ;
+	__m256d MaxT;
+};
+
+UE_TARGET_AVX2_FMA static inline __m256d Dot3(__m256d AX, __m256d AY, __m256d AZ, __m256d BX, __m256d BY, __m256d BZ)
+{
+	return _mm256_fmadd_pd(AX, BX, _mm256_fmadd_pd(AY, BY, _mm256_mul_pd(AZ, BZ)));
+}
+
+UE_TARGET_AVX2_FMA static inline __m256d EnterSphereAVX2(const FRayAVX2& R, __m256d OCX, __m256d OCY, __m256d OCZ, __m256d RadiusSquared)
+{
+	const __m256d Zero = _mm256_setzero_pd();
+	const __m256d B = Dot3(R.DX, R.DY, R.DZ, OCX, OCY, OCZ);
+	const __m256d C = _mm256_sub_pd(Dot3(OCX, OCY, OCZ, OCX, OCY, OCZ), RadiusSquared);
+	const __m256d H = _mm256_fmsub_pd(B, B, C);
+	const __m256d T = _mm256_sub_pd(_mm256_sub_pd(Zero, B), _mm256_sqrt_pd(_mm256_max_pd(H, Zero)));
+	const __m256d Hit = _mm256_and_pd(_mm256_cmp_pd(H, Zero, _CMP_GE_OQ), _mm256_cmp_pd(T, Zero, _CMP_GE_OQ));
+	return _mm256_blendv_pd(_mm256_set1_pd(INFINITY), T, Hit);
+}
+
+UE_TARGET_AVX2_FMA static inline __m256d HitAVX2(const FRayAVX2& R, const FSphereSoA& Spheres, size_t i)
+{
+	const __m256d OCX = _mm256_sub_pd(R.OX, _mm256_loadu_pd(Spheres.Center.X + i));
+	const __m256d OCY = _mm256_sub_pd(R.OY, _mm256_loadu_pd(Spheres.Center.Y + i));
+	const __m256d OCZ = _mm256_sub_pd(R.OZ, _mm256_loadu_pd(Spheres.Center.Z + i));
+	const __m256d Radius = _mm256_loadu_pd(Spheres.Radius + i);
+	const __m256d RadiusSquared = _mm256_mul_pd(Radius, Radius);
+
+	const __m256d Inside = _mm256_cmp_pd(Dot3(OCX, OCY, OCZ, OCX, OCY, OCZ), RadiusSquared, _CMP_LE_OQ);
+	const __m256d T = _mm256_andnot_pd(Inside, EnterSphereAVX2(R, OCX, OCY, OCZ, RadiusSquared));
+	return _mm256_blendv_pd(_mm256_set1_pd(INFINITY), T, _mm256_cmp_pd(T, R.MaxT, _CMP_LE_OQ));
+}
+
+UE_TARGET_AVX2_FMA static inline __m256d HitAVX2(const FRayAVX2& R, const FBoxSoA& Slabs, size_t i)
+{
+	// max(TNear, T0) and min(TFar, T1) return the second operand on a NaN
+	__m256d T0 = _mm256_setzero_pd(), T1 = R.MaxT;
+	T0 = _mm256_max_pd(_mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(Slabs.Min.X + i), R.OX), R.IX), T0);
+	T1 = _mm256_min_pd(_mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(Slabs.Max.X + i), R.OX), R.IX), T1);
+	T0 = _mm256_max_pd(_mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(Slabs.Min.Y + i), R.OY), R.IY), T0);
+	T1 = _mm256_min_pd(_mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(Slabs.Max.Y + i), R.OY), R.IY), T1);
+	T0 = _mm256_max_pd(_mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(Slabs.Min.Z + i), R.OZ), R.IZ), T0);
+	T1 = _mm256_min_pd(_mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(Slabs.Max.Z + i), R.OZ), R.IZ), T1);
+	return _mm256_blendv_pd(_mm256_set1_pd(INFINITY), T0, _mm256_cmp_pd(T0, T1, _CMP_LE_OQ));
+}
+
+UE_TARGET_AVX2_FMA static inline __m256d HitAVX2(const FRayAVX2& R, const FCapsuleSoA& Capsules, size_t i)
+{
+	const __m256d Zero = _mm256_setzero_pd();
+	const __m256d One = _mm256_set1_pd(1.0);
+	const __m256d AX = _mm256_loadu_pd(Capsules.Start.X + i);
+	const __m256d AY = _mm256_loadu_pd(Capsules.Start.Y + i);
+	const __m256d AZ = _mm256_loadu_pd(Capsules.Start.Z + i);
+	const __m256d BX = _mm256_loadu_pd(Capsules.End.X + i);
+	const __m256d BY = _mm256_loadu_pd(Capsules.End.Y + i);
+	const __m256d BZ = _mm256_loadu_pd(Capsules.End.Z + i);
+	const __m256d Radius = _mm256_loadu_pd(Capsules.Radius + i);
+	const __m256d RadiusSquared = _mm256_mul_pd(Radius, Radius);
+
+	const __m256d BAX = _mm256_sub_pd(BX, AX), BAY = _mm256_sub_pd(BY, AY), BAZ = _mm256_sub_pd(BZ, AZ);
+	const __m256d OAX = _mm256_sub_pd(R.OX, AX), OAY = _mm256_sub_pd(R.OY, AY), OAZ = _mm256_sub_pd(R.OZ, AZ);
+	const __m256d BABA = Dot3(BAX, BAY, BAZ, BAX, BAY, BAZ);
+	const __m256d BARD = Dot3(BAX, BAY, BAZ, R.DX, R.DY, R.DZ);
+	const __m256d BAOA = Dot3(BAX, BAY, BAZ, OAX, OAY, OAZ);
+	const __m256d RDOA = Dot3(R.DX, R.DY, R.DZ, OAX, OAY, OAZ);
+	const __m256d OAOA = Dot3(OAX, OAY, OAZ, OAX, OAY, OAZ);
+
+	// max(NaN, 0) is 0, as in the scalar clamp
+	const __m256d S = _mm256_min_pd(_mm256_max_pd(_mm256_div_pd(BAOA, BABA), Zero), One);
+	const __m256d PX = _mm256_fnmadd_pd(BAX, S, OAX), PY = _mm256_fnmadd_pd(BAY, S, OAY), PZ = _mm256_fnmadd_pd(BAZ, S, OAZ);
+	const __m256d Inside = _mm256_cmp_pd(Dot3(PX, PY, PZ, PX, PY, PZ), RadiusSquared, _CMP_LE_OQ);
+
+	const __m256d A = _mm256_fnmadd_pd(BARD, BARD, BABA);
+	const __m256d B = _mm256_fmsub_pd(BABA, RDOA, _mm256_mul_pd(BAOA, BARD));
+	const __m256d C = _mm256_fnmadd_pd(RadiusSquared, BABA, _mm256_fmsub_pd(BABA, OAOA, _mm256_mul_pd(BAOA, BAOA)));
+	const __m256d H = _mm256_fmsub_pd(B, B, _mm256_mul_pd(A, C));
+	const __m256d TSide = _mm256_div_pd(_mm256_sub_pd(_mm256_sub_pd(Zero, B), _mm256_sqrt_pd(_mm256_max_pd(H, Zero))), A);
+	const __m256d Y = _mm256_fmadd_pd(TSide, BARD, BAOA);
+	__m256d SideHit = _mm256_and_pd(_mm256_cmp_pd(H, Zero, _CMP_GE_OQ), _mm256_cmp_pd(A, Zero, _CMP_GT_OQ));
+	SideHit = _mm256_and_pd(SideHit, _mm256_cmp_pd(TSide, Zero, _CMP_GE_OQ));
+	SideHit = _mm256_and_pd(SideHit, _mm256_and_pd(_mm256_cmp_pd(Y, Zero, _CMP_GE_OQ), _mm256_cmp_pd(Y, BABA, _CMP_LE_OQ)));
+	__m256d T = _mm256_blendv_pd(_mm256_set1_pd(INFINITY), TSide, SideHit);
+
+	T = _mm256_min_pd(T, EnterSphereAVX2(R, OAX, OAY, OAZ, RadiusSquared));
+	T = _mm256_min_pd(T, EnterSphereAVX2(R, _mm256_sub_pd(R.OX, BX), _mm256_sub_pd(R.OY, BY), _mm256_sub_pd(R.OZ, BZ), RadiusSquared));
+	T = _mm256_andnot_pd(Inside, T);
+	return _mm256_blendv_pd(_mm256_set1_pd(INFINITY), T, _mm256_cmp_pd(T, R.MaxT, _CMP_LE_OQ));
+}
+
+template<typename ShapeSoA>
+UE_TARGET_AVX2_FMA static size_t RaycastAVX2(const FRay& Ray, const FVector& InvDirection, const ShapeSoA& Shapes, size_t Count, int32_t& BestIndex, double& BestDistance)
+{
+	if (Count < 4)
+	{
+		return 0;
+	}
+
+	FRayAVX2 R;
+	R.OX = _mm256_set1_pd(Ray.Origin.X); R.OY = _mm256_set1_pd(Ray.Origin.Y); R.OZ = _mm256_set1_pd(Ray.Origin.Z);
+	R.DX = _mm256_set1_pd(Ray.Direction.X); R.DY = _mm256_set1_pd(Ray.Direction.Y); R.DZ = _mm256_set1_pd(Ray.Direction.Z);
+	R.IX = _mm256_set1_pd(InvDirection.X); R.IY = _mm256_set1_pd(InvDirection.Y); R.IZ = _mm256_set1_pd(InvDirection.Z);
+	R.MaxT = _mm256_set1_pd(Ray.MaxDistance);
+
+	__m256d Best = _mm256_set1_pd(INFINITY);
+	__m256d BestLane = _mm256_setzero_pd();
+	__m256d Index = _mm256_set_pd(3, 2, 1, 0);
+	const __m256d Step = _mm256_set1_pd(4);
+
+	size_t i = 0;
+	for (; i + 4 <= Count; i += 4)
+	{
+		const __m256d T = HitAVX2(R, Shapes, i);
+		const __m256d Nearer = _mm256_cmp_pd(T, Best, _CMP_LT_OQ);
+		Best = _mm256_blendv_pd(Best, T, Nearer);
+		BestLane = _mm256_blendv_pd(BestLane, Index, Nearer);
+		Index = _mm256_add_pd(Index, Step);
+	}
+
+	alignas(32) double Distances[4], Indices[4];
+	_mm256_store_pd(Distances, Best);
+	_mm256_store_pd(Indices, BestLane);
+	_mm256_zeroupper();
+	MergeLanes(Distances, Indices, 4, BestIndex, BestDistance);
+	return i;
+}
+
+struct FRayAVX512
+{
+	__m512d OX, OY, OZ;
+	__m512d DX, DY, DZ;
+	__m512d IX, IY, IZ;
+	__m512d MaxT;
+};
+
+UE_TARGET_AVX512 static inline __m512d Dot3(__m512d AX, __m512d AY, __m512d AZ, __m512d BX, __m512d BY, __m512d BZ)
+{
+	return _mm512_fmadd_pd(AX, BX, _mm512_fmadd_pd(AY, BY, _mm512_mul_pd(AZ, BZ)));
+}
+
+UE_TARGET_AVX512 static inline __m512d EnterSphereAVX512(const FRayAVX512& R, __m512d OCX, __m512d OCY, __m512d OCZ, __m512d RadiusSquared)
+{
+	const __m512d Zero = _mm512_setzero_pd();
+	const __m512d B = Dot3(R.DX, R.DY, R.DZ, OCX, OCY, OCZ);
+	const __m512d C = _mm512_sub_pd(Dot3(OCX, OCY, OCZ, OCX, OCY, OCZ), RadiusSquared);
+	const __m512d H = _mm512_fmsub_pd(B, B, C);
+	const __m512d T = _mm512_sub_pd(_mm512_sub_pd(Zero, B), _mm512_sqrt_pd(_mm512_max_pd(H, Zero)));
+	const __mmask8 Hit = _mm512_cmp_pd_mask(H, Zero, _CMP_GE_OQ) & _mm512_cmp_pd_mask(T, Zero, _CMP_GE_OQ);
+	return _mm512_mask_blend_pd(Hit, _mm512_set1_pd(INFINITY), T);
+}
+
+UE_TARGET_AVX512 static inline __m512d HitAVX512(const FRayAVX512& R, const FSphereSoA& Spheres, size_t i)
+{
+	const __m512d OCX = _mm512_sub_pd(R.OX, _mm512_loadu_pd(Spheres.Center.X + i));
+	const __m512d OCY = _mm512_sub_pd(R.OY, _mm512_loadu_pd(Spheres.Center.Y + i));
+	const __m512d OCZ = _mm512_sub_pd(R.OZ, _mm512_loadu_pd(Spheres.Center.Z + i));
+	const __m512d Radius = _mm512_loadu_pd(Spheres.Radius + i);
+	const __m512d RadiusSquared = _mm512_mul_pd(Radius, Radius);
+
+	const __mmask8 Inside = _mm512_cmp_pd_mask(Dot3(OCX, OCY, OCZ, OCX, OCY, OCZ), RadiusSquared, _CMP_LE_OQ);
+	const __m512d T = _mm512_mask_blend_pd(Inside, EnterSphereAVX512(R, OCX, OCY, OCZ, RadiusSquared), _mm512_setzero_pd());
+	return _mm512_mask_blend_pd(_mm512_cmp_pd_mask(T, R.MaxT, _CMP_LE_OQ), _mm512_set1_pd(INFINITY), T);
+}
+
+UE_TARGET_AVX512 static inline __m512d HitAVX512(const FRayAVX512& R, const FBoxSoA& Slabs, size_t i)
+{
+	__m512d T0 = _mm512_setzero_pd(), T1 = R.MaxT;
+	T0 = _mm512_max_pd(_mm512_mul_pd(_mm512_sub_pd(_mm512_loadu_pd(Slabs.Min.X + i), R.OX), R.IX), T0);
+	T1 = _mm512_min_pd(_mm512_mul_pd(_mm512_sub_pd(_mm512_loadu_pd(Slabs.Max.X + i), R.OX), R.IX), T1);
+	T0 = _mm512_max_pd(_mm512_mul_pd(_mm512_sub_pd(_mm512_loadu_pd(Slabs.Min.Y + i), R.OY), R.IY), T0);
+	T1 = _mm512_min_pd(_mm512_mul_pd(_mm512_sub_pd(_mm512_loadu_pd(Slabs.Max.Y + i), R.OY), R.IY), T1);
+	T0 = _mm512_max_pd(_mm512_mul_pd(_mm512_sub_pd(_mm512_loadu_pd(Slabs.Min.Z + i), R.OZ), R.IZ), T0);
+	T1 = _mm512_min_pd(_mm512_mul_pd(_mm512_sub_pd(_mm512_loadu_pd(Slabs.Max.Z + i), R.OZ), R.IZ), T1);
+	return _mm512_mask_blend_pd(_mm512_cmp_pd_mask(T0, T1, _CMP_LE_OQ), _mm512_set1_pd(INFINITY), T0);
+}
+
+UE_TARGET_AVX512 static inline __m512d HitAVX512(const FRayAVX512& R, const FCapsuleSoA& Capsules, size_t i)
+{
+	const __m512d Zero = _mm512_setzero_pd();
+	const __m512d One = _mm512_set1_pd(1.0);
+	const __m512d AX = _mm512_loadu_pd(Capsules.Start.X + i);
+	const __m512d AY = _mm512_loadu_pd(Capsules.Start.Y + i);
+	const __m512d AZ = _mm512_loadu_pd(Capsules.Start.Z + i);
+	const __m512d BX = _mm512_loadu_pd(Capsules.End.X + i);
+	const __m512d BY = _mm512_loadu_pd(Capsules.End.Y + i);
+	const __m512d BZ = _mm512_loadu_pd(Capsules.End.Z + i);
+	const __m512d Radius = _mm512_loadu_pd(Capsules.Radius + i);
+	const __m512d RadiusSquared = _mm512_mul_pd(Radius, Radius);
+
+	const __m512d BAX = _mm512_sub_pd(BX, AX), BAY = _mm512_sub_pd(BY, AY), BAZ = _mm512_sub_pd(BZ, AZ);
+	const __m512d OAX = _mm512_sub_pd(R.OX, AX), OAY = _mm512_sub_pd(R.OY, AY), OAZ = _mm512_sub_pd(R.OZ, AZ);
+	const __m512d BABA = Dot3(BAX, BAY, BAZ, BAX, BAY, BAZ);
+	const __m512d BARD = Dot3(BAX, BAY, BAZ, R.DX, R.DY, R.DZ);
+	const __m512d BAOA = Dot3(BAX, BAY, BAZ, OAX, OAY, OAZ);
+	const __m512d RDOA = Dot3(R.DX, R.DY, R.DZ, OAX, OAY, OAZ);
+	const __m512d OAOA = Dot3(OAX, OAY, OAZ, OAX, OAY, OAZ);
+
+	const __m512d S = _mm512_min_pd(_mm512_max_pd(_mm512_div_pd(BAOA, BABA), Zero), One);
+	const __m512d PX = _mm512_fnmadd_pd(BAX, S, OAX), PY = _mm512_fnmadd_pd(BAY, S, OAY), PZ = _mm512_fnmadd_pd(BAZ, S, OAZ);
+	const __mmask8 Inside = _mm512_cmp_pd_mask(Dot3(PX, PY, PZ, PX, PY, PZ), RadiusSquared, _CMP_LE_OQ);
+
+	const __m512d A = _mm512_fnmadd_pd(BARD, BARD, BABA);
+	const __m512d B = _mm512_fmsub_pd(BABA, RDOA, _mm512_mul_pd(BAOA, BARD));
+	const __m512d C = _mm512_fnmadd_pd(RadiusSquared, BABA, _mm512_fmsub_pd(BABA, OAOA, _mm512_mul_pd(BAOA, BAOA)));
+	const __m512d H = _mm512_fmsub_pd(B, B, _mm512_mul_pd(A, C));
+	const __m512d TSide = _mm512_div_pd(_mm512_sub_pd(_mm512_sub_pd(Zero, B), _mm512_sqrt_pd(_mm512_max_pd(H, Zero))), A);
+	const __m512d Y = _mm512_fmadd_pd(TSide, BARD, BAOA);
+	__mmask8 SideHit = _mm512_cmp_pd_mask(H, Zero, _CMP_GE_OQ) & _mm512_cmp_pd_mask(A, Zero, _CMP_GT_OQ);
+	SideHit &= _mm512_cmp_pd_mask(TSide, Zero, _CMP_GE_OQ);
+	SideHit &= _mm512_cmp_pd_mask(Y, Zero, _CMP_GE_OQ) & _mm512_cmp_pd_mask(Y, BABA, _CMP_LE_OQ);
+	__m512d T = _mm512_mask_blend_pd(SideHit, _mm512_set1_pd(INFINITY), TSide);
+
+	T = _mm512_min_pd(T, EnterSphereAVX512(R, OAX, OAY, OAZ, RadiusSquared));
+	T = _mm512_min_pd(T, EnterSphereAVX512(R, _mm512_sub_pd(R.OX, BX), _mm512_sub_pd(R.OY, BY), _mm512_sub_pd(R.OZ, BZ), RadiusSquared));
+	T = _mm512_mask_blend_pd(Inside, T, Zero);
+	return _mm512_mask_blend_pd(_mm512_cmp_pd_mask(T, R.MaxT, _CMP_LE_OQ), _mm512_set1_pd(INFINITY), T);
+}
+
+template<typename ShapeSoA>
+UE_TARGET_AVX512 static size_t RaycastAVX512(const FRay& Ray, const FVector& InvDirection, const ShapeSoA& Shapes, size_t Count, int32_t& BestIndex, double& BestDistance)
+{
+	if (Count < 8)
+	{
+		return 0;
+	}
+
+	FRayAVX512 R;
+	R.OX = _mm512_set1_pd(Ray.Origin.X); R.OY = _mm512_set1_pd(Ray.Origin.Y); R.OZ = _mm512_set1_pd(Ray.Origin.Z);
+	R.DX = _mm512_set1_pd(Ray.Direction.X); R.DY = _mm512_set1_pd(Ray.Direction.Y); R.DZ = _mm512_set1_pd(Ray.Direction.Z);
+	R.IX = _mm512_set1_pd(InvDirection.X); R.IY = _mm512_set1_pd(InvDirection.Y); R.IZ = _mm512_set1_pd(InvDirection.Z);
+	R.MaxT = _mm512_set1_pd(Ray.MaxDistance);
+
+	__m512d Best = _mm512_set1_pd(INFINITY);
+	__m512d BestLane = _mm512_setzero_pd();
+	__m512d Index = _mm512_set_pd(7, 6, 5, 4, 3, 2, 1, 0);
+	const __m512d Step = _mm512_set1_pd(8);
+
+	size_t i = 0;
+	for (; i + 8 <= Count; i += 8)
+	{
+		const __m512d T = HitAVX512(R, Shapes, i);
+		const __mmask8 Nearer = _mm512_cmp_pd_mask(T, Best, _CMP_LT_OQ);
+		Best = _mm512_mask_blend_pd(Nearer, Best, T);
+		BestLane = _mm512_mask_blend_pd(Nearer, BestLane, Index);
+		Index = _mm512_add_pd(Index, Step);
+	}
+
+	alignas(64) double Distances[8], Indices[8];
+	_mm512_store_pd(Distances, Best);
+	_mm512_store_pd(Indices, BestLane);
+	_mm256_zeroupper();
+	MergeLanes(Distances, Indices, 8, BestIndex, BestDistance);
+	return i;
+}
+#endif
+
+template<typename ShapeSoA>
+static bool RaycastDispatch(const FRay& Ray, const ShapeSoA& Shapes, size_t Count, int32_t& OutIndex, double& OutDistance)
+{
+	const FVector InvDirection = GetInvDirection(Ray);
+	int32_t BestIndex = -1;
+	double BestDistance = INFINITY;
+
+	size_t Begin = 0;
+	switch (GetSimdLevel())
+	{
+#if UE_MATH_X86
+	case ESimdLevel::AVX512:
+		Begin = RaycastAVX512(Ray, InvDirection, Shapes, Count, BestIndex, BestDistance);
+		break;
+	case ESimdLevel::AVX2:
+		Begin = RaycastAVX2(Ray, InvDirection, Shapes, Count, BestIndex, BestDistance);
+		break;
+#endif
+	default:
+		break;
+	}
+	RaycastScalar(Ray, InvDirection, Shapes, Begin, Count, BestIndex, BestDistance);
+
+	if (BestIndex < 0)
+	{
+		return false;
+	}
+	OutIndex = BestIndex;
+	OutDistance = BestDistance;
+	return true;
+}
+
+bool RaycastSpheres(const FRay& Ray, const FSphereSoA& Spheres, size_t Count, int32_t& OutIndex, double& OutDistance)
+{
+	return RaycastDispatch(Ray, Spheres, Count, OutIndex, OutDistance);
+}
+
+bool RaycastBoxes(const FRay& Ray, const FBoxSoA& Boxes, size_t Count, int32_t& OutIndex, double& OutDistance)
+{
+	FBoxSoA Slabs = Boxes;
+	OrderSlabs(Ray.Direction, Slabs.Min.X, Slabs.Min.Y, Slabs.Min.Z, Slabs.Max.X, Slabs.Max.Y, Slabs.Max.Z);
+	return RaycastDispatch(Ray, Slabs, Count, OutIndex, OutDistance);
+}
+
+bool RaycastCapsules(const FRay& Ray, const FCapsuleSoA& Capsules, size_t Count, int32_t& OutIndex, double& OutDistance)
+{
+	return RaycastDispatch(Ray, Capsules, Count, OutIndex, OutDistance);
+}
+
+void GetBoneCapsules(const FSkeletonPose& Pose, const FTransform& ComponentToWorld, const double* Radii, FCapsuleSoA Out)
+{
+	// Parents come first, so every parent location is known by the time its children read it
+	Pose.GetWorldLocations(ComponentToWorld, Out.End);
+	for (size_t Bone = 0; Bone < Pose.Num(); ++Bone)
+	{
+		const int32_t Parent = Pose.GetParentIndex(Bone);
+		Out.Start.Set(Bone, Out.End.Get(Parent >= 0 ? (size_t)Parent : Bone));
+		Out.Radius[Bone] = Radii[Bone];
+	}
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include "ue4math.h"
+#include "vector.h"
+#include "bounds.h"
+#include "batch.h"
+#include "skeleton.h"
+
+/**
+ * Ray or segment: the points Origin + t * Direction for 0 <= t <= MaxDistance.
+ *
+ * Direction is unit length, so t is a distance. A shape the ray starts inside is hit at t = 0;
+ * shapes that only touch the ray count as hit.
+ */
+struct FRay
+{
+public:
+	FVector Origin;
+	FVector Direction;
+	double MaxDistance;
+
+	FRay() : Origin(), Direction(1, 0, 0), MaxDistance(INFINITY) {}
+
+	/** Normalizes Direction; a zero Direction makes a ray that only hits shapes containing Origin. */
+	FRay(const FVector& Origin, const FVector& Direction, double MaxDistance = INFINITY);
+
+	/** The segment from Start to End. */
+	static FRay Segment(const FVector& Start, const FVector& End);
+
+	FVector PointAt(double Distance) const { return Origin + Direction * Distance; }
+
+	/** @return false if the shape is missed (OutDistance is left alone) */
+	bool IntersectSphere(const FSphere& Sphere, double& OutDistance) const;
+	bool IntersectBox(const FBox& Box, double& OutDistance) const;
+	bool IntersectCapsule(const FVector& Start, const FVector& End, double Radius, double& OutDistance) const;
+};
+
+/*-----------------------------------------------------------------------------
+	Shape arrays for the batched ray casts, one array per component as with
+	FVectorSoA. Not owning.
+-----------------------------------------------------------------------------*/
+
+struct FSphereSoA
+{
+	FVectorSoA Center;
+	double* Radius;
+
+	FSphereSoA() : Radius(nullptr) {}
+	FSphereSoA(FVectorSoA Center, double* Radius) : Center(Center), Radius(Radius) {}
+};
+
+struct FBoxSoA
+{
+	FVectorSoA Min;
+	FVectorSoA Max;
+
+	FBoxSoA() {}
+	FBoxSoA(FVectorSoA Min, FVectorSoA Max) : Min(Min), Max(Max) {}
+};
+
+/** Capsules: the points within Radius of the segment Start - End. Start == End makes a sphere. */
+struct FCapsuleSoA
+{
+	FVectorSoA Start;
+	FVectorSoA End;
+	double* Radius;
+
+	FCapsuleSoA() : Radius(nullptr) {}
+	FCapsuleSoA(FVectorSoA Start, FVectorSoA End, double* Radius) : Start(Start), End(End), Radius(Radius) {}
+};
+
+/**
+ * Nearest of Count shapes hit by Ray, with ties going to the lower index. Tests four (AVX2) or
+ * eight (AVX-512) shapes per step per GetSimdLevel(), with the same formulas as the FRay methods.
+ *
+ * @return false if nothing is hit (the out values are left alone)
+ */
+bool RaycastSpheres(const FRay& Ray, const FSphereSoA& Spheres, size_t Count, int32_t& OutIndex, double& OutDistance);
+bool RaycastBoxes(const FRay& Ray, const FBoxSoA& Boxes, size_t Count, int32_t& OutIndex, double& OutDistance);
+bool RaycastCapsules(const FRay& Ray, const FCapsuleSoA& Capsules, size_t Count, int32_t& OutIndex, double& OutDistance);
+
+/**
+ * Hitbox capsules for every bone of Pose, in world space as of its last Evaluate(): capsule i
+ * runs from the parent of bone i to bone i with radius Radii[i], so a hit index is the bone
+ * index. A root's capsule is a sphere around the bone.
+ */
+void GetBoneCapsules(const FSkeletonPose& Pose, const FTransform& ComponentToWorld, const double* Radii, FCapsuleSoA Out);
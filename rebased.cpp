@@ -0,0 +1,471 @@
+#include "rebased.h"
+#include "cpu.h"
+#include "parallel.h"
+
+#if UE_MATH_X86
+#include <immintrin.h>
+#endif
+
+/*-----------------------------------------------------------------------------
+	Conversions. The double difference or sum is rounded once either way, so
+	the vector kernels (four vectors per step) match the scalar code exactly.
+-----------------------------------------------------------------------------*/
+
+#if UE_MATH_X86
+UE_TARGET_AVX2 UE_NO_FP_CONTRACT static size_t RebaseAVX2(const FVector* World, FRebasedVectorSoA Out, size_t Count)
+{
+	const __m256d OX = _mm256_set1_pd(Out.Origin.X);
+	const __m256d OY = _mm256_set1_pd(Out.Origin.Y);
+	const __m256d OZ = _mm256_set1_pd(Out.Origin.Z);
+
+	size_t i = 0;
+	for (; i + 4 <= Count; i += 4)
+	{
+		// Four packed FVectors are three registers: x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3
+		const double* Src = &World[i].X;
+		const __m256d R0 = _mm256_loadu_pd(Src + 0);
+		const __m256d R1 = _mm256_loadu_pd(Src + 4);
+		const __m256d R2 = _mm256_loadu_pd(Src + 8);
+		const __m256d PX = _mm256_permute4x64_pd(_mm256_blend_pd(_mm256_blend_pd(R0, R1, 0x4), R2, 0x2), _MM_SHUFFLE(1, 2, 3, 0));
+		const __m256d PY = _mm256_permute4x64_pd(_mm256_blend_pd(_mm256_blend_pd(R0, R1, 0x9), R2, 0x4), _MM_SHUFFLE(2, 3, 0, 1));
+		const __m256d PZ = _mm256_permute4x64_pd(_mm256_blend_pd(_mm256_blend_pd(R0, R1, 0x2), R2, 0x9), _MM_SHUFFLE(3, 0, 1, 2));
+
+		_mm_storeu_ps(Out.Offsets.X + i, _mm256_cvtpd_ps(_mm256_sub_pd(PX, OX)));
+		_mm_storeu_ps(Out.Offsets.Y + i, _mm256_cvtpd_ps(_mm256_sub_pd(PY, OY)));
+		_mm_storeu_ps(Out.Offsets.Z + i, _mm256_cvtpd_ps(_mm256_sub_pd(PZ, OZ)));
+	}
+	return i;
+}
+
+UE_TARGET_AVX2 UE_NO_FP_CONTRACT static size_t ResolveAVX2(const FRebasedVectorSoA& In, FVector* OutWorld, size_t Count)
+{
+	const __m256d OX = _mm256_set1_pd(In.Origin.X);
+	const __m256d OY = _mm256_set1_pd(In.Origin.Y);
+	const __m256d OZ = _mm256_set1_pd(In.Origin.Z);
+
+	size_t i = 0;
+	for (; i + 4 <= Count; i += 4)
+	{
+		const __m256d PX = _mm256_add_pd(OX, _mm256_cvtps_pd(_mm_loadu_ps(In.Offsets.X + i)));
+		const __m256d PY = _mm256_add_pd(OY, _mm256_cvtps_pd(_mm_loadu_ps(In.Offsets.Y + i)));
+		const __m256d PZ = _mm256_add_pd(OZ, _mm256_cvtps_pd(_mm_loadu_ps(In.Offsets.Z + i)));
+
+		// The inverse of the shuffle in RebaseAVX2: x0 x3 x2 x1, y1 y0 y3 y2 and z2 z1 z0 z3 blend into the three rows
+		const __m256d X = _mm256_permute4x64_pd(PX, _MM_SHUFFLE(1, 2, 3, 0));
+		const __m256d Y = _mm256_permute4x64_pd(PY, _MM_SHUFFLE(2, 3, 0, 1));
+		const __m256d Z = _mm256_permute4x64_pd(PZ, _MM_SHUFFLE(3, 0, 1, 2));
+		double* Dst = &OutWorld[i].X;
+		_mm256_storeu_pd(Dst + 0, _mm256_blend_pd(_mm256_blend_pd(X, Y, 0x2), Z, 0x4));
+		_mm256_storeu_pd(Dst + 4, _mm256_blend_pd(_mm256_blend_pd(Y, Z, 0x2), X, 0x4));
+		_mm256_storeu_pd(Dst + 8, _mm256_blend_pd(_mm256_blend_pd(Z, X, 0x2), Y, 0x4));
+	}
+	return i;
+}
+#endif
+
+void BatchRebase(const FVector* World, FRebasedVectorSoA Out, size_t Count)
+{
+	size_t i = 0;
+	switch (GetSimdLevel())
+	{
+#if UE_MATH_X86
+	case ESimdLevel::AVX512:
+	case ESimdLevel::AVX2:
+		i = RebaseAVX2(World, Out, Count);
+		break;
+#endif
+	default:
+		break;
+	}
+
+	for (; i < Count; ++i)
+	{
+		Out.Set(i, World[i]);
+	}
+}
+
+void BatchResolve(const FRebasedVectorSoA& In, FVector* OutWorld, size_t Count)
+{
+	size_t i = 0;
+	switch (GetSimdLevel())
+	{
+#if UE_MATH_X86
+	case ESimdLevel::AVX512:
+	case ESimdLevel::AVX2:
+		i = ResolveAVX2(In, OutWorld, Count);
+		break;
+#endif
+	default:
+		break;
+	}
+
+	for (; i < Count; ++i)
+	{
+		OutWorld[i] = In.Get(i);
+	}
+}
+
+/*-----------------------------------------------------------------------------
+	Distances. Multiplies and adds in the scalar order, without contraction,
+	so every level agrees bit for bit.
+-----------------------------------------------------------------------------*/
+
+static void DistanceSquaredScalar(FVector3fSoA In, const FVector3f& Point, float* Out, size_t Begin, size_t Count)
+{
+	for (size_t i = Begin; i < Count; ++i)
+	{
+		const FVector3f D = In.Get(i) - Point;
+		Out[i] = D | D;
+	}
+}
+
+#if UE_MATH_X86
+UE_TARGET_AVX2 UE_NO_FP_CONTRACT static size_t DistanceSquaredAVX2(FVector3fSoA In, const FVector3f& Point, float* Out, size_t Count)
+{
+	const __m256 PX = _mm256_set1_ps(Point.X);
+	const __m256 PY = _mm256_set1_ps(Point.Y);
+	const __m256 PZ = _mm256_set1_ps(Point.Z);
+
+	size_t i = 0;
+	for (; i + 8 <= Count; i += 8)
+	{
+		const __m256 DX = _mm256_sub_ps(_mm256_loadu_ps(In.X + i), PX);
+		const __m256 DY = _mm256_sub_ps(_mm256_loadu_ps(In.Y + i), PY);
+		const __m256 DZ = _mm256_sub_ps(_mm256_loadu_ps(In.Z + i), PZ);
+		_mm256_storeu_ps(Out + i, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(DX, DX), _mm256_mul_ps(DY, DY)), _mm256_mul_ps(DZ, DZ)));
+	}
+	return i;
+}
+
+UE_TARGET_AVX512 UE_NO_FP_CONTRACT static size_t DistanceSquaredAVX512(FVector3fSoA In, const FVector3f& Point, float* Out, size_t Count)
+{
+	const __m512 PX = _mm512_set1_ps(Point.X);
+	const __m512 PY = _mm512_set1_ps(Point.Y);
+	const __m512 PZ = _mm512_set1_ps(Point.Z);
+
+	size_t i = 0;
+	for (; i + 16 <= Count; i += 16)
+	{
+		const __m512 DX = _mm512_sub_ps(_mm512_loadu_ps(In.X + i), PX);
+		const __m512 DY = _mm512_sub_ps(_mm512_loadu_ps(In.Y + i), PY);
+		const __m512 DZ = _mm512_sub_ps(_mm512_loadu_ps(In.Z + i), PZ);
+		_mm512_storeu_ps(Out + i, _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(DX, DX), _mm512_mul_ps(DY, DY)), _mm512_mul_ps(DZ, DZ)));
+	}
+	return i;
+}
+#endif
+
+void BatchDistanceSquared(const FRebasedVectorSoA& In, const FVector& Point, float* Out, size_t Count, FTaskScheduler* Scheduler)
+{
+	const FVector3f Offset = In.ToOffset(Point);
+	ParallelFor(Scheduler, Count, GetParallelChunkSize(4 * sizeof(float)), [&](size_t Begin, size_t End)
+	{
+		const FVector3fSoA Chunk(In.Offsets.X + Begin, In.Offsets.Y + Begin, In.Offsets.Z + Begin);
+		const size_t ChunkCount = End - Begin;
+		size_t i = 0;
+		switch (GetSimdLevel())
+		{
+#if UE_MATH_X86
+		case ESimdLevel::AVX512:
+			i = DistanceSquaredAVX512(Chunk, Offset, Out + Begin, ChunkCount);
+			break;
+		case ESimdLevel::AVX2:
+			i = DistanceSquaredAVX2(Chunk, Offset, Out + Begin, ChunkCount);
+			break;
+#endif
+		default:
+			break;
+		}
+		DistanceSquaredScalar(Chunk, Offset, Out + Begin, i, ChunkCount);
+	});
+}
+
+/*-----------------------------------------------------------------------------
+	Projection. Columns X, Y and W of the view-projection (see FCamera) with
+	the translation row recomputed for the camera's location relative to the
+	origin, then rounded to float.
+-----------------------------------------------------------------------------*/
+
+struct FRebasedViewProjection
+{
+	float M[4][3];		/* M[Row][0, 1, 2] = FCamera's M[Row][0, 1, 3] */
+	float NearPlane;
+
+	FRebasedViewProjection(const FCamera& Camera, const FVector& Origin)
+	{
+		const FMatrix& VP = Camera.GetViewProjectionMatrix();
+		const FVector Location = Camera.Location - Origin;
+		const int Columns[3] = { 0, 1, 3 };
+		for (int Column = 0; Column < 3; ++Column)
+		{
+			const int Source = Columns[Column];
+			M[0][Column] = (float)VP.M[0][Source];
+			M[1][Column] = (float)VP.M[1][Source];
+			M[2][Column] = (float)VP.M[2][Source];
+			M[3][Column] = (float)-(Location.X * VP.M[0][Source] + Location.Y * VP.M[1][Source] + Location.Z * VP.M[2][Source]);
+		}
+		NearPlane = (float)Camera.NearPlane;
+	}
+};
+
+static size_t WorldToScreenScalar(const FRebasedViewProjection& P, FVector3fSoA In, FVector2f* OutScreen, uint64_t* OutVisibleMask, size_t Begin, size_t Count)
+{
+	size_t NumVisible = 0;
+	for (size_t i = Begin; i < Count; ++i)
+	{
+		const float X = In.X[i], Y = In.Y[i], Z = In.Z[i];
+		const float SX = X * P.M[0][0] + Y * P.M[1][0] + Z * P.M[2][0] + P.M[3][0];
+		const float SY = X * P.M[0][1] + Y * P.M[1][1] + Z * P.M[2][1] + P.M[3][1];
+		const float W = X * P.M[0][2] + Y * P.M[1][2] + Z * P.M[2][2] + P.M[3][2];
+		const float Depth = std::max(W, P.NearPlane);
+		OutScreen[i] = FVector2f(SX / Depth, SY / Depth);
+
+		const bool bVisible = W >= P.NearPlane;
+		OutVisibleMask[i >> 6] |= (uint64_t)bVisible << (i & 63);
+		NumVisible += bVisible;
+	}
+	return NumVisible;
+}
+
+#if UE_MATH_X86
+UE_TARGET_AVX2_FMA static size_t WorldToScreenAVX2(const FRebasedViewProjection& P, FVector3fSoA In, FVector2f* OutScreen, uint64_t* OutVisibleMask, size_t Count)
+{
+	const __m256 M00 = _mm256_set1_ps(P.M[0][0]), M10 = _mm256_set1_ps(P.M[1][0]), M20 = _mm256_set1_ps(P.M[2][0]), M30 = _mm256_set1_ps(P.M[3][0]);
+	const __m256 M01 = _mm256_set1_ps(P.M[0][1]), M11 = _mm256_set1_ps(P.M[1][1]), M21 = _mm256_set1_ps(P.M[2][1]), M31 = _mm256_set1_ps(P.M[3][1]);
+	const __m256 M02 = _mm256_set1_ps(P.M[0][2]), M12 = _mm256_set1_ps(P.M[1][2]), M22 = _mm256_set1_ps(P.M[2][2]), M32 = _mm256_set1_ps(P.M[3][2]);
+	const __m256 Near = _mm256_set1_ps(P.NearPlane);
+
+	size_t NumVisible = 0;
+	size_t i = 0;
+	for (; i + 8 <= Count; i += 8)
+	{
+		const __m256 PX = _mm256_loadu_ps(In.X + i);
+		const __m256 PY = _mm256_loadu_ps(In.Y + i);
+		const __m256 PZ = _mm256_loadu_ps(In.Z + i);
+
+		const __m256 SX = _mm256_fmadd_ps(PX, M00, _mm256_fmadd_ps(PY, M10, _mm256_fmadd_ps(PZ, M20, M30)));
+		const __m256 SY = _mm256_fmadd_ps(PX, M01, _mm256_fmadd_ps(PY, M11, _mm256_fmadd_ps(PZ, M21, M31)));
+		const __m256 W = _mm256_fmadd_ps(PX, M02, _mm256_fmadd_ps(PY, M12, _mm256_fmadd_ps(PZ, M22, M32)));
+
+		const __m256 Visible = _mm256_cmp_ps(W, Near, _CMP_GE_OQ);
+		const __m256 Depth = _mm256_max_ps(W, Near);
+		const __m256 X = _mm256_div_ps(SX, Depth);
+		const __m256 Y = _mm256_div_ps(SY, Depth);
+
+		// Interleave back to FVector2f pairs
+		const __m256 XY0145 = _mm256_unpacklo_ps(X, Y);
+		const __m256 XY2367 = _mm256_unpackhi_ps(X, Y);
+		float* Dst = &OutScreen[i].X;
+		_mm256_storeu_ps(Dst + 0, _mm256_permute2f128_ps(XY0145, XY2367, 0x20));
+		_mm256_storeu_ps(Dst + 8, _mm256_permute2f128_ps(XY0145, XY2367, 0x31));
+
+		const uint64_t Bits = (uint64_t)_mm256_movemask_ps(Visible);
+		OutVisibleMask[i >> 6] |= Bits << (i & 63);
+		NumVisible += CountBits64(Bits);
+	}
+
+	_mm256_zeroupper();
+	return NumVisible + WorldToScreenScalar(P, In, OutScreen, OutVisibleMask, i, Count);
+}
+
+UE_TARGET_AVX512 static size_t WorldToScreenAVX512(const FRebasedViewProjection& P, FVector3fSoA In, FVector2f* OutScreen, uint64_t* OutVisibleMask, size_t Count)
+{
+	const __m512 M00 = _mm512_set1_ps(P.M[0][0]), M10 = _mm512_set1_ps(P.M[1][0]), M20 = _mm512_set1_ps(P.M[2][0]), M30 = _mm512_set1_ps(P.M[3][0]);
+	const __m512 M01 = _mm512_set1_ps(P.M[0][1]), M11 = _mm512_set1_ps(P.M[1][1]), M21 = _mm512_set1_ps(P.M[2][1]), M31 = _mm512_set1_ps(P.M[3][1]);
+	const __m512 M02 = _mm512_set1_ps(P.M[0][2]), M12 = _mm512_set1_ps(P.M[1][2]), M22 = _mm512_set1_ps(P.M[2][2]), M32 = _mm512_set1_ps(P.M[3][2]);
+	const __m512 Near = _mm512_set1_ps(P.NearPlane);
+	const __m512i InterleaveLo = _mm512_set_epi32(23, 7, 22, 6, 21, 5, 20, 4, 19, 3, 18, 2, 17, 1, 16, 0);
+	const __m512i InterleaveHi = _mm512_set_epi32(31, 15, 30, 14, 29, 13, 28, 12, 27, 11, 26, 10, 25, 9, 24, 8);
+
+	size_t NumVisible = 0;
+	size_t i = 0;
+	for (; i + 16 <= Count; i += 16)
+	{
+		const __m512 PX = _mm512_loadu_ps(In.X + i);
+		const __m512 PY = _mm512_loadu_ps(In.Y + i);
+		const __m512 PZ = _mm512_loadu_ps(In.Z + i);
+
+		const __m512 SX = _mm512_fmadd_ps(PX, M00, _mm512_fmadd_ps(PY, M10, _mm512_fmadd_ps(PZ, M20, M30)));
+		const __m512 SY = _mm512_fmadd_ps(PX, M01, _mm512_fmadd_ps(PY, M11, _mm512_fmadd_ps(PZ, M21, M31)));
+		const __m512 W = _mm512_fmadd_ps(PX, M02, _mm512_fmadd_ps(PY, M12, _mm512_fmadd_ps(PZ, M22, M32)));
+
+		const __mmask16 Visible = _mm512_cmp_ps_mask(W, Near, _CMP_GE_OQ);
+		const __m512 Depth = _mm512_max_ps(W, Near);
+		const __m512 X = _mm512_div_ps(SX, Depth);
+		const __m512 Y = _mm512_div_ps(SY, Depth);
+
+		float* Dst = &OutScreen[i].X;
+		_mm512_storeu_ps(Dst + 0, _mm512_permutex2var_ps(X, InterleaveLo, Y));
+		_mm512_storeu_ps(Dst + 16, _mm512_permutex2var_ps(X, InterleaveHi, Y));
+
+		OutVisibleMask[i >> 6] |= (uint64_t)Visible << (i & 63);
+		NumVisible += CountBits64(Visible);
+	}
+
+	_mm256_zeroupper();
+	return NumVisible + WorldToScreenScalar(P, In, OutScreen, OutVisibleMask, i, Count);
+}
+#endif
+
+static size_t WorldToScreenDispatch(const FRebasedViewProjection& P, FVector3fSoA In, FVector2f* OutScreen, uint64_t* OutVisibleMask, size_t Count)
+{
+	memset(OutVisibleMask, 0, ((Count + 63) / 64) * sizeof(uint64_t));
+
+	switch (GetSimdLevel())
+	{
+#if UE_MATH_X86
+	case ESimdLevel::AVX512:
+		return WorldToScreenAVX512(P, In, OutScreen, OutVisibleMask, Count);
+	case ESimdLevel::AVX2:
+		return WorldToScreenAVX2(P, In, OutScreen, OutVisibleMask, Count);
+#endif
+	default:
+		return WorldToScreenScalar(P, In, OutScreen, OutVisibleMask, 0, Count);
+	}
+}
+
+size_t BatchWorldToScreen(const FCamera& Camera, const FRebasedVectorSoA& In, FVector2f* OutScreen, uint64_t* OutVisibleMask, size_t Count, FTaskScheduler* Scheduler)
+{
+	const FRebasedViewProjection P(Camera, In.Origin);
+
+	std::atomic<size_t> NumVisible(0);
+	ParallelFor(Scheduler, Count, GetParallelChunkSize(3 * sizeof(float) + sizeof(FVector2f)), [&](size_t Begin, size_t End)
+	{
+		const FVector3fSoA Chunk(In.Offsets.X + Begin, In.Offsets.Y + Begin, In.Offsets.Z + Begin);
+		NumVisible.fetch_add(WorldToScreenDispatch(P, Chunk, OutScreen + Begin, OutVisibleMask + Begin / 64, End - Begin), std::memory_order_relaxed);
+	});
+	return NumVisible.load(std::memory_order_relaxed);
+}
+
+/*-----------------------------------------------------------------------------
+	Culling. The plane offsets move to the origin in double, (N | Origin)
+	added to each, and are then rounded to float with the normals.
+-----------------------------------------------------------------------------*/
+
+struct FRebasedPlanes
+{
+	float NX[FFrustum::MaxPlanes];
+	float NY[FFrustum::MaxPlanes];
+	float NZ[FFrustum::MaxPlanes];
+	float Offsets[FFrustum::MaxPlanes];
+	int NumPlanes;
+
+	FRebasedPlanes(const FFrustum& Frustum, const FVector& Origin) : NumPlanes(Frustum.NumPlanes)
+	{
+		for (int Plane = 0; Plane < NumPlanes; ++Plane)
+		{
+			const FVector& N = Frustum.Normals[Plane];
+			NX[Plane] = (float)N.X;
+			NY[Plane] = (float)N.Y;
+			NZ[Plane] = (float)N.Z;
+			Offsets[Plane] = (float)(Frustum.Offsets[Plane] + (N | Origin));
+		}
+	}
+};
+
+static size_t CullSpheresScalar(const FRebasedPlanes& Planes, FVector3fSoA Centers, const float* Radii, uint64_t* OutVisibleMask, size_t Begin, size_t Count)
+{
+	size_t NumVisible = 0;
+	for (size_t i = Begin; i < Count; ++i)
+	{
+		bool bVisible = true;
+		for (int Plane = 0; Plane < Planes.NumPlanes && bVisible; ++Plane)
+		{
+			bVisible = Planes.NX[Plane] * Centers.X[i] + Planes.NY[Plane] * Centers.Y[i] + Planes.NZ[Plane] * Centers.Z[i] + Planes.Offsets[Plane] + Radii[i] >= 0.0f;
+		}
+		OutVisibleMask[i >> 6] |= (uint64_t)bVisible << (i & 63);
+		NumVisible += bVisible;
+	}
+	return NumVisible;
+}
+
+#if UE_MATH_X86
+UE_TARGET_AVX2_FMA static size_t CullSpheresAVX2(const FRebasedPlanes& Planes, FVector3fSoA Centers, const float* Radii, uint64_t* OutVisibleMask, size_t Count)
+{
+	const __m256 Zero = _mm256_setzero_ps();
+
+	size_t NumVisible = 0;
+	size_t i = 0;
+	for (; i + 8 <= Count; i += 8)
+	{
+		const __m256 CX = _mm256_loadu_ps(Centers.X + i);
+		const __m256 CY = _mm256_loadu_ps(Centers.Y + i);
+		const __m256 CZ = _mm256_loadu_ps(Centers.Z + i);
+		const __m256 R = _mm256_loadu_ps(Radii + i);
+
+		__m256 Inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		for (int Plane = 0; Plane < Planes.NumPlanes; ++Plane)
+		{
+			const __m256 NX = _mm256_set1_ps(Planes.NX[Plane]), NY = _mm256_set1_ps(Planes.NY[Plane]), NZ = _mm256_set1_ps(Planes.NZ[Plane]);
+			const __m256 Distance = _mm256_fmadd_ps(NX, CX, _mm256_fmadd_ps(NY, CY, _mm256_fmadd_ps(NZ, CZ, _mm256_set1_ps(Planes.Offsets[Plane]))));
+			Inside = _mm256_and_ps(Inside, _mm256_cmp_ps(_mm256_add_ps(Distance, R), Zero, _CMP_GE_OQ));
+		}
+
+		const uint64_t Bits = (uint64_t)_mm256_movemask_ps(Inside);
+		OutVisibleMask[i >> 6] |= Bits << (i & 63);
+		NumVisible += CountBits64(Bits);
+	}
+
+	_mm256_zeroupper();
+	return NumVisible + CullSpheresScalar(Planes, Centers, Radii, OutVisibleMask, i, Count);
+}
+
+UE_TARGET_AVX512 static size_t CullSpheresAVX512(const FRebasedPlanes& Planes, FVector3fSoA Centers, const float* Radii, uint64_t* OutVisibleMask, size_t Count)
+{
+	const __m512 Zero = _mm512_setzero_ps();
+
+	size_t NumVisible = 0;
+	size_t i = 0;
+	for (; i + 16 <= Count; i += 16)
+	{
+		const __m512 CX = _mm512_loadu_ps(Centers.X + i);
+		const __m512 CY = _mm512_loadu_ps(Centers.Y + i);
+		const __m512 CZ = _mm512_loadu_ps(Centers.Z + i);
+		const __m512 R = _mm512_loadu_ps(Radii + i);
+
+		__mmask16 Inside = 0xFFFF;
+		for (int Plane = 0; Plane < Planes.NumPlanes; ++Plane)
+		{
+			const __m512 NX = _mm512_set1_ps(Planes.NX[Plane]), NY = _mm512_set1_ps(Planes.NY[Plane]), NZ = _mm512_set1_ps(Planes.NZ[Plane]);
+			const __m512 Distance = _mm512_fmadd_ps(NX, CX, _mm512_fmadd_ps(NY, CY, _mm512_fmadd_ps(NZ, CZ, _mm512_set1_ps(Planes.Offsets[Plane]))));
+			Inside = _mm512_mask_cmp_ps_mask(Inside, _mm512_add_ps(Distance, R), Zero, _CMP_GE_OQ);
+		}
+
+		OutVisibleMask[i >> 6] |= (uint64_t)Inside << (i & 63);
+		NumVisible += CountBits64(Inside);
+	}
+
+	_mm256_zeroupper();
+	return NumVisible + CullSpheresScalar(Planes, Centers, Radii, OutVisibleMask, i, Count);
+}
+#endif
+
+static size_t CullSpheresDispatch(const FRebasedPlanes& Planes, FVector3fSoA Centers, const float* Radii, uint64_t* OutVisibleMask, size_t Count)
+{
+	memset(OutVisibleMask, 0, ((Count + 63) / 64) * sizeof(uint64_t));
+
+	switch (GetSimdLevel())
+	{
+#if UE_MATH_X86
+	case ESimdLevel::AVX512:
+		return CullSpheresAVX512(Planes, Centers, Radii, OutVisibleMask, Count);
+	case ESimdLevel::AVX2:
+		return CullSpheresAVX2(Planes, Centers, Radii, OutVisibleMask, Count);
+#endif
+	default:
+		return CullSpheresScalar(Planes, Centers, Radii, OutVisibleMask, 0, Count);
+	}
+}
+
+size_t BatchCullSpheres(const FFrustum& Frustum, const FRebasedVectorSoA& Centers, const float* Radii, uint64_t* OutVisibleMask, size_t Count, FTaskScheduler* Scheduler)
+{
+	const FRebasedPlanes Planes(Frustum, Centers.Origin);
+
+	std::atomic<size_t> NumVisible(0);
+	ParallelFor(Scheduler, Count, GetParallelChunkSize(4 * sizeof(float)), [&](size_t Begin, size_t End)
+	{
+		const FVector3fSoA Chunk(Centers.Offsets.X + Begin, Centers.Offsets.Y + Begin, Centers.Offsets.Z + Begin);
+		NumVisible.fetch_add(CullSpheresDispatch(Planes, Chunk, Radii + Begin, OutVisibleMask + Begin / 64, End - Begin), std::memory_order_relaxed);
+	});
+	return NumVisible.load(std::memory_order_relaxed);
+}
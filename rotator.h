@@ -1,92 +1,107 @@
 #pragma once
 #include "ue4math.h"
+#include "mathfwd.h"
 #include "vector.h"
 
-struct FQuat;
-struct FMatrix;
-
 // ScriptStruct CoreUObject.Rotator
 // 0x000C
-struct FRotator {
+template<typename T>
+struct TRotator {
 public:
-	double                                              Pitch;                                                    // 0x0000(0x0004) (CPF_Edit, CPF_BlueprintVisible, CPF_ZeroConstructor, CPF_SaveGame, CPF_IsPlainOldData)
-	double                                              Yaw;                                                      // 0x0004(0x0004) (CPF_Edit, CPF_BlueprintVisible, CPF_ZeroConstructor, CPF_SaveGame, CPF_IsPlainOldData)
-	double                                              Roll;                                                     // 0x0008(0x0004) (CPF_Edit, CPF_BlueprintVisible, CPF_ZeroConstructor, CPF_SaveGame, CPF_IsPlainOldData)
+	using FReal = T;
+
+	T                                                   Pitch;                                                    // 0x0000(0x0004) (CPF_Edit, CPF_BlueprintVisible, CPF_ZeroConstructor, CPF_SaveGame, CPF_IsPlainOldData)
+	T                                                   Yaw;                                                      // 0x0004(0x0004) (CPF_Edit, CPF_BlueprintVisible, CPF_ZeroConstructor, CPF_SaveGame, CPF_IsPlainOldData)
+	T                                                   Roll;                                                     // 0x0008(0x0004) (CPF_Edit, CPF_BlueprintVisible, CPF_ZeroConstructor, CPF_SaveGame, CPF_IsPlainOldData)
+
+	constexpr TRotator() : Pitch(0), Yaw(0), Roll(0) {}
+	constexpr TRotator(T pitch, T yaw, T roll) : Pitch(pitch), Yaw(yaw), Roll(roll) {}
 
-	FRotator() : Pitch(0.0), Yaw(0.0), Roll(0.0) {}
-	FRotator(double pitch, double yaw, double roll) : Pitch(pitch), Yaw(yaw), Roll(roll) {}
+	/** Explicit precision conversion, e.g. FRotator3f(SomeFRotator). */
+	template<typename U, typename = typename std::enable_if<!std::is_same<T, U>::value>::type>
+	constexpr explicit TRotator(const TRotator<U>& v) : Pitch((T)v.Pitch), Yaw((T)v.Yaw), Roll((T)v.Roll) {}
 
-	static double NormalizeAxis(double Angle) {
+	static constexpr T NormalizeAxis(T Angle) {
 		//-180 ~ 180
-		if (Angle > 180.0)
-			Angle -= 360.0;
-		if (Angle < -180.0)
-			Angle += 360.0;
+		if (Angle > T(180))
+			Angle -= T(360);
+		if (Angle < T(-180))
+			Angle += T(360);
 		return Angle;
 	}
 
 	void Clamp() {
-		Pitch = std::clamp(NormalizeAxis(Pitch), -75.0, 75.0);
+		Pitch = std::clamp(NormalizeAxis(Pitch), T(-75), T(75));
 		Yaw = NormalizeAxis(Yaw);
 		Roll = NormalizeAxis(Roll);
 	}
 
-	double InnerProduct(const FRotator& v) const {
+	constexpr T InnerProduct(const TRotator& v) const {
 		return (Pitch * v.Pitch) + (Yaw * v.Yaw) + (Roll * v.Roll);
 	}
 
-	FRotator OuterProduct(const FRotator& v) const {
-		FRotator output;
+	constexpr TRotator OuterProduct(const TRotator& v) const {
+		TRotator output;
 		output.Pitch = (Yaw * v.Roll) - (Roll * v.Yaw);
 		output.Yaw = (Roll * v.Pitch) - (Pitch * v.Roll);
 		output.Roll = (Pitch * v.Yaw) - (Yaw * v.Pitch);
 		return output;
 	}
 
-	bool operator == (const FRotator& v) const {
+	constexpr bool operator == (const TRotator& v) const {
 		return Pitch == v.Pitch && Yaw == v.Yaw && Roll == v.Roll;
 	}
 
-	bool operator != (const FRotator& v) const {
+	constexpr bool operator != (const TRotator& v) const {
 		return !(*this == v);
 	}
 
-	FRotator operator - () const {
-		return FRotator(-Pitch, -Yaw, -Roll);
+	constexpr TRotator operator - () const {
+		return TRotator(-Pitch, -Yaw, -Roll);
 	}
 
-	FRotator operator + (const FRotator& v) const {
-		return FRotator(Pitch + v.Pitch, Yaw + v.Yaw, Roll + v.Roll);
+	constexpr TRotator operator + (const TRotator& v) const {
+		return TRotator(Pitch + v.Pitch, Yaw + v.Yaw, Roll + v.Roll);
 	}
 
-	FRotator operator - (const FRotator& v) const {
-		return FRotator(Pitch - v.Pitch, Yaw - v.Yaw, Roll - v.Roll);
+	constexpr TRotator operator - (const TRotator& v) const {
+		return TRotator(Pitch - v.Pitch, Yaw - v.Yaw, Roll - v.Roll);
 	}
 
-	FRotator operator * (double Value) const {
-		return FRotator(Pitch * Value, Yaw * Value, Roll * Value);
+	constexpr TRotator operator * (T Value) const {
+		return TRotator(Pitch * Value, Yaw * Value, Roll * Value);
 	}
 
-	double Length() const {
+	T Length() const {
 		return sqrt(Pitch * Pitch + Yaw * Yaw + Roll * Roll);
 	}
 
-	double Distance(const FRotator& v) const {
+	T Distance(const TRotator& v) const {
 		return (v - *this).Length();
 	}
 
-	FRotator operator ^ (const FRotator& v) const {
+	constexpr TRotator operator ^ (const TRotator& v) const {
 		return OuterProduct(v);
 	}
 
-	double operator * (const FRotator& v) const {
+	constexpr T operator * (const TRotator& v) const {
 		return InnerProduct(v);
 	}
 
-	FQuat GetQuaternion() const;
-	FRotator(const FQuat& q);
-	operator FQuat() const;
+	TQuat<T> GetQuaternion() const;
+	TRotator(const TQuat<T>& q);
+	operator TQuat<T>() const;
 
-	FVector GetUnitVector() const;
-	FMatrix GetMatrix(FVector origin = { 0, 0, 0 }) const;
+	TVector<T> GetUnitVector() const;
+	TMatrix<T> GetMatrix(TVector<T> origin = { 0, 0, 0 }) const;
 };
+
+static_assert(sizeof(FRotator) == 24, "FRotator");
+static_assert(sizeof(FRotator3f) == 12, "FRotator3f");
+
+#if UE_MATH_HEADER_ONLY
+#include "rotator.inl"
+#else
+extern template struct TRotator<float>;
+extern template struct TRotator<double>;
+#endif
@@ -0,0 +1,112 @@
+#pragma once
+#include "rotator.h"
+#include "vector.h"
+#include "quat.h"
+#include "matrix.h"
+
+template<typename T>
+UE_MATH_INLINE TRotator<T>::TRotator(const TQuat<T>& q) {
+	const T SingularitYTest = q.Z * q.X - q.W * q.Y;
+	const T YawY = T(2) * (q.W * q.Z + q.X * q.Y);
+	const T YawX = (T(1) - T(2) * (q.Y * q.Y + q.Z * q.Z));
+
+	const T SINGULARITY_THRESHOLD = T(0.4999995);
+	const T RAD_TO_DEG = T((180.0) / PI);
+
+	if (SingularitYTest < -SINGULARITY_THRESHOLD) {
+		Pitch = T(-90);
+		Yaw = atan2(YawY, YawX) * RAD_TO_DEG;
+		Roll = NormalizeAxis(-Yaw - (T(2) * atan2(q.X, q.W) * RAD_TO_DEG));
+	}
+	else if (SingularitYTest > SINGULARITY_THRESHOLD) {
+		Pitch = T(90);
+		Yaw = atan2(YawY, YawX) * RAD_TO_DEG;
+		Roll = NormalizeAxis(Yaw - (T(2) * atan2(q.X, q.W) * RAD_TO_DEG));
+	}
+	else {
+		Pitch = asin(T(2) * (SingularitYTest)) * RAD_TO_DEG;
+		Yaw = atan2(YawY, YawX) * RAD_TO_DEG;
+		Roll = atan2(T(-2) * (q.W * q.X + q.Y * q.Z), (T(1) - T(2) * (q.X * q.X + q.Y * q.Y))) * RAD_TO_DEG;
+	}
+}
+
+template<typename T>
+UE_MATH_INLINE TQuat<T> TRotator<T>::GetQuaternion() const {
+	const T DEG_TO_RAD = T(PI / (180.0));
+	const T RADS_DIVIDED_BY_2 = DEG_TO_RAD / T(2);
+	T SP, SY, SR;
+	T CP, CY, CR;
+
+	const T PitchNoWinding = fmod(Pitch, T(360));
+	const T YawNoWinding = fmod(Yaw, T(360));
+	const T RollNoWinding = fmod(Roll, T(360));
+
+	SP = sin(PitchNoWinding * RADS_DIVIDED_BY_2);
+	CP = cos(PitchNoWinding * RADS_DIVIDED_BY_2);
+	SY = sin(YawNoWinding * RADS_DIVIDED_BY_2);
+	CY = cos(YawNoWinding * RADS_DIVIDED_BY_2);
+	SR = sin(RollNoWinding * RADS_DIVIDED_BY_2);
+	CR = cos(RollNoWinding * RADS_DIVIDED_BY_2);
+
+	TQuat<T> RotationQuat;
+	RotationQuat.X = CR * SP * SY - SR * CP * CY;
+	RotationQuat.Y = -CR * SP * CY - SR * CP * SY;
+	RotationQuat.Z = CR * CP * SY - SR * SP * CY;
+	RotationQuat.W = CR * CP * CY + SR * SP * SY;
+	return RotationQuat;
+}
+
+template<typename T>
+UE_MATH_INLINE TRotator<T>::operator TQuat<T>() const {
+	return GetQuaternion();
+}
+
+template<typename T>
+UE_MATH_INLINE TMatrix<T> TRotator<T>::GetMatrix(TVector<T> origin) const {
+	T radPitch = ConvertToRadians(Pitch);
+	T radYaw = ConvertToRadians(Yaw);
+	T radRoll = ConvertToRadians(Roll);
+
+	T SP = sin(radPitch);
+	T CP = cos(radPitch);
+	T SY = sin(radYaw);
+	T CY = cos(radYaw);
+	T SR = sin(radRoll);
+	T CR = cos(radRoll);
+
+	TMatrix<T> matriX;
+	matriX.M[0][0] = CP * CY;
+	matriX.M[0][1] = CP * SY;
+	matriX.M[0][2] = SP;
+	matriX.M[0][3] = 0.0;
+
+	matriX.M[1][0] = SR * SP * CY - CR * SY;
+	matriX.M[1][1] = SR * SP * SY + CR * CY;
+	matriX.M[1][2] = -SR * CP;
+	matriX.M[1][3] = 0.0;
+
+	matriX.M[2][0] = -(CR * SP * CY + SR * SY);
+	matriX.M[2][1] = CY * SR - CR * SP * SY;
+	matriX.M[2][2] = CR * CP;
+	matriX.M[2][3] = 0.0;
+
+	matriX.M[3][0] = origin.X;
+	matriX.M[3][1] = origin.Y;
+	matriX.M[3][2] = origin.Z;
+	matriX.M[3][3] = 1.0;
+
+	return matriX;
+}
+
+template<typename T>
+UE_MATH_INLINE TVector<T> TRotator<T>::GetUnitVector() const {
+	T radPitch = ConvertToRadians(Pitch);
+	T radYaw = ConvertToRadians(Yaw);
+
+	T SP = sin(radPitch);
+	T CP = cos(radPitch);
+	T SY = sin(radYaw);
+	T CY = cos(radYaw);
+
+	return TVector<T>(CP * CY, CP * SY, SP);
+}
@@ -0,0 +1,135 @@
+#include "skeleton.h"
+
+bool FSkeletonPose::Init(const int32_t* ParentIndices, size_t NumBones)
+{
+	Parents.clear();
+	for (size_t i = 0; i < NumBones; ++i)
+	{
+		if (ParentIndices[i] >= (int32_t)i || ParentIndices[i] < -1)
+		{
+			*this = FSkeletonPose();
+			return false;
+		}
+	}
+
+	Parents.assign(ParentIndices, ParentIndices + NumBones);
+	FirstChild.assign(NumBones, -1);
+	NextSibling.assign(NumBones, -1);
+	for (size_t i = NumBones; i-- > 0;)
+	{
+		const int32_t Parent = Parents[i];
+		if (Parent >= 0)
+		{
+			NextSibling[i] = FirstChild[Parent];
+			FirstChild[Parent] = (int32_t)i;
+		}
+	}
+
+	RotationX.assign(NumBones, 0.0);
+	RotationY.assign(NumBones, 0.0);
+	RotationZ.assign(NumBones, 0.0);
+	RotationW.assign(NumBones, 1.0);
+	TranslationX.assign(NumBones, 0.0);
+	TranslationY.assign(NumBones, 0.0);
+	TranslationZ.assign(NumBones, 0.0);
+	ScaleX.assign(NumBones, 1.0);
+	ScaleY.assign(NumBones, 1.0);
+	ScaleZ.assign(NumBones, 1.0);
+
+	Component.assign(NumBones, FTransform());
+	Dirty.assign((NumBones + 63) / 64, 0);
+	MarkStack.clear();
+	MarkStack.reserve(NumBones);
+	MarkAllDirty();
+	return true;
+}
+
+FTransform FSkeletonPose::GetLocalTransform(size_t Bone) const
+{
+	return FTransform(
+		FQuat(RotationX[Bone], RotationY[Bone], RotationZ[Bone], RotationW[Bone]),
+		FVector(TranslationX[Bone], TranslationY[Bone], TranslationZ[Bone]),
+		FVector(ScaleX[Bone], ScaleY[Bone], ScaleZ[Bone]));
+}
+
+void FSkeletonPose::SetLocalTransform(size_t Bone, const FTransform& Local)
+{
+	RotationX[Bone] = Local.Rotation.X;
+	RotationY[Bone] = Local.Rotation.Y;
+	RotationZ[Bone] = Local.Rotation.Z;
+	RotationW[Bone] = Local.Rotation.W;
+	TranslationX[Bone] = Local.Translation.X;
+	TranslationY[Bone] = Local.Translation.Y;
+	TranslationZ[Bone] = Local.Translation.Z;
+	ScaleX[Bone] = Local.Scale3D.X;
+	ScaleY[Bone] = Local.Scale3D.Y;
+	ScaleZ[Bone] = Local.Scale3D.Z;
+	MarkDirty(Bone);
+}
+
+void FSkeletonPose::MarkDirty(size_t Bone)
+{
+	// A dirty bone always has a dirty subtree, so marking stops at the first dirty bone it meets
+	MarkStack.push_back((int32_t)Bone);
+	while (!MarkStack.empty())
+	{
+		const int32_t Index = MarkStack.back();
+		MarkStack.pop_back();
+		if (IsDirty(Index))
+		{
+			continue;
+		}
+
+		Dirty[Index >> 6] |= 1ull << (Index & 63);
+		for (int32_t Child = FirstChild[Index]; Child >= 0; Child = NextSibling[Child])
+		{
+			MarkStack.push_back(Child);
+		}
+	}
+}
+
+void FSkeletonPose::MarkAllDirty()
+{
+	const size_t NumBones = Num();
+	for (size_t Word = 0; Word < Dirty.size(); ++Word)
+	{
+		const size_t BitsInWord = std::min<size_t>(64, NumBones - Word * 64);
+		Dirty[Word] = BitsInWord == 64 ? ~0ull : (1ull << BitsInWord) - 1;
+	}
+}
+
+size_t FSkeletonPose::Evaluate()
+{
+	size_t NumEvaluated = 0;
+
+	// Parents have lower indices than their children, so ascending order evaluates a parent first
+	for (size_t Word = 0; Word < Dirty.size(); ++Word)
+	{
+		uint64_t Bits = Dirty[Word];
+		Dirty[Word] = 0;
+		while (Bits)
+		{
+			const size_t Bone = Word * 64 + CountTrailingZeros64(Bits);
+			Bits &= Bits - 1;
+
+			const FTransform Local = GetLocalTransform(Bone);
+			const int32_t Parent = Parents[Bone];
+			if (Parent < 0)
+			{
+				Component[Bone] = Local;
+			}
+			else
+			{
+				FTransform::Multiply(&Component[Bone], &Local, &Component[Parent]);
+			}
+			++NumEvaluated;
+		}
+	}
+
+	return NumEvaluated;
+}
+
+void FSkeletonPose::GetWorldLocations(const FTransform& ComponentToWorld, FVectorSoA Out) const
+{
+	BatchGetBoneWithRotation(ComponentToWorld, Component.data(), Component.size(), Out);
+}
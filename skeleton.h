@@ -0,0 +1,66 @@
+#pragma once
+#include "ue4math.h"
+#include "vector.h"
+#include "quat.h"
+#include "transform.h"
+#include "batch.h"
+#include <vector>
+
+/**
+ * Local -> component space evaluator for one skeleton.
+ *
+ * Local transforms are stored as structure-of-arrays, the hierarchy as a parent index per
+ * bone, sorted so every parent comes before its children (roots have parent -1). Setting a
+ * local transform marks the bone and its whole subtree dirty; Evaluate() then recomputes
+ * only dirty bones, walking the dirty bitset a 64 bit word at a time, so a mostly static
+ * pose costs little more than a scan of the bitset.
+ */
+struct FSkeletonPose
+{
+public:
+	FSkeletonPose() {}
+
+	/**
+	 * Sets up the hierarchy and resets every local transform to identity.
+	 * @return false, leaving the pose empty, if some bone's parent is not a lower index
+	 */
+	bool Init(const int32_t* ParentIndices, size_t NumBones);
+
+	size_t Num() const { return Parents.size(); }
+	int32_t GetParentIndex(size_t Bone) const { return Parents[Bone]; }
+
+	FTransform GetLocalTransform(size_t Bone) const;
+	void SetLocalTransform(size_t Bone, const FTransform& Local);
+
+	/** Marks Bone and all of its descendants for recomputation. */
+	void MarkDirty(size_t Bone);
+	void MarkAllDirty();
+	bool IsDirty(size_t Bone) const { return (Dirty[Bone >> 6] >> (Bone & 63)) & 1; }
+
+	/**
+	 * Recomputes the component space transform of every dirty bone, parents first.
+	 * @return number of bones recomputed
+	 */
+	size_t Evaluate();
+
+	/** Component space transforms as of the last Evaluate(). */
+	const FTransform& GetComponentTransform(size_t Bone) const { return Component[Bone]; }
+	const FTransform* GetComponentTransforms() const { return Component.data(); }
+
+	/** World positions of every bone for the given component-to-world transform, as of the last Evaluate(). */
+	void GetWorldLocations(const FTransform& ComponentToWorld, FVectorSoA Out) const;
+
+private:
+	std::vector<int32_t> Parents;
+	std::vector<int32_t> FirstChild;
+	std::vector<int32_t> NextSibling;
+
+	// Local space pose, one array per component
+	std::vector<double> RotationX, RotationY, RotationZ, RotationW;
+	std::vector<double> TranslationX, TranslationY, TranslationZ;
+	std::vector<double> ScaleX, ScaleY, ScaleZ;
+
+	std::vector<FTransform> Component;
+	std::vector<uint64_t> Dirty;
+	std::vector<int32_t> MarkStack;
+};
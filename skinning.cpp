@@ -0,0 +1,327 @@
+#include "skinning.h"
+#include "cpu.h"
+#include "parallel.h"
+#include "transformlanes.h"
+
+void BuildSkinningMatrices(const FTransform* ComponentTransforms, const FMatrix* InverseBindMatrices, FMatrix* OutPalette, size_t NumBones)
+{
+	for (size_t i = 0; i < NumBones; ++i)
+	{
+		OutPalette[i] = ComponentTransforms[i].ToMatrixWithScale();
+	}
+	FMatrix::MultiplyBatch(OutPalette, InverseBindMatrices, OutPalette, NumBones);
+}
+
+void BuildSkinningDualQuats(const FTransform* ComponentTransforms, const FTransform* InverseBindTransforms, FDualQuat* OutPalette, size_t NumBones)
+{
+	for (size_t i = 0; i < NumBones; ++i)
+	{
+		FTransform RefToComponent;
+		FTransform::Multiply(&RefToComponent, &InverseBindTransforms[i], &ComponentTransforms[i]);
+		OutPalette[i] = FDualQuat(RefToComponent);
+	}
+}
+
+/*-----------------------------------------------------------------------------
+	Linear blend skinning.
+-----------------------------------------------------------------------------*/
+
+static inline FVector SkinPosition(const FMatrix* Palette, const FSkinWeightInfo& Info, const FVector& Position)
+{
+	// Blended rows 0-3, columns 0-2
+	double B[4][3];
+	const FMatrix& First = Palette[Info.InfluenceBones[0]];
+	const double FirstWeight = Info.InfluenceWeights[0];
+	for (int Row = 0; Row < 4; ++Row)
+		for (int Column = 0; Column < 3; ++Column)
+			B[Row][Column] = First.M[Row][Column] * FirstWeight;
+
+	for (int Influence = 1; Influence < MaxSkinInfluences; ++Influence)
+	{
+		const FMatrix& Bone = Palette[Info.InfluenceBones[Influence]];
+		const double Weight = Info.InfluenceWeights[Influence];
+		for (int Row = 0; Row < 4; ++Row)
+			for (int Column = 0; Column < 3; ++Column)
+				B[Row][Column] = B[Row][Column] + Bone.M[Row][Column] * Weight;
+	}
+
+	return FVector(
+		Position.X * B[0][0] + Position.Y * B[1][0] + Position.Z * B[2][0] + B[3][0],
+		Position.X * B[0][1] + Position.Y * B[1][1] + Position.Z * B[2][1] + B[3][1],
+		Position.X * B[0][2] + Position.Y * B[1][2] + Position.Z * B[2][2] + B[3][2]);
+}
+
+#if UE_MATH_X86
+/** Skinned vertex as (X, Y, Z, junk): the blended matrix one row per register. */
+UE_TARGET_AVX2 UE_NO_FP_CONTRACT static inline __m256d SkinVertexAVX2(const FMatrix* Palette, const FSkinWeightInfo& Info, double X, double Y, double Z)
+{
+	const double* M = &Palette[Info.InfluenceBones[0]].M[0][0];
+	__m256d Weight = _mm256_set1_pd((double)Info.InfluenceWeights[0]);
+	__m256d B0 = _mm256_mul_pd(_mm256_loadu_pd(M + 0), Weight);
+	__m256d B1 = _mm256_mul_pd(_mm256_loadu_pd(M + 4), Weight);
+	__m256d B2 = _mm256_mul_pd(_mm256_loadu_pd(M + 8), Weight);
+	__m256d B3 = _mm256_mul_pd(_mm256_loadu_pd(M + 12), Weight);
+	for (int Influence = 1; Influence < MaxSkinInfluences; ++Influence)
+	{
+		M = &Palette[Info.InfluenceBones[Influence]].M[0][0];
+		Weight = _mm256_set1_pd((double)Info.InfluenceWeights[Influence]);
+		B0 = _mm256_add_pd(B0, _mm256_mul_pd(_mm256_loadu_pd(M + 0), Weight));
+		B1 = _mm256_add_pd(B1, _mm256_mul_pd(_mm256_loadu_pd(M + 4), Weight));
+		B2 = _mm256_add_pd(B2, _mm256_mul_pd(_mm256_loadu_pd(M + 8), Weight));
+		B3 = _mm256_add_pd(B3, _mm256_mul_pd(_mm256_loadu_pd(M + 12), Weight));
+	}
+	const __m256d XY = _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(X), B0), _mm256_mul_pd(_mm256_set1_pd(Y), B1));
+	return _mm256_add_pd(_mm256_add_pd(XY, _mm256_mul_pd(_mm256_set1_pd(Z), B2)), B3);
+}
+
+/** As SkinVertexAVX2 with rows 0-1 and 2-3 paired in one register each; row 3 is multiplied by 1, which is exact. */
+UE_TARGET_AVX512 UE_NO_FP_CONTRACT static inline __m256d SkinVertexAVX512(const FMatrix* Palette, const FSkinWeightInfo& Info, double X, double Y, double Z)
+{
+	const double* M = &Palette[Info.InfluenceBones[0]].M[0][0];
+	__m512d Weight = _mm512_set1_pd((double)Info.InfluenceWeights[0]);
+	__m512d B01 = _mm512_mul_pd(_mm512_loadu_pd(M + 0), Weight);
+	__m512d B23 = _mm512_mul_pd(_mm512_loadu_pd(M + 8), Weight);
+	for (int Influence = 1; Influence < MaxSkinInfluences; ++Influence)
+	{
+		M = &Palette[Info.InfluenceBones[Influence]].M[0][0];
+		Weight = _mm512_set1_pd((double)Info.InfluenceWeights[Influence]);
+		B01 = _mm512_add_pd(B01, _mm512_mul_pd(_mm512_loadu_pd(M + 0), Weight));
+		B23 = _mm512_add_pd(B23, _mm512_mul_pd(_mm512_loadu_pd(M + 8), Weight));
+	}
+	const __m512d P01 = _mm512_mul_pd(_mm512_insertf64x4(_mm512_set1_pd(X), _mm256_set1_pd(Y), 1), B01);
+	const __m512d P23 = _mm512_mul_pd(_mm512_insertf64x4(_mm512_set1_pd(Z), _mm256_set1_pd(1.0), 1), B23);
+	const __m256d XY = _mm256_add_pd(_mm512_castpd512_pd256(P01), _mm512_extractf64x4_pd(P01, 1));
+	return _mm256_add_pd(_mm256_add_pd(XY, _mm512_castpd512_pd256(P23)), _mm512_extractf64x4_pd(P23, 1));
+}
+
+/** Four (X, Y, Z, junk) rows into X, Y and Z lanes, stored at Out[i .. i + 3]. */
+UE_TARGET_AVX2 static inline void StoreTransposedAVX2(__m256d R0, __m256d R1, __m256d R2, __m256d R3, FVectorSoA Out, size_t i)
+{
+	__m256d X, Y, Z, Pad;
+	Transpose4x4(R0, R1, R2, R3, X, Y, Z, Pad);
+	_mm256_storeu_pd(Out.X + i, X);
+	_mm256_storeu_pd(Out.Y + i, Y);
+	_mm256_storeu_pd(Out.Z + i, Z);
+}
+
+UE_TARGET_AVX2 UE_NO_FP_CONTRACT static size_t SkinPositionsAVX2(const FMatrix* Palette, const FSkinWeightInfo* Weights, FVectorSoA In, FVectorSoA Out, size_t Count)
+{
+	size_t i = 0;
+	for (; i + 4 <= Count; i += 4)
+	{
+		// All four read before any store, for Out aliasing In
+		const __m256d R0 = SkinVertexAVX2(Palette, Weights[i + 0], In.X[i + 0], In.Y[i + 0], In.Z[i + 0]);
+		const __m256d R1 = SkinVertexAVX2(Palette, Weights[i + 1], In.X[i + 1], In.Y[i + 1], In.Z[i + 1]);
+		const __m256d R2 = SkinVertexAVX2(Palette, Weights[i + 2], In.X[i + 2], In.Y[i + 2], In.Z[i + 2]);
+		const __m256d R3 = SkinVertexAVX2(Palette, Weights[i + 3], In.X[i + 3], In.Y[i + 3], In.Z[i + 3]);
+		StoreTransposedAVX2(R0, R1, R2, R3, Out, i);
+	}
+	return i;
+}
+
+UE_TARGET_AVX512 UE_NO_FP_CONTRACT static size_t SkinPositionsAVX512(const FMatrix* Palette, const FSkinWeightInfo* Weights, FVectorSoA In, FVectorSoA Out, size_t Count)
+{
+	size_t i = 0;
+	for (; i + 4 <= Count; i += 4)
+	{
+		const __m256d R0 = SkinVertexAVX512(Palette, Weights[i + 0], In.X[i + 0], In.Y[i + 0], In.Z[i + 0]);
+		const __m256d R1 = SkinVertexAVX512(Palette, Weights[i + 1], In.X[i + 1], In.Y[i + 1], In.Z[i + 1]);
+		const __m256d R2 = SkinVertexAVX512(Palette, Weights[i + 2], In.X[i + 2], In.Y[i + 2], In.Z[i + 2]);
+		const __m256d R3 = SkinVertexAVX512(Palette, Weights[i + 3], In.X[i + 3], In.Y[i + 3], In.Z[i + 3]);
+		StoreTransposedAVX2(R0, R1, R2, R3, Out, i);
+	}
+	return i;
+}
+#endif
+
+static void SkinPositionsDispatch(const FMatrix* Palette, const FSkinWeightInfo* Weights, FVectorSoA In, FVectorSoA Out, size_t Count)
+{
+	size_t i = 0;
+	switch (GetSimdLevel())
+	{
+#if UE_MATH_X86
+	case ESimdLevel::AVX512:
+		i = SkinPositionsAVX512(Palette, Weights, In, Out, Count);
+		break;
+	case ESimdLevel::AVX2:
+		i = SkinPositionsAVX2(Palette, Weights, In, Out, Count);
+		break;
+#endif
+	default:
+		break;
+	}
+
+	for (; i < Count; ++i)
+	{
+		Out.Set(i, SkinPosition(Palette, Weights[i], In.Get(i)));
+	}
+}
+
+/*-----------------------------------------------------------------------------
+	Dual quaternion skinning.
+-----------------------------------------------------------------------------*/
+
+static inline FVector SkinPosition(const FDualQuat* Palette, const FSkinWeightInfo& Info, const FVector& Position)
+{
+	FDualQuat Influences[MaxSkinInfluences];
+	double InfluenceWeights[MaxSkinInfluences];
+	for (int Influence = 0; Influence < MaxSkinInfluences; ++Influence)
+	{
+		Influences[Influence] = Palette[Info.InfluenceBones[Influence]];
+		InfluenceWeights[Influence] = Info.InfluenceWeights[Influence];
+	}
+	return FDualQuat::Blend(Influences, InfluenceWeights, MaxSkinInfluences).TransformPosition(Position);
+}
+
+#if UE_MATH_X86
+/** FDualQuat::Blend and TransformPosition per lane, with the palette entries gathered by bone index. */
+UE_TARGET_AVX2 UE_NO_FP_CONTRACT static size_t SkinDualQuatsAVX2(const FDualQuat* Palette, const FSkinWeightInfo* Weights, FVectorSoA In, FVectorSoA Out, size_t Count)
+{
+	static_assert(sizeof(FDualQuat) == 8 * sizeof(double), "Gather offsets assume 8 doubles per FDualQuat");
+	const double* Base = &Palette[0].Real.X;
+	const __m256d Zero = _mm256_setzero_pd();
+	const __m256d One = _mm256_set1_pd(1.0);
+	const __m256d Two = _mm256_set1_pd(2.0);
+	const __m256d SignBit = _mm256_set1_pd(-0.0);
+	const __m256d SmallNumber = _mm256_set1_pd(SMALL_NUMBER);
+
+	size_t i = 0;
+	for (; i + 4 <= Count; i += 4)
+	{
+		const FSkinWeightInfo* Info = Weights + i;
+
+		// Blend, each influence flipped to the first one's hemisphere
+		__m256d RX = Zero, RY = Zero, RZ = Zero, RW = Zero;
+		__m256d DX = Zero, DY = Zero, DZ = Zero, DW = Zero;
+		__m256d FirstX = Zero, FirstY = Zero, FirstZ = Zero, FirstW = Zero;
+		for (int Influence = 0; Influence < MaxSkinInfluences; ++Influence)
+		{
+			const __m128i Index = _mm_set_epi32(Info[3].InfluenceBones[Influence] * 8, Info[2].InfluenceBones[Influence] * 8,
+				Info[1].InfluenceBones[Influence] * 8, Info[0].InfluenceBones[Influence] * 8);
+			const __m256d QX = _mm256_i32gather_pd(Base + 0, Index, 8);
+			const __m256d QY = _mm256_i32gather_pd(Base + 1, Index, 8);
+			const __m256d QZ = _mm256_i32gather_pd(Base + 2, Index, 8);
+			const __m256d QW = _mm256_i32gather_pd(Base + 3, Index, 8);
+			if (Influence == 0)
+			{
+				FirstX = QX;
+				FirstY = QY;
+				FirstZ = QZ;
+				FirstW = QW;
+			}
+
+			const __m256d Dot = _mm256_add_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(FirstX, QX), _mm256_mul_pd(FirstY, QY)), _mm256_mul_pd(FirstZ, QZ)), _mm256_mul_pd(FirstW, QW));
+			const __m256d Weight = _mm256_set_pd(Info[3].InfluenceWeights[Influence], Info[2].InfluenceWeights[Influence], Info[1].InfluenceWeights[Influence], Info[0].InfluenceWeights[Influence]);
+			const __m256d Signed = _mm256_blendv_pd(_mm256_xor_pd(Weight, SignBit), Weight, _mm256_cmp_pd(Dot, Zero, _CMP_GE_OQ));
+
+			RX = _mm256_add_pd(RX, _mm256_mul_pd(QX, Signed));
+			RY = _mm256_add_pd(RY, _mm256_mul_pd(QY, Signed));
+			RZ = _mm256_add_pd(RZ, _mm256_mul_pd(QZ, Signed));
+			RW = _mm256_add_pd(RW, _mm256_mul_pd(QW, Signed));
+			DX = _mm256_add_pd(DX, _mm256_mul_pd(_mm256_i32gather_pd(Base + 4, Index, 8), Signed));
+			DY = _mm256_add_pd(DY, _mm256_mul_pd(_mm256_i32gather_pd(Base + 5, Index, 8), Signed));
+			DZ = _mm256_add_pd(DZ, _mm256_mul_pd(_mm256_i32gather_pd(Base + 6, Index, 8), Signed));
+			DW = _mm256_add_pd(DW, _mm256_mul_pd(_mm256_i32gather_pd(Base + 7, Index, 8), Signed));
+		}
+
+		// Normalize; lanes with a vanishing Real become the identity afterwards
+		const __m256d SquareSum = _mm256_add_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(RX, RX), _mm256_mul_pd(RY, RY)), _mm256_mul_pd(RZ, RZ)), _mm256_mul_pd(RW, RW));
+		const __m256d Scale = _mm256_div_pd(One, _mm256_sqrt_pd(SquareSum));
+		RX = _mm256_mul_pd(RX, Scale);
+		RY = _mm256_mul_pd(RY, Scale);
+		RZ = _mm256_mul_pd(RZ, Scale);
+		RW = _mm256_mul_pd(RW, Scale);
+		DX = _mm256_mul_pd(DX, Scale);
+		DY = _mm256_mul_pd(DY, Scale);
+		DZ = _mm256_mul_pd(DZ, Scale);
+		DW = _mm256_mul_pd(DW, Scale);
+		const __m256d RealDotDual = _mm256_add_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(RX, DX), _mm256_mul_pd(RY, DY)), _mm256_mul_pd(RZ, DZ)), _mm256_mul_pd(RW, DW));
+		DX = _mm256_sub_pd(DX, _mm256_mul_pd(RX, RealDotDual));
+		DY = _mm256_sub_pd(DY, _mm256_mul_pd(RY, RealDotDual));
+		DZ = _mm256_sub_pd(DZ, _mm256_mul_pd(RZ, RealDotDual));
+		DW = _mm256_sub_pd(DW, _mm256_mul_pd(RW, RealDotDual));
+
+		const __m256d bIdentity = _mm256_cmp_pd(SquareSum, SmallNumber, _CMP_LT_OQ);
+		RX = _mm256_blendv_pd(RX, Zero, bIdentity);
+		RY = _mm256_blendv_pd(RY, Zero, bIdentity);
+		RZ = _mm256_blendv_pd(RZ, Zero, bIdentity);
+		RW = _mm256_blendv_pd(RW, One, bIdentity);
+		DX = _mm256_blendv_pd(DX, Zero, bIdentity);
+		DY = _mm256_blendv_pd(DY, Zero, bIdentity);
+		DZ = _mm256_blendv_pd(DZ, Zero, bIdentity);
+		DW = _mm256_blendv_pd(DW, Zero, bIdentity);
+
+		// Translation: ((DualV * W - RealV * Dual.W) + (RealV ^ DualV)) * 2
+		const __m256d TX = _mm256_mul_pd(_mm256_add_pd(_mm256_sub_pd(_mm256_mul_pd(DX, RW), _mm256_mul_pd(RX, DW)), _mm256_sub_pd(_mm256_mul_pd(RY, DZ), _mm256_mul_pd(RZ, DY))), Two);
+		const __m256d TY = _mm256_mul_pd(_mm256_add_pd(_mm256_sub_pd(_mm256_mul_pd(DY, RW), _mm256_mul_pd(RY, DW)), _mm256_sub_pd(_mm256_mul_pd(RZ, DX), _mm256_mul_pd(RX, DZ))), Two);
+		const __m256d TZ = _mm256_mul_pd(_mm256_add_pd(_mm256_sub_pd(_mm256_mul_pd(DZ, RW), _mm256_mul_pd(RZ, DW)), _mm256_sub_pd(_mm256_mul_pd(RX, DY), _mm256_mul_pd(RY, DX))), Two);
+
+		// Rotation as FQuat::RotateVector
+		const __m256d VX = _mm256_loadu_pd(In.X + i);
+		const __m256d VY = _mm256_loadu_pd(In.Y + i);
+		const __m256d VZ = _mm256_loadu_pd(In.Z + i);
+		const __m256d T0 = _mm256_mul_pd(_mm256_sub_pd(_mm256_mul_pd(RY, VZ), _mm256_mul_pd(RZ, VY)), Two);
+		const __m256d T1 = _mm256_mul_pd(_mm256_sub_pd(_mm256_mul_pd(RZ, VX), _mm256_mul_pd(RX, VZ)), Two);
+		const __m256d T2 = _mm256_mul_pd(_mm256_sub_pd(_mm256_mul_pd(RX, VY), _mm256_mul_pd(RY, VX)), Two);
+		__m256d PX = _mm256_add_pd(VX, _mm256_mul_pd(T0, RW));
+		__m256d PY = _mm256_add_pd(VY, _mm256_mul_pd(T1, RW));
+		__m256d PZ = _mm256_add_pd(VZ, _mm256_mul_pd(T2, RW));
+		PX = _mm256_add_pd(PX, _mm256_sub_pd(_mm256_mul_pd(RY, T2), _mm256_mul_pd(RZ, T1)));
+		PY = _mm256_add_pd(PY, _mm256_sub_pd(_mm256_mul_pd(RZ, T0), _mm256_mul_pd(RX, T2)));
+		PZ = _mm256_add_pd(PZ, _mm256_sub_pd(_mm256_mul_pd(RX, T1), _mm256_mul_pd(RY, T0)));
+
+		_mm256_storeu_pd(Out.X + i, _mm256_add_pd(PX, TX));
+		_mm256_storeu_pd(Out.Y + i, _mm256_add_pd(PY, TY));
+		_mm256_storeu_pd(Out.Z + i, _mm256_add_pd(PZ, TZ));
+	}
+	return i;
+}
+#endif
+
+static void SkinPositionsDispatch(const FDualQuat* Palette, const FSkinWeightInfo* Weights, FVectorSoA In, FVectorSoA Out, size_t Count)
+{
+	size_t i = 0;
+	switch (GetSimdLevel())
+	{
+#if UE_MATH_X86
+	case ESimdLevel::AVX512:
+	case ESimdLevel::AVX2:
+		i = SkinDualQuatsAVX2(Palette, Weights, In, Out, Count);
+		break;
+#endif
+	default:
+		break;
+	}
+
+	for (; i < Count; ++i)
+	{
+		Out.Set(i, SkinPosition(Palette, Weights[i], In.Get(i)));
+	}
+}
+
+/*-----------------------------------------------------------------------------
+	Entry points.
+-----------------------------------------------------------------------------*/
+
+// Position in and out plus the weights, per vertex
+static const size_t SkinnedVertexBytes = 6 * sizeof(double) + sizeof(FSkinWeightInfo);
+
+template<typename PaletteType>
+static void SkinPositions(const PaletteType* Palette, const FSkinWeightInfo* Weights, FVectorSoA In, FVectorSoA Out, size_t Count, FTaskScheduler* Scheduler)
+{
+	ParallelFor(Scheduler, Count, GetParallelChunkSize(SkinnedVertexBytes), [&](size_t Begin, size_t End)
+	{
+		SkinPositionsDispatch(Palette, Weights + Begin, FVectorSoA(In.X + Begin, In.Y + Begin, In.Z + Begin),
+			FVectorSoA(Out.X + Begin, Out.Y + Begin, Out.Z + Begin), End - Begin);
+	});
+}
+
+void BatchSkinPositions(const FMatrix* Palette, const FSkinWeightInfo* Weights, FVectorSoA In, FVectorSoA Out, size_t Count, FTaskScheduler* Scheduler)
+{
+	SkinPositions(Palette, Weights, In, Out, Count, Scheduler);
+}
+
+void BatchSkinPositions(const FDualQuat* Palette, const FSkinWeightInfo* Weights, FVectorSoA In, FVectorSoA Out, size_t Count, FTaskScheduler* Scheduler)
+{
+	SkinPositions(Palette, Weights, In, Out, Count, Scheduler);
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "ue4math.h"
+#include "mathfwd.h"
+#include "vector.h"
+#include "matrix.h"
+#include "transform.h"
+#include "batch.h"
+#include "dualquat.h"
+
+/** Bone influences per vertex the skinning kernels read. */
+static constexpr int32_t MaxSkinInfluences = 4;
+
+/**
+ * The bones deforming one vertex and their weights, which should sum to 1. A vertex with fewer
+ * influences fills the rest with weight 0 and any valid bone index (e.g. its first bone's).
+ */
+struct FSkinWeightInfo
+{
+	uint16_t InfluenceBones[MaxSkinInfluences];
+	float InfluenceWeights[MaxSkinInfluences];
+};
+
+static_assert(sizeof(FSkinWeightInfo) == 24, "FSkinWeightInfo");
+
+/**
+ * The linear blend skinning palette of a pose: OutPalette[i] = InverseBindMatrices[i] *
+ * ComponentTransforms[i].ToMatrixWithScale(), taking a bind pose vertex to component space
+ * through bone i. InverseBindMatrices are the inverted bind pose matrices, computed once per mesh.
+ */
+void BuildSkinningMatrices(const FTransform* ComponentTransforms, const FMatrix* InverseBindMatrices, FMatrix* OutPalette, size_t NumBones);
+
+/**
+ * The dual quaternion skinning palette of a pose: OutPalette[i] = FDualQuat(InverseBindTransforms[i]
+ * * ComponentTransforms[i]). Dual quaternions carry no scale, so the transforms should be unscaled.
+ */
+void BuildSkinningDualQuats(const FTransform* ComponentTransforms, const FTransform* InverseBindTransforms, FDualQuat* OutPalette, size_t NumBones);
+
+/**
+ * Linear blend skinning: each vertex In[i] goes through the weighted sum of the palette matrices of
+ * its influences Weights[i], as a row vector with the translation in the last row. Every influence
+ * is blended, including those of weight 0.
+ *
+ * Dispatches on GetSimdLevel() to an AVX-512 kernel (two matrix rows per register) or an AVX2
+ * one (one row per register, four vertices per step), both bit identical to the scalar code as
+ * long as it is not built with FMA contraction. With a Scheduler, batches of more than a few
+ * cache-sized chunks are split over its threads. Out may alias In.
+ */
+void BatchSkinPositions(const FMatrix* Palette, const FSkinWeightInfo* Weights, FVectorSoA In, FVectorSoA Out, size_t Count, FTaskScheduler* Scheduler = nullptr);
+
+/**
+ * Dual quaternion skinning: each vertex In[i] goes through FDualQuat::Blend of the palette entries
+ * of its influences. Unlike the linear blend it keeps twisted joints from collapsing, but ignores
+ * scale. The AVX2 kernel (also used at the AVX-512 level) gathers four vertices' influences per
+ * step and matches FDualQuat::Blend(...).TransformPosition(In[i]) bit for bit. Scheduler and
+ * aliasing as above.
+ */
+void BatchSkinPositions(const FDualQuat* Palette, const FSkinWeightInfo* Weights, FVectorSoA In, FVectorSoA Out, size_t Count, FTaskScheduler* Scheduler = nullptr);
@@ -0,0 +1,194 @@
+#include "stats.h"
+#include <atomic>
+#include <mutex>
+
+static const int NumStats = (int)EMathStat::Num;
+
+static const char* const StatNames[NumStats] =
+{
+	"FMatrix::Inverse",
+	"FTransform::Multiply",
+	"FTransform::MultiplyUsingMatrixWithScale",
+	"FTransform::GetRelativeTransform",
+	"FTransform::GetRelativeTransformUsingMatrixWithScale",
+};
+
+/**
+ * One thread's counters. Only the owning thread writes them, with a relaxed load and store
+ * rather than a locked add; the atomics are there so a report can read them while it runs.
+ */
+struct FThreadStats
+{
+	std::atomic<uint64_t> Calls[NumStats];
+	std::atomic<uint64_t> SlowPathHits[NumStats];
+	std::atomic<uint64_t> TotalTicks[NumStats];
+	std::atomic<uint64_t> Histogram[NumStats][MathStatNumBuckets];
+
+	FThreadStats* Next;
+	FThreadStats* Prev;
+
+	FThreadStats();
+	~FThreadStats();
+};
+
+/** The live threads' counters, and the totals of the threads that have exited. */
+struct FStatsRegistry
+{
+	std::mutex Mutex;
+	FThreadStats* Head = nullptr;
+	FMathStatCounters Retired[NumStats] = {};
+};
+
+static FStatsRegistry& GetRegistry()
+{
+	static FStatsRegistry Registry;
+	return Registry;
+}
+
+static inline void Add(std::atomic<uint64_t>& Counter, uint64_t Value)
+{
+	Counter.store(Counter.load(std::memory_order_relaxed) + Value, std::memory_order_relaxed);
+}
+
+static int GetBucket(uint64_t Ticks)
+{
+	return Ticks == 0 ? 0 : std::min<int>(FloorLog2_64(Ticks) + 1, MathStatNumBuckets - 1);
+}
+
+FThreadStats::FThreadStats() : Next(nullptr), Prev(nullptr)
+{
+	for (int Stat = 0; Stat < NumStats; ++Stat)
+	{
+		Calls[Stat].store(0, std::memory_order_relaxed);
+		SlowPathHits[Stat].store(0, std::memory_order_relaxed);
+		TotalTicks[Stat].store(0, std::memory_order_relaxed);
+		for (std::atomic<uint64_t>& Bucket : Histogram[Stat])
+			Bucket.store(0, std::memory_order_relaxed);
+	}
+
+	FStatsRegistry& Registry = GetRegistry();
+	std::lock_guard<std::mutex> Lock(Registry.Mutex);
+	Next = Registry.Head;
+	if (Next)
+		Next->Prev = this;
+	Registry.Head = this;
+}
+
+FThreadStats::~FThreadStats()
+{
+	FStatsRegistry& Registry = GetRegistry();
+	std::lock_guard<std::mutex> Lock(Registry.Mutex);
+	for (int Stat = 0; Stat < NumStats; ++Stat)
+	{
+		FMathStatCounters& Retired = Registry.Retired[Stat];
+		Retired.Calls += Calls[Stat].load(std::memory_order_relaxed);
+		Retired.SlowPathHits += SlowPathHits[Stat].load(std::memory_order_relaxed);
+		Retired.TotalTicks += TotalTicks[Stat].load(std::memory_order_relaxed);
+		for (int Bucket = 0; Bucket < MathStatNumBuckets; ++Bucket)
+			Retired.Histogram[Bucket] += Histogram[Stat][Bucket].load(std::memory_order_relaxed);
+	}
+
+	if (Prev)
+		Prev->Next = Next;
+	else
+		Registry.Head = Next;
+	if (Next)
+		Next->Prev = Prev;
+}
+
+static FThreadStats& GetThreadStats()
+{
+	static thread_local FThreadStats ThreadStats;
+	return ThreadStats;
+}
+
+void RecordMathStatCall(EMathStat Stat, uint64_t Ticks)
+{
+	FThreadStats& Stats = GetThreadStats();
+	Add(Stats.Calls[(int)Stat], 1);
+	Add(Stats.TotalTicks[(int)Stat], Ticks);
+	Add(Stats.Histogram[(int)Stat][GetBucket(Ticks)], 1);
+}
+
+void RecordMathStatSlowPath(EMathStat Stat)
+{
+	Add(GetThreadStats().SlowPathHits[(int)Stat], 1);
+}
+
+const char* GetMathStatName(EMathStat Stat)
+{
+	return (int)Stat < NumStats ? StatNames[(int)Stat] : "?";
+}
+
+const char* GetMathStatTickUnit()
+{
+	return UE_MATH_X86 ? "cycles" : "ns";
+}
+
+void GetMathStats(EMathStat Stat, FMathStatCounters& OutCounters)
+{
+	FStatsRegistry& Registry = GetRegistry();
+	std::lock_guard<std::mutex> Lock(Registry.Mutex);
+	OutCounters = Registry.Retired[(int)Stat];
+	for (const FThreadStats* Thread = Registry.Head; Thread; Thread = Thread->Next)
+	{
+		OutCounters.Calls += Thread->Calls[(int)Stat].load(std::memory_order_relaxed);
+		OutCounters.SlowPathHits += Thread->SlowPathHits[(int)Stat].load(std::memory_order_relaxed);
+		OutCounters.TotalTicks += Thread->TotalTicks[(int)Stat].load(std::memory_order_relaxed);
+		for (int Bucket = 0; Bucket < MathStatNumBuckets; ++Bucket)
+			OutCounters.Histogram[Bucket] += Thread->Histogram[(int)Stat][Bucket].load(std::memory_order_relaxed);
+	}
+}
+
+void ResetMathStats()
+{
+	FStatsRegistry& Registry = GetRegistry();
+	std::lock_guard<std::mutex> Lock(Registry.Mutex);
+	for (int Stat = 0; Stat < NumStats; ++Stat)
+	{
+		Registry.Retired[Stat] = FMathStatCounters();
+		for (FThreadStats* Thread = Registry.Head; Thread; Thread = Thread->Next)
+		{
+			Thread->Calls[Stat].store(0, std::memory_order_relaxed);
+			Thread->SlowPathHits[Stat].store(0, std::memory_order_relaxed);
+			Thread->TotalTicks[Stat].store(0, std::memory_order_relaxed);
+			for (std::atomic<uint64_t>& Bucket : Thread->Histogram[Stat])
+				Bucket.store(0, std::memory_order_relaxed);
+		}
+	}
+}
+
+#if UE_MATH_STATS
+/** Upper bound of the bucket holding the call at Fraction of the way through the histogram. */
+static uint64_t GetPercentileTicks(const FMathStatCounters& Counters, double Fraction)
+{
+	const uint64_t Target = std::max<uint64_t>((uint64_t)ceil(Counters.Calls * Fraction), 1);
+	uint64_t Seen = 0;
+	for (int Bucket = 0; Bucket < MathStatNumBuckets; ++Bucket)
+	{
+		Seen += Counters.Histogram[Bucket];
+		if (Seen >= Target)
+			return Bucket == 0 ? 0 : ((uint64_t)1 << Bucket) - 1;
+	}
+	return UINT64_MAX;
+}
+#endif
+
+void DumpMathStats(FILE* Out)
+{
+#if !UE_MATH_STATS
+	fprintf(Out, "ue5math stats: compiled out (build with UE_MATH_STATS=1)\n");
+#else
+	fprintf(Out, "%-52s %12s %12s %10s %10s %10s  (%s)\n", "function", "calls", "slow path", "mean", "p50 <=", "p99 <=", GetMathStatTickUnit());
+	for (int Stat = 0; Stat < NumStats; ++Stat)
+	{
+		FMathStatCounters Counters;
+		GetMathStats((EMathStat)Stat, Counters);
+		if (Counters.Calls == 0 && Counters.SlowPathHits == 0)
+			continue;
+		fprintf(Out, "%-52s %12llu %12llu %10.1f %10llu %10llu\n", StatNames[Stat], (unsigned long long)Counters.Calls, (unsigned long long)Counters.SlowPathHits,
+			Counters.Calls ? (double)Counters.TotalTicks / Counters.Calls : 0.0,
+			(unsigned long long)GetPercentileTicks(Counters, 0.5), (unsigned long long)GetPercentileTicks(Counters, 0.99));
+	}
+#endif
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include "ue4math.h"
+#include "cpu.h"
+#include <stdio.h>
+#if !UE_MATH_X86
+#include <chrono>
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+/*-----------------------------------------------------------------------------
+	Instrumentation of the opaque entry points: call counts, slow path hits
+	and latency histograms per function. Compiled out unless UE_MATH_STATS is
+	defined to 1 (the UE_MATH_STATS CMake option), in which case the macros
+	below record into buckets owned by the calling thread: a handful of
+	relaxed stores per call, no locks and no allocations. A thread's buckets
+	are registered the first time it records and folded into a shared total
+	when it exits. The reporting functions exist in both modes; with the
+	instrumentation compiled out GetMathStats returns zeros and DumpMathStats
+	prints one line saying so instead of the table. Like UE_MATH_HEADER_ONLY,
+	the setting must agree across a program.
+-----------------------------------------------------------------------------*/
+#ifndef UE_MATH_STATS
+#define UE_MATH_STATS 0
+#endif
+
+/** The instrumented functions. Float and double instantiations share a counter. */
+enum class EMathStat : uint8_t
+{
+	MatrixInverse,								/* Slow path: zero scale or singular, returns the fallback */
+	TransformMultiply,							/* Slow path: negative scale, through matrices */
+	TransformMultiplyUsingMatrixWithScale,
+	TransformGetRelativeTransform,				/* Slow path: negative scale, through matrices */
+	TransformGetRelativeTransformUsingMatrixWithScale,
+	Num
+};
+
+/** Latency bucket i counts calls that took [2^(i-1), 2^i) ticks (bucket 0: no tick); the last bucket takes the rest. */
+static constexpr int MathStatNumBuckets = 32;
+
+struct FMathStatCounters
+{
+	uint64_t Calls;
+	uint64_t SlowPathHits;
+	uint64_t TotalTicks;
+	uint64_t Histogram[MathStatNumBuckets];
+};
+
+const char* GetMathStatName(EMathStat Stat);
+
+/** Unit of the latency figures: "cycles" (rdtsc) on x86, "ns" (steady_clock) elsewhere. */
+const char* GetMathStatTickUnit();
+
+/** Sums Stat over every thread, live or exited. Exact once the recording threads are quiet. */
+void GetMathStats(EMathStat Stat, FMathStatCounters& OutCounters);
+
+/** Zeroes every counter. Calls recording at the same time may be half counted. */
+void ResetMathStats();
+
+/** Writes a table of calls, slow path hits and latency percentiles per function with any calls. */
+void DumpMathStats(FILE* Out = stdout);
+
+/** Ticks of the clock the latency histograms use. */
+inline uint64_t ReadMathStatTicks()
+{
+#if UE_MATH_X86
+	return __rdtsc();
+#else
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+void RecordMathStatCall(EMathStat Stat, uint64_t Ticks);
+void RecordMathStatSlowPath(EMathStat Stat);
+
+/** Records one call to Stat and its latency when it goes out of scope. */
+struct FMathStatScope
+{
+	EMathStat Stat;
+	uint64_t StartTicks;
+
+	explicit FMathStatScope(EMathStat Stat) : Stat(Stat), StartTicks(ReadMathStatTicks()) {}
+	~FMathStatScope() { RecordMathStatCall(Stat, ReadMathStatTicks() - StartTicks); }
+
+	FMathStatScope(const FMathStatScope&) = delete;
+	FMathStatScope& operator=(const FMathStatScope&) = delete;
+};
+
+#if UE_MATH_STATS
+#define UE_MATH_STAT_SCOPE(Stat)		FMathStatScope MathStatScope(EMathStat::Stat)
+#define UE_MATH_STAT_SLOW_PATH(Stat)	RecordMathStatSlowPath(EMathStat::Stat)
+#else
+#define UE_MATH_STAT_SCOPE(Stat)
+#define UE_MATH_STAT_SLOW_PATH(Stat)
+#endif
@@ -0,0 +1,157 @@
+#pragma once
+#include "ue4math.h"
+#include "cpu.h"
+#include "vector.h"
+#include "quat.h"
+#include "rotator.h"
+#include <stdio.h>
+#include <vector>
+#if UE_MATH_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+/*-----------------------------------------------------------------------------
+	Minimal self-contained test registry, so the tests build without any
+	third party framework. TEST_CASE(Suite, Name) registers a test; the
+	CHECK macros record a failure and keep going, so one run reports every
+	broken expectation of a test.
+-----------------------------------------------------------------------------*/
+
+struct FTestCase
+{
+	const char* Suite;
+	const char* Name;
+	void (*Function)();
+};
+
+inline std::vector<FTestCase>& GetTestRegistry()
+{
+	static std::vector<FTestCase> Registry;
+	return Registry;
+}
+
+/** Failures recorded by the CHECK macros since the current test started. */
+inline int& GetTestFailureCount()
+{
+	static int Count = 0;
+	return Count;
+}
+
+struct FTestRegistrar
+{
+	FTestRegistrar(const char* Suite, const char* Name, void (*Function)()) { GetTestRegistry().push_back({ Suite, Name, Function }); }
+};
+
+inline void ReportTestFailure(const char* File, int Line, const char* Expression)
+{
+	printf("  %s:%d: CHECK(%s) failed\n", File, Line, Expression);
+	++GetTestFailureCount();
+}
+
+inline void ReportTestFailureNear(const char* File, int Line, const char* Expression, double A, double B, double Tolerance)
+{
+	printf("  %s:%d: CHECK_NEAR(%s) failed: %.17g vs %.17g, tolerance %g\n", File, Line, Expression, A, B, Tolerance);
+	++GetTestFailureCount();
+}
+
+#define UE_TEST_CONCAT_INNER(A, B) A##B
+#define UE_TEST_CONCAT(A, B) UE_TEST_CONCAT_INNER(A, B)
+
+#define TEST_CASE(Suite, Name) \
+	static void UE_TEST_CONCAT(Test_##Suite##_, Name)(); \
+	static FTestRegistrar UE_TEST_CONCAT(Registrar_##Suite##_, Name)(#Suite, #Name, &UE_TEST_CONCAT(Test_##Suite##_, Name)); \
+	static void UE_TEST_CONCAT(Test_##Suite##_, Name)()
+
+#define CHECK(Expression) \
+	do { if (!(Expression)) ReportTestFailure(__FILE__, __LINE__, #Expression); } while (0)
+
+#define CHECK_NEAR(A, B, Tolerance) \
+	do { \
+		const double CheckA = (double)(A), CheckB = (double)(B), CheckTolerance = (double)(Tolerance); \
+		if (!(fabs(CheckA - CheckB) <= CheckTolerance)) ReportTestFailureNear(__FILE__, __LINE__, #A ", " #B, CheckA, CheckB, CheckTolerance); \
+	} while (0)
+
+#define CHECK_VECTOR_NEAR(A, B, Tolerance) \
+	do { CHECK_NEAR((A).X, (B).X, Tolerance); CHECK_NEAR((A).Y, (B).Y, Tolerance); CHECK_NEAR((A).Z, (B).Z, Tolerance); } while (0)
+
+/** Runs Function once per SIMD level the CPU supports, restoring the current level afterwards. */
+template<typename FunctionType>
+void ForEachSimdLevel(FunctionType Function)
+{
+	const ESimdLevel Saved = GetSimdLevel();
+	for (int Level = (int)ESimdLevel::Scalar; Level <= (int)GetSupportedSimdLevel(); ++Level)
+	{
+		SetSimdLevel((ESimdLevel)Level);
+		Function((ESimdLevel)Level);
+	}
+	SetSimdLevel(Saved);
+}
+
+/**
+ * True while the upper halves of the YMM registers hold live state (XINUSE bit 2), so the next
+ * SSE instruction pays a transition or a false dependency. False where the CPU cannot report it.
+ */
+inline bool IsUpperSimdStateDirty()
+{
+#if UE_MATH_X86
+	// XGETBV with ECX = 1 needs CPUID.(EAX=0DH, ECX=1):EAX bit 2
+#if defined(_MSC_VER)
+	int Info[4];
+	__cpuidex(Info, 0xD, 1);
+	return (Info[0] & 4) != 0 && (_xgetbv(1) & 4) != 0;
+#else
+	uint32_t Regs[4];
+	if (!__get_cpuid_count(0xD, 1, &Regs[0], &Regs[1], &Regs[2], &Regs[3]) || !(Regs[0] & 4))
+		return false;
+	uint32_t Lo, Hi;
+	__asm__ volatile("xgetbv" : "=a"(Lo), "=d"(Hi) : "c"(1));
+	return (Lo & 4) != 0;
+#endif
+#else
+	return false;
+#endif
+}
+
+/** Small deterministic generator (xorshift64*), so failures reproduce across platforms. */
+struct FTestRandom
+{
+	uint64_t State;
+
+	explicit FTestRandom(uint64_t Seed = 0x9E3779B97F4A7C15ull) : State(Seed ? Seed : 1) {}
+
+	uint64_t Next()
+	{
+		State ^= State >> 12;
+		State ^= State << 25;
+		State ^= State >> 27;
+		return State * 0x2545F4914F6CDD1Dull;
+	}
+
+	/** Uniform in [Min, Max). */
+	double Range(double Min, double Max) { return Min + (Max - Min) * (double)(Next() >> 11) * (1.0 / 9007199254740992.0); }
+
+	/** Each component uniform in [Min, Max), drawn X, Y, Z in that order. */
+	FVector Vector(double Min, double Max)
+	{
+		const double X = Range(Min, Max);
+		const double Y = Range(Min, Max);
+		const double Z = Range(Min, Max);
+		return FVector(X, Y, Z);
+	}
+
+	/** Each component uniform in [-Extent, Extent). */
+	FVector Vector(double Extent) { return Vector(-Extent, Extent); }
+
+	/** A unit rotation from a random rotator, pitch kept off the poles. */
+	FQuat Quat()
+	{
+		const double Pitch = Range(-89, 89);
+		const double Yaw = Range(-180, 180);
+		const double Roll = Range(-180, 180);
+		return FRotator(Pitch, Yaw, Roll).GetQuaternion();
+	}
+};
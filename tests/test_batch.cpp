@@ -0,0 +1,387 @@
+#include "test.h"
+#include "batch.h"
+#include "parallel.h"
+#include <string.h>
+#include <vector>
+
+static FTransform RandomTransform(FTestRandom& Random)
+{
+	return FTransform(
+		FRotator(Random.Range(-180, 180), Random.Range(-180, 180), Random.Range(-180, 180)).GetQuaternion(),
+		Random.Vector(1000),
+		Random.Vector(0.5, 2));
+}
+
+TEST_CASE(Batch, SetSimdLevelClamps)
+{
+	const ESimdLevel Saved = GetSimdLevel();
+	SetSimdLevel(ESimdLevel::AVX512);
+	CHECK(GetSimdLevel() == GetSupportedSimdLevel());
+	SetSimdLevel(ESimdLevel::Scalar);
+	CHECK(GetSimdLevel() == ESimdLevel::Scalar);
+	SetSimdLevel(Saved);
+}
+
+TEST_CASE(Batch, GetBoneWithRotationBitExact)
+{
+	FTestRandom Random(43);
+	const FTransform ComponentToWorld = RandomTransform(Random);
+
+	// Odd count so every kernel runs its scalar tail
+	const size_t Count = 1000 + 7;
+	std::vector<FTransform> Bones(Count);
+	for (FTransform& Bone : Bones)
+		Bone = RandomTransform(Random);
+
+	std::vector<double> X(Count), Y(Count), Z(Count);
+	ForEachSimdLevel([&](ESimdLevel)
+	{
+		BatchGetBoneWithRotation(ComponentToWorld, Bones.data(), Count, FVectorSoA(X.data(), Y.data(), Z.data()));
+		size_t NumMismatches = 0;
+		for (size_t i = 0; i < Count; ++i)
+		{
+			const FVector Expected = ComponentToWorld.GetBoneWithRotation(Bones[i]);
+			NumMismatches += Expected.X != X[i] || Expected.Y != Y[i] || Expected.Z != Z[i];
+		}
+		CHECK(NumMismatches == 0);
+	});
+}
+
+TEST_CASE(Batch, GetBoneWithRotationLeavesUpperStateClean)
+{
+	// The scalar tail runs after the vector loop; the caller must not inherit dirty YMM state from it
+	FTestRandom Random(45);
+	const FTransform ComponentToWorld = RandomTransform(Random);
+	std::vector<FTransform> Bones(16 + 3);
+	for (FTransform& Bone : Bones)
+		Bone = RandomTransform(Random);
+	std::vector<double> X(Bones.size()), Y(Bones.size()), Z(Bones.size());
+	ForEachSimdLevel([&](ESimdLevel Level)
+	{
+		if (Level == ESimdLevel::Scalar)
+			return;
+		// Both enter the vector loop at every level, one with a tail and one without
+		for (size_t Count : { (size_t)8, Bones.size() })
+		{
+			BatchGetBoneWithRotation(ComponentToWorld, Bones.data(), Count, FVectorSoA(X.data(), Y.data(), Z.data()));
+			CHECK(!IsUpperSimdStateDirty());
+		}
+	});
+}
+
+TEST_CASE(Batch, GetBoneWithRotationFromViews)
+{
+	FTestRandom Random(44);
+	const FTransform ComponentToWorld = RandomTransform(Random);
+	const size_t Count = 300 + 5;
+	std::vector<FTransform> Bones(Count);
+	for (FTransform& Bone : Bones)
+		Bone = RandomTransform(Random);
+
+	// A packed record with the fields shuffled and nothing aligned: scale, 5 bytes, translation, rotation
+	const size_t Stride = 24 + 5 + 24 + 32;
+	const size_t ScaleOffset = 0, TranslationOffset = 29, RotationOffset = 53;
+	std::vector<std::byte> Records(Count * Stride + 3);
+	std::byte* Data = Records.data() + 3;
+	for (size_t i = 0; i < Count; ++i)
+	{
+		memcpy(Data + i * Stride + ScaleOffset, &Bones[i].Scale3D, sizeof(FVector));
+		memcpy(Data + i * Stride + TranslationOffset, &Bones[i].Translation, sizeof(FVector));
+		memcpy(Data + i * Stride + RotationOffset, &Bones[i].Rotation, sizeof(FQuat));
+	}
+	const FTransformArrayView Shuffled(Data, Count, Stride, RotationOffset, TranslationOffset, ScaleOffset);
+	const FTransformArrayView InPlace((const std::byte*)Bones.data(), Count);
+	CHECK(InPlace.HasTransformLayout() && !Shuffled.HasTransformLayout());
+	for (size_t i = 0; i < Count; i += 17)
+	{
+		const FTransform Bone = Shuffled[i];
+		CHECK(Bone.Rotation.X == Bones[i].Rotation.X && Bone.Rotation.W == Bones[i].Rotation.W);
+		CHECK(Bone.Translation == Bones[i].Translation && Bone.Scale3D == Bones[i].Scale3D);
+	}
+
+	std::vector<double> X(Count), Y(Count), Z(Count);
+	ForEachSimdLevel([&](ESimdLevel)
+	{
+		for (const FTransformArrayView& View : { Shuffled, InPlace })
+		{
+			BatchGetBoneWithRotation(ComponentToWorld, View, FVectorSoA(X.data(), Y.data(), Z.data()));
+			size_t NumMismatches = 0;
+			for (size_t i = 0; i < Count; ++i)
+			{
+				const FVector Expected = ComponentToWorld.GetBoneWithRotation(Bones[i]);
+				NumMismatches += Expected.X != X[i] || Expected.Y != Y[i] || Expected.Z != Z[i];
+			}
+			CHECK(NumMismatches == 0);
+		}
+	});
+}
+
+TEST_CASE(Batch, Convert)
+{
+	FTestRandom Random(47);
+	const size_t Count = 301;
+	std::vector<double> Doubles(Count), Back(Count);
+	std::vector<float> Floats(Count);
+	for (double& Value : Doubles)
+		Value = Random.Range(-1e6, 1e6);
+
+	ForEachSimdLevel([&](ESimdLevel)
+	{
+		BatchConvert(Doubles.data(), Floats.data(), Count);
+		BatchConvert(Floats.data(), Back.data(), Count);
+		size_t NumMismatches = 0;
+		for (size_t i = 0; i < Count; ++i)
+			NumMismatches += Floats[i] != (float)Doubles[i] || Back[i] != (double)Floats[i];
+		CHECK(NumMismatches == 0);
+	});
+
+	std::vector<FTransform> Transforms(5);
+	std::vector<FTransform3f> Transforms3f(5);
+	for (FTransform& T : Transforms)
+		T = RandomTransform(Random);
+	BatchConvert(Transforms.data(), Transforms3f.data(), Transforms.size());
+	for (size_t i = 0; i < Transforms.size(); ++i)
+	{
+		CHECK(Transforms3f[i].Rotation.W == (float)Transforms[i].Rotation.W);
+		CHECK(Transforms3f[i].Translation.Y == (float)Transforms[i].Translation.Y);
+		CHECK(Transforms3f[i].Scale3D.Z == (float)Transforms[i].Scale3D.Z);
+	}
+}
+
+TEST_CASE(Batch, RotationConversions)
+{
+	FTestRandom Random(53);
+	const size_t Count = 300;
+	std::vector<FRotator> Rotators(Count);
+	std::vector<FQuat> Quats(Count);
+	std::vector<FVector> Vectors(Count);
+	for (size_t i = 0; i < Count; ++i)
+	{
+		Rotators[i] = FRotator(Random.Range(-720, 720), Random.Range(-720, 720), Random.Range(-720, 720));
+		Quats[i] = Random.Quat();
+		Vectors[i] = Random.Vector(10);
+	}
+	// Gimbal lock on both sides
+	Quats[0] = FRotator(90, 30, 10).GetQuaternion();
+	Quats[1] = FRotator(-90, -60, 20).GetQuaternion();
+
+	std::vector<FQuat> OutQuats(Count);
+	std::vector<FRotator> OutRotators(Count);
+	std::vector<FMatrix> OutMatrices(Count);
+
+	for (ETrigAccuracy Accuracy : { ETrigAccuracy::Precise, ETrigAccuracy::Fast })
+	{
+		const double Tolerance = Accuracy == ETrigAccuracy::Precise ? 1e-13 : 1e-7;
+		ForEachSimdLevel([&](ESimdLevel)
+		{
+			BatchRotatorsToQuats(Rotators.data(), OutQuats.data(), Count, Accuracy);
+			BatchRotatorsToMatrices(Rotators.data(), OutMatrices.data(), Count, Accuracy);
+			for (size_t i = 0; i < Count; ++i)
+			{
+				const FQuat Expected = Rotators[i].GetQuaternion();
+				CHECK_NEAR(OutQuats[i].X, Expected.X, Tolerance);
+				CHECK_NEAR(OutQuats[i].W, Expected.W, Tolerance);
+
+				const FMatrix ExpectedMatrix = Rotators[i].GetMatrix();
+				for (int Row = 0; Row < 4; ++Row)
+					for (int Column = 0; Column < 4; ++Column)
+						CHECK_NEAR(OutMatrices[i].M[Row][Column], ExpectedMatrix.M[Row][Column], Tolerance);
+			}
+
+			// Angles in degrees: a few hundred ULP of the radian result, more for the fast tier
+			const double DegreeTolerance = Accuracy == ETrigAccuracy::Precise ? 1e-10 : 1e-5;
+			BatchQuatsToRotators(Quats.data(), OutRotators.data(), Count, Accuracy);
+			for (size_t i = 0; i < Count; ++i)
+			{
+				const FRotator Expected(Quats[i]);
+				CHECK_NEAR(OutRotators[i].Pitch, Expected.Pitch, DegreeTolerance);
+				CHECK_NEAR(OutRotators[i].Yaw, Expected.Yaw, DegreeTolerance);
+				CHECK_NEAR(OutRotators[i].Roll, Expected.Roll, DegreeTolerance);
+			}
+
+			BatchVectorsToDirectionRotators(Vectors.data(), OutRotators.data(), Count, Accuracy);
+			for (size_t i = 0; i < Count; ++i)
+			{
+				const FRotator Expected = Vectors[i].GetDirectionRotator();
+				CHECK_NEAR(OutRotators[i].Pitch, Expected.Pitch, DegreeTolerance);
+				CHECK_NEAR(OutRotators[i].Yaw, Expected.Yaw, DegreeTolerance);
+				CHECK(OutRotators[i].Roll == 0);
+			}
+		});
+	}
+}
+
+TEST_CASE(Batch, RotatorsToQuatsNonFiniteAndHuge)
+{
+	// GetQuaternion's fmod turns NaN and Inf into NaN and reduces 1e300 exactly
+	std::vector<FRotator> Rotators;
+	for (int i = 0; i < 19; ++i)
+		Rotators.push_back(FRotator(i % 3 == 0 ? NAN : 1e300, i % 3 == 1 ? INFINITY : -1e300, i % 3 == 2 ? -INFINITY : 7.0e299 + i));
+	std::vector<FQuat> Out(Rotators.size());
+	ForEachSimdLevel([&](ESimdLevel)
+	{
+		BatchRotatorsToQuats(Rotators.data(), Out.data(), Rotators.size());
+		size_t NumMismatches = 0;
+		for (size_t i = 0; i < Rotators.size(); ++i)
+		{
+			const FQuat Expected = Rotators[i].GetQuaternion();
+			CHECK(std::isnan(Expected.W));
+			NumMismatches += !std::isnan(Out[i].X) || !std::isnan(Out[i].W);
+		}
+		CHECK(NumMismatches == 0);
+
+		const FRotator Huge(1e300, -1e300, 3.3e299);
+		BatchRotatorsToQuats(&Huge, Out.data(), 1);
+		const FQuat Expected = Huge.GetQuaternion();
+		CHECK_NEAR(Out[0].X, Expected.X, 1e-13);
+		CHECK_NEAR(Out[0].Y, Expected.Y, 1e-13);
+		CHECK_NEAR(Out[0].Z, Expected.Z, 1e-13);
+		CHECK_NEAR(Out[0].W, Expected.W, 1e-13);
+	});
+}
+
+TEST_CASE(Batch, InvSqrtEstimateError)
+{
+	// Every 7th float of [1, 4), which covers both exponent parities the bit level guess depends on;
+	// the portable estimate must meet the same bound as rsqrtss even where it is not the one in use
+	const double Bound = 1.5 / 4096.0;
+	double MaxError = 0.0, MaxPortableError = 0.0;
+	for (float F = 1.0f; F < 4.0f; )
+	{
+		const double Exact = 1.0 / sqrt((double)F);
+		MaxError = std::max(MaxError, fabs(InvSqrtEstimate(F) - Exact) / Exact);
+		MaxPortableError = std::max(MaxPortableError, fabs(InvSqrtEstimatePortable(F) - Exact) / Exact);
+		uint32_t Bits;
+		memcpy(&Bits, &F, sizeof(Bits));
+		Bits += 7;
+		memcpy(&F, &Bits, sizeof(F));
+	}
+	CHECK(MaxError < Bound);
+	CHECK(MaxPortableError < 5e-6);
+
+	// Scaling by 4 scales the result by exactly 1/2, so the sweep holds over the whole normal range
+	for (float F : { 1e-37f, 3e-20f, 0.5f, 7.0f, 1e20f, 3e38f })
+	{
+		const double Exact = 1.0 / sqrt((double)F);
+		CHECK(fabs(InvSqrtEstimate(F) - Exact) / Exact < Bound);
+		CHECK(fabs(InvSqrtEstimatePortable(F) - Exact) / Exact < 5e-6);
+	}
+}
+
+TEST_CASE(Batch, InvSqrtFastError)
+{
+	FTestRandom Random(160);
+	double MaxError = 0.0, MaxFloatError = 0.0;
+	for (int i = 0; i < 100000; ++i)
+	{
+		// Log-uniform over most of float's normal range
+		const double F = pow(10.0, Random.Range(-37, 37));
+		const double Exact = 1.0 / sqrt(F);
+		MaxError = std::max(MaxError, fabs(InvSqrtFast(F) - Exact) / Exact);
+		const float FloatF = (float)F;
+		MaxFloatError = std::max(MaxFloatError, fabs(InvSqrtFast(FloatF) - 1.0 / sqrt((double)FloatF)) * sqrt((double)FloatF));
+	}
+	CHECK(MaxError < 1e-13);
+	CHECK(MaxFloatError < 4e-7);
+	CHECK(InvSqrt<EMathPrecision::Precise>(2.0) == InvSqrt(2.0));
+	CHECK(InvSqrt<EMathPrecision::Fast>(2.0) == InvSqrtFast(2.0));
+
+	FVector V(3, -4, 12);
+	V.Normalize<EMathPrecision::Fast>();
+	CHECK_NEAR(V.X, 3.0 / 13.0, 1e-14);
+	CHECK_NEAR(V.Length(), 1.0, 1e-13);
+
+	FMatrix M = FRotator(10, 20, 30).GetMatrix();
+	M.M[0][0] *= 3.0; M.M[0][1] *= 3.0; M.M[0][2] *= 3.0;
+	M.RemoveScaling<EMathPrecision::Fast>();
+	CHECK_NEAR(M.GetScaledAxisX().Length(), 1.0, 1e-13);
+}
+
+TEST_CASE(Batch, NormalizeMatchesScalar)
+{
+	// Every batch form agrees bit for bit with its scalar counterpart, in both precisions
+	FTestRandom Random(161);
+	const size_t Count = 300 + 5;
+	std::vector<double> Values(Count), X(Count), Y(Count), Z(Count), OutValues(Count), OutX(Count), OutY(Count), OutZ(Count);
+	std::vector<FQuat> Quats(Count), OutQuats(Count);
+	for (size_t i = 0; i < Count; ++i)
+	{
+		Values[i] = pow(10.0, Random.Range(-30, 30));
+		X[i] = Random.Range(-100, 100);
+		Y[i] = Random.Range(-100, 100);
+		Z[i] = Random.Range(-100, 100);
+		Quats[i] = FQuat(Random.Range(-2, 2), Random.Range(-2, 2), Random.Range(-2, 2), Random.Range(-2, 2));
+	}
+	Quats[7] = FQuat(1e-5, 0, 0, 0);
+
+	for (EMathPrecision Precision : { EMathPrecision::Precise, EMathPrecision::Fast })
+	{
+		const bool bFast = Precision == EMathPrecision::Fast;
+		ForEachSimdLevel([&](ESimdLevel)
+		{
+			BatchInvSqrt(Values.data(), OutValues.data(), Count, Precision);
+			BatchNormalizeVectors(FVectorSoA(X.data(), Y.data(), Z.data()), FVectorSoA(OutX.data(), OutY.data(), OutZ.data()), Count, Precision);
+			BatchNormalizeQuats(Quats.data(), OutQuats.data(), Count, Precision);
+
+			size_t NumMismatches = 0;
+			for (size_t i = 0; i < Count; ++i)
+			{
+				NumMismatches += OutValues[i] != (bFast ? InvSqrtFast(Values[i]) : InvSqrt(Values[i]));
+
+				const FVector V(X[i], Y[i], Z[i]);
+				const FVector N = bFast ? V.GetNormalizedVector<EMathPrecision::Fast>() : V.GetNormalizedVector();
+				NumMismatches += OutX[i] != N.X || OutY[i] != N.Y || OutZ[i] != N.Z;
+
+				const FQuat Q = bFast ? Quats[i].GetNormalized<EMathPrecision::Fast>() : Quats[i].GetNormalized();
+				NumMismatches += OutQuats[i].X != Q.X || OutQuats[i].Y != Q.Y || OutQuats[i].Z != Q.Z || OutQuats[i].W != Q.W;
+			}
+			CHECK(NumMismatches == 0);
+			CHECK(OutQuats[7].W == 1.0);
+		});
+	}
+}
+
+TEST_CASE(Batch, GetRelativeTransformsMatchesScalar)
+{
+	FTestRandom Random(162);
+	const size_t Count = 1000 + 7;
+	std::vector<FTransform> Transforms(Count), Out(Count);
+	for (size_t i = 0; i < Count; ++i)
+	{
+		Transforms[i] = RandomTransform(Random);
+		// Scattered negative scales for the per lane matrix path, and a zero scale
+		if (i % 7 == 3)
+			Transforms[i].Scale3D.Y = -Transforms[i].Scale3D.Y;
+	}
+	Transforms[10].Scale3D.Z = 0.0;
+
+	FTransform Bases[4] = { RandomTransform(Random), RandomTransform(Random), RandomTransform(Random), RandomTransform(Random) };
+	Bases[1].Scale3D.X = 1e-10;
+	Bases[2].Scale3D.Z = -Bases[2].Scale3D.Z;
+	Bases[3].Rotation = Bases[3].Rotation * 1.1;
+
+	const auto BitwiseEqual = [](const FTransform& A, const FTransform& B)
+	{
+		return memcmp(&A.Rotation, &B.Rotation, sizeof(FQuat)) == 0 && memcmp(&A.Translation, &B.Translation, sizeof(FVector)) == 0
+			&& memcmp(&A.Scale3D, &B.Scale3D, sizeof(FVector)) == 0;
+	};
+
+	FTaskScheduler Scheduler(4);
+	for (const FTransform& Base : Bases)
+	{
+		ForEachSimdLevel([&](ESimdLevel)
+		{
+			size_t NumMismatches = 0;
+			BatchGetRelativeTransforms(Transforms.data(), Base, Out.data(), Count);
+			for (size_t i = 0; i < Count; ++i)
+				NumMismatches += !BitwiseEqual(Out[i], Transforms[i].GetRelativeTransform(Base));
+
+			// Threaded and in place
+			std::vector<FTransform> InPlace = Transforms;
+			BatchGetRelativeTransforms(InPlace.data(), Base, InPlace.data(), Count, &Scheduler);
+			for (size_t i = 0; i < Count; ++i)
+				NumMismatches += !BitwiseEqual(InPlace[i], Out[i]);
+			CHECK(NumMismatches == 0);
+		});
+	}
+}
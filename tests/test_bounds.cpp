@@ -0,0 +1,85 @@
+#include "test.h"
+#include "bounds.h"
+#include "rotator.h"
+#include "matrix.h"
+#include <vector>
+
+static_assert(FBox(FVector(0, 0, 0), FVector(2, 4, 6)).GetCenter() == FVector(1, 2, 3), "constexpr GetCenter");
+
+TEST_CASE(Bounds, BoxFromPoints)
+{
+	FTestRandom Random(111);
+	std::vector<FVector> Points(100);
+	std::vector<FTransform> Bones(Points.size());
+	FVector Min(1e9, 1e9, 1e9), Max(-1e9, -1e9, -1e9);
+	for (size_t i = 0; i < Points.size(); ++i)
+	{
+		Points[i] = Random.Vector(50);
+		Bones[i].Translation = Points[i];
+		Min = Min.Min(Points[i]);
+		Max = Max.Max(Points[i]);
+	}
+
+	const FBox Box(Points.data(), Points.size());
+	CHECK(Box.IsValid);
+	CHECK(Box.Min == Min);
+	CHECK(Box.Max == Max);
+
+	const FBox BoneBox(Bones.data(), Bones.size());
+	CHECK(BoneBox.IsValid);
+	CHECK(BoneBox.Min == Min);
+	CHECK(BoneBox.Max == Max);
+	CHECK(!FBox(Bones.data(), 0).IsValid);
+
+	// Adding to an empty box takes the other side as is
+	FBox Sum;
+	Sum += FBox();
+	CHECK(!Sum.IsValid);
+	Sum += Box;
+	CHECK(Sum.Min == Box.Min && Sum.Max == Box.Max);
+	Sum += FVector(1000, 0, 0);
+	CHECK(Sum.Max.X == 1000);
+	CHECK(Sum.IsInside(Box.GetCenter()));
+	CHECK(Sum.Intersect(FBox(FVector(999, 0, 0), FVector(1001, 1, 1))));
+	CHECK(!Sum.Intersect(FBox(FVector(1001, 0, 0), FVector(1002, 1, 1))));
+}
+
+// P as the row vector (P, 1) times M
+static FVector TransformPosition(const FMatrix& M, const FVector& P)
+{
+	return M.GetOrigin() + M.GetScaledAxisX() * P.X + M.GetScaledAxisY() * P.Y + M.GetScaledAxisZ() * P.Z;
+}
+
+TEST_CASE(Bounds, BoxTransformBy)
+{
+	FTestRandom Random(112);
+	for (int i = 0; i < 100; ++i)
+	{
+		const FBox Box(FVector(-1, -2, -3) + Random.Vector(1), FVector(1, 2, 3) + Random.Vector(1));
+		const FTransform Transform(Random.Quat(), Random.Vector(100), Random.Vector(0.5, 2));
+		const FMatrix M = Transform.ToMatrixWithScale();
+		const FBox Result = Box.TransformBy(M);
+
+		// Holds every corner and is touched by one on each side
+		FBox Corners;
+		for (int Corner = 0; Corner < 8; ++Corner)
+		{
+			const FVector P((Corner & 1) ? Box.Max.X : Box.Min.X, (Corner & 2) ? Box.Max.Y : Box.Min.Y, (Corner & 4) ? Box.Max.Z : Box.Min.Z);
+			Corners += TransformPosition(M, P);
+		}
+		CHECK_VECTOR_NEAR(Result.Min, Corners.Min, 1e-12);
+		CHECK_VECTOR_NEAR(Result.Max, Corners.Max, 1e-12);
+	}
+}
+
+TEST_CASE(Bounds, Sphere)
+{
+	const FBox Box(FVector(-1, -2, -2), FVector(1, 2, 2));
+	const FSphere Sphere(Box);
+	CHECK(Sphere.Center == FVector(0, 0, 0));
+	CHECK_NEAR(Sphere.W, 3.0, 1e-15);
+	CHECK(Sphere.IsInside(Box.Max));
+	CHECK(!Sphere.IsInside(FVector(3.1, 0, 0)));
+	CHECK(Sphere.Intersects(FSphere(FVector(5, 0, 0), 2.0)));
+	CHECK(!Sphere.Intersects(FSphere(FVector(5.1, 0, 0), 2.0)));
+}
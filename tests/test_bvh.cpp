@@ -0,0 +1,147 @@
+#include "test.h"
+#include "bvh.h"
+#include <algorithm>
+#include <vector>
+
+static double BoxDistanceSquared(const FVector& P, const FBox& Box)
+{
+	const FVector Closest(std::clamp(P.X, Box.Min.X, Box.Max.X), std::clamp(P.Y, Box.Min.Y, Box.Max.Y), std::clamp(P.Z, Box.Min.Z, Box.Max.Z));
+	return (P - Closest) | (P - Closest);
+}
+
+/** Checks the BVH queries against brute force loops over Boxes. */
+static void CheckQueries(const FBVH& Tree, const std::vector<FBox>& Boxes, FTestRandom& Random)
+{
+	const size_t K = 7;
+	int32_t Indices[K];
+	double Distances[K];
+	std::vector<int32_t> Found;
+	for (int Query = 0; Query < 50; ++Query)
+	{
+		const FVector P = Random.Vector(120);
+
+		std::vector<double> Expected(Boxes.size());
+		for (size_t i = 0; i < Boxes.size(); ++i)
+			Expected[i] = BoxDistanceSquared(P, Boxes[i]);
+		std::vector<double> Sorted = Expected;
+		std::sort(Sorted.begin(), Sorted.end());
+
+		const size_t NumFound = Tree.FindNearest(P, K, Indices, Distances);
+		CHECK(NumFound == std::min(K, Boxes.size()));
+		for (size_t i = 0; i < NumFound; ++i)
+		{
+			CHECK(Distances[i] == Sorted[i]);
+			CHECK(Distances[i] == Expected[Indices[i]]);
+		}
+		if (!Boxes.empty())
+			CHECK(Expected[Tree.FindNearest(P)] == Sorted[0]);
+
+		const double Radius = Random.Range(0, 60);
+		Found.clear();
+		Tree.FindInRadius(P, Radius, Found);
+		std::sort(Found.begin(), Found.end());
+		std::vector<int32_t> ExpectedFound;
+		for (size_t i = 0; i < Boxes.size(); ++i)
+			if (Expected[i] <= Radius * Radius)
+				ExpectedFound.push_back((int32_t)i);
+		CHECK(Found == ExpectedFound);
+
+		// Against the slab test of each box on its own
+		const FVector Direction = Random.Vector(1).GetNormalizedVector();
+		int32_t ExpectedHit = -1;
+		double ExpectedT = 150.0;
+		for (size_t i = 0; i < Boxes.size(); ++i)
+		{
+			double T0 = 0.0, T1 = ExpectedT;
+			for (int Axis = 0; Axis < 3; ++Axis)
+			{
+				const double O = (&P.X)[Axis], D = (&Direction.X)[Axis];
+				double Near = ((&Boxes[i].Min.X)[Axis] - O) / D, Far = ((&Boxes[i].Max.X)[Axis] - O) / D;
+				if (Near > Far)
+					std::swap(Near, Far);
+				T0 = std::max(T0, Near);
+				T1 = std::min(T1, Far);
+			}
+			if (T0 <= T1 && (ExpectedHit < 0 || T0 < ExpectedT))
+			{
+				ExpectedHit = (int32_t)i;
+				ExpectedT = T0;
+			}
+		}
+		int32_t Hit = -1;
+		double HitT = 0;
+		CHECK(Tree.Raycast(P, Direction, 150.0, Hit, HitT) == (ExpectedHit >= 0));
+		if (ExpectedHit >= 0)
+		{
+			CHECK_NEAR(HitT, ExpectedT, 1e-12);
+			CHECK(Hit == ExpectedHit || BoxDistanceSquared(P + Direction * HitT, Boxes[Hit]) < 1e-18);
+		}
+	}
+}
+
+TEST_CASE(BVH, BoxesMatchBruteForce)
+{
+	FTestRandom Random(131);
+	for (size_t Count : { (size_t)0, (size_t)1, (size_t)3, (size_t)100, (size_t)2000 })
+	{
+		std::vector<FBox> Boxes(Count);
+		for (FBox& Box : Boxes)
+		{
+			const FVector Center = Random.Vector(100);
+			const FVector Extent = Random.Vector(0, 5);
+			Box = FBox(Center - Extent, Center + Extent);
+		}
+
+		FBVH Tree;
+		Tree.Build(Boxes.data(), Count);
+		CHECK(Tree.Num() == Count);
+		CheckQueries(Tree, Boxes, Random);
+
+		// Moved, refitted and still exact
+		for (FBox& Box : Boxes)
+		{
+			const FVector Offset = Random.Vector(10);
+			Box = FBox(Box.Min + Offset, Box.Max + Offset);
+		}
+		Tree.Refit(Boxes.data());
+		CheckQueries(Tree, Boxes, Random);
+		if (Count > 0)
+		{
+			FBox Expected;
+			for (const FBox& Box : Boxes)
+				Expected += Box;
+			CHECK(Tree.GetBounds().Min == Expected.Min && Tree.GetBounds().Max == Expected.Max);
+		}
+	}
+}
+
+TEST_CASE(BVH, Points)
+{
+	FTestRandom Random(132);
+	std::vector<FVector> Points(1000);
+	for (FVector& Point : Points)
+		Point = Random.Vector(100);
+	// Duplicates must not unbalance the tree
+	for (size_t i = 500; i < 700; ++i)
+		Points[i] = FVector(1, 2, 3);
+
+	FBVH Tree;
+	Tree.Build(Points.data(), Points.size());
+	for (int Query = 0; Query < 100; ++Query)
+	{
+		const FVector P = Random.Vector(120);
+		double Best = INFINITY;
+		for (const FVector& Point : Points)
+			Best = std::min(Best, P.Distance(Point));
+		CHECK(P.Distance(Points[Tree.FindNearest(P)]) == Best);
+	}
+
+	std::vector<int32_t> Found;
+	Tree.FindInRadius(FVector(1, 2, 3), 0.0, Found);
+	CHECK(Found.size() >= 200);
+
+	std::vector<FBox> Boxes(Points.size());
+	for (size_t i = 0; i < Points.size(); ++i)
+		Boxes[i] = FBox(Points[i], Points[i]);
+	CheckQueries(Tree, Boxes, Random);
+}
@@ -0,0 +1,81 @@
+#include "test.h"
+#include "cachedtransform.h"
+#include "rotator.h"
+#include <string.h>
+
+static FTransform RandomTransform(FTestRandom& Random, double MinScale)
+{
+	return FTransform(Random.Quat(),
+		Random.Vector(100),
+		FVector(Random.Range(MinScale, 2), Random.Range(MinScale, 2), Random.Range(MinScale, 2)));
+}
+
+static bool BitwiseEqual(const FMatrix& A, const FMatrix& B)
+{
+	return memcmp(A.M, B.M, sizeof(A.M)) == 0;
+}
+
+static bool BitwiseEqual(const FTransform& A, const FTransform& B)
+{
+	return memcmp(&A.Rotation, &B.Rotation, sizeof(FQuat)) == 0 && memcmp(&A.Translation, &B.Translation, sizeof(FVector)) == 0
+		&& memcmp(&A.Scale3D, &B.Scale3D, sizeof(FVector)) == 0;
+}
+
+TEST_CASE(CachedTransform, MatchesPlainFunctions)
+{
+	FTestRandom Random(220);
+	for (int i = 0; i < 100; ++i)
+	{
+		// Negative scales in half of them, for the matrix paths
+		const FTransform Transform = RandomTransform(Random, i % 2 ? -2.0 : 0.5);
+		const FCachedTransform Cached(Transform);
+		CHECK(BitwiseEqual(Cached.GetMatrixWithScale(), Transform.ToMatrixWithScale()));
+		CHECK(BitwiseEqual(Cached.GetInverseMatrixWithScale(), Transform.ToInverseMatrixWithScale()));
+		CHECK(BitwiseEqual(Cached.GetInverse(), FTransform().GetRelativeTransform(Transform)));
+
+		const FTransform Other = RandomTransform(Random, i % 3 ? 0.5 : -2.0);
+		CHECK(BitwiseEqual(Cached.GetRelativeTransform(FCachedTransform(Other)), Transform.GetRelativeTransform(Other)));
+		CHECK(BitwiseEqual(FCachedTransform(Other).GetRelativeTransform(Cached), Other.GetRelativeTransform(Transform)));
+
+		// The inverse matrix inverts
+		const FMatrix Identity = Cached.GetMatrixWithScale() * Cached.GetInverseMatrixWithScale();
+		for (int Row = 0; Row < 4; ++Row)
+			for (int Column = 0; Column < 4; ++Column)
+				CHECK_NEAR(Identity.M[Row][Column], Row == Column ? 1.0 : 0.0, 1e-12);
+	}
+
+	const FCachedTransform Uniform(FTransform(FRotator(10, 20, 30).GetQuaternion(), FVector(1, 2, 3), FVector(2, 2, 2)));
+	FTransform RoundTrip;
+	FTransform::Multiply(&RoundTrip, &Uniform.GetTransform(), &Uniform.GetInverse());
+	CHECK_VECTOR_NEAR(RoundTrip.Translation, FVector(0, 0, 0), 1e-12);
+	CHECK_VECTOR_NEAR(RoundTrip.Scale3D, FVector(1, 1, 1), 1e-15);
+}
+
+TEST_CASE(CachedTransform, MutationInvalidates)
+{
+	FTestRandom Random(221);
+	FCachedTransform Cached(RandomTransform(Random, 0.5));
+	const uint64_t Version = Cached.GetVersion();
+	const FMatrix* Matrix = &Cached.GetMatrixWithScale();
+	const FMatrix First = *Matrix;
+	CHECK(&Cached.GetMatrixWithScale() == Matrix);
+
+	Cached.SetTranslation(FVector(5, 6, 7));
+	CHECK(Cached.GetVersion() == Version + 1);
+	CHECK(BitwiseEqual(Cached.GetMatrixWithScale(), Cached.GetTransform().ToMatrixWithScale()));
+	CHECK(!BitwiseEqual(Cached.GetMatrixWithScale(), First));
+
+	Cached.SetScale3D(FVector(1, -1, 1));
+	Cached.SetRotation(FRotator(0, 45, 0).GetQuaternion());
+	CHECK(Cached.GetVersion() == Version + 3);
+	CHECK(BitwiseEqual(Cached.GetInverseMatrixWithScale(), Cached.GetTransform().ToInverseMatrixWithScale()));
+	CHECK(BitwiseEqual(Cached.GetInverse(), FTransform().GetRelativeTransform(Cached.GetTransform())));
+
+	// Cached values computed before a change are not reused after it
+	Cached.Update();
+	const FTransform Next = RandomTransform(Random, 0.5);
+	Cached.SetTransform(Next);
+	CHECK(BitwiseEqual(Cached.GetMatrixWithScale(), Next.ToMatrixWithScale()));
+	CHECK(BitwiseEqual(Cached.GetInverseMatrixWithScale(), Next.ToInverseMatrixWithScale()));
+	CHECK(BitwiseEqual(Cached.GetInverse(), FTransform().GetRelativeTransform(Next)));
+}
@@ -0,0 +1,100 @@
+#include "test.h"
+#include "camera.h"
+#include <vector>
+
+TEST_CASE(Camera, CenterAndEdges)
+{
+	// Looking down +X from the origin with a 90 degree FOV: the view edge is at 45 degrees
+	const FCamera Camera(FVector(0, 0, 0), FRotator(0, 0, 0), 90.0, 1920.0, 1080.0);
+	FVector2D Screen;
+	CHECK(Camera.WorldToScreen(FVector(100, 0, 0), Screen));
+	CHECK_NEAR(Screen.X, 960, 1e-9);
+	CHECK_NEAR(Screen.Y, 540, 1e-9);
+
+	CHECK(Camera.WorldToScreen(FVector(100, 100, 0), Screen));
+	CHECK_NEAR(Screen.X, 1920, 1e-9);
+
+	CHECK(Camera.WorldToScreen(FVector(100, 0, 50), Screen));
+	CHECK_NEAR(Screen.Y, 540 - 960 * 0.5, 1e-9);
+
+	CHECK(!Camera.WorldToScreen(FVector(-100, 0, 0), Screen));
+}
+
+TEST_CASE(Camera, BatchMatchesSingle)
+{
+	FTestRandom Random(79);
+	const FCamera Camera(FVector(10, -20, 30), FRotator(-15, 40, 5), 75.0, 1280.0, 720.0);
+	const size_t Count = 500 + 3;
+	std::vector<FVector> Points(Count);
+	for (FVector& Point : Points)
+		Point = Random.Vector(500);
+
+	std::vector<FVector2D> Screen(Count);
+	std::vector<uint64_t> Mask((Count + 63) / 64);
+	ForEachSimdLevel([&](ESimdLevel)
+	{
+		size_t NumExpectedVisible = 0;
+		const size_t NumVisible = Camera.WorldToScreen(Points.data(), Screen.data(), Mask.data(), Count);
+		for (size_t i = 0; i < Count; ++i)
+		{
+			FVector2D Expected;
+			const bool bVisible = Camera.WorldToScreen(Points[i], Expected);
+			NumExpectedVisible += bVisible;
+			CHECK(bVisible == (((Mask[i >> 6] >> (i & 63)) & 1) != 0));
+			CHECK_NEAR(Screen[i].X, Expected.X, 1e-9 * (1 + fabs(Expected.X)));
+			CHECK_NEAR(Screen[i].Y, Expected.Y, 1e-9 * (1 + fabs(Expected.Y)));
+		}
+		CHECK(NumVisible == NumExpectedVisible);
+	});
+}
+
+TEST_CASE(Camera, BatchLeavesUpperStateClean)
+{
+	// As Batch.GetBoneWithRotationLeavesUpperStateClean, for the WorldToScreen kernels
+	FTestRandom Random(81);
+	const FCamera Camera(FVector(10, -20, 30), FRotator(-15, 40, 5), 75.0, 1280.0, 720.0);
+	std::vector<FVector> Points(16 + 3);
+	for (FVector& Point : Points)
+		Point = Random.Vector(500);
+	std::vector<FVector2D> Screen(Points.size());
+	uint64_t Mask = 0;
+	ForEachSimdLevel([&](ESimdLevel Level)
+	{
+		if (Level == ESimdLevel::Scalar)
+			return;
+		for (size_t Count : { (size_t)8, Points.size() })
+		{
+			Camera.WorldToScreen(Points.data(), Screen.data(), &Mask, Count);
+			CHECK(!IsUpperSimdStateDirty());
+		}
+	});
+}
+
+TEST_CASE(Camera, BatchFromStridedView)
+{
+	// The translations of a bone array, projected in place, match the packed points exactly
+	FTestRandom Random(80);
+	const FCamera Camera(FVector(10, -20, 30), FRotator(-15, 40, 5), 75.0, 1280.0, 720.0);
+	const size_t Count = 200 + 7;
+	std::vector<FTransform> Bones(Count);
+	std::vector<FVector> Points(Count);
+	for (size_t i = 0; i < Count; ++i)
+	{
+		Points[i] = Random.Vector(500);
+		Bones[i].Translation = Points[i];
+	}
+
+	std::vector<FVector2D> Packed(Count), Strided(Count);
+	std::vector<uint64_t> PackedMask((Count + 63) / 64), StridedMask((Count + 63) / 64);
+	ForEachSimdLevel([&](ESimdLevel)
+	{
+		const FVectorArrayView View = FTransformArrayView(Bones.data(), Count).GetTranslations();
+		CHECK(!View.IsPacked());
+		CHECK(Camera.WorldToScreen(View, Strided.data(), StridedMask.data()) == Camera.WorldToScreen(Points.data(), Packed.data(), PackedMask.data(), Count));
+		CHECK(PackedMask == StridedMask);
+		size_t NumMismatches = 0;
+		for (size_t i = 0; i < Count; ++i)
+			NumMismatches += Packed[i].X != Strided[i].X || Packed[i].Y != Strided[i].Y;
+		CHECK(NumMismatches == 0);
+	});
+}
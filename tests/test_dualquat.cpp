@@ -0,0 +1,127 @@
+#include "test.h"
+#include "dualquat.h"
+#include "rotator.h"
+#include <vector>
+
+static double MaxComponentError(const FQuat& A, const FQuat& B)
+{
+	return std::max(std::max(fabs(A.X - B.X), fabs(A.Y - B.Y)), std::max(fabs(A.Z - B.Z), fabs(A.W - B.W)));
+}
+
+TEST_CASE(DualQuat, TransformRoundTrip)
+{
+	FTestRandom Random(200);
+	const FDualQuat Identity;
+	CHECK(Identity.GetTranslation() == FVector(0, 0, 0));
+	CHECK(Identity.TransformPosition(FVector(1, 2, 3)) == FVector(1, 2, 3));
+
+	for (int i = 0; i < 100; ++i)
+	{
+		const FTransform Transform(Random.Quat(), Random.Vector(1000), FVector(1, 1, 1));
+		const FDualQuat DualQuat(Transform);
+		CHECK(MaxComponentError(DualQuat.GetRotation(), Transform.Rotation) == 0);
+		CHECK_VECTOR_NEAR(DualQuat.GetTranslation(), Transform.Translation, 1e-10);
+
+		const FTransform Back = DualQuat.ToTransform();
+		CHECK_VECTOR_NEAR(Back.Translation, Transform.Translation, 1e-10);
+		CHECK(Back.Scale3D == FVector(1, 1, 1));
+
+		const FVector Position = Random.Vector(100);
+		CHECK_VECTOR_NEAR(DualQuat.TransformPosition(Position), Transform.Rotation.RotateVector(Position) + Transform.Translation, 1e-10);
+		CHECK(DualQuat.TransformVector(Position) == Transform.Rotation.RotateVector(Position));
+	}
+}
+
+TEST_CASE(DualQuat, ComposeAndInverse)
+{
+	FTestRandom Random(201);
+	for (int i = 0; i < 100; ++i)
+	{
+		const FTransform A(Random.Quat(), Random.Vector(1000), FVector(1, 1, 1));
+		const FTransform B(Random.Quat(), Random.Vector(1000), FVector(1, 1, 1));
+		FTransform AB;
+		FTransform::Multiply(&AB, &A, &B);
+
+		// A then B, as FTransform::Multiply
+		const FDualQuat Composed = FDualQuat(A) * FDualQuat(B);
+		CHECK(MaxComponentError(Composed.Real, AB.Rotation) < 1e-14);
+		CHECK_VECTOR_NEAR(Composed.GetTranslation(), AB.Translation, 1e-9);
+
+		const FVector Position = Random.Vector(100);
+		CHECK_VECTOR_NEAR(Composed.TransformPosition(Position), FDualQuat(B).TransformPosition(FDualQuat(A).TransformPosition(Position)), 1e-9);
+
+		const FDualQuat Inverse = FDualQuat(A).Inverse();
+		CHECK_VECTOR_NEAR(Inverse.TransformPosition(FDualQuat(A).TransformPosition(Position)), Position, 1e-9);
+		const FDualQuat Identity = FDualQuat(A) * Inverse;
+		CHECK(MaxComponentError(Identity.Real, FQuat()) < 1e-14 || MaxComponentError(Identity.Real * -1.0, FQuat()) < 1e-14);
+		CHECK_VECTOR_NEAR(Identity.GetTranslation(), FVector(0, 0, 0), 1e-9);
+	}
+}
+
+TEST_CASE(DualQuat, Blend)
+{
+	FTestRandom Random(202);
+	for (int i = 0; i < 100; ++i)
+	{
+		const FDualQuat A(Random.Quat(), Random.Vector(100));
+		const FDualQuat B(Random.Quat(), Random.Vector(100));
+		const FDualQuat AtA = FDualQuat::Blend(A, B, 0.0);
+		const FDualQuat AtB = FDualQuat::Blend(A, B, 1.0);
+		CHECK(MaxComponentError(AtA.Real, A.Real) < 1e-15);
+		CHECK_VECTOR_NEAR(AtA.GetTranslation(), A.GetTranslation(), 1e-12);
+		CHECK_VECTOR_NEAR(AtB.GetTranslation(), B.GetTranslation(), 1e-12);
+
+		// Rigid: a unit rotation and a Dual orthogonal to it, so distances are kept
+		const FDualQuat Mid = FDualQuat::Blend(A, B, 0.3);
+		CHECK(Mid.Real.IsNormalized());
+		CHECK_NEAR(Mid.Real | Mid.Dual, 0.0, 1e-12);
+		const FVector P0 = Random.Vector(100), P1 = Random.Vector(100);
+		CHECK_NEAR((Mid.TransformPosition(P0) - Mid.TransformPosition(P1)).Length(), (P0 - P1).Length(), 1e-9);
+
+		// The opposite sign of B is the same transform and blends the same way
+		const FDualQuat NegB(B.Real * -1.0, B.Dual * -1.0);
+		const FDualQuat MidNeg = FDualQuat::Blend(A, NegB, 0.3);
+		CHECK(MaxComponentError(MidNeg.Real, Mid.Real) < 1e-14);
+		CHECK_VECTOR_NEAR(MidNeg.GetTranslation(), Mid.GetTranslation(), 1e-10);
+	}
+
+	// Pure translations blend linearly
+	const FDualQuat T0(FQuat(), FVector(0, 0, 0)), T1(FQuat(), FVector(10, -20, 30));
+	CHECK_VECTOR_NEAR(FDualQuat::Blend(T0, T1, 0.25).GetTranslation(), FVector(2.5, -5, 7.5), 1e-12);
+
+	// Weights summing to zero leave nothing to normalize
+	const FDualQuat Pair[2] = { T1, T1 };
+	const double Weights[2] = { 1.0, -1.0 };
+	CHECK(FDualQuat::Blend(Pair, Weights, 2).GetTranslation() == FVector(0, 0, 0));
+}
+
+TEST_CASE(DualQuat, BatchMatchesScalar)
+{
+	FTestRandom Random(203);
+	const size_t Count = 200 + 7;
+	const FDualQuat DualQuat(Random.Quat(), Random.Vector(1000));
+	std::vector<double> In(Count * 3), Out(Count * 3);
+	for (double& Value : In)
+		Value = Random.Range(-100, 100);
+	const FVectorSoA InSoA(In.data(), In.data() + Count, In.data() + 2 * Count);
+	const FVectorSoA OutSoA(Out.data(), Out.data() + Count, Out.data() + 2 * Count);
+
+	ForEachSimdLevel([&](ESimdLevel)
+	{
+		BatchTransformPositions(DualQuat, InSoA, OutSoA, Count);
+		size_t NumMismatches = 0;
+		for (size_t i = 0; i < Count; ++i)
+		{
+			const FVector Expected = DualQuat.TransformPosition(InSoA.Get(i));
+			const FVector Result = OutSoA.Get(i);
+			NumMismatches += Result.X != Expected.X || Result.Y != Expected.Y || Result.Z != Expected.Z;
+		}
+		CHECK(NumMismatches == 0);
+
+		// In place
+		std::vector<double> InPlace = In;
+		const FVectorSoA InPlaceSoA(InPlace.data(), InPlace.data() + Count, InPlace.data() + 2 * Count);
+		BatchTransformPositions(DualQuat, InPlaceSoA, InPlaceSoA, Count);
+		CHECK(InPlace == Out);
+	});
+}
@@ -0,0 +1,101 @@
+#include "test.h"
+#include "frustum.h"
+#include "camera.h"
+#include <vector>
+
+static const FCamera TestCamera(FVector(10, -20, 30), FRotator(-15, 40, 5), 75.0, 1280.0, 720.0);
+
+static bool ProjectsInside(const FCamera& Camera, const FVector& P)
+{
+	FVector2D Screen;
+	return Camera.WorldToScreen(P, Screen) && Screen.X >= 0 && Screen.X <= Camera.ViewportWidth && Screen.Y >= 0 && Screen.Y <= Camera.ViewportHeight;
+}
+
+TEST_CASE(Frustum, PlanesMatchProjection)
+{
+	const FFrustum Frustum = TestCamera.GetFrustum();
+	CHECK(Frustum.NumPlanes == 5);
+	CHECK(TestCamera.GetFrustum(1000.0).NumPlanes == 6);
+
+	FTestRandom Random(121);
+	for (int i = 0; i < 2000; ++i)
+	{
+		const FVector P = TestCamera.Location + Random.Vector(500);
+		CHECK(Frustum.IntersectsPoint(P) == ProjectsInside(TestCamera, P));
+	}
+
+	// The far plane cuts at that distance along the view direction
+	const FVector Forward = TestCamera.Rotation.GetMatrix().GetScaledAxisX();
+	CHECK(TestCamera.GetFrustum(100.0).IntersectsPoint(TestCamera.Location + Forward * 99.0));
+	CHECK(!TestCamera.GetFrustum(100.0).IntersectsPoint(TestCamera.Location + Forward * 101.0));
+	CHECK(!Frustum.IntersectsPoint(TestCamera.Location + Forward * 0.5));
+}
+
+TEST_CASE(Frustum, CullingIsConservative)
+{
+	// A box or sphere with any visible point inside is never culled
+	const FFrustum Frustum = TestCamera.GetFrustum();
+	FTestRandom Random(122);
+	for (int i = 0; i < 500; ++i)
+	{
+		const FVector Center = TestCamera.Location + Random.Vector(400);
+		const FVector Extent = Random.Vector(1, 40);
+		const FBox Box(Center - Extent, Center + Extent);
+		const FSphere Sphere(Center, Extent.X);
+		for (int Sample = 0; Sample < 20; ++Sample)
+		{
+			const FVector P = Center + Random.Vector(1) * Extent;
+			if (ProjectsInside(TestCamera, P))
+				CHECK(Frustum.IntersectsBox(Box));
+			const FVector Q = Center + Random.Vector(1).GetNormalizedVector() * (Extent.X * Random.Range(0, 1));
+			if (ProjectsInside(TestCamera, Q))
+				CHECK(Frustum.IntersectsSphere(Sphere));
+		}
+	}
+
+	// Far off to the side is culled
+	const FVector Right = TestCamera.Rotation.GetMatrix().GetScaledAxisY();
+	CHECK(!Frustum.IntersectsBox(FBox(TestCamera.Location + Right * 1000.0 - FVector(1, 1, 1), TestCamera.Location + Right * 1000.0 + FVector(1, 1, 1))));
+	CHECK(!Frustum.IntersectsSphere(FSphere(TestCamera.Location - Right * 1000.0, 10.0)));
+}
+
+TEST_CASE(Frustum, BatchMatchesSingle)
+{
+	const FFrustum Frustum = TestCamera.GetFrustum(800.0);
+	FTestRandom Random(123);
+	const size_t Count = 500 + 5;
+	std::vector<FBox> Boxes(Count);
+	std::vector<FSphere> Spheres(Count);
+	for (size_t i = 0; i < Count; ++i)
+	{
+		const FVector Center = TestCamera.Location + Random.Vector(1000);
+		const FVector Extent = Random.Vector(0, 50);
+		Boxes[i] = FBox(Center - Extent, Center + Extent);
+		Spheres[i] = FSphere(Center, Extent.Y);
+	}
+
+	std::vector<uint64_t> Mask((Count + 63) / 64);
+	ForEachSimdLevel([&](ESimdLevel)
+	{
+		size_t NumExpected = 0;
+		const size_t NumVisible = Frustum.CullBoxes(Boxes.data(), Mask.data(), Count);
+		for (size_t i = 0; i < Count; ++i)
+		{
+			const bool bVisible = Frustum.IntersectsBox(Boxes[i]);
+			NumExpected += bVisible;
+			CHECK(bVisible == (((Mask[i >> 6] >> (i & 63)) & 1) != 0));
+		}
+		CHECK(NumVisible == NumExpected);
+		CHECK(NumVisible > 0 && NumVisible < Count);
+
+		NumExpected = 0;
+		const size_t NumVisibleSpheres = Frustum.CullSpheres(Spheres.data(), Mask.data(), Count);
+		for (size_t i = 0; i < Count; ++i)
+		{
+			const bool bVisible = Frustum.IntersectsSphere(Spheres[i]);
+			NumExpected += bVisible;
+			CHECK(bVisible == (((Mask[i >> 6] >> (i & 63)) & 1) != 0));
+		}
+		CHECK(NumVisibleSpheres == NumExpected);
+	});
+}
@@ -0,0 +1,57 @@
+#include "test.h"
+#include "matrix.h"
+#include "transform.h"
+
+/*-----------------------------------------------------------------------------
+	Built against ue5math_header_only, without linking the library: every
+	math type call here has to be defined in the headers.
+-----------------------------------------------------------------------------*/
+
+TEST_CASE(HeaderOnly, MatrixMultiply)
+{
+	FTestRandom Random(501);
+	for (int n = 0; n < 20; ++n)
+	{
+		const FMatrix A = FTransform(Random.Quat(), Random.Vector(100), Random.Vector(0.5, 2)).ToMatrixWithScale();
+		const FMatrix B = FTransform(Random.Quat(), Random.Vector(100), Random.Vector(0.5, 2)).ToMatrixWithScale();
+		const FMatrix Product = A * B;
+		for (int i = 0; i < 4; ++i)
+			for (int j = 0; j < 4; ++j)
+				CHECK_NEAR(Product.M[i][j], A.M[i][0] * B.M[0][j] + A.M[i][1] * B.M[1][j] + A.M[i][2] * B.M[2][j] + A.M[i][3] * B.M[3][j], 1e-10);
+
+		const FMatrix44f Af(A), Bf(B);
+		const FMatrix44f Productf = Af * Bf;
+		for (int i = 0; i < 4; ++i)
+			for (int j = 0; j < 4; ++j)
+				CHECK_NEAR(Productf.M[i][j], Product.M[i][j], 1e-3);
+	}
+}
+
+TEST_CASE(HeaderOnly, RelativeTransform)
+{
+	FTestRandom Random(502);
+	for (int n = 0; n < 20; ++n)
+	{
+		// A negative scale takes the matrix paths of both operator* and GetRelativeTransform
+		FTransform A(Random.Quat(), Random.Vector(100), Random.Vector(0.5, 2) * FVector(-1, 1, 1));
+		const FTransform B(Random.Quat(), Random.Vector(100), FVector(1, 1, 1));
+		const FMatrix Relative = (A * B).GetRelativeTransform(B).ToMatrixWithScale();
+		const FMatrix Expected = A.ToMatrixWithScale();
+		for (int i = 0; i < 4; ++i)
+			for (int j = 0; j < 4; ++j)
+				CHECK_NEAR(Relative.M[i][j], Expected.M[i][j], 1e-9);
+	}
+}
+
+int main()
+{
+	int NumFailed = 0;
+	for (const FTestCase& Test : GetTestRegistry())
+	{
+		GetTestFailureCount() = 0;
+		Test.Function();
+		printf("%s %s.%s\n", GetTestFailureCount() ? "[FAIL]" : "[ OK ]", Test.Suite, Test.Name);
+		NumFailed += GetTestFailureCount() ? 1 : 0;
+	}
+	return NumFailed ? 1 : 0;
+}
@@ -0,0 +1,127 @@
+#include "test.h"
+#include "history.h"
+#include "rotator.h"
+#include <vector>
+
+TEST_CASE(History, RingOrder)
+{
+	FVectorHistory History(4);
+	CHECK(History.GetCapacity() == 4 && History.Num() == 0);
+	for (int i = 0; i < 6; ++i)
+		CHECK(History.AddSample(i * 0.1, FVector(i, 0, 0)));
+	CHECK(History.Num() == 4);
+	CHECK(History.GetTime(0) == 0.2 && History.GetSample(0).X == 2.0);
+	CHECK(History.GetSample(3).X == 5.0);
+
+	// Older samples are refused, one at the newest time replaces it
+	CHECK(!History.AddSample(0.45, FVector(9, 9, 9)));
+	CHECK(History.AddSample(0.5, FVector(7, 0, 0)));
+	CHECK(History.Num() == 4 && History.GetSample(3).X == 7.0);
+
+	History.Reset();
+	FVector Out(1, 2, 3);
+	CHECK(History.Sample(1.0, Out) == EHistorySample::Empty);
+	CHECK(Out.X == 1.0);
+	CHECK(!FVectorHistory().AddSample(0.0, Out));
+}
+
+TEST_CASE(History, InterpolateAndExtrapolate)
+{
+	FVectorHistory History(8);
+	History.AddSample(0.0, FVector(0, 0, 0));
+	History.AddSample(1.0, FVector(10, 0, 0));
+	History.AddSample(1.5, FVector(10, 20, 0));
+
+	FVector Out;
+	CHECK(History.Sample(0.5, Out) == EHistorySample::Interpolated);
+	CHECK_VECTOR_NEAR(Out, FVector(5, 0, 0), 1e-12);
+	CHECK(History.Sample(1.25, Out) == EHistorySample::Interpolated);
+	CHECK_VECTOR_NEAR(Out, FVector(10, 10, 0), 1e-12);
+	CHECK(History.Sample(1.0, Out) == EHistorySample::Interpolated);
+	CHECK(Out.X == 10.0 && Out.Y == 0.0);
+
+	// After the newest sample, at the last velocity of 40 per second in Y, up to MaxExtrapolation
+	CHECK(History.Sample(1.6, Out) == EHistorySample::Extrapolated);
+	CHECK_VECTOR_NEAR(Out, FVector(10, 24, 0), 1e-12);
+	CHECK(History.Sample(3.0, Out, 0.25) == EHistorySample::Clamped);
+	CHECK_VECTOR_NEAR(Out, FVector(10, 30, 0), 1e-12);
+	CHECK(History.Sample(3.0, Out, 0.0) == EHistorySample::Clamped);
+	CHECK(Out.Y == 20.0);
+
+	// Before the oldest sample, and with a single sample, the value holds
+	CHECK(History.Sample(-1.0, Out) == EHistorySample::Clamped);
+	CHECK(Out.X == 0.0 && Out.Y == 0.0);
+	FVectorHistory Single(2);
+	Single.AddSample(2.0, FVector(1, 2, 3));
+	CHECK(Single.Sample(2.1, Out) == EHistorySample::Clamped);
+	CHECK(Out.Z == 3.0);
+}
+
+TEST_CASE(History, TransformRotation)
+{
+	FTransformHistory History(4);
+	History.AddSample(0.0, FTransform(FRotator(0, 0, 0).GetQuaternion(), FVector(0, 0, 0), FVector(1, 1, 1)));
+	History.AddSample(1.0, FTransform(FRotator(0, 30, 0).GetQuaternion(), FVector(100, 0, 0), FVector(2, 2, 2)));
+
+	FTransform Out;
+	CHECK(History.Sample(0.5, Out) == EHistorySample::Interpolated);
+	CHECK_NEAR(FRotator(Out.Rotation).Yaw, 15.0, 1e-9);
+	CHECK_VECTOR_NEAR(Out.Scale3D, FVector(1.5, 1.5, 1.5), 1e-12);
+
+	// Rotation continues along the arc, translation at its velocity, the scale holds
+	CHECK(History.Sample(2.0, Out, 1.0) == EHistorySample::Extrapolated);
+	CHECK_NEAR(FRotator(Out.Rotation).Yaw, 60.0, 1e-9);
+	CHECK_VECTOR_NEAR(Out.Translation, FVector(200, 0, 0), 1e-12);
+	CHECK_VECTOR_NEAR(Out.Scale3D, FVector(2, 2, 2), 0.0);
+}
+
+TEST_CASE(History, BatchMatchesSample)
+{
+	FTestRandom Random(190);
+	const size_t Count = 300;
+	std::vector<FTransformHistory> Transforms(Count);
+	std::vector<FVectorHistory> Vectors(Count);
+	for (size_t i = 0; i < Count; ++i)
+	{
+		// Irregular intervals, some histories empty or with a single sample
+		Transforms[i].Init(16);
+		Vectors[i].Init(16);
+		const size_t NumSamples = i % 23;
+		double Time = Random.Range(0.0, 0.5);
+		for (size_t Sample = 0; Sample < NumSamples; ++Sample)
+		{
+			const FQuat Rotation = FRotator(Random.Range(-90, 90), Random.Range(-180, 180), Random.Range(-180, 180)).GetQuaternion();
+			const FVector Translation = Random.Vector(100);
+			Transforms[i].AddSample(Time, FTransform(Rotation, Translation, FVector(Random.Range(0.5, 2), 1, 1)));
+			Vectors[i].AddSample(Time, Translation);
+			Time += Random.Range(0.01, 0.1);
+		}
+	}
+
+	std::vector<FTransform> Out(Count);
+	std::vector<FVector> OutVectors(Count);
+	std::vector<EHistorySample> Results(Count), VectorResults(Count);
+	for (double Time : { -1.0, 0.3, 0.6, 0.9, 1.2, 3.0 })
+	{
+		BatchSampleHistories(Transforms.data(), Count, Time, Out.data(), Results.data());
+		BatchSampleHistories(Vectors.data(), Count, Time, OutVectors.data(), VectorResults.data());
+		size_t NumMismatches = 0;
+		double MaxRotationError = 0.0;
+		for (size_t i = 0; i < Count; ++i)
+		{
+			FTransform Expected;
+			FVector ExpectedVector;
+			NumMismatches += Transforms[i].Sample(Time, Expected) != Results[i];
+			NumMismatches += Vectors[i].Sample(Time, ExpectedVector) != VectorResults[i];
+			if (Results[i] == EHistorySample::Empty)
+				continue;
+			NumMismatches += Out[i].Translation.X != Expected.Translation.X || Out[i].Translation.Y != Expected.Translation.Y || Out[i].Translation.Z != Expected.Translation.Z;
+			NumMismatches += Out[i].Scale3D.X != Expected.Scale3D.X;
+			NumMismatches += OutVectors[i].X != ExpectedVector.X || OutVectors[i].Y != ExpectedVector.Y || OutVectors[i].Z != ExpectedVector.Z;
+			const FQuat D = Out[i].Rotation - Expected.Rotation;
+			MaxRotationError = std::max({ MaxRotationError, fabs(D.X), fabs(D.Y), fabs(D.Z), fabs(D.W) });
+		}
+		CHECK(NumMismatches == 0);
+		CHECK(MaxRotationError < 1e-14);
+	}
+}
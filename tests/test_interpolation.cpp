@@ -0,0 +1,223 @@
+#include "test.h"
+#include "interpolation.h"
+#include "rotator.h"
+#include <vector>
+
+static double AngleBetween(const FQuat& A, const FQuat& B)
+{
+	return 2.0 * acos(std::min(1.0, fabs(A | B)));
+}
+
+static double MaxComponentError(const FQuat& A, const FQuat& B)
+{
+	return std::max(std::max(fabs(A.X - B.X), fabs(A.Y - B.Y)), std::max(fabs(A.Z - B.Z), fabs(A.W - B.W)));
+}
+
+TEST_CASE(Interpolation, SlerpConstantSpeed)
+{
+	FTestRandom Random(101);
+	for (int i = 0; i < 100; ++i)
+	{
+		const FQuat A = Random.Quat(), B = Random.Quat();
+		CHECK(MaxComponentError(FQuat::Slerp(A, B, 0.0), A) < 1e-12);
+		CHECK_NEAR(AngleBetween(FQuat::Slerp(A, B, 1.0), B), 0.0, 1e-6);
+
+		// The angle travelled is proportional to Alpha, along the shorter arc
+		const double Total = AngleBetween(A, B);
+		for (double Alpha = 0.1; Alpha < 1.0; Alpha += 0.2)
+		{
+			const FQuat Q = FQuat::Slerp(A, B, Alpha);
+			CHECK(Q.IsNormalized());
+			CHECK_NEAR(AngleBetween(A, Q), Alpha * Total, 1e-6);
+		}
+	}
+}
+
+TEST_CASE(Interpolation, FastSlerpMatchesSlerp)
+{
+	FTestRandom Random(102);
+	double MaxError = 0;
+	for (int i = 0; i < 20000; ++i)
+	{
+		const FQuat A = Random.Quat(), B = Random.Quat();
+		const double Alpha = Random.Range(0, 1);
+		MaxError = std::max(MaxError, MaxComponentError(FQuat::FastSlerp(A, B, Alpha), FQuat::Slerp(A, B, Alpha)));
+	}
+	CHECK(MaxError < 5e-8);
+}
+
+TEST_CASE(Interpolation, NLerpEndpointsAndSpeed)
+{
+	const FQuat A(0, 0, 0, 1);
+	const FQuat B = FRotator(0, 90, 0).GetQuaternion();
+	CHECK(MaxComponentError(FQuat::NLerp(A, B, 0.0), A) < 1e-15);
+	CHECK(MaxComponentError(FQuat::NLerp(A, B, 1.0), B) < 1e-15);
+
+	double MaxDegreesOff = 0;
+	for (double Alpha = 0.0; Alpha <= 1.0; Alpha += 1.0 / 256)
+	{
+		MaxDegreesOff = std::max(MaxDegreesOff, fabs(AngleBetween(A, FQuat::NLerp(A, B, Alpha)) * 180.0 / PI - Alpha * 90.0));
+	}
+	CHECK(MaxDegreesOff < 0.92);
+	CHECK(MaxDegreesOff > 0.9);
+
+	// The opposite sign of the same rotation blends the short way
+	const FQuat NegB(-B.X, -B.Y, -B.Z, -B.W);
+	CHECK_NEAR(AngleBetween(FQuat::NLerp(A, NegB, 0.5), FQuat::Slerp(A, B, 0.5)), 0.0, 1e-7);
+}
+
+TEST_CASE(Interpolation, SquadTangents)
+{
+	FTestRandom Random(103);
+	for (int i = 0; i < 50; ++i)
+	{
+		// Keys on the same hemisphere as their predecessor, as a Squad spline expects them
+		FQuat Q0 = Random.Quat(), Q1 = Random.Quat(), Q2 = Random.Quat(), Q3 = Random.Quat();
+		Q1 = (Q0 | Q1) < 0 ? Q1 * -1.0 : Q1;
+		Q2 = (Q1 | Q2) < 0 ? Q2 * -1.0 : Q2;
+		Q3 = (Q2 | Q3) < 0 ? Q3 * -1.0 : Q3;
+		FQuat T1, T2;
+		FQuat::CalcTangents(Q0, Q1, Q2, 0.0, T1);
+		FQuat::CalcTangents(Q1, Q2, Q3, 0.0, T2);
+		CHECK(T1.IsNormalized());
+		CHECK_NEAR(AngleBetween(FQuat::Squad(Q1, T1, Q2, T2, 0.0), Q1), 0.0, 1e-6);
+		CHECK_NEAR(AngleBetween(FQuat::Squad(Q1, T1, Q2, T2, 1.0), Q2), 0.0, 1e-6);
+
+		// Tension 1 puts the tangents on the keys, so Squad is a plain Slerp
+		FQuat::CalcTangents(Q0, Q1, Q2, 1.0, T1);
+		FQuat::CalcTangents(Q1, Q2, Q3, 1.0, T2);
+		CHECK_NEAR(AngleBetween(FQuat::Squad(Q1, T1, Q2, T2, 0.4), FQuat::Slerp(Q1, Q2, 0.4)), 0.0, 1e-6);
+	}
+}
+
+TEST_CASE(Interpolation, BatchMatchesScalar)
+{
+	FTestRandom Random(104);
+	const size_t Count = 300 + 5;
+	std::vector<FQuat> A(Count), B(Count), TangentA(Count), TangentB(Count), Out(Count);
+	for (size_t i = 0; i < Count; ++i)
+	{
+		A[i] = Random.Quat();
+		B[i] = Random.Quat();
+		TangentA[i] = Random.Quat();
+		TangentB[i] = Random.Quat();
+	}
+	// Nearly equal and opposite sign pairs
+	B[1] = A[1];
+	B[2] = A[2] * -1.0;
+
+	// One Alpha per element, some of them extrapolating
+	std::vector<double> Alphas(Count);
+	for (double& Alpha : Alphas)
+		Alpha = Random.Range(-0.5, 1.5);
+
+	ForEachSimdLevel([&](ESimdLevel)
+	{
+		BatchSlerp(A.data(), B.data(), Alphas.data(), Out.data(), Count);
+		for (size_t i = 0; i < Count; ++i)
+			CHECK(MaxComponentError(Out[i], FQuat::Slerp(A[i], B[i], Alphas[i])) < 1e-14);
+
+		for (double Alpha : { 0.25, 0.8 })
+		{
+			BatchSlerp(A.data(), B.data(), Alpha, Out.data(), Count);
+			for (size_t i = 0; i < Count; ++i)
+				CHECK(MaxComponentError(Out[i], FQuat::Slerp(A[i], B[i], Alpha)) < 1e-15);
+
+			BatchSlerp(A.data(), B.data(), Alpha, Out.data(), Count, ETrigAccuracy::Fast);
+			for (size_t i = 0; i < Count; ++i)
+				CHECK(MaxComponentError(Out[i], FQuat::Slerp(A[i], B[i], Alpha)) < 1e-8);
+
+			BatchFastSlerp(A.data(), B.data(), Alpha, Out.data(), Count);
+			for (size_t i = 0; i < Count; ++i)
+				CHECK(MaxComponentError(Out[i], FQuat::FastSlerp(A[i], B[i], Alpha)) < 1e-15);
+
+			BatchNLerp(A.data(), B.data(), Alpha, Out.data(), Count);
+			for (size_t i = 0; i < Count; ++i)
+				CHECK(MaxComponentError(Out[i], FQuat::NLerp(A[i], B[i], Alpha)) < 1e-15);
+
+			BatchSquad(A.data(), TangentA.data(), B.data(), TangentB.data(), Alpha, Out.data(), Count);
+			for (size_t i = 0; i < Count; ++i)
+				CHECK(MaxComponentError(Out[i], FQuat::Squad(A[i], TangentA[i], B[i], TangentB[i], Alpha)) < 1e-14);
+		}
+
+		// In place
+		std::vector<FQuat> InPlace = A;
+		BatchNLerp(InPlace.data(), B.data(), 0.5, InPlace.data(), Count);
+		BatchNLerp(A.data(), B.data(), 0.5, Out.data(), Count);
+		for (size_t i = 0; i < Count; ++i)
+			CHECK(MaxComponentError(InPlace[i], Out[i]) == 0);
+	});
+}
+
+TEST_CASE(Interpolation, SquadAntipodalTangents)
+{
+	// Squad's tangent slerp takes the full path, so antipodal tangents have cos(Angle) = -1 and
+	// sin(Angle) = 0 (exactly, for axis quaternions); the blend falls back to linear there
+	FTestRandom Random(105);
+	const FQuat Axes[] = { FQuat(1, 0, 0, 0), FQuat(0, 1, 0, 0), FQuat(0, 0, 1, 0), FQuat(0, 0, 0, 1) };
+	const size_t Count = 8 + 3;
+	std::vector<FQuat> P(Count), Q(Count), TangentP(Count), TangentQ(Count), Out(Count);
+	for (size_t i = 0; i < Count; ++i)
+	{
+		P[i] = Random.Quat();
+		Q[i] = Random.Quat();
+		TangentP[i] = Axes[i % 4];
+		TangentQ[i] = TangentP[i] * -1.0;
+	}
+
+	const double Alpha = 0.3;
+	ForEachSimdLevel([&](ESimdLevel)
+	{
+		for (ETrigAccuracy Accuracy : { ETrigAccuracy::Precise, ETrigAccuracy::Fast })
+		{
+			BatchSquad(P.data(), TangentP.data(), Q.data(), TangentQ.data(), Alpha, Out.data(), Count, Accuracy);
+			double MaxError = 0;
+			for (size_t i = 0; i < Count; ++i)
+			{
+				const FQuat Q1 = FQuat::Slerp_NotNormalized(P[i], Q[i], Alpha);
+				const FQuat Q2 = TangentP[i] * (1.0 - Alpha) + TangentQ[i] * Alpha;
+				MaxError = std::max(MaxError, MaxComponentError(Out[i], FQuat::SlerpFullPath(Q1, Q2, 2.0 * Alpha * (1.0 - Alpha))));
+			}
+			CHECK(MaxError < (Accuracy == ETrigAccuracy::Precise ? 1e-14 : 1e-7));
+		}
+	});
+}
+
+TEST_CASE(Interpolation, BlendTransforms)
+{
+	FTestRandom Random(105);
+	const size_t Count = 200 + 3;
+	std::vector<FTransform> A(Count), B(Count), Out(Count);
+	for (size_t i = 0; i < Count; ++i)
+	{
+		A[i] = FTransform(Random.Quat(), Random.Vector(100), Random.Vector(0.5, 2));
+		B[i] = FTransform(Random.Quat(), Random.Vector(100), Random.Vector(0.5, 2));
+	}
+
+	ForEachSimdLevel([&](ESimdLevel)
+	{
+		for (double Alpha : { 0.0, 0.000001, 0.3, 0.999999, 1.0 })
+		{
+			BatchBlendTransforms(A.data(), B.data(), Alpha, Out.data(), Count);
+			for (size_t i = 0; i < Count; ++i)
+			{
+				FTransform Expected;
+				Expected.Blend(A[i], B[i], Alpha);
+				CHECK(Out[i].Translation == Expected.Translation);
+				CHECK(Out[i].Scale3D == Expected.Scale3D);
+				CHECK(MaxComponentError(Out[i].Rotation, Expected.Rotation) < 1e-15);
+			}
+		}
+
+		BatchBlendTransforms(A.data(), B.data(), 0.6, Out.data(), Count, EQuatInterpolation::Slerp);
+		for (size_t i = 0; i < Count; ++i)
+			CHECK(MaxComponentError(Out[i].Rotation, FQuat::Slerp(A[i].Rotation, B[i].Rotation, 0.6)) < 1e-15);
+	});
+
+	// BlendWith blends from the current value
+	FTransform Current = A[0];
+	Current.BlendWith(B[0], 0.5);
+	FTransform Expected;
+	Expected.Blend(A[0], B[0], 0.5);
+	CHECK(Current.Translation == Expected.Translation);
+}
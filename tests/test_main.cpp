@@ -0,0 +1,40 @@
+#include "test.h"
+#include <string.h>
+
+/**
+ * Usage: ue5math_tests [Filter...]
+ * Runs every test whose "Suite.Name" starts with one of the filters, or all tests without any.
+ * Returns non-zero if a test failed or no test matched.
+ */
+int main(int argc, char** argv)
+{
+	int NumRun = 0;
+	int NumFailed = 0;
+	char FullName[256];
+
+	for (const FTestCase& Test : GetTestRegistry())
+	{
+		snprintf(FullName, sizeof(FullName), "%s.%s", Test.Suite, Test.Name);
+
+		bool bSelected = argc < 2;
+		for (int i = 1; i < argc && !bSelected; ++i)
+			bSelected = strncmp(FullName, argv[i], strlen(argv[i])) == 0;
+		if (!bSelected)
+			continue;
+
+		GetTestFailureCount() = 0;
+		Test.Function();
+		++NumRun;
+
+		if (GetTestFailureCount())
+		{
+			printf("[FAIL] %s (%d failed checks)\n", FullName, GetTestFailureCount());
+			++NumFailed;
+		}
+		else
+			printf("[ OK ] %s\n", FullName);
+	}
+
+	printf("%d tests, %d failed (SIMD level %s)\n", NumRun, NumFailed, GetSimdLevelName(GetSupportedSimdLevel()));
+	return (NumRun == 0 || NumFailed) ? 1 : 0;
+}
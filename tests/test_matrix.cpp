@@ -0,0 +1,150 @@
+#include "test.h"
+#include "matrix.h"
+#include "rotator.h"
+#include "transform.h"
+#include <vector>
+
+static FMatrix RandomTransformMatrix(FTestRandom& Random, double MinScale, double MaxScale)
+{
+	const FTransform T(
+		FRotator(Random.Range(-180, 180), Random.Range(-180, 180), Random.Range(-180, 180)).GetQuaternion(),
+		Random.Vector(100),
+		FVector(Random.Range(MinScale, MaxScale), Random.Range(MinScale, MaxScale), Random.Range(MinScale, MaxScale)));
+	return T.ToMatrixWithScale();
+}
+
+static void CheckIdentity(const FMatrix& M, double Tolerance)
+{
+	for (int i = 0; i < 4; ++i)
+		for (int j = 0; j < 4; ++j)
+			CHECK_NEAR(M.M[i][j], i == j ? 1.0 : 0.0, Tolerance);
+}
+
+TEST_CASE(Matrix, MultiplyAllLevels)
+{
+	FTestRandom Random(13);
+	const FMatrix A = RandomTransformMatrix(Random, 0.5, 2), B = RandomTransformMatrix(Random, 0.5, 2);
+
+	FMatrix Expected;
+	for (int i = 0; i < 4; ++i)
+		for (int j = 0; j < 4; ++j)
+			Expected.M[i][j] = A.M[i][0] * B.M[0][j] + A.M[i][1] * B.M[1][j] + A.M[i][2] * B.M[2][j] + A.M[i][3] * B.M[3][j];
+
+	ForEachSimdLevel([&](ESimdLevel)
+	{
+		const FMatrix Product = A * B;
+		for (int i = 0; i < 4; ++i)
+			for (int j = 0; j < 4; ++j)
+				CHECK_NEAR(Product.M[i][j], Expected.M[i][j], 1e-10);
+	});
+}
+
+TEST_CASE(Matrix, MultiplyBatchMatchesSingle)
+{
+	FTestRandom Random(17);
+	const size_t Count = 37;
+	std::vector<FMatrix> A(Count), B(Count), Out(Count);
+	for (size_t i = 0; i < Count; ++i)
+	{
+		A[i] = RandomTransformMatrix(Random, 0.5, 2);
+		B[i] = RandomTransformMatrix(Random, 0.5, 2);
+	}
+
+	// Each element must match a batch of one, which is the single multiply of the library build;
+	// header-only builds multiply single matrices with the scalar path only
+	ForEachSimdLevel([&](ESimdLevel Level)
+	{
+		FMatrix Expected;
+		FMatrix::MultiplyBatch(Out.data(), A.data(), B[0], Count);
+		for (size_t i = 0; i < Count; ++i)
+		{
+			FMatrix::MultiplyBatch(&Expected, &A[i], B[0], 1);
+			CHECK(memcmp(&Out[i], &Expected, sizeof(FMatrix)) == 0);
+			if (Level == ESimdLevel::Scalar)
+			{
+				Expected = A[i] * B[0];
+				CHECK(memcmp(&Out[i], &Expected, sizeof(FMatrix)) == 0);
+			}
+		}
+
+		FMatrix::MultiplyBatch(Out.data(), A.data(), B.data(), Count);
+		for (size_t i = 0; i < Count; ++i)
+		{
+			FMatrix::MultiplyBatch(&Expected, &A[i], &B[i], 1);
+			CHECK(memcmp(&Out[i], &Expected, sizeof(FMatrix)) == 0);
+			if (Level == ESimdLevel::Scalar)
+			{
+				Expected = A[i] * B[i];
+				CHECK(memcmp(&Out[i], &Expected, sizeof(FMatrix)) == 0);
+			}
+		}
+	});
+}
+
+TEST_CASE(Matrix, Inverse)
+{
+	FTestRandom Random(19);
+	for (int i = 0; i < 50; ++i)
+	{
+		const FMatrix Affine = RandomTransformMatrix(Random, 0.5, 2);
+		CheckIdentity(Affine * Affine.Inverse(), 1e-10);
+		CheckIdentity(Affine * Affine.InverseAffine(), 1e-10);
+		CheckIdentity(Affine * Affine.InverseAuto(), 1e-10);
+
+		const FMatrix Rigid = RandomTransformMatrix(Random, 1, 1);
+		CheckIdentity(Rigid * Rigid.InverseRigid(), 1e-10);
+	}
+
+	FMatrix Singular;
+	Singular.M[1][1] = 0;
+	CheckIdentity(Singular.Inverse(), 0);
+}
+
+TEST_CASE(Matrix, Classify)
+{
+	FTestRandom Random(23);
+	CHECK(FMatrix().Classify() == EMatrixClass::Rigid);
+	CHECK(RandomTransformMatrix(Random, 1, 1).Classify(1e-10) == EMatrixClass::Rigid);
+	CHECK(RandomTransformMatrix(Random, 2, 3).Classify() == EMatrixClass::Affine);
+
+	// Float rounding of a normalized quaternion's matrix is far above SMALL_NUMBER
+	for (int i = 0; i < 100; ++i)
+	{
+		const FQuat4f Q = FQuat4f(FRotator(Random.Range(-180, 180), Random.Range(-180, 180), Random.Range(-180, 180)).GetQuaternion()).GetNormalized();
+		const FMatrix44f M = FTransform3f(Q, FVector3f((float)Random.Range(-100, 100), 0.0f, 5.0f), FVector3f(1, 1, 1)).ToMatrixWithScale();
+		CHECK(M.Classify() == EMatrixClass::Rigid);
+		CHECK(FTransform3f(Q, FVector3f(0, 0, 0), FVector3f(2, 1, 1)).ToMatrixWithScale().Classify() == EMatrixClass::Affine);
+	}
+
+	FMatrix Projective;
+	Projective.M[2][3] = 1;
+	CHECK(Projective.Classify() == EMatrixClass::General);
+}
+
+TEST_CASE(Matrix, RemoveScalingAndRotator)
+{
+	const FRotator R(20, -40, 60);
+	FMatrix M = FTransform(R.GetQuaternion(), FVector(0, 0, 0), FVector(2, 3, 4)).ToMatrixWithScale();
+	M.RemoveScaling();
+	CHECK_NEAR(M.GetScaledAxisX().Length(), 1, 1e-15);
+	CHECK_NEAR(M.GetScaledAxisZ().Length(), 1, 1e-15);
+
+	const FRotator Back = M.GetRotator();
+	CHECK_NEAR(Back.Pitch, R.Pitch, 1e-9);
+	CHECK_NEAR(Back.Yaw, R.Yaw, 1e-9);
+	CHECK_NEAR(Back.Roll, R.Roll, 1e-9);
+}
+
+TEST_CASE(Matrix, GetRotatorKeepsRoll)
+{
+	FTestRandom Random(14);
+	for (int i = 0; i < 100; ++i)
+	{
+		// Away from +-90 degrees pitch, where roll and yaw are not separable
+		const FRotator R(Random.Range(-80, 80), Random.Range(-180, 180), Random.Range(-180, 180));
+		const FRotator Back = R.GetMatrix().GetRotator();
+		CHECK_NEAR(Back.Pitch, R.Pitch, 1e-9);
+		CHECK_NEAR(Back.Yaw, R.Yaw, 1e-9);
+		CHECK_NEAR(Back.Roll, R.Roll, 1e-9);
+	}
+}
@@ -0,0 +1,194 @@
+#include "test.h"
+#include "packedtransform.h"
+#include <vector>
+
+/** Rotation angle between A and B in radians, from the chord between them (stable for small angles). */
+static double RotationError(const FQuat& A, const FQuat& B)
+{
+	const double Sign = A.X * B.X + A.Y * B.Y + A.Z * B.Z + A.W * B.W < 0.0 ? -1.0 : 1.0;
+	const double DX = A.X - B.X * Sign, DY = A.Y - B.Y * Sign, DZ = A.Z - B.Z * Sign, DW = A.W - B.W * Sign;
+	return 4.0 * asin(std::min(1.0, sqrt(DX * DX + DY * DY + DZ * DZ + DW * DW) * 0.5));
+}
+
+static FQuat RandomRotation(FTestRandom& Random)
+{
+	FQuat Q(Random.Range(-1, 1), Random.Range(-1, 1), Random.Range(-1, 1), Random.Range(-1, 1));
+	Q.Normalize();
+	return Q;
+}
+
+static bool SameBits(const std::vector<FPackedTransform>& A, const std::vector<FPackedTransform>& B)
+{
+	return A.size() == B.size() && memcmp(A.data(), B.data(), A.size() * sizeof(FPackedTransform)) == 0;
+}
+
+TEST_CASE(PackedTransform, Halves)
+{
+	CHECK(FloatToHalf(1.0f) == 0x3C00);
+	CHECK(FloatToHalf(-2.0f) == 0xC000);
+	CHECK(FloatToHalf(65504.0f) == 0x7BFF);
+	CHECK(FloatToHalf(1e6f) == 0x7BFF);
+	CHECK(FloatToHalf(1e-6f) == 0);
+	CHECK(FloatToHalf(1.0f + 1.0f / 4096.0f) == 0x3C00);	// Halfway rounds to even
+	CHECK(FloatToHalf(1.0f + 3.0f / 2048.0f) == 0x3C02);	// And up to even
+
+	// Every normal half survives the round trip
+	int NumWrong = 0;
+	for (uint32_t Half = 0; Half <= 0xFFFF; ++Half)
+	{
+		const uint32_t Exponent = (Half >> 10) & 0x1F;
+		if (Exponent != 0 && Exponent != 0x1F)
+			NumWrong += FloatToHalf(HalfToFloat((uint16_t)Half)) != Half;
+	}
+	CHECK(NumWrong == 0);
+	CHECK(HalfToFloat(0) == 0.0f && HalfToFloat(0x3555) == 0.333251953125f);
+}
+
+TEST_CASE(PackedTransform, RoundTripErrorBounds)
+{
+	FTestRandom Random(180);
+	const FTranslationQuantizer Quantizer(FVector(-100000, -100000, -5000), FVector(100000, 100000, 20000));
+	const FVector MaxError = Quantizer.GetMaxError();
+	CHECK(MaxError.X < 0.048 && MaxError.Z < 0.006);
+
+	const size_t Count = 20000;
+	std::vector<FTransform> Transforms(Count);
+	for (size_t i = 0; i < Count; ++i)
+	{
+		const double Scale = Random.Range(0.01, 100.0);
+		Transforms[i] = FTransform(RandomRotation(Random), FVector(Random.Range(-100000, 100000), Random.Range(-100000, 100000), Random.Range(-5000, 20000)), FVector(Scale, Scale, Scale));
+	}
+	Transforms[0] = FTransform();
+
+	std::vector<FPackedTransform> Packed(Count);
+	std::vector<FTransform> Unpacked(Count);
+	CHECK(BatchPackTransforms(Transforms.data(), Packed.data(), Count, Quantizer) == 0);
+	BatchUnpackTransforms(Packed.data(), Unpacked.data(), Count, Quantizer);
+
+	double MaxRotationError = 0.0, MaxScaleError = 0.0;
+	size_t NumOutOfBounds = 0;
+	for (size_t i = 0; i < Count; ++i)
+	{
+		MaxRotationError = std::max(MaxRotationError, RotationError(Transforms[i].Rotation, Unpacked[i].Rotation));
+		MaxScaleError = std::max(MaxScaleError, fabs(Unpacked[i].Scale3D.X / Transforms[i].Scale3D.X - 1.0));
+		const FVector Delta = Unpacked[i].Translation - Transforms[i].Translation;
+		NumOutOfBounds += fabs(Delta.X) > MaxError.X * 1.0001 || fabs(Delta.Y) > MaxError.Y * 1.0001 || fabs(Delta.Z) > MaxError.Z * 1.0001;
+		NumOutOfBounds += Unpacked[i].Scale3D.X != Unpacked[i].Scale3D.Y || Unpacked[i].Scale3D.X != Unpacked[i].Scale3D.Z;
+	}
+	CHECK(MaxRotationError < 1.5e-4);
+	CHECK(MaxScaleError <= 1.0 / 2048.0);
+	CHECK(NumOutOfBounds == 0);
+
+	// The identity comes back exact, bar the translation step
+	CHECK(Unpacked[0].Rotation.X == 0.0 && Unpacked[0].Rotation.Y == 0.0 && Unpacked[0].Rotation.Z == 0.0 && Unpacked[0].Rotation.W == 1.0);
+	CHECK(Unpacked[0].Scale3D.X == 1.0);
+
+	// Q and -Q pack the same; an unnormalized rotation packs as its normal
+	FTransform Negated = Transforms[1];
+	Negated.Rotation = FQuat(-Negated.Rotation.X, -Negated.Rotation.Y, -Negated.Rotation.Z, -Negated.Rotation.W);
+	FTransform Scaled = Transforms[1];
+	Scaled.Rotation = FQuat(Scaled.Rotation.X * 3, Scaled.Rotation.Y * 3, Scaled.Rotation.Z * 3, Scaled.Rotation.W * 3);
+	FPackedTransform PackedNegated, PackedScaled;
+	BatchPackTransforms(&Negated, &PackedNegated, 1, Quantizer);
+	BatchPackTransforms(&Scaled, &PackedScaled, 1, Quantizer);
+	CHECK(memcmp(&PackedNegated, &Packed[1], sizeof(FPackedTransform)) == 0);
+	CHECK(RotationError(UnpackTransform(PackedScaled, Quantizer).Rotation, Transforms[1].Rotation) < 1.5e-4);
+
+	// Out of range translations clamp to the range
+	FTransform Outside;
+	Outside.Translation = FVector(-1e7, 1e7, 0);
+	FPackedTransform PackedOutside;
+	BatchPackTransforms(&Outside, &PackedOutside, 1, Quantizer);
+	const FVector Clamped = UnpackTransform(PackedOutside, Quantizer).Translation;
+	CHECK(Clamped.X == -100000.0);
+	CHECK_NEAR(Clamped.Y, 100000.0, 1e-9);
+}
+
+TEST_CASE(PackedTransform, NonUniformScales)
+{
+	const FTranslationQuantizer Quantizer(FBox(FVector(-10, -10, -10), FVector(10, 10, 10)));
+	std::vector<FTransform> Transforms(9);
+	Transforms[2].Scale3D = FVector(1, 2, 3);
+	Transforms[5].Scale3D = FVector(-0.5, 0.5, 0.5);
+	Transforms[6].Scale3D = FVector(2, 2, 2.0001);		// Differs by less than a half step, so still uniform
+	Transforms[8].Scale3D = FVector(4, -8, 1);
+
+	std::vector<FPackedTransform> Packed(9);
+	std::vector<FPackedScale> Scales(9);
+	CHECK(BatchPackTransforms(Transforms.data(), Packed.data(), 9, Quantizer, Scales.data()) == 3);
+	CHECK(Packed[2].HasNonUniformScale() && Packed[2].Scale == 0);
+	CHECK(Packed[5].HasNonUniformScale() && Packed[5].Scale == 1);
+	CHECK(!Packed[6].HasNonUniformScale());
+	CHECK(Packed[8].HasNonUniformScale() && Packed[8].Scale == 2);
+
+	std::vector<FTransform> Unpacked(9);
+	BatchUnpackTransforms(Packed.data(), Unpacked.data(), 9, Quantizer, Scales.data());
+	for (size_t i = 0; i < 9; ++i)
+	{
+		CHECK_VECTOR_NEAR(Unpacked[i].Scale3D, Transforms[i].Scale3D, 1e-3);
+	}
+	CHECK(Unpacked[5].Scale3D.X == -0.5 && Unpacked[8].Scale3D.Y == -8.0);
+
+	// Without a scale array, the axis of largest magnitude stands for all three
+	CHECK(BatchPackTransforms(Transforms.data(), Packed.data(), 9, Quantizer) == 0);
+	BatchUnpackTransforms(Packed.data(), Unpacked.data(), 9, Quantizer);
+	CHECK(Unpacked[2].Scale3D.X == 3.0 && Unpacked[5].Scale3D.X == -0.5 && Unpacked[8].Scale3D.Z == -8.0);
+}
+
+TEST_CASE(PackedTransform, SimdLevelsAgree)
+{
+	FTestRandom Random(181);
+	const FTranslationQuantizer Quantizer(FVector(-500, -500, -500), FVector(500, 500, 500));
+	const size_t Count = 1003;
+	std::vector<FTransform> Transforms(Count);
+	std::vector<double> Columns(Count * 10);
+	double* C = Columns.data();
+	FTransformSoA SoA(FQuatSoA(C, C + Count, C + 2 * Count, C + 3 * Count), FVectorSoA(C + 4 * Count, C + 5 * Count, C + 6 * Count), FVectorSoA(C + 7 * Count, C + 8 * Count, C + 9 * Count));
+	for (size_t i = 0; i < Count; ++i)
+	{
+		const double Scale = Random.Range(-4.0, 4.0);
+		const FVector Scale3D = (i % 7 == 3) ? Random.Vector(0.1, 2) : FVector(Scale, Scale, Scale);
+		// Some translations fall outside the range
+		Transforms[i] = FTransform(RandomRotation(Random), Random.Vector(600), Scale3D);
+		SoA.Set(i, Transforms[i]);
+	}
+
+	std::vector<FPackedTransform> Reference, Packed(Count), PackedSoA(Count);
+	std::vector<FPackedScale> ReferenceScales, Scales(Count), ScalesSoA(Count);
+	std::vector<FTransform> ReferenceUnpacked, Unpacked(Count);
+	std::vector<double> UnpackedColumns(Count * 10);
+	double* U = UnpackedColumns.data();
+	FTransformSoA UnpackedSoA(FQuatSoA(U, U + Count, U + 2 * Count, U + 3 * Count), FVectorSoA(U + 4 * Count, U + 5 * Count, U + 6 * Count), FVectorSoA(U + 7 * Count, U + 8 * Count, U + 9 * Count));
+	ForEachSimdLevel([&](ESimdLevel Level)
+	{
+		const size_t NumScales = BatchPackTransforms(Transforms.data(), Packed.data(), Count, Quantizer, Scales.data());
+		CHECK(BatchPackTransforms(SoA, PackedSoA.data(), Count, Quantizer, ScalesSoA.data()) == NumScales);
+		CHECK(SameBits(Packed, PackedSoA));
+		CHECK(NumScales == (Count + 3) / 7);
+		BatchUnpackTransforms(Packed.data(), Unpacked.data(), Count, Quantizer, Scales.data());
+		BatchUnpackTransforms(Packed.data(), UnpackedSoA, Count, Quantizer, Scales.data());
+		if (Level == ESimdLevel::Scalar)
+		{
+			Reference = Packed;
+			ReferenceScales = Scales;
+			ReferenceUnpacked = Unpacked;
+		}
+		CHECK(SameBits(Packed, Reference));
+		CHECK(memcmp(Scales.data(), ReferenceScales.data(), NumScales * sizeof(FPackedScale)) == 0);
+
+		size_t NumMismatches = 0;
+		for (size_t i = 0; i < Count; ++i)
+		{
+			const FTransform& A = ReferenceUnpacked[i];
+			const FTransform& B = Unpacked[i];
+			const FTransform S = UnpackedSoA.Get(i);
+			for (const FTransform* T : { &B, &S })
+			{
+				NumMismatches += A.Rotation.X != T->Rotation.X || A.Rotation.Y != T->Rotation.Y || A.Rotation.Z != T->Rotation.Z || A.Rotation.W != T->Rotation.W;
+				NumMismatches += A.Translation.X != T->Translation.X || A.Translation.Y != T->Translation.Y || A.Translation.Z != T->Translation.Z;
+				NumMismatches += A.Scale3D.X != T->Scale3D.X || A.Scale3D.Y != T->Scale3D.Y || A.Scale3D.Z != T->Scale3D.Z;
+			}
+		}
+		CHECK(NumMismatches == 0);
+	});
+}
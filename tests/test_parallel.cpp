@@ -0,0 +1,136 @@
+#include "test.h"
+#include "parallel.h"
+#include "batch.h"
+#include "camera.h"
+#include "frustum.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/** Runs Scheduler.ParallelFor and checks every index in [0, Count) is visited exactly once, in whole chunks. */
+static void CheckCoverage(FTaskScheduler& Scheduler, size_t Count, size_t ChunkSize)
+{
+	std::vector<std::atomic<int>> Visits(Count);
+	std::atomic<size_t> NumBadChunks(0);
+	Scheduler.ParallelFor(Count, ChunkSize, [&](size_t Begin, size_t End)
+	{
+		if (End <= Begin || End > Count || (Begin % ChunkSize != 0) || (End - Begin != ChunkSize && End != Count))
+			NumBadChunks.fetch_add(1);
+		for (size_t i = Begin; i < End; ++i)
+			Visits[i].fetch_add(1);
+	});
+	CHECK(NumBadChunks.load() == 0);
+	size_t NumWrong = 0;
+	for (const std::atomic<int>& Visit : Visits)
+		NumWrong += Visit.load() != 1;
+	CHECK(NumWrong == 0);
+}
+
+TEST_CASE(Parallel, EveryIndexOnce)
+{
+	for (int NumThreads : { 1, 2, 3, 8 })
+	{
+		FTaskScheduler Scheduler(NumThreads);
+		CHECK(Scheduler.GetNumThreads() == NumThreads);
+		for (size_t Count : { 0, 1, 7, 64, 1000, 100003 })
+		{
+			for (size_t ChunkSize : { 1, 3, 64, 4096 })
+			{
+				CheckCoverage(Scheduler, Count, ChunkSize);
+			}
+		}
+	}
+}
+
+TEST_CASE(Parallel, NestedAndConcurrentCalls)
+{
+	FTaskScheduler Scheduler(4);
+
+	// A ParallelFor from inside a body runs inline on the thread making it
+	std::atomic<size_t> Sum(0);
+	Scheduler.ParallelFor(64, 1, [&](size_t Begin, size_t End)
+	{
+		Scheduler.ParallelFor(100, 10, [&](size_t InnerBegin, size_t InnerEnd)
+		{
+			CHECK(InnerBegin == 0 && InnerEnd == 100);
+			Sum.fetch_add(InnerEnd - InnerBegin);
+		});
+	});
+	CHECK(Sum.load() == 64 * 100);
+
+	// Calls from several threads at once take turns
+	std::vector<std::thread> Callers;
+	for (int Caller = 0; Caller < 3; ++Caller)
+	{
+		Callers.emplace_back([&]()
+		{
+			for (int Repeat = 0; Repeat < 20; ++Repeat)
+				CheckCoverage(Scheduler, 5000, 17);
+		});
+	}
+	for (std::thread& Caller : Callers)
+		Caller.join();
+}
+
+TEST_CASE(Parallel, ChunkSizes)
+{
+	CHECK(GetParallelChunkSize(1) == ParallelChunkBytes);
+	CHECK(GetParallelChunkSize(40) % 64 == 0);
+	CHECK(GetParallelChunkSize(40) * 40 >= ParallelChunkBytes);
+	CHECK(GetParallelChunkSize(1 << 30) == 64);
+
+	// Under ParallelMinChunks chunks, the free ParallelFor makes one call on the caller
+	FTaskScheduler Scheduler(4);
+	int NumCalls = 0;
+	ParallelFor(&Scheduler, 64 * ParallelMinChunks - 1, 64, [&](size_t Begin, size_t End) { ++NumCalls; });
+	CHECK(NumCalls == 1);
+}
+
+TEST_CASE(Parallel, BatchAPIsMatchSequential)
+{
+	// Large enough for many chunks in every API, with a tail that is not a multiple of 64
+	FTestRandom Random(150);
+	const size_t Count = 40000 + 13;
+	const FTransform ComponentToWorld(FRotator(20, -35, 70).GetQuaternion(), FVector(10, -20, 30), FVector(1.5, 0.5, 2));
+	const FCamera Camera(FVector(10, -20, 30), FRotator(-15, 40, 5), 75.0, 1280.0, 720.0);
+	const FFrustum Frustum = Camera.GetFrustum(800.0);
+
+	std::vector<FTransform> Bones(Count);
+	std::vector<FVector> Points(Count);
+	std::vector<FBox> Boxes(Count);
+	std::vector<FSphere> Spheres(Count);
+	for (size_t i = 0; i < Count; ++i)
+	{
+		Points[i] = Random.Vector(500);
+		Bones[i].Translation = Points[i];
+		Boxes[i] = FBox(Points[i] - FVector(10, 10, 10), Points[i] + FVector(10, 10, 10));
+		Spheres[i] = FSphere(Points[i], 10.0);
+	}
+
+	FTaskScheduler Scheduler(4);
+	const size_t NumWords = (Count + 63) / 64;
+	std::vector<double> Sequential(Count * 3), Parallel(Count * 3);
+	std::vector<FVector2D> SequentialScreen(Count), ParallelScreen(Count);
+	std::vector<uint64_t> SequentialMask(NumWords), ParallelMask(NumWords);
+	ForEachSimdLevel([&](ESimdLevel)
+	{
+		double* S = Sequential.data();
+		double* P = Parallel.data();
+		BatchGetBoneWithRotation(ComponentToWorld, Bones.data(), Count, FVectorSoA(S, S + Count, S + 2 * Count));
+		BatchGetBoneWithRotation(ComponentToWorld, Bones.data(), Count, FVectorSoA(P, P + Count, P + 2 * Count), &Scheduler);
+		CHECK(Sequential == Parallel);
+
+		CHECK(Camera.WorldToScreen(Points.data(), SequentialScreen.data(), SequentialMask.data(), Count)
+			== Camera.WorldToScreen(Points.data(), ParallelScreen.data(), ParallelMask.data(), Count, &Scheduler));
+		CHECK(SequentialMask == ParallelMask);
+		size_t NumMismatches = 0;
+		for (size_t i = 0; i < Count; ++i)
+			NumMismatches += SequentialScreen[i].X != ParallelScreen[i].X || SequentialScreen[i].Y != ParallelScreen[i].Y;
+		CHECK(NumMismatches == 0);
+
+		CHECK(Frustum.CullBoxes(Boxes.data(), SequentialMask.data(), Count) == Frustum.CullBoxes(Boxes.data(), ParallelMask.data(), Count, &Scheduler));
+		CHECK(SequentialMask == ParallelMask);
+		CHECK(Frustum.CullSpheres(Spheres.data(), SequentialMask.data(), Count) == Frustum.CullSpheres(Spheres.data(), ParallelMask.data(), Count, &Scheduler));
+		CHECK(SequentialMask == ParallelMask);
+	});
+}
@@ -0,0 +1,71 @@
+#include "test.h"
+#include "quat.h"
+#include "rotator.h"
+#include "matrix.h"
+
+static_assert(FQuat(1, 2, 3, 4).SizeSquared() == 30, "constexpr SizeSquared");
+
+TEST_CASE(Quat, RotateVector)
+{
+	// 90 degrees of yaw turns +X into +Y
+	const FQuat Yaw90 = FRotator(0, 90, 0).GetQuaternion();
+	CHECK_VECTOR_NEAR(Yaw90.RotateVector(FVector(1, 0, 0)), FVector(0, 1, 0), 1e-15);
+	CHECK_VECTOR_NEAR(Yaw90 * FVector(0, 1, 0), FVector(-1, 0, 0), 1e-15);
+
+	FTestRandom Random;
+	for (int i = 0; i < 100; ++i)
+	{
+		const FQuat Q = Random.Quat();
+		const FVector V = Random.Vector(100);
+		CHECK_VECTOR_NEAR(Q.RotateVectorInverse(Q.RotateVector(V)), V, 1e-12);
+		CHECK_VECTOR_NEAR(Q.Inverse().RotateVector(V), Q.RotateVectorInverse(V), 1e-12);
+		CHECK_NEAR(Q.RotateVector(V).Length(), V.Length(), 1e-12);
+	}
+}
+
+TEST_CASE(Quat, MultiplyComposesRotations)
+{
+	FTestRandom Random(7);
+	for (int i = 0; i < 100; ++i)
+	{
+		const FQuat A = Random.Quat(), B = Random.Quat();
+		const FVector V = Random.Vector(10);
+		// (A * B) applies B first
+		CHECK_VECTOR_NEAR((A * B).RotateVector(V), A.RotateVector(B.RotateVector(V)), 1e-12);
+	}
+}
+
+TEST_CASE(Quat, Normalize)
+{
+	FQuat Q(1, 2, 3, 4);
+	CHECK(!Q.IsNormalized());
+	Q.Normalize();
+	CHECK(Q.IsNormalized());
+	CHECK_NEAR(Q.SizeSquared(), 1, 1e-15);
+
+	FQuat Fast(1, 2, 3, 4);
+	Fast.Normalize<EMathPrecision::Fast>();
+	CHECK_NEAR(Fast.SizeSquared(), 1, 1e-13);
+	CHECK_NEAR(Fast.W, Q.W, 1e-13);
+
+	FQuat Zero(0, 0, 0, 0);
+	Zero.Normalize();
+	CHECK(Zero.X == 0 && Zero.Y == 0 && Zero.Z == 0 && Zero.W == 1);
+}
+
+TEST_CASE(Quat, FromMatrix)
+{
+	FTestRandom Random(11);
+	for (int i = 0; i < 100; ++i)
+	{
+		const FRotator R(Random.Range(-89, 89), Random.Range(-180, 180), Random.Range(-180, 180));
+		const FQuat FromRotator = R.GetQuaternion();
+		const FQuat FromMatrix(R.GetMatrix());
+		// q and -q are the same rotation
+		const double Sign = (FromRotator.X * FromMatrix.X + FromRotator.Y * FromMatrix.Y + FromRotator.Z * FromMatrix.Z + FromRotator.W * FromMatrix.W) < 0 ? -1 : 1;
+		CHECK_NEAR(FromMatrix.X * Sign, FromRotator.X, 1e-12);
+		CHECK_NEAR(FromMatrix.Y * Sign, FromRotator.Y, 1e-12);
+		CHECK_NEAR(FromMatrix.Z * Sign, FromRotator.Z, 1e-12);
+		CHECK_NEAR(FromMatrix.W * Sign, FromRotator.W, 1e-12);
+	}
+}
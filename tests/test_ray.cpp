@@ -0,0 +1,222 @@
+#include "test.h"
+#include "ray.h"
+#include <algorithm>
+#include <vector>
+
+/** Signed distances from the shapes' surfaces, negative inside. */
+static double SphereDistance(const FVector& P, const FVector& Center, double Radius)
+{
+	return P.Distance(Center) - Radius;
+}
+
+static double BoxDistance(const FVector& P, const FBox& Box)
+{
+	const FVector Delta = P - Box.GetCenter();
+	const FVector Q = FVector(fabs(Delta.X), fabs(Delta.Y), fabs(Delta.Z)) - Box.GetExtent();
+	const FVector Outside(std::max(Q.X, 0.0), std::max(Q.Y, 0.0), std::max(Q.Z, 0.0));
+	return Outside.Length() + std::min(std::max(Q.X, std::max(Q.Y, Q.Z)), 0.0);
+}
+
+static double CapsuleDistance(const FVector& P, const FVector& Start, const FVector& End, double Radius)
+{
+	const FVector Axis = End - Start;
+	const double S = (Axis | Axis) > 0.0 ? std::clamp(((P - Start) | Axis) / (Axis | Axis), 0.0, 1.0) : 0.0;
+	return P.Distance(Start + Axis * S) - Radius;
+}
+
+/**
+ * Checks a hit (or miss) against the shape's distance function: the hit point is on the surface,
+ * and the ray is outside the shape everywhere before it, as far as sampling along it can tell.
+ */
+template<typename DistanceType>
+static void CheckFirstHit(const FRay& Ray, bool bHit, double T, DistanceType Distance)
+{
+	if (bHit && T == 0.0)
+	{
+		CHECK(Distance(Ray.Origin) <= 1e-9);
+		return;
+	}
+
+	const double End = bHit ? T : Ray.MaxDistance;
+	for (int Sample = 0; Sample < 400; ++Sample)
+	{
+		CHECK(Distance(Ray.PointAt(End * Sample / 400.0)) > -1e-9);
+	}
+	if (bHit)
+	{
+		CHECK_NEAR(Distance(Ray.PointAt(T)), 0.0, 1e-9);
+	}
+}
+
+TEST_CASE(Ray, FirstHitIsOnTheSurface)
+{
+	FTestRandom Random(131);
+	int NumHits = 0;
+	for (int i = 0; i < 3000; ++i)
+	{
+		// Aim near the shapes so that about half the rays hit
+		const FVector Center = Random.Vector(20);
+		const double Radius = Random.Range(1, 15);
+		const FVector Origin = Center + Random.Vector(60);
+		const FRay Ray(Origin, Center - Origin + Random.Vector(15), Random.Range(40, 200));
+
+		double T = -1.0;
+		bool bHit = Ray.IntersectSphere(FSphere(Center, Radius), T);
+		CheckFirstHit(Ray, bHit, T, [&](const FVector& P) { return SphereDistance(P, Center, Radius); });
+		NumHits += bHit;
+
+		const FVector Extent = Random.Vector(1, 15);
+		const FBox Box(Center - Extent, Center + Extent);
+		bHit = Ray.IntersectBox(Box, T);
+		CheckFirstHit(Ray, bHit, T, [&](const FVector& P) { return BoxDistance(P, Box); });
+		NumHits += bHit;
+
+		const FVector End = Center + Random.Vector(25);
+		bHit = Ray.IntersectCapsule(Center, End, Radius, T);
+		CheckFirstHit(Ray, bHit, T, [&](const FVector& P) { return CapsuleDistance(P, Center, End, Radius); });
+		NumHits += bHit;
+	}
+	CHECK(NumHits > 2000 && NumHits < 7000);
+
+	// Degenerate cases: a sphere capsule, rays along the capsule axis and along box faces
+	double T = -1.0;
+	CHECK(FRay(FVector(-10, 0, 0), FVector(1, 0, 0)).IntersectCapsule(FVector(0, 0, 0), FVector(0, 0, 0), 2.0, T));
+	CHECK_NEAR(T, 8.0, 1e-12);
+	CHECK(FRay(FVector(-10, 0, 0), FVector(1, 0, 0)).IntersectCapsule(FVector(0, 0, 0), FVector(5, 0, 0), 2.0, T));
+	CHECK_NEAR(T, 8.0, 1e-12);
+	CHECK(FRay(FVector(20, 0, 0), FVector(-1, 0, 0)).IntersectCapsule(FVector(0, 0, 0), FVector(5, 0, 0), 2.0, T));
+	CHECK_NEAR(T, 13.0, 1e-12);
+	CHECK(FRay(FVector(-10, 1e-7, 0), FVector(1, 1e-13, 0)).IntersectCapsule(FVector(0, 0, 0), FVector(5, 0, 0), 2.0, T));
+	CHECK_NEAR(T, 8.0, 1e-9);
+	CHECK(FRay(FVector(-10, 1, 1), FVector(1, 0, 0)).IntersectBox(FBox(FVector(0, 1, 0), FVector(4, 2, 2)), T));
+	CHECK(T == 10.0);
+	CHECK(!FRay(FVector(-10, 3, 1), FVector(1, 0, 0)).IntersectBox(FBox(FVector(0, 1, 0), FVector(4, 2, 2)), T));
+
+	// Inside hits at 0; segments stop at their end; a zero direction only hits what contains it
+	CHECK(FRay(FVector(1, 0, 0), FVector(0, 0, 1)).IntersectSphere(FSphere(FVector(0, 0, 0), 2.0), T) && T == 0.0);
+	CHECK(!FRay::Segment(FVector(-10, 0, 0), FVector(-3, 0, 0)).IntersectSphere(FSphere(FVector(0, 0, 0), 2.0), T));
+	CHECK(FRay::Segment(FVector(-10, 0, 0), FVector(-2, 0, 0)).IntersectSphere(FSphere(FVector(0, 0, 0), 2.0), T));
+	CHECK(FRay(FVector(1, 0, 0), FVector(0, 0, 0)).IntersectBox(FBox(FVector(0, 0, 0), FVector(2, 2, 2)), T) && T == 0.0);
+	CHECK(!FRay(FVector(3, 0, 0), FVector(0, 0, 0)).IntersectCapsule(FVector(0, 0, 0), FVector(0, 0, 2), 1.0, T));
+}
+
+/** Shape arrays backed by vectors, one per component. */
+struct FTestShapeArrays
+{
+	std::vector<double> Data[7];
+
+	explicit FTestShapeArrays(size_t Count) { for (std::vector<double>& Array : Data) Array.resize(Count); }
+
+	FVectorSoA Vectors(int First) { return FVectorSoA(Data[First].data(), Data[First + 1].data(), Data[First + 2].data()); }
+	FSphereSoA Spheres() { return FSphereSoA(Vectors(0), Data[6].data()); }
+	FBoxSoA Boxes() { return FBoxSoA(Vectors(0), Vectors(3)); }
+	FCapsuleSoA Capsules() { return FCapsuleSoA(Vectors(0), Vectors(3), Data[6].data()); }
+};
+
+TEST_CASE(Ray, BatchMatchesSingleShapes)
+{
+	ForEachSimdLevel([](ESimdLevel)
+	{
+		FTestRandom Random(132);
+		for (size_t Count : { 0, 1, 3, 4, 7, 8, 13, 64, 301 })
+		{
+			FTestShapeArrays Shapes(Count);
+			FVectorSoA Min = Shapes.Vectors(0), Max = Shapes.Vectors(3);
+			for (size_t i = 0; i < Count; ++i)
+			{
+				const FVector Center = Random.Vector(100);
+				const FVector Extent = Random.Vector(1, 10);
+				Min.Set(i, Center - Extent);
+				Max.Set(i, i % 5 == 0 ? Center - Extent : Center + Extent + Random.Vector(5));
+				Shapes.Data[6][i] = Random.Range(1, 10);
+			}
+
+			for (int Query = 0; Query < 40; ++Query)
+			{
+				const FRay Ray = Query % 4 == 0
+					? FRay::Segment(Random.Vector(100), Random.Vector(100))
+					: FRay(Random.Vector(120), Random.Vector(1));
+
+				int32_t ExpectedSphere = -1, ExpectedBox = -1, ExpectedCapsule = -1;
+				double SphereT = INFINITY, BoxT = INFINITY, CapsuleT = INFINITY, T;
+				for (size_t i = 0; i < Count; ++i)
+				{
+					if (Ray.IntersectSphere(FSphere(Min.Get(i), Shapes.Data[6][i]), T) && T < SphereT)
+						SphereT = T, ExpectedSphere = (int32_t)i;
+					if (Ray.IntersectBox(FBox(Min.Get(i), Max.Get(i)), T) && T < BoxT)
+						BoxT = T, ExpectedBox = (int32_t)i;
+					if (Ray.IntersectCapsule(Min.Get(i), Max.Get(i), Shapes.Data[6][i], T) && T < CapsuleT)
+						CapsuleT = T, ExpectedCapsule = (int32_t)i;
+				}
+
+				int32_t Index = -1;
+				T = -1.0;
+				CHECK(RaycastSpheres(Ray, Shapes.Spheres(), Count, Index, T) == (ExpectedSphere >= 0));
+				if (ExpectedSphere >= 0)
+				{
+					CHECK(Index == ExpectedSphere);
+					CHECK_NEAR(T, SphereT, 1e-9);
+				}
+				CHECK(RaycastBoxes(Ray, Shapes.Boxes(), Count, Index, T) == (ExpectedBox >= 0));
+				if (ExpectedBox >= 0)
+				{
+					CHECK(Index == ExpectedBox);
+					CHECK_NEAR(T, BoxT, 1e-9);
+				}
+				CHECK(RaycastCapsules(Ray, Shapes.Capsules(), Count, Index, T) == (ExpectedCapsule >= 0));
+				if (ExpectedCapsule >= 0)
+				{
+					CHECK(Index == ExpectedCapsule);
+					CHECK_NEAR(T, CapsuleT, 1e-9);
+				}
+			}
+		}
+
+		// Shapes containing the origin all hit at 0; the first one wins
+		FTestShapeArrays Nested(16);
+		for (size_t i = 0; i < 16; ++i)
+		{
+			Nested.Vectors(0).Set(i, FVector(0, 0, 0));
+			Nested.Vectors(3).Set(i, FVector(1, 1, 1));
+			Nested.Data[6][i] = i < 5 ? 0.5 : 3.0;
+		}
+		int32_t Index = -1;
+		double T = -1.0;
+		CHECK(RaycastSpheres(FRay(FVector(2, 0, 0), FVector(1, 0, 0)), Nested.Spheres(), 16, Index, T) && Index == 5 && T == 0.0);
+		CHECK(RaycastCapsules(FRay(FVector(2, 0, 0), FVector(1, 0, 0)), Nested.Capsules(), 16, Index, T) && Index == 5 && T == 0.0);
+	});
+}
+
+TEST_CASE(Ray, BoneCapsules)
+{
+	// A root with a straight chain along X and a branch along Y
+	const int32_t Parents[] = { -1, 0, 1, 2, 0, 4 };
+	FSkeletonPose Pose;
+	CHECK(Pose.Init(Parents, 6));
+	const FVector Offsets[] = { FVector(0, 0, 0), FVector(10, 0, 0), FVector(10, 0, 0), FVector(10, 0, 0), FVector(0, 10, 0), FVector(0, 10, 0) };
+	for (size_t Bone = 0; Bone < 6; ++Bone)
+		Pose.SetLocalTransform(Bone, FTransform(FQuat(0, 0, 0, 1), Offsets[Bone], FVector(1, 1, 1)));
+	Pose.Evaluate();
+
+	const FTransform ComponentToWorld(FRotator(0, 90, 0).GetQuaternion(), FVector(100, 0, 0), FVector(1, 1, 1));
+	const double Radii[] = { 4, 2, 2, 2, 3, 3 };
+	FTestShapeArrays Capsules(6);
+	GetBoneCapsules(Pose, ComponentToWorld, Radii, Capsules.Capsules());
+
+	for (size_t Bone = 0; Bone < 6; ++Bone)
+	{
+		const FVector BoneLocation = ComponentToWorld.GetBoneWithRotation(Pose.GetComponentTransform(Bone));
+		const FVector ParentLocation = Parents[Bone] >= 0 ? ComponentToWorld.GetBoneWithRotation(Pose.GetComponentTransform(Parents[Bone])) : BoneLocation;
+		CHECK_VECTOR_NEAR(Capsules.Vectors(3).Get(Bone), BoneLocation, 1e-12);
+		CHECK_VECTOR_NEAR(Capsules.Vectors(0).Get(Bone), ParentLocation, 1e-12);
+		CHECK(Capsules.Data[6][Bone] == Radii[Bone]);
+	}
+
+	// The chain runs along world Y after the yaw; a shot across it at Y = 25 hits bone 3 (20 to 30)
+	int32_t Index = -1;
+	double T = -1.0;
+	CHECK(RaycastCapsules(FRay(FVector(100, 25, 50), FVector(0, 0, -1)), Capsules.Capsules(), 6, Index, T));
+	CHECK(Index == 3);
+	CHECK_NEAR(T, 48.0, 1e-9);
+	CHECK(!RaycastCapsules(FRay::Segment(FVector(100, 25, 50), FVector(100, 25, 10)), Capsules.Capsules(), 6, Index, T));
+}
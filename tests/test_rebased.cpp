@@ -0,0 +1,180 @@
+#include "test.h"
+#include "rebased.h"
+#include "parallel.h"
+#include <vector>
+
+// Far enough from the world origin that float world coordinates are off by up to 32 cm
+static const FVector FarOrigin(6.0e8, -7.5e8, 1.0e5);
+
+/** Count offsets in one block, X then Y then Z, and the view over them. */
+struct FRebasedStorage
+{
+	std::vector<float> Data;
+	FRebasedVectorSoA View;
+
+	FRebasedStorage(const FVector& Origin, size_t Count) : Data(3 * Count)
+	{
+		View = FRebasedVectorSoA(Origin, FVector3fSoA(Data.data(), Data.data() + Count, Data.data() + 2 * Count));
+	}
+};
+
+TEST_CASE(Rebased, RoundTrip)
+{
+	FTestRandom Random(250);
+	const size_t Count = 1000 + 3;
+	std::vector<FVector> World(Count), Resolved(Count);
+	for (FVector& Point : World)
+		Point = FarOrigin + Random.Vector(1.0e6);
+
+	FRebasedStorage Storage(FarOrigin + FVector(123.25, -0.5, 7.0), Count);
+	const FRebasedVectorSoA& Rebased = Storage.View;
+	ForEachSimdLevel([&](ESimdLevel)
+	{
+		BatchRebase(World.data(), Rebased, Count);
+		BatchResolve(Rebased, Resolved.data(), Count);
+		size_t NumMismatches = 0;
+		double MaxRelativeError = 0;
+		for (size_t i = 0; i < Count; ++i)
+		{
+			const FVector3f Offset = Rebased.ToOffset(World[i]);
+			NumMismatches += Rebased.Offsets.X[i] != Offset.X || Rebased.Offsets.Y[i] != Offset.Y || Rebased.Offsets.Z[i] != Offset.Z;
+			const FVector Expected = Rebased.ToWorld(Offset);
+			NumMismatches += Resolved[i].X != Expected.X || Resolved[i].Y != Expected.Y || Resolved[i].Z != Expected.Z;
+
+			const FVector Delta = World[i] - Rebased.Origin;
+			const double Length = std::max({ fabs(Delta.X), fabs(Delta.Y), fabs(Delta.Z) });
+			const FVector Error = Resolved[i] - World[i];
+			MaxRelativeError = std::max(MaxRelativeError, std::max({ fabs(Error.X), fabs(Error.Y), fabs(Error.Z) }) / Length);
+		}
+		CHECK(NumMismatches == 0);
+		CHECK(MaxRelativeError <= 1.0 / (1 << 24));
+	});
+
+	// Within 10 km of the origin the error stays under a millimetre; plain floats lose decimetres out here
+	const FVector Point = FarOrigin + FVector(1.0e6 + 0.3, -1.0e6 + 17.7, 5.0e5 + 2.1);
+	CHECK_VECTOR_NEAR(Rebased.ToWorld(Rebased.ToOffset(Point)), Point, 0.1);
+	const FVector3f Plain(Point);
+	CHECK(fabs((double)Plain.X - Point.X) > 1.0 || fabs((double)Plain.Y - Point.Y) > 1.0);
+}
+
+TEST_CASE(Rebased, DistanceSquared)
+{
+	FTestRandom Random(251);
+	const size_t Count = 500 + 9;
+	FRebasedStorage Storage(FarOrigin, Count);
+	for (size_t i = 0; i < Count; ++i)
+		Storage.View.Set(i, FarOrigin + Random.Vector(2.0e5));
+	const FVector Point = FarOrigin + FVector(1000.5, -20.25, 3.0);
+	const FVector3f PointOffset = Storage.View.ToOffset(Point);
+
+	std::vector<float> Out(Count);
+	FTaskScheduler Scheduler(4);
+	ForEachSimdLevel([&](ESimdLevel)
+	{
+		size_t NumMismatches = 0;
+		BatchDistanceSquared(Storage.View, Point, Out.data(), Count);
+		for (size_t i = 0; i < Count; ++i)
+		{
+			const FVector3f D = Storage.View.Offsets.Get(i) - PointOffset;
+			NumMismatches += Out[i] != (D | D);
+			const double Expected = Storage.View.Get(i).Distance(Point);
+			CHECK_NEAR(sqrt(Out[i]), Expected, 1e-6 * Expected);
+		}
+		std::vector<float> Threaded(Count);
+		BatchDistanceSquared(Storage.View, Point, Threaded.data(), Count, &Scheduler);
+		NumMismatches += Threaded != Out;
+		CHECK(NumMismatches == 0);
+	});
+}
+
+TEST_CASE(Rebased, WorldToScreenMatchesDouble)
+{
+	FTestRandom Random(252);
+	const FCamera Camera(FarOrigin + FVector(10, -20, 30), FRotator(-15, 40, 5), 75.0, 1280.0, 720.0);
+	const size_t Count = 2000 + 5;
+	std::vector<FVector> Points(Count);
+	for (FVector& Point : Points)
+		Point = Camera.Location + Random.Vector(2.0e5);
+
+	// Offsets from a point near the camera, not the camera itself
+	FRebasedStorage Storage(FarOrigin, Count);
+	BatchRebase(Points.data(), Storage.View, Count);
+
+	std::vector<FVector2f> Screen(Count);
+	std::vector<uint64_t> Mask((Count + 63) / 64), ThreadedMask(Mask.size());
+	FTaskScheduler Scheduler(4);
+	ForEachSimdLevel([&](ESimdLevel)
+	{
+		size_t NumExpectedVisible = 0, NumMismatches = 0;
+		const size_t NumVisible = BatchWorldToScreen(Camera, Storage.View, Screen.data(), Mask.data(), Count);
+		for (size_t i = 0; i < Count; ++i)
+		{
+			const bool bBatchVisible = ((Mask[i >> 6] >> (i & 63)) & 1) != 0;
+			NumExpectedVisible += bBatchVisible;
+
+			FVector2D Expected;
+			const bool bVisible = Camera.WorldToScreen(Points[i], Expected);
+			const FMatrix& M = Camera.GetViewProjectionMatrix();
+			const double W = Points[i].X * M.M[0][3] + Points[i].Y * M.M[1][3] + Points[i].Z * M.M[2][3] + M.M[3][3];
+			if (fabs(W - Camera.NearPlane) > 1.0)
+				NumMismatches += bVisible != bBatchVisible;
+			if (W > 1.0)
+			{
+				// Float rounding of terms as large as the offset, divided by W and scaled to pixels; the
+				// measured worst case is under 5 float ULPs of this
+				const double Scale = 16.0 / (1 << 24) * (Points[i] - Storage.View.Origin).Length() / W;
+				const double HalfWidth = 0.5 * Camera.ViewportWidth, HalfHeight = 0.5 * Camera.ViewportHeight;
+				CHECK_NEAR(Screen[i].X, Expected.X, Scale * (HalfWidth + fabs(Expected.X - HalfWidth)));
+				CHECK_NEAR(Screen[i].Y, Expected.Y, Scale * (HalfWidth + fabs(Expected.Y - HalfHeight)));
+			}
+		}
+		CHECK(NumVisible == NumExpectedVisible);
+		CHECK(NumMismatches == 0);
+
+		CHECK(BatchWorldToScreen(Camera, Storage.View, Screen.data(), ThreadedMask.data(), Count, &Scheduler) == NumVisible);
+		CHECK(ThreadedMask == Mask);
+	});
+}
+
+TEST_CASE(Rebased, CullSpheresMatchesDouble)
+{
+	FTestRandom Random(253);
+	const FCamera Camera(FarOrigin, FRotator(10, -70, 0), 90.0, 1920.0, 1080.0);
+	const FFrustum Frustum = Camera.GetFrustum(1.0e5);
+	const size_t Count = 2000 + 11;
+	FRebasedStorage Storage(FarOrigin + FVector(5000, 5000, 0), Count);
+	std::vector<float> Radii(Count);
+	std::vector<FSphere> Spheres(Count);
+	for (size_t i = 0; i < Count; ++i)
+	{
+		Storage.View.Set(i, Camera.Location + Random.Vector(1.5e5));
+		Radii[i] = (float)Random.Range(0, 5000);
+		Spheres[i] = FSphere(Storage.View.Get(i), Radii[i]);
+	}
+
+	std::vector<uint64_t> Mask((Count + 63) / 64), ThreadedMask(Mask.size());
+	FTaskScheduler Scheduler(4);
+	ForEachSimdLevel([&](ESimdLevel)
+	{
+		size_t NumExpectedVisible = 0, NumMismatches = 0;
+		const size_t NumVisible = BatchCullSpheres(Frustum, Storage.View, Radii.data(), Mask.data(), Count);
+		for (size_t i = 0; i < Count; ++i)
+		{
+			const bool bBatchVisible = ((Mask[i >> 6] >> (i & 63)) & 1) != 0;
+			NumExpectedVisible += bBatchVisible;
+
+			// Spheres touching a plane to within float rounding may go either way
+			double Margin = 1e30;
+			for (int Plane = 0; Plane < Frustum.NumPlanes; ++Plane)
+				Margin = std::min(Margin, fabs((Frustum.Normals[Plane] | Spheres[i].Center) + Frustum.Offsets[Plane] + Spheres[i].W));
+			if (Margin > 1.0)
+				NumMismatches += Frustum.IntersectsSphere(Spheres[i]) != bBatchVisible;
+		}
+		CHECK(NumVisible == NumExpectedVisible);
+		CHECK(NumMismatches == 0);
+		CHECK(NumVisible > 0 && NumVisible < Count);
+
+		CHECK(BatchCullSpheres(Frustum, Storage.View, Radii.data(), ThreadedMask.data(), Count, &Scheduler) == NumVisible);
+		CHECK(ThreadedMask == Mask);
+	});
+}
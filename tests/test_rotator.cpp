@@ -0,0 +1,62 @@
+#include "test.h"
+#include "rotator.h"
+#include "quat.h"
+#include "matrix.h"
+
+static_assert(FRotator::NormalizeAxis(270) == -90, "constexpr NormalizeAxis");
+
+TEST_CASE(Rotator, NormalizeAndClamp)
+{
+	CHECK(FRotator::NormalizeAxis(190) == -170);
+	CHECK(FRotator::NormalizeAxis(-190) == 170);
+	CHECK(FRotator::NormalizeAxis(45) == 45);
+
+	FRotator R(100, 350, -200);
+	R.Clamp();
+	CHECK(R.Pitch == 75 && R.Yaw == -10 && R.Roll == 160);
+}
+
+TEST_CASE(Rotator, QuatRoundTrip)
+{
+	FTestRandom Random(3);
+	for (int i = 0; i < 200; ++i)
+	{
+		const FRotator R(Random.Range(-89, 89), Random.Range(-179, 179), Random.Range(-179, 179));
+		const FRotator Back(R.GetQuaternion());
+		CHECK_NEAR(Back.Pitch, R.Pitch, 1e-9);
+		CHECK_NEAR(Back.Yaw, R.Yaw, 1e-9);
+		CHECK_NEAR(Back.Roll, R.Roll, 1e-9);
+	}
+
+	// Gimbal lock folds yaw and roll together but keeps the rotation
+	const FQuat Locked = FRotator(90, 30, 10).GetQuaternion();
+	const FRotator Back(Locked);
+	CHECK(Back.Pitch == 90);
+	CHECK_VECTOR_NEAR(Back.GetQuaternion().RotateVector(FVector(1, 2, 3)), Locked.RotateVector(FVector(1, 2, 3)), 1e-9);
+}
+
+TEST_CASE(Rotator, MatrixMatchesQuat)
+{
+	FTestRandom Random(5);
+	for (int i = 0; i < 100; ++i)
+	{
+		const FRotator R(Random.Range(-180, 180), Random.Range(-720, 720), Random.Range(-180, 180));
+		const FMatrix M = R.GetMatrix(FVector(1, 2, 3));
+		const FQuat Q = R.GetQuaternion();
+		CHECK_VECTOR_NEAR(M.GetScaledAxisX(), Q.RotateVector(FVector(1, 0, 0)), 1e-12);
+		CHECK_VECTOR_NEAR(M.GetScaledAxisY(), Q.RotateVector(FVector(0, 1, 0)), 1e-12);
+		CHECK_VECTOR_NEAR(M.GetScaledAxisZ(), Q.RotateVector(FVector(0, 0, 1)), 1e-12);
+		CHECK(M.GetOrigin() == FVector(1, 2, 3));
+		CHECK_VECTOR_NEAR(R.GetUnitVector(), M.GetScaledAxisX(), 1e-15);
+	}
+}
+
+TEST_CASE(Rotator, Arithmetic)
+{
+	const FRotator A(10, 20, 30), B(1, 2, 3);
+	CHECK(A + B == FRotator(11, 22, 33));
+	CHECK(A - B == FRotator(9, 18, 27));
+	CHECK(A * 2.0 == FRotator(20, 40, 60));
+	CHECK(A * B == 140);
+	CHECK(-A == FRotator(-10, -20, -30));
+}
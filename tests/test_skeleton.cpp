@@ -0,0 +1,77 @@
+#include "test.h"
+#include "skeleton.h"
+#include <vector>
+
+static FTransform RandomTransform(FTestRandom& Random)
+{
+	return FTransform(
+		Random.Quat(),
+		Random.Vector(50),
+		FVector(1, 1, 1));
+}
+
+static bool SameTransform(const FTransform& A, const FTransform& B)
+{
+	return A.Rotation.X == B.Rotation.X && A.Rotation.Y == B.Rotation.Y && A.Rotation.Z == B.Rotation.Z && A.Rotation.W == B.Rotation.W
+		&& A.Translation == B.Translation && A.Scale3D == B.Scale3D;
+}
+
+TEST_CASE(Skeleton, InitRejectsUnsortedParents)
+{
+	FSkeletonPose Pose;
+	const int32_t Bad[] = { -1, 2, 0 };
+	CHECK(!Pose.Init(Bad, 3));
+	CHECK(Pose.Num() == 0);
+
+	const int32_t Good[] = { -1, 0, 0, 1 };
+	CHECK(Pose.Init(Good, 4));
+	CHECK(Pose.Num() == 4 && Pose.GetParentIndex(3) == 1);
+}
+
+TEST_CASE(Skeleton, EvaluateMatchesHierarchy)
+{
+	FTestRandom Random(73);
+	const size_t NumBones = 200;
+	std::vector<int32_t> Parents(NumBones);
+	for (size_t i = 0; i < NumBones; ++i)
+		Parents[i] = i == 0 ? -1 : (int32_t)(Random.Next() % i);
+
+	FSkeletonPose Pose;
+	CHECK(Pose.Init(Parents.data(), NumBones));
+	std::vector<FTransform> Locals(NumBones);
+	for (size_t i = 0; i < NumBones; ++i)
+	{
+		Locals[i] = RandomTransform(Random);
+		Pose.SetLocalTransform(i, Locals[i]);
+	}
+	CHECK(Pose.Evaluate() == NumBones);
+	CHECK(Pose.Evaluate() == 0);
+
+	std::vector<FTransform> Expected(NumBones);
+	for (size_t i = 0; i < NumBones; ++i)
+	{
+		if (Parents[i] < 0)
+			Expected[i] = Locals[i];
+		else
+			FTransform::Multiply(&Expected[i], &Locals[i], &Expected[Parents[i]]);
+		CHECK(SameTransform(Pose.GetComponentTransform(i), Expected[i]));
+	}
+
+	// Changing one bone recomputes exactly its subtree
+	size_t SubtreeSize = 0;
+	std::vector<bool> InSubtree(NumBones, false);
+	for (size_t i = 5; i < NumBones; ++i)
+	{
+		InSubtree[i] = i == 5 || (Parents[i] >= 0 && InSubtree[Parents[i]]);
+		SubtreeSize += InSubtree[i];
+	}
+	Pose.SetLocalTransform(5, RandomTransform(Random));
+	CHECK(Pose.IsDirty(5));
+	CHECK(Pose.Evaluate() == SubtreeSize);
+
+	std::vector<double> X(NumBones), Y(NumBones), Z(NumBones);
+	const FTransform ComponentToWorld = RandomTransform(Random);
+	Pose.GetWorldLocations(ComponentToWorld, FVectorSoA(X.data(), Y.data(), Z.data()));
+	for (size_t i = 0; i < NumBones; ++i)
+		CHECK(FVector(X[i], Y[i], Z[i]) == ComponentToWorld.GetBoneWithRotation(Pose.GetComponentTransform(i)));
+}
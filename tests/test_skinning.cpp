@@ -0,0 +1,157 @@
+#include "test.h"
+#include "skinning.h"
+#include "parallel.h"
+#include "rotator.h"
+#include <vector>
+
+/** One to four random influences with weights summing to 1, unused slots at weight 0. */
+static FSkinWeightInfo RandomWeights(FTestRandom& Random, size_t NumBones)
+{
+	FSkinWeightInfo Info;
+	const int NumInfluences = 1 + (int)Random.Range(0, 3.999);
+	float Sum = 0;
+	for (int Influence = 0; Influence < MaxSkinInfluences; ++Influence)
+	{
+		Info.InfluenceBones[Influence] = (uint16_t)Random.Range(0, NumBones - 0.001);
+		Info.InfluenceWeights[Influence] = Influence < NumInfluences ? (float)Random.Range(0.1, 1) : 0.0f;
+		Sum += Info.InfluenceWeights[Influence];
+	}
+	for (float& Weight : Info.InfluenceWeights)
+		Weight /= Sum;
+	return Info;
+}
+
+TEST_CASE(Skinning, Palettes)
+{
+	FTestRandom Random(210);
+	const size_t NumBones = 8;
+	std::vector<FTransform> Bind(NumBones), Pose(NumBones), InverseBind(NumBones);
+	std::vector<FMatrix> InverseBindMatrices(NumBones), Matrices(NumBones);
+	std::vector<FDualQuat> DualQuats(NumBones);
+	for (size_t i = 0; i < NumBones; ++i)
+	{
+		Bind[i] = FTransform(Random.Quat(), Random.Vector(100), FVector(1, 1, 1));
+		Pose[i] = FTransform(Random.Quat(), Random.Vector(100), FVector(1, 1, 1));
+		InverseBind[i] = FTransform(Bind[i].Rotation.Inverse(), Bind[i].Rotation.Inverse().RotateVector(Bind[i].Translation) * -1.0, FVector(1, 1, 1));
+		InverseBindMatrices[i] = Bind[i].ToMatrixWithScale().Inverse();
+	}
+	BuildSkinningMatrices(Pose.data(), InverseBindMatrices.data(), Matrices.data(), NumBones);
+	BuildSkinningDualQuats(Pose.data(), InverseBind.data(), DualQuats.data(), NumBones);
+
+	// A vertex on one bone at its bind position follows the bone to its posed position
+	std::vector<double> Positions(NumBones * 3), Skinned(NumBones * 3);
+	FVectorSoA In(Positions.data(), Positions.data() + NumBones, Positions.data() + 2 * NumBones);
+	const FVectorSoA Out(Skinned.data(), Skinned.data() + NumBones, Skinned.data() + 2 * NumBones);
+	std::vector<FSkinWeightInfo> Weights(NumBones);
+	const FVector Local(10, -20, 30);
+	for (size_t i = 0; i < NumBones; ++i)
+	{
+		In.Set(i, Bind[i].Rotation.RotateVector(Local) + Bind[i].Translation);
+		Weights[i] = { { (uint16_t)i, (uint16_t)i, 0, 0 }, { 1.0f, 0.0f, 0.0f, 0.0f } };
+	}
+	BatchSkinPositions(Matrices.data(), Weights.data(), In, Out, NumBones);
+	for (size_t i = 0; i < NumBones; ++i)
+		CHECK_VECTOR_NEAR(Out.Get(i), Pose[i].Rotation.RotateVector(Local) + Pose[i].Translation, 1e-9);
+	BatchSkinPositions(DualQuats.data(), Weights.data(), In, Out, NumBones);
+	for (size_t i = 0; i < NumBones; ++i)
+		CHECK_VECTOR_NEAR(Out.Get(i), Pose[i].Rotation.RotateVector(Local) + Pose[i].Translation, 1e-9);
+}
+
+TEST_CASE(Skinning, TwistKeepsVolumeWithDualQuats)
+{
+	// Half way between no twist and a half turn about X: the linear blend collapses to the axis
+	const FTransform Pose[2] = { FTransform(), FTransform(FRotator(0, 0, 180).GetQuaternion(), FVector(0, 0, 0), FVector(1, 1, 1)) };
+	const FMatrix InverseBind[2];
+	const FTransform InverseBindTransforms[2];
+	FMatrix Matrices[2];
+	FDualQuat DualQuats[2];
+	BuildSkinningMatrices(Pose, InverseBind, Matrices, 2);
+	BuildSkinningDualQuats(Pose, InverseBindTransforms, DualQuats, 2);
+
+	double X = 5, Y = 1, Z = 0;
+	const FSkinWeightInfo Weights = { { 0, 1, 0, 0 }, { 0.5f, 0.5f, 0.0f, 0.0f } };
+	BatchSkinPositions(Matrices, &Weights, FVectorSoA(&X, &Y, &Z), FVectorSoA(&X, &Y, &Z), 1);
+	CHECK_VECTOR_NEAR(FVector(X, Y, Z), FVector(5, 0, 0), 1e-12);
+
+	X = 5, Y = 1, Z = 0;
+	BatchSkinPositions(DualQuats, &Weights, FVectorSoA(&X, &Y, &Z), FVectorSoA(&X, &Y, &Z), 1);
+	CHECK_NEAR(X, 5.0, 1e-12);
+	CHECK_NEAR(Y * Y + Z * Z, 1.0, 1e-12);
+}
+
+TEST_CASE(Skinning, BatchMatchesScalar)
+{
+	FTestRandom Random(211);
+	const size_t NumBones = 64;
+	const size_t Count = 10000 + 3;
+	std::vector<FMatrix> Matrices(NumBones);
+	std::vector<FDualQuat> DualQuats(NumBones);
+	for (size_t i = 0; i < NumBones; ++i)
+	{
+		const FTransform Bone(Random.Quat(), Random.Vector(100), Random.Vector(0.5, 2));
+		Matrices[i] = Bone.ToMatrixWithScale();
+		DualQuats[i] = FDualQuat(Bone);
+	}
+	std::vector<FSkinWeightInfo> Weights(Count);
+	for (FSkinWeightInfo& Info : Weights)
+		Info = RandomWeights(Random, NumBones);
+	// Opposite influences whose blend vanishes, which dual quaternion skinning maps to the identity
+	DualQuats[1] = FDualQuat(DualQuats[0].Real * -1.0, DualQuats[0].Dual * -1.0);
+	Weights[5] = { { 0, 1, 0, 0 }, { 0.5f, -0.5f, 0.0f, 0.0f } };
+
+	std::vector<double> Positions(Count * 3), Expected(Count * 3), ExpectedDualQuat(Count * 3), Skinned(Count * 3);
+	for (double& Value : Positions)
+		Value = Random.Range(-100, 100);
+	const auto MakeSoA = [Count](std::vector<double>& Data) { return FVectorSoA(Data.data(), Data.data() + Count, Data.data() + 2 * Count); };
+	const FVectorSoA In = MakeSoA(Positions), Out = MakeSoA(Skinned);
+
+	size_t NumMismatches = 0;
+	FTaskScheduler Scheduler(4);
+	ForEachSimdLevel([&](ESimdLevel Level)
+	{
+		// The scalar level runs first and is the reference
+		BatchSkinPositions(Matrices.data(), Weights.data(), In, Out, Count);
+		if (Level == ESimdLevel::Scalar)
+			Expected = Skinned;
+		NumMismatches += Skinned != Expected;
+
+		BatchSkinPositions(DualQuats.data(), Weights.data(), In, Out, Count);
+		if (Level == ESimdLevel::Scalar)
+			ExpectedDualQuat = Skinned;
+		NumMismatches += Skinned != ExpectedDualQuat;
+
+		// Threaded and in place
+		BatchSkinPositions(Matrices.data(), Weights.data(), In, Out, Count, &Scheduler);
+		NumMismatches += Skinned != Expected;
+		std::vector<double> InPlace = Positions;
+		BatchSkinPositions(DualQuats.data(), Weights.data(), MakeSoA(InPlace), MakeSoA(InPlace), Count, &Scheduler);
+		NumMismatches += InPlace != ExpectedDualQuat;
+	});
+	CHECK(NumMismatches == 0);
+
+	// The scalar results against the definitions
+	double MaxError = 0;
+	for (size_t i = 0; i < Count; ++i)
+	{
+		const FVector P = In.Get(i);
+		FVector Linear(0, 0, 0);
+		FDualQuat Influences[MaxSkinInfluences];
+		double InfluenceWeights[MaxSkinInfluences];
+		for (int Influence = 0; Influence < MaxSkinInfluences; ++Influence)
+		{
+			const FMatrix& M = Matrices[Weights[i].InfluenceBones[Influence]];
+			const FVector Transformed(P.X * M.M[0][0] + P.Y * M.M[1][0] + P.Z * M.M[2][0] + M.M[3][0],
+				P.X * M.M[0][1] + P.Y * M.M[1][1] + P.Z * M.M[2][1] + M.M[3][1],
+				P.X * M.M[0][2] + P.Y * M.M[1][2] + P.Z * M.M[2][2] + M.M[3][2]);
+			Linear = Linear + Transformed * (double)Weights[i].InfluenceWeights[Influence];
+			Influences[Influence] = DualQuats[Weights[i].InfluenceBones[Influence]];
+			InfluenceWeights[Influence] = Weights[i].InfluenceWeights[Influence];
+		}
+		const FVector Dual = FDualQuat::Blend(Influences, InfluenceWeights, MaxSkinInfluences).TransformPosition(P);
+		MaxError = std::max({ MaxError, fabs(Linear.X - Expected[i]), fabs(Linear.Y - Expected[Count + i]), fabs(Linear.Z - Expected[2 * Count + i]) });
+		NumMismatches += Dual.X != ExpectedDualQuat[i] || Dual.Y != ExpectedDualQuat[Count + i] || Dual.Z != ExpectedDualQuat[2 * Count + i];
+	}
+	CHECK(MaxError < 1e-9);
+	CHECK(NumMismatches == 0);
+	CHECK(ExpectedDualQuat[5] == Positions[5]);
+}
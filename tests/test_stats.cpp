@@ -0,0 +1,64 @@
+#include "test.h"
+#include "stats.h"
+#include "matrix.h"
+#include "rotator.h"
+#include "transform.h"
+#include <thread>
+
+static uint64_t SumHistogram(const FMathStatCounters& Counters)
+{
+	uint64_t Sum = 0;
+	for (uint64_t Bucket : Counters.Histogram)
+		Sum += Bucket;
+	return Sum;
+}
+
+TEST_CASE(Stats, CountsCallsAndSlowPaths)
+{
+	ResetMathStats();
+	const FTransform Positive(FRotator(10, 20, 30).GetQuaternion(), FVector(1, 2, 3), FVector(1, 2, 3));
+	const FTransform Negative(FRotator(-40, 5, 60).GetQuaternion(), FVector(4, 5, 6), FVector(-1, 2, 1));
+
+	FTransform Out;
+	for (int i = 0; i < 10; ++i)
+		FTransform::Multiply(&Out, &Positive, &Positive);
+	for (int i = 0; i < 3; ++i)
+		FTransform::Multiply(&Out, &Positive, &Negative);
+	Out = Positive.GetRelativeTransform(Negative);
+	FMatrix Zero;
+	memset(Zero.M, 0, sizeof(Zero.M));
+	CHECK(Zero.Inverse().M[0][0] == 1.0);
+
+	// Calls made on another thread are counted after it exits
+	std::thread([&]() { FTransform Local; FTransform::Multiply(&Local, &Negative, &Negative); }).join();
+
+	FMathStatCounters Multiply, UsingMatrix, Relative, RelativeUsingMatrix, Inverse;
+	GetMathStats(EMathStat::TransformMultiply, Multiply);
+	GetMathStats(EMathStat::TransformMultiplyUsingMatrixWithScale, UsingMatrix);
+	GetMathStats(EMathStat::TransformGetRelativeTransform, Relative);
+	GetMathStats(EMathStat::TransformGetRelativeTransformUsingMatrixWithScale, RelativeUsingMatrix);
+	GetMathStats(EMathStat::MatrixInverse, Inverse);
+#if UE_MATH_STATS
+	CHECK(Multiply.Calls == 14 && Multiply.SlowPathHits == 4);
+	CHECK(UsingMatrix.Calls == 4 && UsingMatrix.SlowPathHits == 0);
+	CHECK(Relative.Calls == 1 && Relative.SlowPathHits == 1);
+	CHECK(RelativeUsingMatrix.Calls == 1);
+	// The zero matrix takes the zero scale fallback
+	CHECK(Inverse.Calls == 1 && Inverse.SlowPathHits == 1);
+	CHECK(SumHistogram(Multiply) == Multiply.Calls);
+#else
+	CHECK(Multiply.Calls == 0 && Multiply.SlowPathHits == 0 && SumHistogram(Multiply) == 0);
+	CHECK(UsingMatrix.Calls == 0 && Relative.Calls == 0 && RelativeUsingMatrix.Calls == 0 && Inverse.Calls == 0);
+#endif
+
+	ResetMathStats();
+	GetMathStats(EMathStat::TransformMultiply, Multiply);
+	CHECK(Multiply.Calls == 0 && Multiply.SlowPathHits == 0 && Multiply.TotalTicks == 0 && SumHistogram(Multiply) == 0);
+}
+
+TEST_CASE(Stats, Names)
+{
+	for (int Stat = 0; Stat < (int)EMathStat::Num; ++Stat)
+		CHECK(strcmp(GetMathStatName((EMathStat)Stat), "?") != 0);
+	CHECK(strcmp(GetMathStatName(EMathStat::MatrixInverse), "FMatrix::Inverse") == 0);
+}
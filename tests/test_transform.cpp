@@ -0,0 +1,81 @@
+#include "test.h"
+#include "transform.h"
+#include "rotator.h"
+#include "matrix.h"
+
+static FTransform RandomTransform(FTestRandom& Random, double MinScale = 0.5, double MaxScale = 2)
+{
+	return FTransform(
+		Random.Quat(),
+		Random.Vector(100),
+		FVector(Random.Range(MinScale, MaxScale), Random.Range(MinScale, MaxScale), Random.Range(MinScale, MaxScale)));
+}
+
+static FVector TransformPosition(const FTransform& T, const FVector& P)
+{
+	return T.GetBoneWithRotation(FTransform(FQuat(), P, FVector(1, 1, 1)));
+}
+
+TEST_CASE(Transform, GetBoneWithRotationMatchesMatrix)
+{
+	FTestRandom Random(29);
+	for (int i = 0; i < 100; ++i)
+	{
+		const FTransform T = RandomTransform(Random);
+		const FMatrix M = T.ToMatrixWithScale();
+		const FVector P = Random.Vector(10);
+		const FVector FromMatrix(
+			P.X * M.M[0][0] + P.Y * M.M[1][0] + P.Z * M.M[2][0] + M.M[3][0],
+			P.X * M.M[0][1] + P.Y * M.M[1][1] + P.Z * M.M[2][1] + M.M[3][1],
+			P.X * M.M[0][2] + P.Y * M.M[1][2] + P.Z * M.M[2][2] + M.M[3][2]);
+		CHECK_VECTOR_NEAR(TransformPosition(T, P), FromMatrix, 1e-10);
+	}
+}
+
+TEST_CASE(Transform, MultiplyAppliesLeftFirst)
+{
+	FTestRandom Random(31);
+	for (int i = 0; i < 100; ++i)
+	{
+		// Uniform scale keeps the composition exactly representable as a transform
+		const double S = Random.Range(0.5, 2);
+		FTransform A = RandomTransform(Random);
+		const FTransform B(RandomTransform(Random).Rotation, FVector(Random.Range(-50, 50), 0, 1), FVector(S, S, S));
+		const FVector P = Random.Vector(10);
+		CHECK_VECTOR_NEAR(TransformPosition(A * B, P), TransformPosition(B, TransformPosition(A, P)), 1e-9);
+	}
+}
+
+TEST_CASE(Transform, NegativeScaleUsesMatrixPath)
+{
+	FTestRandom Random(37);
+	FTransform A = RandomTransform(Random);
+	A.Scale3D.X = -A.Scale3D.X;
+	const FTransform B = RandomTransform(Random, 1, 1);
+	const FVector P(1, 2, 3);
+	CHECK(FTransform::AnyHasNegativeScale(A.Scale3D, B.Scale3D));
+	CHECK_VECTOR_NEAR(TransformPosition(A * B, P), TransformPosition(B, TransformPosition(A, P)), 1e-9);
+}
+
+TEST_CASE(Transform, RelativeAndInverse)
+{
+	FTestRandom Random(41);
+	for (int i = 0; i < 100; ++i)
+	{
+		FTransform A = RandomTransform(Random);
+		FTransform B = RandomTransform(Random, 1, 1);
+		// (A * B).GetRelativeTransform(B) recovers A
+		const FTransform Relative = (A * B).GetRelativeTransform(B);
+		const FVector P = Random.Vector(10);
+		CHECK_VECTOR_NEAR(TransformPosition(Relative, P), TransformPosition(A, P), 1e-9);
+
+		const FTransform Inverse = B.Inverse();
+		CHECK_VECTOR_NEAR(TransformPosition(Inverse, TransformPosition(B, P)), P, 1e-9);
+	}
+}
+
+TEST_CASE(Transform, SafeScaleReciprocal)
+{
+	const FVector R = FTransform::GetSafeScaleReciprocal(FVector(2, 0, -4));
+	CHECK(R == FVector(0.5, 0, -0.25));
+}
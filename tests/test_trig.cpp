@@ -0,0 +1,184 @@
+#include "test.h"
+#include "trig.h"
+#include <vector>
+
+/** Distance of Value from Reference in units of the last place of the double nearest Reference. */
+static double UlpError(double Value, long double Reference)
+{
+	const double Rounded = (double)Reference;
+	const double Ulp = Rounded == 0 ? 4.9406564584124654e-324 : nextafter(fabs(Rounded), INFINITY) - fabs(Rounded);
+	return (double)(fabsl((long double)Value - Reference) / Ulp);
+}
+
+static void ReferenceSinCosDegrees(double Degrees, long double& OutSin, long double& OutCos)
+{
+	// Exact reduction by multiples of 90 degrees, as the kernel does
+	const double Quadrant = nearbyint(Degrees / 90.0);
+	const long double Radians = (long double)(Degrees - 90.0 * Quadrant) * (3.14159265358979323846264338327950288L / 180.0L);
+	const long double S = sinl(Radians), C = cosl(Radians);
+	switch ((int64_t)Quadrant & 3)
+	{
+	case 0: OutSin = S; OutCos = C; break;
+	case 1: OutSin = C; OutCos = -S; break;
+	case 2: OutSin = -S; OutCos = -C; break;
+	default: OutSin = -C; OutCos = S; break;
+	}
+}
+
+TEST_CASE(Trig, SinCosPrecise)
+{
+	FTestRandom Random(59);
+	const size_t Count = 20000 + 3;
+	std::vector<double> Input(Count), OutSin(Count), OutCos(Count);
+	for (size_t i = 0; i < Count; ++i)
+		Input[i] = i < Count / 2 ? Random.Range(-10, 10) : Random.Range(-1e5, 1e5);
+
+	ForEachSimdLevel([&](ESimdLevel)
+	{
+		BatchSinCos(Input.data(), OutSin.data(), OutCos.data(), Count);
+		double MaxError = 0;
+		for (size_t i = 0; i < Count; ++i)
+		{
+			MaxError = std::max(MaxError, UlpError(OutSin[i], sinl((long double)Input[i])));
+			MaxError = std::max(MaxError, UlpError(OutCos[i], cosl((long double)Input[i])));
+		}
+		CHECK(MaxError <= 2.5);
+	});
+}
+
+TEST_CASE(Trig, SinCosDegreesPrecise)
+{
+	FTestRandom Random(61);
+	const size_t Count = 20000 + 5;
+	std::vector<double> Input(Count), OutSin(Count), OutCos(Count);
+	for (size_t i = 0; i < Count; ++i)
+		Input[i] = i < 8 ? 90.0 * (double)i - 180.0 : Random.Range(-1e6, 1e6);
+
+	ForEachSimdLevel([&](ESimdLevel)
+	{
+		BatchSinCosDegrees(Input.data(), OutSin.data(), OutCos.data(), Count);
+		double MaxError = 0;
+		for (size_t i = 0; i < Count; ++i)
+		{
+			long double S, C;
+			ReferenceSinCosDegrees(Input[i], S, C);
+			MaxError = std::max(MaxError, std::max(UlpError(OutSin[i], S), UlpError(OutCos[i], C)));
+		}
+		CHECK(MaxError <= 2);
+		// Multiples of 90 degrees come out exact
+		CHECK(OutSin[1] == -1 && OutCos[2] == 1 && OutSin[2] == 0 && OutSin[3] == 1);
+	});
+}
+
+TEST_CASE(Trig, Atan2AndAsinPrecise)
+{
+	FTestRandom Random(67);
+	const size_t Count = 20000 + 1;
+	std::vector<double> Y(Count), X(Count), Sines(Count), Out(Count);
+	for (size_t i = 0; i < Count; ++i)
+	{
+		Y[i] = Random.Range(-100, 100);
+		X[i] = Random.Range(-100, 100);
+		Sines[i] = Random.Range(-1, 1);
+	}
+	// Signed zero and axis cases follow libm
+	const double Special[][2] = { { 0.0, -1.0 }, { -0.0, -1.0 }, { 1.0, 0.0 }, { -1.0, 0.0 }, { 0.0, 0.0 }, { -0.0, -0.0 } };
+	for (size_t i = 0; i < sizeof(Special) / sizeof(Special[0]); ++i)
+	{
+		Y[i] = Special[i][0];
+		X[i] = Special[i][1];
+	}
+
+	ForEachSimdLevel([&](ESimdLevel)
+	{
+		BatchAtan2(Y.data(), X.data(), Out.data(), Count);
+		double MaxError = 0;
+		for (size_t i = 0; i < Count; ++i)
+			MaxError = std::max(MaxError, UlpError(Out[i], atan2l((long double)Y[i], (long double)X[i])));
+		CHECK(MaxError <= 2);
+		for (size_t i = 0; i < sizeof(Special) / sizeof(Special[0]); ++i)
+			CHECK(Out[i] == atan2(Y[i], X[i]) && signbit(Out[i]) == signbit(atan2(Y[i], X[i])));
+
+		BatchAsin(Sines.data(), Out.data(), Count);
+		MaxError = 0;
+		for (size_t i = 0; i < Count; ++i)
+			MaxError = std::max(MaxError, UlpError(Out[i], asinl((long double)Sines[i])));
+		CHECK(MaxError <= 2.5);
+	});
+}
+
+TEST_CASE(Trig, FastTier)
+{
+	FTestRandom Random(71);
+	const size_t Count = 10000;
+	std::vector<double> A(Count), B(Count), OutA(Count), OutB(Count);
+	for (size_t i = 0; i < Count; ++i)
+	{
+		A[i] = Random.Range(-1000, 1000);
+		B[i] = Random.Range(-1, 1);
+	}
+
+	ForEachSimdLevel([&](ESimdLevel)
+	{
+		double MaxError = 0;
+		BatchSinCos(A.data(), OutA.data(), OutB.data(), Count, ETrigAccuracy::Fast);
+		for (size_t i = 0; i < Count; ++i)
+			MaxError = std::max(MaxError, std::max(fabs(OutA[i] - sin(A[i])), fabs(OutB[i] - cos(A[i]))));
+		CHECK(MaxError < 3e-9);
+
+		MaxError = 0;
+		BatchAtan2(A.data(), B.data(), OutA.data(), Count, ETrigAccuracy::Fast);
+		BatchAsin(B.data(), OutB.data(), Count, ETrigAccuracy::Fast);
+		for (size_t i = 0; i < Count; ++i)
+			MaxError = std::max(MaxError, std::max(fabs(OutA[i] - atan2(A[i], B[i])), fabs(OutB[i] - asin(B[i]))));
+		CHECK(MaxError < 1e-8);
+	});
+}
+
+TEST_CASE(Trig, NonFiniteAndHugeInput)
+{
+	// Every value twice, so both the vector loops and the scalar tails see it
+	const double Special[] = { NAN, INFINITY, -INFINITY, 1e300, -1e300, 0.5 };
+	std::vector<double> Input;
+	for (int Repeat = 0; Repeat < 2; ++Repeat)
+		for (int Lane = 0; Lane < 8; ++Lane)
+			for (double Value : Special)
+				Input.push_back(Value);
+	Input.resize(Input.size() + 3, 0.5);
+	const size_t Count = Input.size();
+	std::vector<double> OutSin(Count), OutCos(Count);
+
+	for (ETrigAccuracy Accuracy : { ETrigAccuracy::Precise, ETrigAccuracy::Fast })
+	{
+		ForEachSimdLevel([&](ESimdLevel)
+		{
+			// 1e300 is far outside the accurate range; it only has to stay well defined
+			for (bool bDegrees : { false, true })
+			{
+				if (bDegrees)
+					BatchSinCosDegrees(Input.data(), OutSin.data(), OutCos.data(), Count, Accuracy);
+				else
+					BatchSinCos(Input.data(), OutSin.data(), OutCos.data(), Count, Accuracy);
+				size_t NumMismatches = 0;
+				for (size_t i = 0; i < Count; ++i)
+				{
+					if (!std::isfinite(Input[i]))
+						NumMismatches += !std::isnan(OutSin[i]) || !std::isnan(OutCos[i]);
+					else if (Input[i] == 0.5)
+						NumMismatches += fabs(OutSin[i] - (bDegrees ? sin(0.5 * PI / 180) : sin(0.5))) > 1e-8;
+				}
+				CHECK(NumMismatches == 0);
+			}
+		});
+	}
+}
+
+TEST_CASE(Trig, InPlace)
+{
+	std::vector<double> Values = { 0.5, -1.25, 3.0, 100.0, -7.5 };
+	std::vector<double> Cosines(Values.size());
+	const std::vector<double> Input = Values;
+	BatchSinCos(Values.data(), Values.data(), Cosines.data(), Values.size());
+	for (size_t i = 0; i < Values.size(); ++i)
+		CHECK_NEAR(Values[i], sin(Input[i]), 1e-15);
+}
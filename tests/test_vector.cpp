@@ -0,0 +1,73 @@
+#include "test.h"
+#include "vector.h"
+#include "rotator.h"
+
+static_assert(FVector(1, 2, 3).DotProduct(FVector(4, 5, 6)) == 32, "constexpr DotProduct");
+static_assert((FVector(1, 0, 0) ^ FVector(0, 1, 0)) == FVector(0, 0, 1), "constexpr CrossProduct");
+
+TEST_CASE(Vector, Arithmetic)
+{
+	const FVector A(1, -2, 3), B(4, 5, -6);
+	CHECK(A + B == FVector(5, 3, -3));
+	CHECK(A - B == FVector(-3, -7, 9));
+	CHECK(A * B == FVector(4, -10, -18));
+	CHECK(A * 2.0 == FVector(2, -4, 6));
+	CHECK(2.0 * A == FVector(2, -4, 6));
+	CHECK(-A == FVector(-1, 2, -3));
+	CHECK((A | B) == -24);
+	CHECK(A.Min(B) == FVector(1, -2, -6));
+	CHECK(A.Max(B) == FVector(4, 5, 3));
+	CHECK(A.GetSignVector() == FVector(1, -1, 1));
+}
+
+TEST_CASE(Vector, CrossProductIsOrthogonal)
+{
+	FTestRandom Random;
+	for (int i = 0; i < 100; ++i)
+	{
+		const FVector A = Random.Vector(10);
+		const FVector B = Random.Vector(10);
+		const FVector C = A ^ B;
+		CHECK_NEAR(C | A, 0, 1e-10);
+		CHECK_NEAR(C | B, 0, 1e-10);
+	}
+}
+
+TEST_CASE(Vector, LengthAndNormalize)
+{
+	FVector V(3, 4, 12);
+	CHECK(V.Length() == 13);
+	CHECK(V.Distance(FVector(0, 0, 0)) == 13);
+	V.Normalize();
+	CHECK_NEAR(V.Length(), 1, 1e-15);
+	CHECK_VECTOR_NEAR(V, FVector(3.0 / 13, 4.0 / 13, 12.0 / 13), 1e-15);
+	CHECK(FVector(1e-5, -1e-5, 0).IsNearlyZero());
+	CHECK(!FVector(1e-3, 0, 0).IsNearlyZero());
+}
+
+TEST_CASE(Vector, DirectionRotator)
+{
+	const FRotator R = FVector(1, 1, 0).GetDirectionRotator();
+	CHECK_NEAR(R.Pitch, 0, 1e-12);
+	CHECK_NEAR(R.Yaw, 45, 1e-12);
+	CHECK(R.Roll == 0);
+
+	const FRotator Up = FVector(0, 0, 5).GetDirectionRotator();
+	CHECK_NEAR(Up.Pitch, 90, 1e-12);
+
+	// The rotator's unit vector points back along the original direction
+	const FVector Direction = FVector(-2, 3, 1.5).GetNormalizedVector();
+	CHECK_VECTOR_NEAR(Direction.GetDirectionRotator().GetUnitVector(), Direction, 1e-14);
+}
+
+TEST_CASE(Vector, PrecisionConversion)
+{
+	const FVector V(0.1, 1e10, -3.5);
+	const FVector3f F(V);
+	CHECK(F.X == 0.1f && F.Y == 1e10f && F.Z == -3.5f);
+	CHECK(FVector(F).Z == -3.5);
+
+	const FVector2D P(3, 4);
+	CHECK((P + P).X == 6 && (P * 0.5).Y == 2);
+	CHECK(FVector2D(0.05, -0.05).Zero());
+}
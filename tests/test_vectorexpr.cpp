@@ -0,0 +1,72 @@
+#include "test.h"
+#include "vectorexpr.h"
+#include "quat.h"
+#include "rotator.h"
+#include <string.h>
+
+static bool BitwiseEqual(const FVector& A, const FVector& B)
+{
+	return memcmp(&A, &B, sizeof(FVector)) == 0;
+}
+
+TEST_CASE(VectorExpr, CompoundOperators)
+{
+	FTestRandom Random(230);
+	for (int i = 0; i < 100; ++i)
+	{
+		const FVector A = Random.Vector(100), B = Random.Vector(100);
+		const double Scale = Random.Range(-2, 2);
+		FVector V = A;
+		CHECK(BitwiseEqual(V += B, A + B));
+		V = A;
+		CHECK(BitwiseEqual(V -= B, A - B));
+		V = A;
+		CHECK(BitwiseEqual(V *= B, A * B));
+		V = A;
+		CHECK(BitwiseEqual(V *= Scale, A * Scale));
+		V = A;
+		CHECK(BitwiseEqual(V /= Scale, A / Scale));
+		CHECK(BitwiseEqual(A / Scale, FVector(A.X / Scale, A.Y / Scale, A.Z / Scale)));
+
+		const FQuat Q = FRotator(Random.Range(-89, 89), Random.Range(-180, 180), 0).GetQuaternion();
+		const FQuat R = FRotator(0, Random.Range(-180, 180), Random.Range(-180, 180)).GetQuaternion();
+		FQuat Sum = Q;
+		Sum += R;
+		CHECK((Sum | Sum) == ((Q + R) | (Q + R)));
+		Sum -= R * Scale;
+		Sum *= Scale;
+		const FQuat Expected = (Q + R - R * Scale) * Scale;
+		CHECK(Sum.X == Expected.X && Sum.Y == Expected.Y && Sum.Z == Expected.Z && Sum.W == Expected.W);
+	}
+}
+
+TEST_CASE(VectorExpr, MatchesEagerOperators)
+{
+	FTestRandom Random(231);
+	for (int i = 0; i < 100; ++i)
+	{
+		const FVector A = Random.Vector(100), B = Random.Vector(100), C = Random.Vector(100);
+		const double W = Random.Range(-1, 1);
+
+		// FQuat::RotateVector's chain, and FTransform::Multiply's translation
+		const FVector Q = Random.Vector(1);
+		const FVector T = (Q ^ A) * 2.0;
+		const FVector Rotated = LazyVector(A) + LazyVector(T) * W + (LazyVector(Q) ^ T);
+		CHECK(BitwiseEqual(Rotated, A + (T * W) + (Q ^ T)));
+		const FVector Translated = LazyVector(B) * C + A;
+		CHECK(BitwiseEqual(Translated, (B * C) + A));
+
+		// Operands of every kind on either side
+		CHECK(BitwiseEqual((A - LazyVector(B) * 3.0).Eval(), A - B * 3.0));
+		CHECK(BitwiseEqual((0.5 * -LazyVector(A) + C).Eval(), (-A) * 0.5 + C));
+		CHECK(BitwiseEqual((LazyVector(A) ^ (LazyVector(B) + C)).Eval(), A ^ (B + C)));
+		CHECK(BitwiseEqual((A ^ LazyVector(B) * W).Eval(), A ^ (B * W)));
+
+		// Evaluation is complete before the result is assigned, so the target may be an operand
+		FVector V = A;
+		V = LazyVector(B) - V * W + (V ^ LazyVector(C));
+		CHECK(BitwiseEqual(V, B - A * W + (A ^ C)));
+		V += LazyVector(A) * 2.0;
+		CHECK(BitwiseEqual(V, B - A * W + (A ^ C) + A * 2.0));
+	}
+}
@@ -1,220 +1,8 @@
 #include "transform.h"
-#include "vector.h"
-#include "quat.h"
-#include "matrix.h"
 
-FTransform::FTransform(const FQuat& Rotation, const FVector& Translation, const FVector& Scale3D) :Rotation(Rotation), Translation(Translation), Scale3D(Scale3D) {}
-FTransform::FTransform() : Rotation(FQuat(0.0, 0.0, 0.0, 1.0)), Translation(FVector(0.0, 0.0, 0.0)), Scale3D(FVector(1.0, 1.0, 1.0)) {}
+#if !UE_MATH_HEADER_ONLY
+#include "transform.inl"
 
-bool FTransform::AnyHasNegativeScale(const FVector& InScale3D, const FVector& InOtherScale3D)
-{
-	return  (InScale3D.X < 0.0 || InScale3D.Y < 0.0 || InScale3D.Z < 0.0
-		|| InOtherScale3D.X < 0.0 || InOtherScale3D.Y < 0.0 || InOtherScale3D.Z < 0.0);
-}
-
-/**
-* Convert this Transform to a transformation matrix with scaling.
-*/
-FMatrix FTransform::ToMatrixWithScale() const
-{
-	FMatrix OutMatrix;
-	OutMatrix.M[3][0] = Translation.X;
-	OutMatrix.M[3][1] = Translation.Y;
-	OutMatrix.M[3][2] = Translation.Z;
-
-	const double x2 = Rotation.X + Rotation.X;
-	const double y2 = Rotation.Y + Rotation.Y;
-	const double z2 = Rotation.Z + Rotation.Z;
-	{
-		const double xx2 = Rotation.X * x2;
-		const double yy2 = Rotation.Y * y2;
-		const double zz2 = Rotation.Z * z2;
-
-		OutMatrix.M[0][0] = (1.0 - (yy2 + zz2)) * Scale3D.X;
-		OutMatrix.M[1][1] = (1.0 - (xx2 + zz2)) * Scale3D.Y;
-		OutMatrix.M[2][2] = (1.0 - (xx2 + yy2)) * Scale3D.Z;
-	}
-	{
-		const double yz2 = Rotation.Y * z2;
-		const double wx2 = Rotation.W * x2;
-
-		OutMatrix.M[2][1] = (yz2 - wx2) * Scale3D.Z;
-		OutMatrix.M[1][2] = (yz2 + wx2) * Scale3D.Y;
-	}
-	{
-		const double xy2 = Rotation.X * y2;
-		const double wz2 = Rotation.W * z2;
-
-		OutMatrix.M[1][0] = (xy2 - wz2) * Scale3D.Y;
-		OutMatrix.M[0][1] = (xy2 + wz2) * Scale3D.X;
-	}
-	{
-		const double xz2 = Rotation.X * z2;
-		const double wy2 = Rotation.W * y2;
-
-		OutMatrix.M[2][0] = (xz2 + wy2) * Scale3D.Z;
-		OutMatrix.M[0][2] = (xz2 - wy2) * Scale3D.X;
-	}
-
-	OutMatrix.M[0][3] = 0.0;
-	OutMatrix.M[1][3] = 0.0;
-	OutMatrix.M[2][3] = 0.0;
-	OutMatrix.M[3][3] = 1.0;
-
-	return OutMatrix;
-}
-
-void FTransform::MultiplyUsingMatrixWithScale(FTransform* OutTransform, const FTransform* A, const FTransform* B)
-{
-	// the goal of using M is to get the correct orientation
-	// but for translation, we still need scale
-	ConstructTransformFromMatrixWithDesiredScale(A->ToMatrixWithScale(), B->ToMatrixWithScale(), A->Scale3D * B->Scale3D, *OutTransform);
-}
-
-void FTransform::ConstructTransformFromMatrixWithDesiredScale(const FMatrix& AMatrix, const FMatrix& BMatrix, const FVector& DesiredScale, FTransform& OutTransform)
-{
-	// the goal of using M is to get the correct orientation
-	// but for translation, we still need scale
-	FMatrix M = AMatrix * BMatrix;
-	M.RemoveScaling();
-
-	// apply negative scale back to axes
-	FVector SignedScale = DesiredScale.GetSignVector();
-
-	M.SetAxis0(SignedScale.X * M.GetScaledAxisX());
-	M.SetAxis1(SignedScale.Y * M.GetScaledAxisY());
-	M.SetAxis2(SignedScale.Z * M.GetScaledAxisZ());
-
-	// @note: if you have negative with 0 scale, this will return rotation that is identity
-	// since matrix loses that axes
-	FQuat Rotation = FQuat(M);
-	Rotation.Normalize();
-
-	// set values back to output
-	OutTransform.Scale3D = DesiredScale;
-	OutTransform.Rotation = Rotation;
-
-	// technically I could calculate this using FTransform but then it does more quat multiplication 
-	// instead of using Scale in matrix multiplication
-	// it's a question of between RemoveScaling vs using FTransform to move translation
-	OutTransform.Translation = M.GetOrigin();
-}
-
-/** Returns Multiplied Transform of 2 FTransforms **/
-void FTransform::Multiply(FTransform* OutTransform, const FTransform* A, const FTransform* B)
-{
-	if (AnyHasNegativeScale(A->Scale3D, B->Scale3D))
-	{
-		// @note, if you have 0 scale with negative, you're going to lose rotation as it can't convert back to quat
-		MultiplyUsingMatrixWithScale(OutTransform, A, B);
-	}
-	else
-	{
-		OutTransform->Rotation = B->Rotation * A->Rotation;
-		OutTransform->Scale3D = A->Scale3D * B->Scale3D;
-		OutTransform->Translation = B->Rotation * (B->Scale3D * A->Translation) + B->Translation;
-	}
-
-	// we do not support matrix transform when non-uniform
-	// that was removed at rev 21 with UE4
-}
-
-FTransform FTransform::operator*(const FTransform& A) {
-	FTransform OutTransform;
-	Multiply(&OutTransform, this, &A);
-	return OutTransform;
-}
-
-// mathematically if you have 0 scale, it should be infinite, 
-// however, in practice if you have 0 scale, and relative transform doesn't make much sense 
-// anymore because you should be instead of showing gigantic infinite mesh
-// also returning BIG_NUMBER causes sequential NaN issues by multiplying 
-// so we hardcode as 0
-FVector FTransform::GetSafeScaleReciprocal(const FVector& InScale, double Tolerance)
-{
-	FVector SafeReciprocalScale;
-	if (fabs(InScale.X) <= Tolerance)
-	{
-		SafeReciprocalScale.X = 0.0;
-	}
-	else
-	{
-		SafeReciprocalScale.X = 1 / InScale.X;
-	}
-
-	if (fabs(InScale.Y) <= Tolerance)
-	{
-		SafeReciprocalScale.Y = 0.0;
-	}
-	else
-	{
-		SafeReciprocalScale.Y = 1 / InScale.Y;
-	}
-
-	if (fabs(InScale.Z) <= Tolerance)
-	{
-		SafeReciprocalScale.Z = 0.0;
-	}
-	else
-	{
-		SafeReciprocalScale.Z = 1 / InScale.Z;
-	}
-
-	return SafeReciprocalScale;
-}
-
-FVector FTransform::GetBoneWithRotation(const FTransform& Bone) const
-{
-	return Rotation * (Scale3D * Bone.Translation) + Translation;
-}
-
-void FTransform::GetRelativeTransformUsingMatrixWithScale(FTransform* OutTransform, const FTransform* Base, const FTransform* Relative)
-{
-	// the goal of using M is to get the correct orientation
-	// but for translation, we still need scale
-	FMatrix AM = Base->ToMatrixWithScale();
-	FMatrix BM = Relative->ToMatrixWithScale();
-	// get combined scale
-	FVector SafeRecipScale3D = GetSafeScaleReciprocal(Relative->Scale3D, SMALL_NUMBER);
-	FVector DesiredScale3D = Base->Scale3D * SafeRecipScale3D;
-	ConstructTransformFromMatrixWithDesiredScale(AM, BM.Inverse(), DesiredScale3D, *OutTransform);
-}
-
-FTransform FTransform::GetRelativeTransform(const FTransform& Other) const
-{
-	// A * B(-1) = VQS(B)(-1) (VQS (A))
-	// 
-	// Scale = S(A)/S(B)
-	// Rotation = Q(B)(-1) * Q(A)
-	// Translation = 1/S(B) *[Q(B)(-1)*(T(A)-T(B))*Q(B)]
-	// where A = this, B = Other
-	FTransform Result;
-
-	if (AnyHasNegativeScale(Scale3D, Other.Scale3D))
-	{
-		// @note, if you have 0 scale with negative, you're going to lose rotation as it can't convert back to quat
-		GetRelativeTransformUsingMatrixWithScale(&Result, this, &Other);
-	}
-	else
-	{
-		FVector SafeRecipScale3D = GetSafeScaleReciprocal(Other.Scale3D, SMALL_NUMBER);
-		Result.Scale3D = Scale3D * SafeRecipScale3D;
-
-		if (Other.Rotation.IsNormalized() == false)
-		{
-			return FTransform();
-		}
-
-		FQuat Inverse = Other.Rotation.Inverse();
-		Result.Rotation = Inverse * Rotation;
-
-		Result.Translation = (Inverse * (Translation - Other.Translation)) * (SafeRecipScale3D);
-	}
-
-	return Result;
-}
-
-FTransform FTransform::Inverse()
-{
-	return FTransform(Rotation.Inverse(),Rotation.RotateVectorInverse(-Translation),Scale3D);
-}
+template struct TTransform<float>;
+template struct TTransform<double>;
+#endif
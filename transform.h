@@ -1,38 +1,71 @@
 #pragma once
 #include "ue4math.h"
+#include "mathfwd.h"
 #include "vector.h"
 #include "quat.h"
 
-struct FMatrix;
 
-
-struct alignas(16) FTransform {
+template<typename T>
+struct alignas(16) TTransform {
 public:
-	struct FQuat                                       Rotation;                                       
-	struct FVector                                     Translation;                                           
-private:	unsigned char                              UnknownData00[0x8];                                       
-public:		struct FVector                             Scale3D;                                         
+	using FReal = T;
+
+	TQuat<T>                                           Rotation;
+	TVector<T>                                         Translation;
+private:	unsigned char                              UnknownData00[sizeof(T)];	/* 0x8 for double, 0x4 for float, as in the engine layout */
+public:		TVector<T>                                 Scale3D;
+
+	TTransform() : Rotation(TQuat<T>(0.0, 0.0, 0.0, 1.0)), Translation(TVector<T>(0.0, 0.0, 0.0)), Scale3D(TVector<T>(1.0, 1.0, 1.0)) {}
+	TTransform(const TQuat<T>& Rotation, const TVector<T>& Translation, const TVector<T>& Scale3D) : Rotation(Rotation), Translation(Translation), Scale3D(Scale3D) {}
+
+	/** Explicit precision conversion, e.g. FTransform3f(SomeFTransform). */
+	template<typename U, typename = typename std::enable_if<!std::is_same<T, U>::value>::type>
+	explicit TTransform(const TTransform<U>& Other) : Rotation(Other.Rotation), Translation(Other.Translation), Scale3D(Other.Scale3D) {}
+
+	static bool AnyHasNegativeScale(const TVector<T>& InScale3D, const TVector<T>& InOtherScale3D)
+	{
+		return  (InScale3D.X < 0.0 || InScale3D.Y < 0.0 || InScale3D.Z < 0.0
+			|| InOtherScale3D.X < 0.0 || InOtherScale3D.Y < 0.0 || InOtherScale3D.Z < 0.0);
+	}
 
-	FTransform();
-	FTransform(const FQuat& Rotation, const FVector& Translation, const FVector& Scale3D);
-	static bool AnyHasNegativeScale(const FVector& InScale3D, const FVector& InOtherScale3D);
-	static void Multiply(FTransform* OutTransform, const FTransform* A, const FTransform* B);
+	static void Multiply(TTransform* OutTransform, const TTransform* A, const TTransform* B);
 
-	static void MultiplyUsingMatrixWithScale(FTransform* OutTransform, const FTransform* A, const FTransform* B);
-	static void ConstructTransformFromMatrixWithDesiredScale(const FMatrix& AMatrix, const FMatrix& BMatrix, const FVector& DesiredScale, FTransform& OutTransform);
+	static void MultiplyUsingMatrixWithScale(TTransform* OutTransform, const TTransform* A, const TTransform* B);
+	static void ConstructTransformFromMatrixWithDesiredScale(const TMatrix<T>& AMatrix, const TMatrix<T>& BMatrix, const TVector<T>& DesiredScale, TTransform& OutTransform);
 
-	FMatrix ToMatrixWithScale() const;
+	TMatrix<T> ToMatrixWithScale() const;
 
-	FTransform operator*(const FTransform& A);
+	/** Inverse of ToMatrixWithScale(): InverseRigid() for unit scale and a normalized rotation, otherwise InverseAffine(). */
+	TMatrix<T> ToInverseMatrixWithScale() const;
 
-	static FVector GetSafeScaleReciprocal(const FVector& InScale, double Tolerance = SMALL_NUMBER);
+	TTransform operator*(const TTransform& A);
 
-	FVector GetBoneWithRotation(const FTransform& Bone) const;
+	static TVector<T> GetSafeScaleReciprocal(const TVector<T>& InScale, T Tolerance = T(SMALL_NUMBER));
 
-	FTransform GetRelativeTransform(const FTransform& Other) const;
+	TVector<T> GetBoneWithRotation(const TTransform& Bone) const { return Rotation * (Scale3D * Bone.Translation) + Translation; }
 
-	FTransform Inverse();
+	TTransform GetRelativeTransform(const TTransform& Other) const;
 
-	static void GetRelativeTransformUsingMatrixWithScale(FTransform* OutTransform, const FTransform* Base, const FTransform* Relative);
+	TTransform Inverse();
+
+	static void GetRelativeTransformUsingMatrixWithScale(TTransform* OutTransform, const TTransform* Base, const TTransform* Relative);
+
+	/**
+	 * Sets this to the blend of Atom1 and Atom2: translation and scale interpolate linearly, the
+	 * rotation with NLerp. Alpha within ZERO_ANIMWEIGHT_THRESH of 0 or 1 copies that end exactly.
+	 */
+	void Blend(const TTransform& Atom1, const TTransform& Atom2, T Alpha);
+
+	/** Blend(*this, OtherAtom, Alpha). */
+	void BlendWith(const TTransform& OtherAtom, T Alpha);
 };
 
+static_assert(sizeof(FTransform) == 96, "FTransform");
+static_assert(sizeof(FTransform3f) == 48, "FTransform3f");
+
+#if UE_MATH_HEADER_ONLY
+#include "transform.inl"
+#else
+extern template struct TTransform<float>;
+extern template struct TTransform<double>;
+#endif
@@ -0,0 +1,262 @@
+#pragma once
+#include "transform.h"
+#include "vector.h"
+#include "quat.h"
+#include "matrix.h"
+#include "stats.h"
+
+/**
+* Convert this Transform to a transformation matrix with scaling.
+*/
+template<typename T>
+UE_MATH_INLINE TMatrix<T> TTransform<T>::ToMatrixWithScale() const
+{
+	TMatrix<T> OutMatrix;
+	OutMatrix.M[3][0] = Translation.X;
+	OutMatrix.M[3][1] = Translation.Y;
+	OutMatrix.M[3][2] = Translation.Z;
+
+	const T x2 = Rotation.X + Rotation.X;
+	const T y2 = Rotation.Y + Rotation.Y;
+	const T z2 = Rotation.Z + Rotation.Z;
+	{
+		const T xx2 = Rotation.X * x2;
+		const T yy2 = Rotation.Y * y2;
+		const T zz2 = Rotation.Z * z2;
+
+		OutMatrix.M[0][0] = (1.0 - (yy2 + zz2)) * Scale3D.X;
+		OutMatrix.M[1][1] = (1.0 - (xx2 + zz2)) * Scale3D.Y;
+		OutMatrix.M[2][2] = (1.0 - (xx2 + yy2)) * Scale3D.Z;
+	}
+	{
+		const T yz2 = Rotation.Y * z2;
+		const T wx2 = Rotation.W * x2;
+
+		OutMatrix.M[2][1] = (yz2 - wx2) * Scale3D.Z;
+		OutMatrix.M[1][2] = (yz2 + wx2) * Scale3D.Y;
+	}
+	{
+		const T xy2 = Rotation.X * y2;
+		const T wz2 = Rotation.W * z2;
+
+		OutMatrix.M[1][0] = (xy2 - wz2) * Scale3D.Y;
+		OutMatrix.M[0][1] = (xy2 + wz2) * Scale3D.X;
+	}
+	{
+		const T xz2 = Rotation.X * z2;
+		const T wy2 = Rotation.W * y2;
+
+		OutMatrix.M[2][0] = (xz2 + wy2) * Scale3D.Z;
+		OutMatrix.M[0][2] = (xz2 - wy2) * Scale3D.X;
+	}
+
+	OutMatrix.M[0][3] = 0.0;
+	OutMatrix.M[1][3] = 0.0;
+	OutMatrix.M[2][3] = 0.0;
+	OutMatrix.M[3][3] = 1.0;
+
+	return OutMatrix;
+}
+
+template<typename T>
+UE_MATH_INLINE void TTransform<T>::MultiplyUsingMatrixWithScale(TTransform<T>* OutTransform, const TTransform<T>* A, const TTransform<T>* B)
+{
+	UE_MATH_STAT_SCOPE(TransformMultiplyUsingMatrixWithScale);
+	// the goal of using M is to get the correct orientation
+	// but for translation, we still need scale
+	ConstructTransformFromMatrixWithDesiredScale(A->ToMatrixWithScale(), B->ToMatrixWithScale(), A->Scale3D * B->Scale3D, *OutTransform);
+}
+
+template<typename T>
+UE_MATH_INLINE void TTransform<T>::ConstructTransformFromMatrixWithDesiredScale(const TMatrix<T>& AMatrix, const TMatrix<T>& BMatrix, const TVector<T>& DesiredScale, TTransform<T>& OutTransform)
+{
+	// the goal of using M is to get the correct orientation
+	// but for translation, we still need scale
+	TMatrix<T> M = AMatrix * BMatrix;
+	M.RemoveScaling();
+
+	// apply negative scale back to axes
+	TVector<T> SignedScale = DesiredScale.GetSignVector();
+
+	M.SetAxis0(SignedScale.X * M.GetScaledAxisX());
+	M.SetAxis1(SignedScale.Y * M.GetScaledAxisY());
+	M.SetAxis2(SignedScale.Z * M.GetScaledAxisZ());
+
+	// @note: if you have negative with 0 scale, this will return rotation that is identity
+	// since matrix loses that axes
+	TQuat<T> Rotation = TQuat<T>(M);
+	Rotation.Normalize();
+
+	// set values back to output
+	OutTransform.Scale3D = DesiredScale;
+	OutTransform.Rotation = Rotation;
+
+	// technically I could calculate this using FTransform but then it does more quat multiplication 
+	// instead of using Scale in matrix multiplication
+	// it's a question of between RemoveScaling vs using FTransform to move translation
+	OutTransform.Translation = M.GetOrigin();
+}
+
+/** Returns Multiplied Transform of 2 FTransforms **/
+template<typename T>
+UE_MATH_INLINE void TTransform<T>::Multiply(TTransform<T>* OutTransform, const TTransform<T>* A, const TTransform<T>* B)
+{
+	UE_MATH_STAT_SCOPE(TransformMultiply);
+	if (AnyHasNegativeScale(A->Scale3D, B->Scale3D))
+	{
+		// @note, if you have 0 scale with negative, you're going to lose rotation as it can't convert back to quat
+		UE_MATH_STAT_SLOW_PATH(TransformMultiply);
+		MultiplyUsingMatrixWithScale(OutTransform, A, B);
+	}
+	else
+	{
+		OutTransform->Rotation = B->Rotation * A->Rotation;
+		OutTransform->Scale3D = A->Scale3D * B->Scale3D;
+		OutTransform->Translation = B->Rotation * (B->Scale3D * A->Translation) + B->Translation;
+	}
+
+	// we do not support matrix transform when non-uniform
+	// that was removed at rev 21 with UE4
+}
+
+template<typename T>
+UE_MATH_INLINE TTransform<T> TTransform<T>::operator*(const TTransform<T>& A) {
+	TTransform<T> OutTransform;
+	Multiply(&OutTransform, this, &A);
+	return OutTransform;
+}
+
+// mathematically if you have 0 scale, it should be infinite, 
+// however, in practice if you have 0 scale, and relative transform doesn't make much sense 
+// anymore because you should be instead of showing gigantic infinite mesh
+// also returning BIG_NUMBER causes sequential NaN issues by multiplying 
+// so we hardcode as 0
+template<typename T>
+UE_MATH_INLINE TVector<T> TTransform<T>::GetSafeScaleReciprocal(const TVector<T>& InScale, T Tolerance)
+{
+	TVector<T> SafeReciprocalScale;
+	if (fabs(InScale.X) <= Tolerance)
+	{
+		SafeReciprocalScale.X = 0.0;
+	}
+	else
+	{
+		SafeReciprocalScale.X = 1 / InScale.X;
+	}
+
+	if (fabs(InScale.Y) <= Tolerance)
+	{
+		SafeReciprocalScale.Y = 0.0;
+	}
+	else
+	{
+		SafeReciprocalScale.Y = 1 / InScale.Y;
+	}
+
+	if (fabs(InScale.Z) <= Tolerance)
+	{
+		SafeReciprocalScale.Z = 0.0;
+	}
+	else
+	{
+		SafeReciprocalScale.Z = 1 / InScale.Z;
+	}
+
+	return SafeReciprocalScale;
+}
+
+template<typename T>
+UE_MATH_INLINE TMatrix<T> TTransform<T>::ToInverseMatrixWithScale() const
+{
+	// The matrix is affine by construction, so the full 4x4 inverse is never needed. With unit scale
+	// and a normalized rotation it is a pure rotation plus translation and a transpose inverts it.
+	// Deciding from the transform is cheaper than FMatrix::Classify on the matrix.
+	const bool bRigid = Scale3D == TVector<T>(1, 1, 1) && fabs(T(1) - Rotation.SizeSquared()) <= T(SMALL_NUMBER);
+	const TMatrix<T> M = ToMatrixWithScale();
+	return bRigid ? M.InverseRigid() : M.InverseAffine();
+}
+
+template<typename T>
+UE_MATH_INLINE void TTransform<T>::GetRelativeTransformUsingMatrixWithScale(TTransform<T>* OutTransform, const TTransform<T>* Base, const TTransform<T>* Relative)
+{
+	UE_MATH_STAT_SCOPE(TransformGetRelativeTransformUsingMatrixWithScale);
+	// the goal of using M is to get the correct orientation
+	// but for translation, we still need scale
+	TMatrix<T> AM = Base->ToMatrixWithScale();
+	// get combined scale
+	TVector<T> SafeRecipScale3D = GetSafeScaleReciprocal(Relative->Scale3D, SMALL_NUMBER);
+	TVector<T> DesiredScale3D = Base->Scale3D * SafeRecipScale3D;
+	ConstructTransformFromMatrixWithDesiredScale(AM, Relative->ToInverseMatrixWithScale(), DesiredScale3D, *OutTransform);
+}
+
+template<typename T>
+UE_MATH_INLINE TTransform<T> TTransform<T>::GetRelativeTransform(const TTransform<T>& Other) const
+{
+	UE_MATH_STAT_SCOPE(TransformGetRelativeTransform);
+	// A * B(-1) = VQS(B)(-1) (VQS (A))
+	// 
+	// Scale = S(A)/S(B)
+	// Rotation = Q(B)(-1) * Q(A)
+	// Translation = 1/S(B) *[Q(B)(-1)*(T(A)-T(B))*Q(B)]
+	// where A = this, B = Other
+	TTransform<T> Result;
+
+	if (AnyHasNegativeScale(Scale3D, Other.Scale3D))
+	{
+		// @note, if you have 0 scale with negative, you're going to lose rotation as it can't convert back to quat
+		UE_MATH_STAT_SLOW_PATH(TransformGetRelativeTransform);
+		GetRelativeTransformUsingMatrixWithScale(&Result, this, &Other);
+	}
+	else
+	{
+		TVector<T> SafeRecipScale3D = GetSafeScaleReciprocal(Other.Scale3D, SMALL_NUMBER);
+		Result.Scale3D = Scale3D * SafeRecipScale3D;
+
+		if (Other.Rotation.IsNormalized() == false)
+		{
+			return TTransform<T>();
+		}
+
+		TQuat<T> Inverse = Other.Rotation.Inverse();
+		Result.Rotation = Inverse * Rotation;
+
+		Result.Translation = (Inverse * (Translation - Other.Translation)) * (SafeRecipScale3D);
+	}
+
+	return Result;
+}
+
+template<typename T>
+UE_MATH_INLINE TTransform<T> TTransform<T>::Inverse()
+{
+	return TTransform<T>(Rotation.Inverse(),Rotation.RotateVectorInverse(-Translation),Scale3D);
+}
+
+template<typename T>
+UE_MATH_INLINE void TTransform<T>::Blend(const TTransform<T>& Atom1, const TTransform<T>& Atom2, T Alpha)
+{
+	if (Alpha <= T(ZERO_ANIMWEIGHT_THRESH))
+	{
+		// if blend is all the way for child1, then just copy its bone atoms
+		*this = Atom1;
+	}
+	else if (Alpha >= T(1) - T(ZERO_ANIMWEIGHT_THRESH))
+	{
+		// if blend is all the way for child2, then just copy its bone atoms
+		*this = Atom2;
+	}
+	else
+	{
+		// Simple linear interpolation for translation and scale.
+		Translation = Lerp(Atom1.Translation, Atom2.Translation, Alpha);
+		Scale3D = Lerp(Atom1.Scale3D, Atom2.Scale3D, Alpha);
+		Rotation = TQuat<T>::NLerp(Atom1.Rotation, Atom2.Rotation, Alpha);
+	}
+}
+
+template<typename T>
+UE_MATH_INLINE void TTransform<T>::BlendWith(const TTransform<T>& OtherAtom, T Alpha)
+{
+	const TTransform<T> Atom1(*this);
+	Blend(Atom1, OtherAtom, Alpha);
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include "cpu.h"
+#include "transform.h"
+
+#if UE_MATH_X86
+#include <immintrin.h>
+
+/*-----------------------------------------------------------------------------
+	AVX2 helpers shared by the batch kernels, internal to the library's .cpp
+	files. Four FTransforms move between their rows and one lane each: every
+	FTransform is three 32 byte rows, the rotation, the translation and its
+	pad, and the scale and the trailing pad.
+-----------------------------------------------------------------------------*/
+
+/** Four transforms, one lane each. */
+struct FTransformLanesAVX2
+{
+	__m256d QX, QY, QZ, QW;
+	__m256d TX, TY, TZ;
+	__m256d SX, SY, SZ;
+};
+
+/** Transposes four rows into four columns (and back). */
+UE_TARGET_AVX2 inline void Transpose4x4(__m256d R0, __m256d R1, __m256d R2, __m256d R3, __m256d& C0, __m256d& C1, __m256d& C2, __m256d& C3)
+{
+	const __m256d T0 = _mm256_unpacklo_pd(R0, R1);
+	const __m256d T1 = _mm256_unpackhi_pd(R0, R1);
+	const __m256d T2 = _mm256_unpacklo_pd(R2, R3);
+	const __m256d T3 = _mm256_unpackhi_pd(R2, R3);
+	C0 = _mm256_permute2f128_pd(T0, T2, 0x20);
+	C1 = _mm256_permute2f128_pd(T1, T3, 0x20);
+	C2 = _mm256_permute2f128_pd(T0, T2, 0x31);
+	C3 = _mm256_permute2f128_pd(T1, T3, 0x31);
+}
+
+/** Loads T[0..3] into lanes 0..3. */
+UE_TARGET_AVX2 inline void LoadTransformLanesAVX2(const FTransform* T, FTransformLanesAVX2& L)
+{
+	__m256d Pad;
+	Transpose4x4(_mm256_loadu_pd(&T[0].Rotation.X), _mm256_loadu_pd(&T[1].Rotation.X), _mm256_loadu_pd(&T[2].Rotation.X), _mm256_loadu_pd(&T[3].Rotation.X), L.QX, L.QY, L.QZ, L.QW);
+	Transpose4x4(_mm256_loadu_pd(&T[0].Translation.X), _mm256_loadu_pd(&T[1].Translation.X), _mm256_loadu_pd(&T[2].Translation.X), _mm256_loadu_pd(&T[3].Translation.X), L.TX, L.TY, L.TZ, Pad);
+	Transpose4x4(_mm256_loadu_pd(&T[0].Scale3D.X), _mm256_loadu_pd(&T[1].Scale3D.X), _mm256_loadu_pd(&T[2].Scale3D.X), _mm256_loadu_pd(&T[3].Scale3D.X), L.SX, L.SY, L.SZ, Pad);
+}
+
+/** The three rows of each lane's transform, with zero pads, for StoreTransformRowsAVX2. */
+UE_TARGET_AVX2 inline void TransposeTransformLanesAVX2(const FTransformLanesAVX2& L, __m256d Rotation[4], __m256d Translation[4], __m256d Scale[4])
+{
+	const __m256d Zero = _mm256_setzero_pd();
+	Transpose4x4(L.QX, L.QY, L.QZ, L.QW, Rotation[0], Rotation[1], Rotation[2], Rotation[3]);
+	Transpose4x4(L.TX, L.TY, L.TZ, Zero, Translation[0], Translation[1], Translation[2], Translation[3]);
+	Transpose4x4(L.SX, L.SY, L.SZ, Zero, Scale[0], Scale[1], Scale[2], Scale[3]);
+}
+
+/** Writes the fields of T only, leaving the pads as they are, like the scalar code. */
+UE_TARGET_AVX2 inline void StoreTransformRowsAVX2(FTransform& T, __m256d Rotation, __m256d Translation, __m256d Scale)
+{
+	const __m256i Mask3 = _mm256_set_epi64x(0, -1, -1, -1);
+	_mm256_storeu_pd(&T.Rotation.X, Rotation);
+	_mm256_maskstore_pd(&T.Translation.X, Mask3, Translation);
+	_mm256_maskstore_pd(&T.Scale3D.X, Mask3, Scale);
+}
+
+/** Stores lanes 0..3 to T[0..3], fields only. */
+UE_TARGET_AVX2 inline void StoreTransformLanesAVX2(FTransform* T, const FTransformLanesAVX2& L)
+{
+	__m256d Rotation[4], Translation[4], Scale[4];
+	TransposeTransformLanesAVX2(L, Rotation, Translation, Scale);
+	for (int Lane = 0; Lane < 4; ++Lane)
+		StoreTransformRowsAVX2(T[Lane], Rotation[Lane], Translation[Lane], Scale[Lane]);
+}
+#endif
@@ -0,0 +1,550 @@
+#include "trig.h"
+#include "cpu.h"
+
+#if UE_MATH_X86
+#include <immintrin.h>
+#endif
+
+/*-----------------------------------------------------------------------------
+	Coefficients. The precise tier uses the Cephes double precision sin/cos
+	polynomials on [-pi/4, pi/4] and the Cephes atan rational on
+	|t| <= 0.66; the fast tier the Cephes single precision ones (sin/cos on
+	[-pi/4, pi/4], atan on |t| <= tan(pi/8)).
+-----------------------------------------------------------------------------*/
+
+static const double SinCoeffs[6] = { 1.58962301576546568060E-10, -2.50507477628578072866E-8, 2.75573136213857245213E-6, -1.98412698295895385996E-4, 8.33333333332211858878E-3, -1.66666666666666307295E-1 };
+static const double CosCoeffs[6] = { -1.13585365213876817300E-11, 2.08757008419747316778E-9, -2.75573141792967388112E-7, 2.48015872888517045348E-5, -1.38888888888730564116E-3, 4.16666666666665929218E-2 };
+static const double FastSinCoeffs[3] = { -1.9515295891E-4, 8.3321608736E-3, -1.6666654611E-1 };
+static const double FastCosCoeffs[3] = { 2.443315711809948E-5, -1.388731625493765E-3, 4.166664568298827E-2 };
+
+static const double AtanP[5] = { -8.750608600031904122785E-1, -1.615753718733365076637E1, -7.500855792314704667340E1, -1.228866684490136173410E2, -6.485021904942025371773E1 };
+static const double AtanQ[5] = { 2.485846490142306297962E1, 1.650270098316988542046E2, 4.328810604912902668951E2, 4.853903996359136964868E2, 1.945506571482613964425E2 };
+static const double FastAtanCoeffs[4] = { 8.05374449538E-2, -1.38776856032E-1, 1.99777106478E-1, -3.33329491539E-1 };
+
+// Above this the atan argument is reduced with pi/4 + atan((t - 1) / (t + 1))
+static const double AtanReduceAbove = 0.66;
+static const double FastAtanReduceAbove = 0.41421356237309503;	/* tan(pi/8) */
+
+// Multiples of pi as a double plus the rounding error of that double
+static const double PiHi = 3.141592653589793, PiLo = 1.2246467991473532e-16;
+static const double HalfPiHi = 1.5707963267948966, HalfPiLo = 6.123233995736766e-17;
+static const double QuarterPiHi = 0.7853981633974483, QuarterPiLo = 3.061616997868383e-17;
+
+// pi/2 in three parts for Cody-Waite reduction; the first two have 33 significant bits so
+// Quadrant * part is exact for |Quadrant| < 2^20
+static const double HalfPi1 = 1.57079632673412561417e+00;
+static const double HalfPi2 = 6.07710050630396597660e-11;
+static const double HalfPi3 = 2.02226624871116645580e-21;
+static const double TwoOverPi = 0.6366197723675814;
+
+static const double DegToRadHi = 0.017453292519943295, DegToRadLo = 2.9486522708701687e-19;
+
+// Adding 1.5 * 2^52 rounds a double below 2^51 in magnitude to an integer, which also ends up
+// in the low mantissa bits in two's complement
+static const double RoundingMagic = 6755399441055744.0;
+
+/*-----------------------------------------------------------------------------
+	Scalar reference of every kernel; also handles the tails of the vector loops.
+-----------------------------------------------------------------------------*/
+
+/**
+ * The quadrant of QM = Q + RoundingMagic from its low mantissa bits, as the vector kernels take
+ * it. Unlike an integer cast of Q this is defined for NaN, Inf and huge inputs too.
+ */
+static inline uint64_t QuadrantBits(double QM)
+{
+	uint64_t Bits;
+	memcpy(&Bits, &QM, sizeof(Bits));
+	return Bits;
+}
+
+/** sin and cos of R in [-pi/4, pi/4] rotated by Quadrant quarter turns. */
+template<bool bFast>
+static inline void SinCosReduced(double R, uint64_t Quadrant, double& OutSin, double& OutCos)
+{
+	const double Z = R * R;
+	double S, C;
+	if (bFast)
+	{
+		S = R + R * Z * ((FastSinCoeffs[0] * Z + FastSinCoeffs[1]) * Z + FastSinCoeffs[2]);
+		C = 1.0 - 0.5 * Z + Z * Z * ((FastCosCoeffs[0] * Z + FastCosCoeffs[1]) * Z + FastCosCoeffs[2]);
+	}
+	else
+	{
+		S = R + R * Z * (((((SinCoeffs[0] * Z + SinCoeffs[1]) * Z + SinCoeffs[2]) * Z + SinCoeffs[3]) * Z + SinCoeffs[4]) * Z + SinCoeffs[5]);
+		C = 1.0 - 0.5 * Z + Z * Z * (((((CosCoeffs[0] * Z + CosCoeffs[1]) * Z + CosCoeffs[2]) * Z + CosCoeffs[3]) * Z + CosCoeffs[4]) * Z + CosCoeffs[5]);
+	}
+
+	// sin(R + q pi/2) cycles through S, C, -S, -C and cos through C, -S, -C, S
+	if (Quadrant & 1)
+	{
+		std::swap(S, C);
+	}
+	OutSin = (Quadrant & 2) ? -S : S;
+	OutCos = ((Quadrant + 1) & 2) ? -C : C;
+}
+
+template<bool bFast>
+static inline void SinCosScalar(double X, double& OutSin, double& OutCos)
+{
+	const double QM = X * TwoOverPi + RoundingMagic;
+	const double Q = QM - RoundingMagic;
+	const double R = ((X - Q * HalfPi1) - Q * HalfPi2) - Q * HalfPi3;
+	SinCosReduced<bFast>(R, QuadrantBits(QM), OutSin, OutCos);
+}
+
+template<bool bFast>
+static inline void SinCosDegreesScalar(double X, double& OutSin, double& OutCos)
+{
+	const double QM = X * (1.0 / 90.0) + RoundingMagic;
+	const double Q = QM - RoundingMagic;
+	const double RDeg = X - Q * 90.0;
+	const double R = bFast ? RDeg * DegToRadHi : RDeg * DegToRadHi + RDeg * DegToRadLo;
+	SinCosReduced<bFast>(R, QuadrantBits(QM), OutSin, OutCos);
+}
+
+template<bool bFast>
+static inline double Atan2Scalar(double Y, double X)
+{
+	if (X != X || Y != Y)
+	{
+		return X + Y;
+	}
+
+	// atan of the ratio in [0, 1], then mirrored into the right octant
+	const double AY = fabs(Y);
+	const double AX = fabs(X);
+	const double Max = AX > AY ? AX : AY;
+	const double Min = AX > AY ? AY : AX;
+	const double A = Max > 0.0 ? Min / Max : 0.0;
+
+	const bool bReduce = A > (bFast ? FastAtanReduceAbove : AtanReduceAbove);
+	const double T = bReduce ? (A - 1.0) / (A + 1.0) : A;
+	const double Z = T * T;
+	double Result;
+	if (bFast)
+	{
+		Result = T + T * Z * (((FastAtanCoeffs[0] * Z + FastAtanCoeffs[1]) * Z + FastAtanCoeffs[2]) * Z + FastAtanCoeffs[3]);
+	}
+	else
+	{
+		const double P = (((AtanP[0] * Z + AtanP[1]) * Z + AtanP[2]) * Z + AtanP[3]) * Z + AtanP[4];
+		const double Q = ((((Z + AtanQ[0]) * Z + AtanQ[1]) * Z + AtanQ[2]) * Z + AtanQ[3]) * Z + AtanQ[4];
+		Result = T + T * Z * (P / Q);
+	}
+
+	if (bReduce)
+	{
+		Result = QuarterPiHi + (Result + QuarterPiLo);
+	}
+	if (AY > AX)
+	{
+		Result = (HalfPiHi - Result) + HalfPiLo;
+	}
+	if (signbit(X))
+	{
+		Result = (PiHi - Result) + PiLo;
+	}
+	return copysign(Result, Y);
+}
+
+template<bool bFast>
+static inline double AsinScalar(double X)
+{
+	return Atan2Scalar<bFast>(X, sqrt((1.0 - X) * (1.0 + X)));
+}
+
+#if UE_MATH_X86
+/*-----------------------------------------------------------------------------
+	AVX2 / FMA, 4 lanes.
+-----------------------------------------------------------------------------*/
+
+template<bool bFast>
+UE_TARGET_AVX2_FMA static inline void SinCosReducedAVX2(__m256d R, __m256i Quadrant, __m256d& OutSin, __m256d& OutCos)
+{
+	const __m256d Z = _mm256_mul_pd(R, R);
+	__m256d PS, PC;
+	if (bFast)
+	{
+		PS = _mm256_fmadd_pd(_mm256_fmadd_pd(_mm256_set1_pd(FastSinCoeffs[0]), Z, _mm256_set1_pd(FastSinCoeffs[1])), Z, _mm256_set1_pd(FastSinCoeffs[2]));
+		PC = _mm256_fmadd_pd(_mm256_fmadd_pd(_mm256_set1_pd(FastCosCoeffs[0]), Z, _mm256_set1_pd(FastCosCoeffs[1])), Z, _mm256_set1_pd(FastCosCoeffs[2]));
+	}
+	else
+	{
+		PS = _mm256_set1_pd(SinCoeffs[0]);
+		PC = _mm256_set1_pd(CosCoeffs[0]);
+		for (int k = 1; k < 6; ++k)
+		{
+			PS = _mm256_fmadd_pd(PS, Z, _mm256_set1_pd(SinCoeffs[k]));
+			PC = _mm256_fmadd_pd(PC, Z, _mm256_set1_pd(CosCoeffs[k]));
+		}
+	}
+	const __m256d S = _mm256_fmadd_pd(_mm256_mul_pd(R, Z), PS, R);
+	const __m256d C = _mm256_fmadd_pd(_mm256_mul_pd(Z, Z), PC, _mm256_fnmadd_pd(_mm256_set1_pd(0.5), Z, _mm256_set1_pd(1.0)));
+
+	const __m256i One = _mm256_set1_epi64x(1);
+	const __m256i Two = _mm256_set1_epi64x(2);
+	const __m256d Swap = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(Quadrant, One), One));
+	const __m256d SinSign = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_and_si256(Quadrant, Two), 62));
+	const __m256d CosSign = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_and_si256(_mm256_add_epi64(Quadrant, One), Two), 62));
+	OutSin = _mm256_xor_pd(_mm256_blendv_pd(S, C, Swap), SinSign);
+	OutCos = _mm256_xor_pd(_mm256_blendv_pd(C, S, Swap), CosSign);
+}
+
+template<bool bDegrees, bool bFast>
+UE_TARGET_AVX2_FMA static size_t SinCosAVX2(const double* In, double* OutSin, double* OutCos, size_t Count)
+{
+	const __m256d Magic = _mm256_set1_pd(RoundingMagic);
+	size_t i = 0;
+	for (; i + 4 <= Count; i += 4)
+	{
+		const __m256d X = _mm256_loadu_pd(In + i);
+		__m256d QM, R;
+		if (bDegrees)
+		{
+			QM = _mm256_fmadd_pd(X, _mm256_set1_pd(1.0 / 90.0), Magic);
+			const __m256d Q = _mm256_sub_pd(QM, Magic);
+			const __m256d RDeg = _mm256_fnmadd_pd(Q, _mm256_set1_pd(90.0), X);
+			R = bFast ? _mm256_mul_pd(RDeg, _mm256_set1_pd(DegToRadHi))
+				: _mm256_fmadd_pd(RDeg, _mm256_set1_pd(DegToRadLo), _mm256_mul_pd(RDeg, _mm256_set1_pd(DegToRadHi)));
+		}
+		else
+		{
+			QM = _mm256_fmadd_pd(X, _mm256_set1_pd(TwoOverPi), Magic);
+			const __m256d Q = _mm256_sub_pd(QM, Magic);
+			R = _mm256_fnmadd_pd(Q, _mm256_set1_pd(HalfPi1), X);
+			R = _mm256_fnmadd_pd(Q, _mm256_set1_pd(HalfPi2), R);
+			R = _mm256_fnmadd_pd(Q, _mm256_set1_pd(HalfPi3), R);
+		}
+
+		__m256d S, C;
+		SinCosReducedAVX2<bFast>(R, _mm256_castpd_si256(QM), S, C);
+		_mm256_storeu_pd(OutSin + i, S);
+		_mm256_storeu_pd(OutCos + i, C);
+	}
+	return i;
+}
+
+template<bool bFast>
+UE_TARGET_AVX2_FMA static inline __m256d Atan2AVX2(__m256d Y, __m256d X)
+{
+	const __m256d SignMask = _mm256_set1_pd(-0.0);
+	const __m256d One = _mm256_set1_pd(1.0);
+	const __m256d AY = _mm256_andnot_pd(SignMask, Y);
+	const __m256d AX = _mm256_andnot_pd(SignMask, X);
+	const __m256d Max = _mm256_max_pd(AX, AY);
+	const __m256d Min = _mm256_min_pd(AX, AY);
+	const __m256d A = _mm256_and_pd(_mm256_div_pd(Min, Max), _mm256_cmp_pd(Max, _mm256_setzero_pd(), _CMP_GT_OQ));
+
+	const __m256d Reduce = _mm256_cmp_pd(A, _mm256_set1_pd(bFast ? FastAtanReduceAbove : AtanReduceAbove), _CMP_GT_OQ);
+	const __m256d T = _mm256_blendv_pd(A, _mm256_div_pd(_mm256_sub_pd(A, One), _mm256_add_pd(A, One)), Reduce);
+	const __m256d Z = _mm256_mul_pd(T, T);
+	__m256d Ratio;
+	if (bFast)
+	{
+		Ratio = _mm256_set1_pd(FastAtanCoeffs[0]);
+		for (int k = 1; k < 4; ++k)
+		{
+			Ratio = _mm256_fmadd_pd(Ratio, Z, _mm256_set1_pd(FastAtanCoeffs[k]));
+		}
+	}
+	else
+	{
+		__m256d P = _mm256_set1_pd(AtanP[0]);
+		__m256d Q = _mm256_add_pd(Z, _mm256_set1_pd(AtanQ[0]));
+		for (int k = 1; k < 5; ++k)
+		{
+			P = _mm256_fmadd_pd(P, Z, _mm256_set1_pd(AtanP[k]));
+			Q = _mm256_fmadd_pd(Q, Z, _mm256_set1_pd(AtanQ[k]));
+		}
+		Ratio = _mm256_div_pd(P, Q);
+	}
+	__m256d Result = _mm256_fmadd_pd(_mm256_mul_pd(T, Z), Ratio, T);
+
+	Result = _mm256_blendv_pd(Result, _mm256_add_pd(_mm256_set1_pd(QuarterPiHi), _mm256_add_pd(Result, _mm256_set1_pd(QuarterPiLo))), Reduce);
+	Result = _mm256_blendv_pd(Result, _mm256_add_pd(_mm256_sub_pd(_mm256_set1_pd(HalfPiHi), Result), _mm256_set1_pd(HalfPiLo)), _mm256_cmp_pd(AY, AX, _CMP_GT_OQ));
+	// blendv keys on the sign bit, which is exactly the "X is negative or -0" test
+	Result = _mm256_blendv_pd(Result, _mm256_add_pd(_mm256_sub_pd(_mm256_set1_pd(PiHi), Result), _mm256_set1_pd(PiLo)), X);
+	Result = _mm256_or_pd(Result, _mm256_and_pd(Y, SignMask));
+	return _mm256_blendv_pd(Result, _mm256_add_pd(X, Y), _mm256_cmp_pd(X, Y, _CMP_UNORD_Q));
+}
+
+template<bool bFast>
+UE_TARGET_AVX2_FMA static size_t Atan2AVX2Loop(const double* Y, const double* X, double* Out, size_t Count)
+{
+	size_t i = 0;
+	for (; i + 4 <= Count; i += 4)
+	{
+		_mm256_storeu_pd(Out + i, Atan2AVX2<bFast>(_mm256_loadu_pd(Y + i), _mm256_loadu_pd(X + i)));
+	}
+	return i;
+}
+
+template<bool bFast>
+UE_TARGET_AVX2_FMA static size_t AsinAVX2Loop(const double* In, double* Out, size_t Count)
+{
+	const __m256d One = _mm256_set1_pd(1.0);
+	size_t i = 0;
+	for (; i + 4 <= Count; i += 4)
+	{
+		const __m256d X = _mm256_loadu_pd(In + i);
+		const __m256d C = _mm256_sqrt_pd(_mm256_mul_pd(_mm256_sub_pd(One, X), _mm256_add_pd(One, X)));
+		_mm256_storeu_pd(Out + i, Atan2AVX2<bFast>(X, C));
+	}
+	return i;
+}
+
+/*-----------------------------------------------------------------------------
+	AVX-512, 8 lanes. Same operations as the AVX2 code with mask registers.
+-----------------------------------------------------------------------------*/
+
+template<bool bFast>
+UE_TARGET_AVX512 static inline void SinCosReducedAVX512(__m512d R, __m512i Quadrant, __m512d& OutSin, __m512d& OutCos)
+{
+	const __m512d Z = _mm512_mul_pd(R, R);
+	__m512d PS, PC;
+	if (bFast)
+	{
+		PS = _mm512_fmadd_pd(_mm512_fmadd_pd(_mm512_set1_pd(FastSinCoeffs[0]), Z, _mm512_set1_pd(FastSinCoeffs[1])), Z, _mm512_set1_pd(FastSinCoeffs[2]));
+		PC = _mm512_fmadd_pd(_mm512_fmadd_pd(_mm512_set1_pd(FastCosCoeffs[0]), Z, _mm512_set1_pd(FastCosCoeffs[1])), Z, _mm512_set1_pd(FastCosCoeffs[2]));
+	}
+	else
+	{
+		PS = _mm512_set1_pd(SinCoeffs[0]);
+		PC = _mm512_set1_pd(CosCoeffs[0]);
+		for (int k = 1; k < 6; ++k)
+		{
+			PS = _mm512_fmadd_pd(PS, Z, _mm512_set1_pd(SinCoeffs[k]));
+			PC = _mm512_fmadd_pd(PC, Z, _mm512_set1_pd(CosCoeffs[k]));
+		}
+	}
+	const __m512d S = _mm512_fmadd_pd(_mm512_mul_pd(R, Z), PS, R);
+	const __m512d C = _mm512_fmadd_pd(_mm512_mul_pd(Z, Z), PC, _mm512_fnmadd_pd(_mm512_set1_pd(0.5), Z, _mm512_set1_pd(1.0)));
+
+	const __m512i One = _mm512_set1_epi64(1);
+	const __m512i Two = _mm512_set1_epi64(2);
+	const __mmask8 Swap = _mm512_test_epi64_mask(Quadrant, One);
+	const __m512d SinSign = _mm512_castsi512_pd(_mm512_slli_epi64(_mm512_and_si512(Quadrant, Two), 62));
+	const __m512d CosSign = _mm512_castsi512_pd(_mm512_slli_epi64(_mm512_and_si512(_mm512_add_epi64(Quadrant, One), Two), 62));
+	OutSin = _mm512_xor_pd(_mm512_mask_blend_pd(Swap, S, C), SinSign);
+	OutCos = _mm512_xor_pd(_mm512_mask_blend_pd(Swap, C, S), CosSign);
+}
+
+template<bool bDegrees, bool bFast>
+UE_TARGET_AVX512 static size_t SinCosAVX512(const double* In, double* OutSin, double* OutCos, size_t Count)
+{
+	const __m512d Magic = _mm512_set1_pd(RoundingMagic);
+	size_t i = 0;
+	for (; i + 8 <= Count; i += 8)
+	{
+		const __m512d X = _mm512_loadu_pd(In + i);
+		__m512d QM, R;
+		if (bDegrees)
+		{
+			QM = _mm512_fmadd_pd(X, _mm512_set1_pd(1.0 / 90.0), Magic);
+			const __m512d Q = _mm512_sub_pd(QM, Magic);
+			const __m512d RDeg = _mm512_fnmadd_pd(Q, _mm512_set1_pd(90.0), X);
+			R = bFast ? _mm512_mul_pd(RDeg, _mm512_set1_pd(DegToRadHi))
+				: _mm512_fmadd_pd(RDeg, _mm512_set1_pd(DegToRadLo), _mm512_mul_pd(RDeg, _mm512_set1_pd(DegToRadHi)));
+		}
+		else
+		{
+			QM = _mm512_fmadd_pd(X, _mm512_set1_pd(TwoOverPi), Magic);
+			const __m512d Q = _mm512_sub_pd(QM, Magic);
+			R = _mm512_fnmadd_pd(Q, _mm512_set1_pd(HalfPi1), X);
+			R = _mm512_fnmadd_pd(Q, _mm512_set1_pd(HalfPi2), R);
+			R = _mm512_fnmadd_pd(Q, _mm512_set1_pd(HalfPi3), R);
+		}
+
+		__m512d S, C;
+		SinCosReducedAVX512<bFast>(R, _mm512_castpd_si512(QM), S, C);
+		_mm512_storeu_pd(OutSin + i, S);
+		_mm512_storeu_pd(OutCos + i, C);
+	}
+	return i;
+}
+
+template<bool bFast>
+UE_TARGET_AVX512 static inline __m512d Atan2AVX512(__m512d Y, __m512d X)
+{
+	const __m512d SignMask = _mm512_set1_pd(-0.0);
+	const __m512d One = _mm512_set1_pd(1.0);
+	const __m512d AY = _mm512_andnot_pd(SignMask, Y);
+	const __m512d AX = _mm512_andnot_pd(SignMask, X);
+	const __m512d Max = _mm512_max_pd(AX, AY);
+	const __m512d Min = _mm512_min_pd(AX, AY);
+	const __m512d A = _mm512_maskz_div_pd(_mm512_cmp_pd_mask(Max, _mm512_setzero_pd(), _CMP_GT_OQ), Min, Max);
+
+	const __mmask8 Reduce = _mm512_cmp_pd_mask(A, _mm512_set1_pd(bFast ? FastAtanReduceAbove : AtanReduceAbove), _CMP_GT_OQ);
+	const __m512d T = _mm512_mask_div_pd(A, Reduce, _mm512_sub_pd(A, One), _mm512_add_pd(A, One));
+	const __m512d Z = _mm512_mul_pd(T, T);
+	__m512d Ratio;
+	if (bFast)
+	{
+		Ratio = _mm512_set1_pd(FastAtanCoeffs[0]);
+		for (int k = 1; k < 4; ++k)
+		{
+			Ratio = _mm512_fmadd_pd(Ratio, Z, _mm512_set1_pd(FastAtanCoeffs[k]));
+		}
+	}
+	else
+	{
+		__m512d P = _mm512_set1_pd(AtanP[0]);
+		__m512d Q = _mm512_add_pd(Z, _mm512_set1_pd(AtanQ[0]));
+		for (int k = 1; k < 5; ++k)
+		{
+			P = _mm512_fmadd_pd(P, Z, _mm512_set1_pd(AtanP[k]));
+			Q = _mm512_fmadd_pd(Q, Z, _mm512_set1_pd(AtanQ[k]));
+		}
+		Ratio = _mm512_div_pd(P, Q);
+	}
+	__m512d Result = _mm512_fmadd_pd(_mm512_mul_pd(T, Z), Ratio, T);
+
+	Result = _mm512_mask_add_pd(Result, Reduce, _mm512_set1_pd(QuarterPiHi), _mm512_add_pd(Result, _mm512_set1_pd(QuarterPiLo)));
+	Result = _mm512_mask_add_pd(Result, _mm512_cmp_pd_mask(AY, AX, _CMP_GT_OQ), _mm512_sub_pd(_mm512_set1_pd(HalfPiHi), Result), _mm512_set1_pd(HalfPiLo));
+	Result = _mm512_mask_add_pd(Result, _mm512_movepi64_mask(_mm512_castpd_si512(X)), _mm512_sub_pd(_mm512_set1_pd(PiHi), Result), _mm512_set1_pd(PiLo));
+	Result = _mm512_or_pd(Result, _mm512_and_pd(Y, SignMask));
+	return _mm512_mask_add_pd(Result, _mm512_cmp_pd_mask(X, Y, _CMP_UNORD_Q), X, Y);
+}
+
+template<bool bFast>
+UE_TARGET_AVX512 static size_t Atan2AVX512Loop(const double* Y, const double* X, double* Out, size_t Count)
+{
+	size_t i = 0;
+	for (; i + 8 <= Count; i += 8)
+	{
+		_mm512_storeu_pd(Out + i, Atan2AVX512<bFast>(_mm512_loadu_pd(Y + i), _mm512_loadu_pd(X + i)));
+	}
+	return i;
+}
+
+template<bool bFast>
+UE_TARGET_AVX512 static size_t AsinAVX512Loop(const double* In, double* Out, size_t Count)
+{
+	const __m512d One = _mm512_set1_pd(1.0);
+	size_t i = 0;
+	for (; i + 8 <= Count; i += 8)
+	{
+		const __m512d X = _mm512_loadu_pd(In + i);
+		const __m512d C = _mm512_sqrt_pd(_mm512_mul_pd(_mm512_sub_pd(One, X), _mm512_add_pd(One, X)));
+		_mm512_storeu_pd(Out + i, Atan2AVX512<bFast>(X, C));
+	}
+	return i;
+}
+#endif
+
+/*-----------------------------------------------------------------------------
+	Dispatch. The vector loops return how many elements they did; the scalar
+	code finishes the rest.
+-----------------------------------------------------------------------------*/
+
+template<bool bDegrees, bool bFast>
+static void SinCosDispatch(const double* In, double* OutSin, double* OutCos, size_t Count)
+{
+	size_t i = 0;
+	switch (GetSimdLevel())
+	{
+#if UE_MATH_X86
+	case ESimdLevel::AVX512:
+		i = SinCosAVX512<bDegrees, bFast>(In, OutSin, OutCos, Count);
+		break;
+	case ESimdLevel::AVX2:
+		i = SinCosAVX2<bDegrees, bFast>(In, OutSin, OutCos, Count);
+		break;
+#endif
+	default:
+		break;
+	}
+
+	for (; i < Count; ++i)
+	{
+		if (bDegrees)
+		{
+			SinCosDegreesScalar<bFast>(In[i], OutSin[i], OutCos[i]);
+		}
+		else
+		{
+			SinCosScalar<bFast>(In[i], OutSin[i], OutCos[i]);
+		}
+	}
+}
+
+template<bool bFast>
+static void Atan2Dispatch(const double* Y, const double* X, double* Out, size_t Count)
+{
+	size_t i = 0;
+	switch (GetSimdLevel())
+	{
+#if UE_MATH_X86
+	case ESimdLevel::AVX512:
+		i = Atan2AVX512Loop<bFast>(Y, X, Out, Count);
+		break;
+	case ESimdLevel::AVX2:
+		i = Atan2AVX2Loop<bFast>(Y, X, Out, Count);
+		break;
+#endif
+	default:
+		break;
+	}
+
+	for (; i < Count; ++i)
+	{
+		Out[i] = Atan2Scalar<bFast>(Y[i], X[i]);
+	}
+}
+
+template<bool bFast>
+static void AsinDispatch(const double* In, double* Out, size_t Count)
+{
+	size_t i = 0;
+	switch (GetSimdLevel())
+	{
+#if UE_MATH_X86
+	case ESimdLevel::AVX512:
+		i = AsinAVX512Loop<bFast>(In, Out, Count);
+		break;
+	case ESimdLevel::AVX2:
+		i = AsinAVX2Loop<bFast>(In, Out, Count);
+		break;
+#endif
+	default:
+		break;
+	}
+
+	for (; i < Count; ++i)
+	{
+		Out[i] = AsinScalar<bFast>(In[i]);
+	}
+}
+
+void BatchSinCos(const double* Radians, double* OutSin, double* OutCos, size_t Count, ETrigAccuracy Accuracy)
+{
+	if (Accuracy == ETrigAccuracy::Fast)
+		SinCosDispatch<false, true>(Radians, OutSin, OutCos, Count);
+	else
+		SinCosDispatch<false, false>(Radians, OutSin, OutCos, Count);
+}
+
+void BatchSinCosDegrees(const double* Degrees, double* OutSin, double* OutCos, size_t Count, ETrigAccuracy Accuracy)
+{
+	if (Accuracy == ETrigAccuracy::Fast)
+		SinCosDispatch<true, true>(Degrees, OutSin, OutCos, Count);
+	else
+		SinCosDispatch<true, false>(Degrees, OutSin, OutCos, Count);
+}
+
+void BatchAtan2(const double* Y, const double* X, double* OutRadians, size_t Count, ETrigAccuracy Accuracy)
+{
+	if (Accuracy == ETrigAccuracy::Fast)
+		Atan2Dispatch<true>(Y, X, OutRadians, Count);
+	else
+		Atan2Dispatch<false>(Y, X, OutRadians, Count);
+}
+
+void BatchAsin(const double* In, double* OutRadians, size_t Count, ETrigAccuracy Accuracy)
+{
+	if (Accuracy == ETrigAccuracy::Fast)
+		AsinDispatch<true>(In, OutRadians, Count);
+	else
+		AsinDispatch<false>(In, OutRadians, Count);
+}
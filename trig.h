@@ -0,0 +1,44 @@
+#pragma once
+#include "ue4math.h"
+
+/*-----------------------------------------------------------------------------
+	Batch trigonometry over arrays of doubles.
+
+	Polynomial kernels with Cody-Waite argument reduction, dispatched on
+	GetSimdLevel() to AVX-512 (8 lanes), AVX2/FMA (4 lanes) or scalar code.
+	Every entry point takes an ETrigAccuracy; outputs may alias an input array
+	of the same length.
+-----------------------------------------------------------------------------*/
+
+enum class ETrigAccuracy : uint8_t
+{
+	Precise,	/* Double precision polynomials, within 2.5 ULP of the exact result (see each function) */
+	Fast,		/* Single precision polynomials evaluated in double: absolute error below 1e-8 */
+};
+
+/**
+ * OutSin[i] = sin(Radians[i]), OutCos[i] = cos(Radians[i]).
+ * Precise: at most 2.5 ULP from the exact result for |Radians| < 1e6; larger inputs lose accuracy.
+ * Fast: absolute error below 3e-9.
+ */
+void BatchSinCos(const double* Radians, double* OutSin, double* OutCos, size_t Count, ETrigAccuracy Accuracy = ETrigAccuracy::Precise);
+
+/**
+ * Degree input form of BatchSinCos. The reduction by multiples of 90 degrees is exact, so
+ * unlike sin(ConvertToRadians(Degrees)) large angles keep full accuracy (|Degrees| < 1e15).
+ * Precise: at most 2 ULP from the exact result. Fast: absolute error below 3e-9.
+ */
+void BatchSinCosDegrees(const double* Degrees, double* OutSin, double* OutCos, size_t Count, ETrigAccuracy Accuracy = ETrigAccuracy::Precise);
+
+/**
+ * OutRadians[i] = atan2(Y[i], X[i]), including the signed zero and -X quadrant rules of libm.
+ * Precise: at most 2 ULP; Fast: absolute error below 1e-8.
+ * NaN inputs give NaN; two infinite inputs give NaN instead of a multiple of pi/4.
+ */
+void BatchAtan2(const double* Y, const double* X, double* OutRadians, size_t Count, ETrigAccuracy Accuracy = ETrigAccuracy::Precise);
+
+/**
+ * OutRadians[i] = asin(In[i]), evaluated as atan2(In, sqrt((1 - In) * (1 + In))).
+ * Precise: at most 2.5 ULP; Fast: absolute error below 1e-8. |In| > 1 gives NaN.
+ */
+void BatchAsin(const double* In, double* OutRadians, size_t Count, ETrigAccuracy Accuracy = ETrigAccuracy::Precise);
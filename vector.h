@@ -1,151 +1,189 @@
 #pragma once
 #include "ue4math.h"
+#include "mathfwd.h"
 
-struct FRotator;
-
-struct FVector
+template<typename T>
+struct TVector
 {
+	static_assert(std::is_floating_point<T>::value, "T must be floating point");
+
 public:
-	double                                              X;                                            
-	double                                              Y;                                                  
-	double                                              Z;                                                   
+	using FReal = T;
+
+	T                                                   X;
+	T                                                   Y;
+	T                                                   Z;
 
-	FVector() : X(0.0), Y(0.0), Z(0.0) {}
-	FVector(double X, double Y, double Z) :X(X), Y(Y), Z(Z) {}
+	constexpr TVector() : X(0), Y(0), Z(0) {}
+	constexpr TVector(T X, T Y, T Z) :X(X), Y(Y), Z(Z) {}
 
-	double DotProduct(const FVector& v) const {
+	/** Explicit precision conversion, e.g. FVector3f(SomeFVector). */
+	template<typename U, typename = typename std::enable_if<!std::is_same<T, U>::value>::type>
+	constexpr explicit TVector(const TVector<U>& v) : X((T)v.X), Y((T)v.Y), Z((T)v.Z) {}
+
+	constexpr T DotProduct(const TVector& v) const {
 		return (X * v.X) + (Y * v.Y) + (Z * v.Z);
 	}
 
-	FVector CrossProduct(const FVector& v) const {
-		FVector output;
+	constexpr TVector CrossProduct(const TVector& v) const {
+		TVector output;
 		output.X = (Y * v.Z) - (Z * v.Y);
 		output.Y = (Z * v.X) - (X * v.Z);
 		output.Z = (X * v.Y) - (Y * v.X);
 		return output;
 	}
 
-	FVector Min(const FVector& v) const {
-		FVector output;
+	constexpr TVector Min(const TVector& v) const {
+		TVector output;
 		output.X = X < v.X ? X : v.X;
 		output.Y = Y < v.Y ? Y : v.Y;
 		output.Z = Z < v.Z ? Z : v.Z;
 		return output;
 	}
 
-	FVector Max(const FVector& v) const {
-		FVector output;
+	constexpr TVector Max(const TVector& v) const {
+		TVector output;
 		output.X = X > v.X ? X : v.X;
 		output.Y = Y > v.Y ? Y : v.Y;
 		output.Z = Z > v.Z ? Z : v.Z;
 		return output;
 	}
 
-	bool operator == (const FVector& v) const {
+	constexpr bool operator == (const TVector& v) const {
 		return X == v.X && Y == v.Y && Z == v.Z;
 	}
 
-	bool operator != (const FVector& v) const {
+	constexpr bool operator != (const TVector& v) const {
 		return !(*this == v);
 	}
 
-	FVector operator - () const {
-		return FVector(-X, -Y, -Z);
+	constexpr TVector operator - () const {
+		return TVector(-X, -Y, -Z);
+	}
+
+	constexpr TVector operator + (const TVector& v) const {
+		return TVector(X + v.X, Y + v.Y, Z + v.Z);
 	}
 
-	FVector operator + (const FVector& v) const {
-		return FVector(X + v.X, Y + v.Y, Z + v.Z);
+	constexpr TVector operator - (const TVector& v) const {
+		return TVector(X - v.X, Y - v.Y, Z - v.Z);
 	}
 
-	FVector operator - (const FVector& v) const {
-		return FVector(X - v.X, Y - v.Y, Z - v.Z);
+	constexpr TVector operator * (const TVector& v) const {
+		return TVector(X * v.X, Y * v.Y, Z * v.Z);
 	}
 
-	FVector operator * (const FVector& v) const {
-		return FVector(X * v.X, Y * v.Y, Z * v.Z);
+	constexpr TVector operator * (T Value) const {
+		return TVector(X * Value, Y * Value, Z * Value);
 	}
 
-	FVector operator * (double Value) const {
-		return FVector(X * Value, Y * Value, Z * Value);
+	constexpr TVector operator / (T Value) const {
+		return TVector(X / Value, Y / Value, Z / Value);
 	}
 
-	FVector GetNormalizedVector() const {
-		return operator*(1.0 / sqrt(X * X + Y * Y + Z * Z));
+	/** In place forms of the operators above, with the same rounding. */
+	constexpr TVector& operator += (const TVector& v) { X += v.X; Y += v.Y; Z += v.Z; return *this; }
+	constexpr TVector& operator -= (const TVector& v) { X -= v.X; Y -= v.Y; Z -= v.Z; return *this; }
+	constexpr TVector& operator *= (const TVector& v) { X *= v.X; Y *= v.Y; Z *= v.Z; return *this; }
+	constexpr TVector& operator *= (T Value) { X *= Value; Y *= Value; Z *= Value; return *this; }
+	constexpr TVector& operator /= (T Value) { X /= Value; Y /= Value; Z /= Value; return *this; }
+
+	/** No zero check; with EMathPrecision::Fast see InvSqrtFast for the error. */
+	template<EMathPrecision Precision = EMathPrecision::Precise>
+	TVector GetNormalizedVector() const {
+		return operator*(InvSqrt<Precision>(X * X + Y * Y + Z * Z));
 	}
 
+	template<EMathPrecision Precision = EMathPrecision::Precise>
 	void Normalize() {
-		*this = GetNormalizedVector();
+		*this = GetNormalizedVector<Precision>();
 	}
 
-	double Length() const {
+	T Length() const {
 		return sqrt(X * X + Y * Y + Z * Z);
 	}
 
-	double Distance(const FVector& v) const {
+	T Distance(const TVector& v) const {
 		return (v - *this).Length();
 	}
 
-	FVector operator ^ (const FVector& v) const {
+	constexpr TVector operator ^ (const TVector& v) const {
 		return CrossProduct(v);
 	}
 
-	double operator | (const FVector& v) const {
+	constexpr T operator | (const TVector& v) const {
 		return DotProduct(v);
 	}
 
-	FVector GetSignVector() const
+	constexpr TVector GetSignVector() const
 	{
-		return FVector
+		return TVector
 		(
-			Select(X, 1.0, -1.0),
-			Select(Y, 1.0, -1.0),
-			Select(Z, 1.0, -1.0)
+			Select(X, T(1), T(-1)),
+			Select(Y, T(1), T(-1)),
+			Select(Z, T(1), T(-1))
 		);
 	}
 
-	bool IsNearlyZero(double Tolerance = KINDA_SMALL_NUMBER) const {
+	bool IsNearlyZero(T Tolerance = T(KINDA_SMALL_NUMBER)) const {
 		return fabs(X) <= Tolerance && fabs(Y) <= Tolerance && fabs(Z) <= Tolerance;
 	}
 
-	FRotator GetDirectionRotator() const;
+	TRotator<T> GetDirectionRotator() const;
 };
 
-static FVector operator * (double Value, const FVector& v) {
+template<typename T>
+constexpr TVector<T> operator * (typename TVector<T>::FReal Value, const TVector<T>& v) {
 	return v.operator*(Value);
 }
 
 static_assert(sizeof(FVector) == 24, "FVector");
-class FVector2D
+static_assert(sizeof(FVector3f) == 12, "FVector3f");
+
+template<typename T>
+struct TVector2
 {
 public:
+	using FReal = T;
+
+	T                                                   X;                                                         // 0x0000(0x0004) (Edit, BlueprintVisible, ZeroConstructor, SaveGame, IsPlainOldData, NoDestructor, HasGetValueTypeHash, NativeAccessSpecifierPublic)
+	T                                                   Y;                                                         // 0x0004(0x0004) (Edit, BlueprintVisible, ZeroConstructor, SaveGame, IsPlainOldData, NoDestructor, HasGetValueTypeHash, NativeAccessSpecifierPublic)
 
-	double                                              X;                                                         // 0x0000(0x0004) (Edit, BlueprintVisible, ZeroConstructor, SaveGame, IsPlainOldData, NoDestructor, HasGetValueTypeHash, NativeAccessSpecifierPublic)
-	double                                              Y;                                                         // 0x0004(0x0004) (Edit, BlueprintVisible, ZeroConstructor, SaveGame, IsPlainOldData, NoDestructor, HasGetValueTypeHash, NativeAccessSpecifierPublic)
+	constexpr TVector2() : X(0), Y(0) {}
 
-	inline FVector2D() : X(0), Y(0) {}
+	constexpr TVector2(T x, T y) : X(x), Y(y) {}
 
-	inline FVector2D(double x, double y) : X(x), Y(y) {}
-	inline bool Zero() const
+	template<typename U, typename = typename std::enable_if<!std::is_same<T, U>::value>::type>
+	constexpr explicit TVector2(const TVector2<U>& other) : X((T)other.X), Y((T)other.Y) {}
+
+	constexpr bool Zero() const
 	{
-		return (X > -0.1 && X < 0.1 && Y > -0.1 && Y < 0.1);
+		return (X > T(-0.1) && X < T(0.1) && Y > T(-0.1) && Y < T(0.1));
 	}
-	inline FVector2D operator + (const FVector2D& other) const { return FVector2D(X + other.X, Y + other.Y); }
+	constexpr TVector2 operator + (const TVector2& other) const { return TVector2(X + other.X, Y + other.Y); }
+
+	constexpr TVector2 operator - (const TVector2& other) const { return TVector2(X - other.X, Y - other.Y); }
 
-	inline FVector2D operator - (const FVector2D& other) const { return FVector2D(X - other.X, Y - other.Y); }
+	constexpr TVector2 operator * (T scalar) const { return TVector2(X * scalar, Y * scalar); }
 
-	inline FVector2D operator * (double scalar) const { return FVector2D(X * scalar, Y * scalar); }
+	constexpr TVector2 operator * (const TVector2& other) const { return TVector2(X * other.X, Y * other.Y); }
 
-	inline FVector2D operator * (const FVector2D& other) const { return FVector2D(X * other.X, Y * other.Y); }
+	constexpr TVector2 operator / (T scalar) const { return TVector2(X / scalar, Y / scalar); }
 
-	inline FVector2D operator / (double scalar) const { return FVector2D(X / scalar, Y / scalar); }
+	constexpr TVector2 operator / (const TVector2& other) const { return TVector2(X / other.X, Y / other.Y); }
 
-	inline FVector2D operator / (const FVector2D& other) const { return FVector2D(X / other.X, Y / other.Y); }
+	constexpr TVector2& operator=  (const TVector2& other) { X = other.X; Y = other.Y; return *this; }
 
-	inline FVector2D& operator=  (const FVector2D& other) { X = other.X; Y = other.Y; return *this; }
+	constexpr TVector2& operator+= (const TVector2& other) { X += other.X; Y += other.Y; return *this; }
 
-	inline FVector2D& operator+= (const FVector2D& other) { X += other.X; Y += other.Y; return *this; }
+	constexpr TVector2& operator-= (const TVector2& other) { X -= other.X; Y -= other.Y; return *this; }
 
-	inline FVector2D& operator-= (const FVector2D& other) { X -= other.X; Y -= other.Y; return *this; }
+	constexpr TVector2& operator*= (const T other) { X *= other; Y *= other; return *this; }
+};
 
-	inline FVector2D& operator*= (const double other) { X *= other; Y *= other; return *this; }
-};
\ No newline at end of file
+#if UE_MATH_HEADER_ONLY
+#include "vector.inl"
+#else
+extern template struct TVector<float>;
+extern template struct TVector<double>;
+#endif
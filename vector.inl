@@ -0,0 +1,11 @@
+#pragma once
+#include "vector.h"
+
+template<typename T>
+UE_MATH_INLINE TRotator<T> TVector<T>::GetDirectionRotator() const {
+	TRotator<T> r;
+	r.Pitch = ConvertToDegrees(atan2(Z, sqrt(X * X + Y * Y)));
+	r.Yaw = ConvertToDegrees(atan2(Y, X));
+	r.Roll = 0.0;
+	return r;
+}
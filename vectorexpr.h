@@ -0,0 +1,167 @@
+#pragma once
+#include "ue4math.h"
+#include "vector.h"
+
+/**
+ * Opt-in expression templates for element-wise TVector arithmetic.
+ *
+ * Wrapping an operand in LazyVector() makes +, -, * and ^ build an expression instead of a
+ * TVector; converting the expression to TVector (or calling Eval()) evaluates the whole chain
+ * once per component, as one scalar expression per axis with no intermediate vectors:
+ *
+ *     const FVector Result = LazyVector(V) + LazyVector(T) * W + (LazyVector(Q) ^ T);
+ *
+ * The operations and their order are those of the eager operators, so without FP contraction the
+ * results are the same bit for bit; with -ffp-contract=fast (and FMA enabled) the compiler is free
+ * to fuse each axis's multiply-adds. Plain TVector arithmetic is unchanged.
+ *
+ * Expressions keep references to the vectors they were built from, so evaluate them within the
+ * full-expression that builds them rather than holding one in an auto variable.
+ */
+
+/** Base of every expression node; Derived provides T Get(int Axis) const. */
+template<typename T, typename Derived>
+struct TVectorExpr
+{
+	using FReal = T;
+
+	const Derived& Self() const { return static_cast<const Derived&>(*this); }
+
+	TVector<T> Eval() const
+	{
+		const Derived& Expr = Self();
+		return TVector<T>(Expr.Get(0), Expr.Get(1), Expr.Get(2));
+	}
+
+	operator TVector<T>() const { return Eval(); }
+};
+
+/** A TVector operand, by reference. */
+template<typename T>
+struct TVectorLeaf : public TVectorExpr<T, TVectorLeaf<T>>
+{
+	const TVector<T>& V;
+
+	explicit TVectorLeaf(const TVector<T>& V) : V(V) {}
+	T Get(int Axis) const { return Axis == 0 ? V.X : (Axis == 1 ? V.Y : V.Z); }
+};
+
+struct FVectorExprAdd { template<typename T> static T Apply(T A, T B) { return A + B; } };
+struct FVectorExprSub { template<typename T> static T Apply(T A, T B) { return A - B; } };
+struct FVectorExprMul { template<typename T> static T Apply(T A, T B) { return A * B; } };
+
+template<typename T, typename Left, typename Right, typename Op>
+struct TVectorBinary : public TVectorExpr<T, TVectorBinary<T, Left, Right, Op>>
+{
+	Left A;
+	Right B;
+
+	TVectorBinary(const Left& A, const Right& B) : A(A), B(B) {}
+	T Get(int Axis) const { return Op::Apply(A.Get(Axis), B.Get(Axis)); }
+};
+
+template<typename T, typename Operand>
+struct TVectorScale : public TVectorExpr<T, TVectorScale<T, Operand>>
+{
+	Operand A;
+	T Scale;
+
+	TVectorScale(const Operand& A, T Scale) : A(A), Scale(Scale) {}
+	T Get(int Axis) const { return A.Get(Axis) * Scale; }
+};
+
+template<typename T, typename Operand>
+struct TVectorNegate : public TVectorExpr<T, TVectorNegate<T, Operand>>
+{
+	Operand A;
+
+	explicit TVectorNegate(const Operand& A) : A(A) {}
+	T Get(int Axis) const { return -A.Get(Axis); }
+};
+
+/**
+ * A ^ B as TVector::CrossProduct. Each axis reads two components of both operands, so they are
+ * evaluated once up front rather than re-evaluated per axis.
+ */
+template<typename T>
+struct TVectorCross : public TVectorExpr<T, TVectorCross<T>>
+{
+	TVector<T> A;
+	TVector<T> B;
+
+	TVectorCross(const TVector<T>& A, const TVector<T>& B) : A(A), B(B) {}
+	T Get(int Axis) const
+	{
+		return Axis == 0 ? (A.Y * B.Z) - (A.Z * B.Y) : (Axis == 1 ? (A.Z * B.X) - (A.X * B.Z) : (A.X * B.Y) - (A.Y * B.X));
+	}
+};
+
+/** Starts an expression from V. */
+template<typename T>
+TVectorLeaf<T> LazyVector(const TVector<T>& V)
+{
+	return TVectorLeaf<T>(V);
+}
+
+/*-----------------------------------------------------------------------------
+	Operators, with an expression on at least one side.
+-----------------------------------------------------------------------------*/
+
+#define UE_VECTOR_EXPR_OPERATOR(Symbol, Op) \
+	template<typename T, typename Left, typename Right> \
+	TVectorBinary<T, Left, Right, Op> operator Symbol(const TVectorExpr<T, Left>& A, const TVectorExpr<T, Right>& B) \
+	{ \
+		return TVectorBinary<T, Left, Right, Op>(A.Self(), B.Self()); \
+	} \
+	template<typename T, typename Left> \
+	TVectorBinary<T, Left, TVectorLeaf<T>, Op> operator Symbol(const TVectorExpr<T, Left>& A, const TVector<T>& B) \
+	{ \
+		return TVectorBinary<T, Left, TVectorLeaf<T>, Op>(A.Self(), TVectorLeaf<T>(B)); \
+	} \
+	template<typename T, typename Right> \
+	TVectorBinary<T, TVectorLeaf<T>, Right, Op> operator Symbol(const TVector<T>& A, const TVectorExpr<T, Right>& B) \
+	{ \
+		return TVectorBinary<T, TVectorLeaf<T>, Right, Op>(TVectorLeaf<T>(A), B.Self()); \
+	}
+
+UE_VECTOR_EXPR_OPERATOR(+, FVectorExprAdd)
+UE_VECTOR_EXPR_OPERATOR(-, FVectorExprSub)
+UE_VECTOR_EXPR_OPERATOR(*, FVectorExprMul)
+
+#undef UE_VECTOR_EXPR_OPERATOR
+
+template<typename T, typename Operand>
+TVectorScale<T, Operand> operator*(const TVectorExpr<T, Operand>& A, typename TVectorExpr<T, Operand>::FReal Scale)
+{
+	return TVectorScale<T, Operand>(A.Self(), Scale);
+}
+
+template<typename T, typename Operand>
+TVectorScale<T, Operand> operator*(typename TVectorExpr<T, Operand>::FReal Scale, const TVectorExpr<T, Operand>& A)
+{
+	return TVectorScale<T, Operand>(A.Self(), Scale);
+}
+
+template<typename T, typename Operand>
+TVectorNegate<T, Operand> operator-(const TVectorExpr<T, Operand>& A)
+{
+	return TVectorNegate<T, Operand>(A.Self());
+}
+
+template<typename T, typename Left, typename Right>
+TVectorCross<T> operator^(const TVectorExpr<T, Left>& A, const TVectorExpr<T, Right>& B)
+{
+	return TVectorCross<T>(A.Eval(), B.Eval());
+}
+
+template<typename T, typename Left>
+TVectorCross<T> operator^(const TVectorExpr<T, Left>& A, const TVector<T>& B)
+{
+	return TVectorCross<T>(A.Eval(), B);
+}
+
+template<typename T, typename Right>
+TVectorCross<T> operator^(const TVector<T>& A, const TVectorExpr<T, Right>& B)
+{
+	return TVectorCross<T>(A, B.Eval());
+}